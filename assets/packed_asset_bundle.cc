@@ -0,0 +1,387 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <regex>
+#include <utility>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// "FPAB" in little endian.
+constexpr uint32_t kBundleMagic = 0x42415046;
+constexpr uint32_t kBundleVersion = 1u;
+
+// The data of every asset starts at a multiple of this, so that assets that
+// are read in place, such as kernel blobs, are suitably aligned.
+constexpr size_t kAssetAlignment = 16u;
+
+// A bundle is laid out as:
+//
+//   BundleHeader
+//   uint32_t buckets[bucket_count + 1]  Start of each bucket in the slots.
+//   uint32_t slots[entry_count]         Entry indices grouped by bucket.
+//   (padding)
+//   Entry entries[entry_count]          Sorted by name.
+//   char names[]
+//   (padding) asset data, each aligned to kAssetAlignment.
+struct BundleHeader {
+  uint32_t magic = kBundleMagic;
+  uint32_t version = kBundleVersion;
+  uint32_t entry_count = 0u;
+  // Always a power of two.
+  uint32_t bucket_count = 0u;
+};
+
+// FNV-1a.
+uint32_t HashName(std::string_view name) {
+  uint32_t hash = 2166136261u;
+  for (char c : name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+std::string_view GetBaseName(std::string_view name) {
+  auto separator = name.rfind('/');
+  return separator == std::string_view::npos ? name
+                                             : name.substr(separator + 1);
+}
+
+}  // namespace
+
+struct PackedAssetBundle::Entry {
+  uint32_t name_hash = 0u;
+  uint32_t name_offset = 0u;
+  uint32_t name_size = 0u;
+  uint32_t reserved = 0u;
+  uint64_t data_offset = 0u;
+  uint64_t data_size = 0u;
+};
+
+namespace {
+
+struct Layout {
+  uint64_t buckets_offset = 0u;
+  uint64_t slots_offset = 0u;
+  uint64_t entries_offset = 0u;
+  uint64_t names_offset = 0u;
+};
+
+Layout GetLayout(uint32_t entry_count, uint32_t bucket_count) {
+  Layout layout;
+  layout.buckets_offset = sizeof(BundleHeader);
+  layout.slots_offset =
+      layout.buckets_offset + (uint64_t{bucket_count} + 1) * sizeof(uint32_t);
+  layout.entries_offset =
+      AlignUp(layout.slots_offset + uint64_t{entry_count} * sizeof(uint32_t),
+              alignof(uint64_t));
+  return layout;
+}
+
+}  // namespace
+
+PackedAssetBundle::PackedAssetBundle(std::shared_ptr<fml::Mapping> bundle,
+                                     bool is_valid_after_asset_manager_change,
+                                     fml::UniqueFD loose_assets_directory)
+    : bundle_(std::move(bundle)),
+      is_valid_after_asset_manager_change_(
+          is_valid_after_asset_manager_change),
+      loose_assets_directory_(std::move(loose_assets_directory)) {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::PackedAssetBundle");
+  is_valid_ = Validate();
+  if (!is_valid_) {
+    entries_ = nullptr;
+    buckets_ = nullptr;
+    slots_ = nullptr;
+    entry_count_ = 0u;
+    bucket_count_ = 0u;
+  }
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+bool PackedAssetBundle::Validate() {
+  if (!bundle_ || bundle_->GetMapping() == nullptr) {
+    return false;
+  }
+  const uint8_t* data = bundle_->GetMapping();
+  const uint64_t size = bundle_->GetSize();
+  if (size < sizeof(BundleHeader) ||
+      reinterpret_cast<uintptr_t>(data) % alignof(Entry) != 0) {
+    return false;
+  }
+
+  BundleHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kBundleMagic || header.version != kBundleVersion ||
+      header.bucket_count == 0u ||
+      (header.bucket_count & (header.bucket_count - 1)) != 0u) {
+    FML_LOG(ERROR) << "The asset bundle is not in a known format.";
+    return false;
+  }
+
+  Layout layout = GetLayout(header.entry_count, header.bucket_count);
+  if (layout.entries_offset + uint64_t{header.entry_count} * sizeof(Entry) >
+      size) {
+    FML_LOG(ERROR) << "The asset bundle is truncated.";
+    return false;
+  }
+  entry_count_ = header.entry_count;
+  bucket_count_ = header.bucket_count;
+  buckets_ = reinterpret_cast<const uint32_t*>(data + layout.buckets_offset);
+  slots_ = reinterpret_cast<const uint32_t*>(data + layout.slots_offset);
+  entries_ = reinterpret_cast<const Entry*>(data + layout.entries_offset);
+
+  // Check everything once here so that lookups need no bounds checks.
+  if (buckets_[0] != 0u || buckets_[bucket_count_] != entry_count_) {
+    return false;
+  }
+  for (uint32_t i = 0; i < bucket_count_; i++) {
+    if (buckets_[i] > buckets_[i + 1]) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < entry_count_; i++) {
+    if (slots_[i] >= entry_count_) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < entry_count_; i++) {
+    const Entry& entry = entries_[i];
+    if (uint64_t{entry.name_offset} + entry.name_size > size ||
+        entry.data_offset > size ||
+        entry.data_size > size - entry.data_offset) {
+      FML_LOG(ERROR) << "The asset bundle is corrupt.";
+      return false;
+    }
+    // Sorted names allow subdirectories to be listed with a binary search.
+    if (i > 0 && !(GetName(entries_[i - 1]) < GetName(entry))) {
+      FML_LOG(ERROR) << "The asset bundle is corrupt.";
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string_view PackedAssetBundle::GetName(const Entry& entry) const {
+  return std::string_view(
+      reinterpret_cast<const char*>(bundle_->GetMapping()) + entry.name_offset,
+      entry.name_size);
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::MakeMapping(
+    const Entry& entry) const {
+  // The views keep the bundle mapped for as long as they are alive.
+  return std::make_unique<fml::NonOwnedMapping>(
+      bundle_->GetMapping() + entry.data_offset, entry.data_size,
+      [bundle = bundle_](auto, auto) {});
+}
+
+size_t PackedAssetBundle::GetAssetCount() const {
+  return entry_count_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValidAfterAssetManagerChange() const {
+  return is_valid_after_asset_manager_change_;
+}
+
+// |AssetResolver|
+AssetResolver::AssetResolverType PackedAssetBundle::GetType() const {
+  return AssetResolver::AssetResolverType::kPackedAssetBundle;
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+
+  const uint32_t hash = HashName(asset_name);
+  const uint32_t bucket = hash & (bucket_count_ - 1);
+  for (uint32_t i = buckets_[bucket]; i < buckets_[bucket + 1]; i++) {
+    const Entry& entry = entries_[slots_[i]];
+    if (entry.name_hash == hash && GetName(entry) == asset_name) {
+      return MakeMapping(entry);
+    }
+  }
+  return nullptr;
+}
+
+// |AssetResolver|
+std::vector<std::unique_ptr<fml::Mapping>> PackedAssetBundle::GetAsMappings(
+    const std::string& asset_pattern,
+    const std::optional<std::string>& subdir) const {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::GetAsMappings");
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return mappings;
+  }
+
+  // Like the directory bundle, match the file names of all assets, or only
+  // those of the assets directly in the subdirectory.
+  std::regex asset_regex(asset_pattern);
+  const Entry* begin = entries_;
+  const Entry* end = entries_ + entry_count_;
+  std::string prefix;
+  if (subdir.has_value()) {
+    prefix = subdir.value();
+    while (!prefix.empty() && prefix.back() == '/') {
+      prefix.pop_back();
+    }
+    if (!prefix.empty()) {
+      prefix.push_back('/');
+    }
+    begin = std::lower_bound(begin, end, prefix,
+                             [this](const Entry& entry, const std::string& p) {
+                               return GetName(entry) < p;
+                             });
+  }
+
+  for (const Entry* entry = begin; entry != end; entry++) {
+    std::string_view name = GetName(*entry);
+    std::string_view file_name;
+    if (subdir.has_value()) {
+      if (name.compare(0, prefix.size(), prefix) != 0) {
+        break;
+      }
+      file_name = name.substr(prefix.size());
+      if (file_name.find('/') != std::string_view::npos) {
+        continue;
+      }
+    } else {
+      file_name = GetBaseName(name);
+    }
+    if (!std::regex_match(file_name.begin(), file_name.end(), asset_regex)) {
+      continue;
+    }
+    if (loose_assets_directory_.is_valid() &&
+        fml::FileExists(loose_assets_directory_, std::string(name).c_str())) {
+      // Returned by the directory bundle.
+      continue;
+    }
+    mappings.push_back(MakeMapping(*entry));
+  }
+  return mappings;
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::Pack(
+    const std::vector<Asset>& assets) {
+  if (assets.size() >= std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+  std::vector<const Asset*> sorted;
+  sorted.reserve(assets.size());
+  for (const auto& asset : assets) {
+    if (asset.name.empty()) {
+      FML_LOG(ERROR) << "Assets must have names.";
+      return nullptr;
+    }
+    sorted.push_back(&asset);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Asset* a, const Asset* b) {
+    return a->name < b->name;
+  });
+  for (size_t i = 1; i < sorted.size(); i++) {
+    if (sorted[i - 1]->name == sorted[i]->name) {
+      FML_LOG(ERROR) << "Duplicate asset: " << sorted[i]->name;
+      return nullptr;
+    }
+  }
+
+  BundleHeader header;
+  header.entry_count = sorted.size();
+  header.bucket_count = 1u;
+  while (header.bucket_count < header.entry_count) {
+    header.bucket_count <<= 1;
+  }
+  Layout layout = GetLayout(header.entry_count, header.bucket_count);
+  layout.names_offset =
+      layout.entries_offset + uint64_t{header.entry_count} * sizeof(Entry);
+
+  // Lay out the names and then the data.
+  std::vector<Entry> entries(sorted.size());
+  uint64_t offset = layout.names_offset;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    entries[i].name_hash = HashName(sorted[i]->name);
+    entries[i].name_offset = offset;
+    entries[i].name_size = sorted[i]->name.size();
+    offset += sorted[i]->name.size();
+    if (offset > std::numeric_limits<uint32_t>::max()) {
+      FML_LOG(ERROR) << "The asset names are too long.";
+      return nullptr;
+    }
+  }
+  for (size_t i = 0; i < sorted.size(); i++) {
+    const auto& data = sorted[i]->data;
+    offset = AlignUp(offset, kAssetAlignment);
+    entries[i].data_offset = offset;
+    entries[i].data_size = data ? data->GetSize() : 0u;
+    offset += entries[i].data_size;
+  }
+  if (offset != static_cast<size_t>(offset)) {
+    return nullptr;
+  }
+
+  // Group the entries by bucket.
+  const uint32_t mask = header.bucket_count - 1;
+  std::vector<uint32_t> buckets(header.bucket_count + 1, 0u);
+  for (const auto& entry : entries) {
+    buckets[(entry.name_hash & mask) + 1]++;
+  }
+  for (uint32_t i = 0; i < header.bucket_count; i++) {
+    buckets[i + 1] += buckets[i];
+  }
+  std::vector<uint32_t> slots(entries.size());
+  std::vector<uint32_t> next(buckets.begin(), buckets.end() - 1);
+  for (uint32_t i = 0; i < entries.size(); i++) {
+    slots[next[entries[i].name_hash & mask]++] = i;
+  }
+
+  std::vector<uint8_t> bundle(offset, 0u);
+  std::memcpy(bundle.data(), &header, sizeof(header));
+  std::memcpy(bundle.data() + layout.buckets_offset, buckets.data(),
+              buckets.size() * sizeof(uint32_t));
+  if (!entries.empty()) {
+    std::memcpy(bundle.data() + layout.slots_offset, slots.data(),
+                slots.size() * sizeof(uint32_t));
+    std::memcpy(bundle.data() + layout.entries_offset, entries.data(),
+                entries.size() * sizeof(Entry));
+  }
+  for (size_t i = 0; i < sorted.size(); i++) {
+    const auto& asset = *sorted[i];
+    std::memcpy(bundle.data() + entries[i].name_offset, asset.name.data(),
+                asset.name.size());
+    if (entries[i].data_size > 0u) {
+      std::memcpy(bundle.data() + entries[i].data_offset,
+                  asset.data->GetMapping(), entries[i].data_size);
+    }
+  }
+  return std::make_unique<fml::DataMapping>(std::move(bundle));
+}
+
+}  // namespace flutter
@@ -0,0 +1,115 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An asset resolver for assets packed into a single bundle file.
+///
+///             The bundle starts with a table of contents that holds the
+///             names of the assets, sorted, and a hash table over them. The
+///             file is mapped once and the mappings of the assets are views
+///             into it, so resolving an asset costs no file system calls and
+///             copies nothing.
+///
+///             Bundles are produced by the `asset-packer` host tool, or by
+///             |Pack|.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  static constexpr char kFileName[] = "flutter_assets.pak";
+
+  struct Asset {
+    /// The path of the asset relative to the root of the assets, with `/` as
+    /// the separator.
+    std::string name;
+    std::shared_ptr<fml::Mapping> data;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a resolver for the assets in a bundle.
+  ///
+  /// @param[in]  bundle  The contents of the bundle file, usually a
+  ///                     `fml::FileMapping`. The resolver is invalid if this
+  ///                     isn't a well-formed bundle.
+  ///
+  /// @param[in]  loose_assets_directory  The directory the bundle is
+  ///                     installed next to, if its assets are also resolved
+  ///                     by a `DirectoryAssetBundle`. Pattern lookups skip
+  ///                     the assets that exist as loose files in it, which
+  ///                     the directory bundle already returns.
+  ///
+  PackedAssetBundle(std::shared_ptr<fml::Mapping> bundle,
+                    bool is_valid_after_asset_manager_change,
+                    fml::UniqueFD loose_assets_directory = {});
+
+  ~PackedAssetBundle() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Builds a bundle holding the given assets.
+  ///
+  /// @return     The bundle, or nullptr if two assets have the same name or
+  ///             the bundle would be too large.
+  ///
+  static std::unique_ptr<fml::Mapping> Pack(const std::vector<Asset>& assets);
+
+  size_t GetAssetCount() const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override;
+
+  // |AssetResolver|
+  AssetResolver::AssetResolverType GetType() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  std::vector<std::unique_ptr<fml::Mapping>> GetAsMappings(
+      const std::string& asset_pattern,
+      const std::optional<std::string>& subdir) const override;
+
+ private:
+  struct Entry;
+
+  const std::shared_ptr<fml::Mapping> bundle_;
+  const bool is_valid_after_asset_manager_change_;
+  const fml::UniqueFD loose_assets_directory_;
+  const Entry* entries_ = nullptr;
+  const uint32_t* buckets_ = nullptr;
+  const uint32_t* slots_ = nullptr;
+  uint32_t entry_count_ = 0u;
+  uint32_t bucket_count_ = 0u;
+  bool is_valid_ = false;
+
+  bool Validate();
+
+  std::string_view GetName(const Entry& entry) const;
+
+  std::unique_ptr<fml::Mapping> MakeMapping(const Entry& entry) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
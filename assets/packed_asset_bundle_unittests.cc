@@ -0,0 +1,193 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static std::shared_ptr<fml::Mapping> MakeData(const std::string& text) {
+  return std::make_shared<fml::DataMapping>(text);
+}
+
+static std::string ToString(const std::unique_ptr<fml::Mapping>& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                     mapping->GetSize());
+}
+
+static std::shared_ptr<fml::Mapping> PackTestAssets() {
+  return PackedAssetBundle::Pack({
+      {.name = "AssetManifest.json", .data = MakeData("{}")},
+      {.name = "fonts/Roboto.ttf", .data = MakeData("roboto")},
+      {.name = "shaders/a.skp", .data = MakeData("a")},
+      {.name = "shaders/b.skp", .data = MakeData("b")},
+      {.name = "shaders/c.frag", .data = MakeData("c")},
+      {.name = "shaders/nested/d.skp", .data = MakeData("d")},
+      {.name = "empty.txt", .data = MakeData("")},
+  });
+}
+
+TEST(PackedAssetBundleTest, ResolvesAssetsByName) {
+  PackedAssetBundle bundle(PackTestAssets(), true);
+  ASSERT_TRUE(bundle.IsValid());
+  EXPECT_TRUE(bundle.IsValidAfterAssetManagerChange());
+  EXPECT_EQ(bundle.GetType(),
+            AssetResolver::AssetResolverType::kPackedAssetBundle);
+  EXPECT_EQ(bundle.GetAssetCount(), 7u);
+
+  EXPECT_EQ(ToString(bundle.GetAsMapping("AssetManifest.json")), "{}");
+  EXPECT_EQ(ToString(bundle.GetAsMapping("fonts/Roboto.ttf")), "roboto");
+  EXPECT_EQ(ToString(bundle.GetAsMapping("shaders/nested/d.skp")), "d");
+  auto empty = bundle.GetAsMapping("empty.txt");
+  ASSERT_NE(empty, nullptr);
+  EXPECT_EQ(empty->GetSize(), 0u);
+  EXPECT_EQ(bundle.GetAsMapping("fonts"), nullptr);
+  EXPECT_EQ(bundle.GetAsMapping("Roboto.ttf"), nullptr);
+  EXPECT_EQ(bundle.GetAsMapping("missing"), nullptr);
+}
+
+TEST(PackedAssetBundleTest, MappingsOutliveTheResolver) {
+  auto packed = PackTestAssets();
+  std::unique_ptr<fml::Mapping> mapping;
+  {
+    PackedAssetBundle bundle(packed, false);
+    mapping = bundle.GetAsMapping("fonts/Roboto.ttf");
+    // The mapping is a view into the bundle rather than a copy.
+    EXPECT_GE(mapping->GetMapping(), packed->GetMapping());
+    EXPECT_LE(mapping->GetMapping() + mapping->GetSize(),
+              packed->GetMapping() + packed->GetSize());
+  }
+  packed.reset();
+  EXPECT_EQ(ToString(mapping), "roboto");
+}
+
+TEST(PackedAssetBundleTest, ResolvesAssetsByPattern) {
+  PackedAssetBundle bundle(PackTestAssets(), true);
+  ASSERT_TRUE(bundle.IsValid());
+
+  // Without a subdirectory, all assets are matched by their file names.
+  auto all_skps = bundle.GetAsMappings(".*\\.skp$", std::nullopt);
+  ASSERT_EQ(all_skps.size(), 3u);
+  EXPECT_EQ(ToString(all_skps[0]), "a");
+  EXPECT_EQ(ToString(all_skps[1]), "b");
+  EXPECT_EQ(ToString(all_skps[2]), "d");
+
+  // In a subdirectory, only the assets directly in it are matched.
+  auto skps = bundle.GetAsMappings(".*\\.skp$", "shaders");
+  ASSERT_EQ(skps.size(), 2u);
+  EXPECT_EQ(ToString(skps[0]), "a");
+  EXPECT_EQ(ToString(skps[1]), "b");
+  EXPECT_EQ(bundle.GetAsMappings(".*", "shaders/").size(), 3u);
+  EXPECT_EQ(bundle.GetAsMappings(".*", "shaders/nested").size(), 1u);
+  EXPECT_EQ(bundle.GetAsMappings(".*", "missing").size(), 0u);
+  EXPECT_EQ(bundle.GetAsMappings(".*", "").size(), 2u);
+}
+
+TEST(PackedAssetBundleTest, PatternLookupsSkipLooseAssets) {
+  fml::ScopedTemporaryDirectory loose_assets;
+  auto shaders = fml::CreateDirectory(loose_assets.fd(), {"shaders"},
+                                      fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fml::WriteAtomically(shaders, "a.skp", fml::DataMapping("new")));
+
+  PackedAssetBundle bundle(PackTestAssets(), false,
+                           fml::Duplicate(loose_assets.fd().get()));
+  ASSERT_TRUE(bundle.IsValid());
+  EXPECT_FALSE(bundle.IsValidAfterAssetManagerChange());
+
+  // The loose file is left to the directory bundle.
+  auto all_skps = bundle.GetAsMappings(".*\\.skp$", std::nullopt);
+  ASSERT_EQ(all_skps.size(), 2u);
+  EXPECT_EQ(ToString(all_skps[0]), "b");
+  EXPECT_EQ(ToString(all_skps[1]), "d");
+  auto skps = bundle.GetAsMappings(".*\\.skp$", "shaders");
+  ASSERT_EQ(skps.size(), 1u);
+  EXPECT_EQ(ToString(skps[0]), "b");
+
+  // Lookups by name still resolve the packed asset.
+  EXPECT_EQ(ToString(bundle.GetAsMapping("shaders/a.skp")), "a");
+
+  ASSERT_TRUE(fml::UnlinkFile(shaders, "a.skp"));
+  ASSERT_TRUE(fml::UnlinkDirectory(loose_assets.fd(), "shaders"));
+}
+
+TEST(PackedAssetBundleTest, CanResolveManyAssets) {
+  std::vector<PackedAssetBundle::Asset> assets;
+  for (int i = 0; i < 1000; i++) {
+    assets.push_back({
+        .name = "images/" + std::to_string(i) + ".png",
+        .data = MakeData(std::to_string(i)),
+    });
+  }
+  PackedAssetBundle bundle(PackedAssetBundle::Pack(assets), true);
+  ASSERT_TRUE(bundle.IsValid());
+  for (int i = 0; i < 1000; i++) {
+    auto mapping =
+        bundle.GetAsMapping("images/" + std::to_string(i) + ".png");
+    ASSERT_NE(mapping, nullptr);
+    EXPECT_EQ(ToString(mapping), std::to_string(i));
+    // Assets are aligned so that they can be read in place.
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mapping->GetMapping()) % 16u, 0u);
+  }
+}
+
+TEST(PackedAssetBundleTest, CanPackNoAssets) {
+  PackedAssetBundle bundle(PackedAssetBundle::Pack({}), true);
+  ASSERT_TRUE(bundle.IsValid());
+  EXPECT_EQ(bundle.GetAssetCount(), 0u);
+  EXPECT_EQ(bundle.GetAsMapping("missing"), nullptr);
+  EXPECT_EQ(bundle.GetAsMappings(".*", std::nullopt).size(), 0u);
+}
+
+TEST(PackedAssetBundleTest, RejectsDuplicateAssets) {
+  EXPECT_EQ(PackedAssetBundle::Pack({
+                {.name = "a", .data = MakeData("1")},
+                {.name = "a", .data = MakeData("2")},
+            }),
+            nullptr);
+}
+
+TEST(PackedAssetBundleTest, RejectsInvalidBundles) {
+  EXPECT_FALSE(PackedAssetBundle(nullptr, true).IsValid());
+
+  auto packed = PackTestAssets();
+  std::vector<uint8_t> data(packed->GetMapping(),
+                            packed->GetMapping() + packed->GetSize());
+
+  // Truncated.
+  for (size_t size : {size_t{0u}, size_t{8u}, size_t{64u}}) {
+    auto truncated = std::make_shared<fml::DataMapping>(
+        std::vector<uint8_t>(data.begin(), data.begin() + size));
+    EXPECT_FALSE(PackedAssetBundle(truncated, true).IsValid());
+  }
+
+  // Unknown format.
+  auto corrupted_data = data;
+  corrupted_data[0] ^= 0xff;
+  auto corrupted =
+      std::make_shared<fml::DataMapping>(std::move(corrupted_data));
+  EXPECT_FALSE(PackedAssetBundle(corrupted, true).IsValid());
+}
+
+TEST(PackedAssetBundleTest, CanResolveAssetsFromBundleFile) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  ASSERT_TRUE(fml::WriteAtomically(temp_dir.fd(), PackedAssetBundle::kFileName,
+                                   *PackTestAssets()));
+  auto file = fml::FileMapping::CreateReadOnly(temp_dir.fd(),
+                                               PackedAssetBundle::kFileName);
+  ASSERT_NE(file, nullptr);
+
+  PackedAssetBundle bundle(std::move(file), true);
+  ASSERT_TRUE(bundle.IsValid());
+  EXPECT_EQ(ToString(bundle.GetAsMapping("shaders/c.frag")), "c");
+}
+
+}  // namespace testing
+}  // namespace flutter
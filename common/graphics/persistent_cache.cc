@@ -9,6 +9,7 @@
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "flutter/fml/base32.h"
 #include "flutter/fml/file.h"
@@ -86,7 +87,9 @@ bool PersistentCache::Purge() {
 
   std::promise<bool> removed;
   GetWorkerTaskRunner()->PostTask([&removed,
-                                   cache_directory = cache_directory_]() {
+                                   cache_directory = cache_directory_,
+                                   archive = archive_,
+                                   sksl_archive = sksl_archive_]() {
     if (cache_directory->is_valid()) {
       // Only remove files but not directories.
       FML_LOG(INFO) << "Purge persistent cache.";
@@ -96,9 +99,20 @@ bool PersistentCache::Purge() {
         if (fml::IsDirectory(directory, filename.c_str())) {
           return true;
         }
+        // The archives are emptied rather than deleted as they stay open.
+        if (filename == ShaderCacheArchive::kFileName ||
+            filename == ShaderCacheArchive::kLockFileName) {
+          return true;
+        }
         return fml::UnlinkFile(directory, filename.c_str());
       };
-      removed.set_value(VisitFilesRecursively(*cache_directory, delete_file));
+      bool success = VisitFilesRecursively(*cache_directory, delete_file);
+      for (const auto& cache_archive : {archive, sksl_archive}) {
+        if (cache_archive && !cache_archive->Clear()) {
+          success = false;
+        }
+      }
+      removed.set_value(success);
     } else {
       removed.set_value(false);
     }
@@ -132,7 +146,7 @@ static void FreeOldCacheDirectory(const fml::UniqueFD& cache_base_dir) {
 static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
     const std::string& global_cache_base_path,
     bool read_only,
-    bool cache_sksl) {
+    const std::vector<std::string>& renderer_components) {
   fml::UniqueFD cache_base_dir;
   if (global_cache_base_path.length()) {
     cache_base_dir = fml::OpenDirectory(global_cache_base_path.c_str(), false,
@@ -143,11 +157,10 @@ static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
 
   if (cache_base_dir.is_valid()) {
     FreeOldCacheDirectory(cache_base_dir);
-    std::vector<std::string> components = {
-        kEngineComponent, GetFlutterEngineVersion(), "skia", GetSkiaVersion()};
-    if (cache_sksl) {
-      components.push_back(PersistentCache::kSkSLSubdirName);
-    }
+    std::vector<std::string> components = {kEngineComponent,
+                                           GetFlutterEngineVersion()};
+    components.insert(components.end(), renderer_components.begin(),
+                      renderer_components.end());
     return std::make_shared<fml::UniqueFD>(
         CreateDirectory(cache_base_dir, components,
                         read_only ? fml::FilePermission::kRead
@@ -156,6 +169,19 @@ static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
     return std::make_shared<fml::UniqueFD>();
   }
 }
+
+static std::shared_ptr<ShaderCacheArchive> MakeCacheArchive(
+    const std::shared_ptr<fml::UniqueFD>& directory,
+    bool read_only) {
+  if (!directory->is_valid()) {
+    return nullptr;
+  }
+  auto archive = std::make_shared<ShaderCacheArchive>(*directory, read_only);
+  if (!archive->IsValid()) {
+    return nullptr;
+  }
+  return archive;
+}
 }  // namespace
 
 sk_sp<SkData> ParseBase32(const std::string& input) {
@@ -221,8 +247,18 @@ size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
 std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
   std::vector<PersistentCache::SkSLCache> result;
+  if (sksl_archive_) {
+    for (auto& entry : sksl_archive_->LoadAll()) {
+      result.push_back({std::move(entry.key), std::move(entry.value)});
+    }
+  }
+
   fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
                                        const std::string& filename) {
+    if (filename == ShaderCacheArchive::kFileName ||
+        filename == ShaderCacheArchive::kLockFileName) {
+      return true;
+    }
     SkSLCache cache = LoadFile(directory, filename, true);
     if (cache.key != nullptr && cache.value != nullptr) {
       result.push_back(cache);
@@ -277,12 +313,27 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
 
 PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
-      cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
-      sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+      cache_directory_(MakeCacheDirectory(cache_base_path_,
+                                          read_only,
+                                          {"skia", GetSkiaVersion()})),
+      sksl_cache_directory_(MakeCacheDirectory(
+          cache_base_path_,
+          read_only,
+          {"skia", GetSkiaVersion(), kSkSLSubdirName})),
+      impeller_cache_directory_(
+          MakeCacheDirectory(cache_base_path_, read_only, {"impeller"})),
+      archive_(MakeCacheArchive(cache_directory_, read_only)),
+      sksl_archive_(MakeCacheArchive(sksl_cache_directory_, read_only)) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
+    return;
+  }
+  if (archive_ && !read_only) {
+    MigrateCacheFiles(*cache_directory_, *archive_);
+  }
+  if (sksl_archive_ && !read_only) {
+    MigrateCacheFiles(*sksl_cache_directory_, *sksl_archive_);
   }
 }
 
@@ -292,6 +343,47 @@ bool PersistentCache::IsValid() const {
   return cache_directory_ && cache_directory_->is_valid();
 }
 
+fml::UniqueFD PersistentCache::OpenImpellerCacheDirectory() const {
+  if (!impeller_cache_directory_ || !impeller_cache_directory_->is_valid()) {
+    return {};
+  }
+  return fml::Duplicate(impeller_cache_directory_->get());
+}
+
+void PersistentCache::MigrateCacheFiles(const fml::UniqueFD& directory,
+                                        ShaderCacheArchive& archive) {
+  std::vector<ShaderCacheArchive::Entry> entries;
+  std::vector<std::string> file_names;
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& dir,
+                                 const std::string& filename) {
+    if (filename == ShaderCacheArchive::kFileName ||
+        filename == ShaderCacheArchive::kLockFileName ||
+        fml::IsDirectory(dir, filename.c_str())) {
+      return true;
+    }
+    // Other files, such as SKP dumps, are left alone.
+    SkSLCache cache = LoadFile(dir, filename, true);
+    if (cache.key != nullptr && cache.value != nullptr) {
+      entries.push_back({std::move(cache.key), std::move(cache.value)});
+      file_names.push_back(filename);
+    }
+    return true;
+  });
+  if (entries.empty()) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "PersistentCache::MigrateCacheFiles");
+  if (!archive.Store(entries)) {
+    FML_LOG(WARNING) << "Could not move the persistent cache files into the "
+                        "shader cache archive.";
+    return;
+  }
+  for (const auto& file_name : file_names) {
+    fml::UnlinkFile(directory, file_name.c_str());
+  }
+}
+
 PersistentCache::SkSLCache PersistentCache::LoadFile(
     const fml::UniqueFD& dir,
     const std::string& file_name,
@@ -332,18 +424,38 @@ sk_sp<SkData> PersistentCache::load(const SkData& key) {
   if (!IsValid()) {
     return nullptr;
   }
-  auto file_name = SkKeyToFilePath(key);
-  if (file_name.empty()) {
-    return nullptr;
+  sk_sp<SkData> result;
+  if (archive_) {
+    result = archive_->Load(key);
+  }
+  if (result == nullptr) {
+    // Read-only caches may still be in the layout of older engines.
+    auto file_name = SkKeyToFilePath(key);
+    if (file_name.empty()) {
+      return nullptr;
+    }
+    result =
+        PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
   }
-  auto result =
-      PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
   }
   return result;
 }
 
+static void RunOnWorker(const fml::RefPtr<fml::TaskRunner>& worker,
+                        fml::closure task) {
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+  } else {
+    worker->PostTask(std::move(task));
+  }
+}
+
 static void PersistentCacheStore(
     const fml::RefPtr<fml::TaskRunner>& worker,
     const std::shared_ptr<fml::UniqueFD>& cache_directory,
@@ -363,16 +475,21 @@ static void PersistentCacheStore(
       FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
     }
   });
+  RunOnWorker(worker, std::move(task));
+}
 
-  if (!worker) {
-    FML_LOG(WARNING)
-        << "The persistent cache has no available workers. Performing the task "
-           "on the current thread. This slow operation is going to occur on a "
-           "frame workload.";
-    task();
-  } else {
-    worker->PostTask(std::move(task));
-  }
+static void PersistentCacheStore(
+    const fml::RefPtr<fml::TaskRunner>& worker,
+    const std::shared_ptr<ShaderCacheArchive>& archive,
+    sk_sp<SkData> key,
+    sk_sp<SkData> value) {
+  RunOnWorker(worker, [archive, key = std::move(key),
+                       value = std::move(value)]() {
+    TRACE_EVENT0("flutter", "PersistentCacheStore");
+    if (!archive->Store(*key, *value)) {
+      FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
+    }
+  });
 }
 
 std::unique_ptr<fml::MallocMapping> PersistentCache::BuildCacheObject(
@@ -407,20 +524,14 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  auto file_name = SkKeyToFilePath(key);
-
-  if (file_name.empty()) {
-    return;
-  }
-
-  std::unique_ptr<fml::MallocMapping> mapping = BuildCacheObject(key, data);
-  if (!mapping) {
+  const auto& archive = cache_sksl_ ? sksl_archive_ : archive_;
+  if (!archive || key.size() == 0) {
     return;
   }
 
-  PersistentCacheStore(GetWorkerTaskRunner(),
-                       cache_sksl_ ? sksl_cache_directory_ : cache_directory_,
-                       std::move(file_name), std::move(mapping));
+  PersistentCacheStore(GetWorkerTaskRunner(), archive,
+                       SkData::MakeWithCopy(key.data(), key.size()),
+                       SkData::MakeWithCopy(data.data(), data.size()));
 }
 
 void PersistentCache::DumpSkp(const SkData& data) {
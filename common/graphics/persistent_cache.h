@@ -10,6 +10,7 @@
 #include <set>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/common/graphics/shader_cache_archive.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
@@ -74,6 +75,11 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   void RemoveWorkerTaskRunner(const fml::RefPtr<fml::TaskRunner>& task_runner);
 
+  // Opens the directory in which Impeller keeps its caches for this version of
+  // the engine, such as the manifest of the pipeline variants an application
+  // uses. The descriptor is invalid if caching on disk is unavailable.
+  fml::UniqueFD OpenImpellerCacheDirectory() const;
+
   // Whether Skia tries to store any shader into this persistent cache after
   // |ResetStoredNewShaders| is called. This flag is usually reset before each
   // frame so we can know if Skia tries to compile new shaders in that frame.
@@ -83,8 +89,8 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   bool IsDumpingSkp() const { return is_dumping_skp_; }
   void SetIsDumpingSkp(bool value) { is_dumping_skp_ = value; }
 
-  // Remove all files inside the persistent cache directory.
-  // Return whether the purge is successful.
+  // Remove all files inside the persistent cache directory, and all entries of
+  // the shader cache archives. Return whether the purge is successful.
   bool Purge();
 
   // |GrContextOptions::PersistentCache|
@@ -95,7 +101,8 @@ class PersistentCache : public GrContextOptions::PersistentCache {
     sk_sp<SkData> value;
   };
 
-  /// Load all the SkSL shader caches in the right directory.
+  /// Load all the SkSL shader caches in the right directory, from least to most
+  /// recently used.
   std::vector<SkSLCache> LoadSkSLs() const;
 
   //----------------------------------------------------------------------------
@@ -153,6 +160,12 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  const std::shared_ptr<fml::UniqueFD> impeller_cache_directory_;
+  // Cache objects are kept in a single archive file per directory. Older
+  // versions of the engine stored each object in its own file, which are
+  // moved into the archives when the cache is created.
+  const std::shared_ptr<ShaderCacheArchive> archive_;
+  const std::shared_ptr<ShaderCacheArchive> sksl_archive_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
 
@@ -163,6 +176,10 @@ class PersistentCache : public GrContextOptions::PersistentCache {
                             const std::string& file_name,
                             bool need_key);
 
+  // Moves the cache object files in the directory into the archive.
+  static void MigrateCacheFiles(const fml::UniqueFD& directory,
+                                ShaderCacheArchive& archive);
+
   bool IsValid() const;
 
   explicit PersistentCache(bool read_only = false);
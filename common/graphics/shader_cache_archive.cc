@@ -0,0 +1,551 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/shader_cache_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// "FSCA" and "FSCR" in little endian.
+constexpr uint32_t kArchiveMagic = 0x41435346;
+constexpr uint32_t kRecordMagic = 0x52435346;
+constexpr uint32_t kArchiveVersion = 1u;
+
+struct ArchiveHeader {
+  uint32_t magic = kArchiveMagic;
+  uint32_t version = kArchiveVersion;
+};
+
+// Each record is this header followed by the key and the value.
+struct RecordHeader {
+  uint32_t magic = kRecordMagic;
+  uint32_t key_size = 0u;
+  uint32_t value_size = 0u;
+  uint32_t checksum = 0u;
+};
+
+// Archives smaller than this are not compacted just because most of their
+// records were superseded, as rewriting them would save little.
+constexpr size_t kMinSizeToCompactSupersededRecords = 256u * 1024u;
+
+// FNV-1a, which is plenty to detect torn and corrupted records.
+uint32_t Checksum(const uint8_t* key,
+                  size_t key_size,
+                  const uint8_t* value,
+                  size_t value_size) {
+  uint32_t hash = 2166136261u;
+  auto add = [&hash](const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      hash ^= data[i];
+      hash *= 16777619u;
+    }
+  };
+  add(key, key_size);
+  add(value, value_size);
+  return hash;
+}
+
+void AppendRecord(std::vector<uint8_t>& buffer,
+                  const uint8_t* key,
+                  size_t key_size,
+                  const uint8_t* value,
+                  size_t value_size) {
+  RecordHeader header;
+  header.key_size = key_size;
+  header.value_size = value_size;
+  header.checksum = Checksum(key, key_size, value, value_size);
+  const auto* header_bytes = reinterpret_cast<const uint8_t*>(&header);
+  buffer.insert(buffer.end(), header_bytes, header_bytes + sizeof(header));
+  buffer.insert(buffer.end(), key, key + key_size);
+  buffer.insert(buffer.end(), value, value + value_size);
+}
+
+std::string MakeIndexKey(const void* data, size_t size) {
+  return std::string(static_cast<const char*>(data), size);
+}
+
+// Holds the lock on the lock file of an archive while it is alive.
+class ScopedFileLock {
+ public:
+  explicit ScopedFileLock(const fml::UniqueFD& file)
+      : file_(file), locked_(fml::LockFile(file)) {}
+
+  ~ScopedFileLock() {
+    if (locked_) {
+      fml::UnlockFile(file_);
+    }
+  }
+
+  bool locked() const { return locked_; }
+
+ private:
+  const fml::UniqueFD& file_;
+  const bool locked_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ScopedFileLock);
+};
+
+}  // namespace
+
+size_t ShaderCacheArchive::IndexEntry::GetRecordSize() const {
+  return sizeof(RecordHeader) + key_size + value_size;
+}
+
+const uint8_t* ShaderCacheArchive::Snapshot::GetKey(
+    const IndexEntry& entry) const {
+  return mapping->GetMapping() + entry.offset + sizeof(RecordHeader);
+}
+
+const uint8_t* ShaderCacheArchive::Snapshot::GetValue(
+    const IndexEntry& entry) const {
+  return GetKey(entry) + entry.key_size;
+}
+
+bool ShaderCacheArchive::Snapshot::Verify(const IndexEntry& entry) const {
+  // The index is built from this mapping, but never read past its end.
+  if (!mapping || entry.offset > mapping->GetSize() ||
+      entry.GetRecordSize() > mapping->GetSize() - entry.offset) {
+    return false;
+  }
+  return Checksum(GetKey(entry), entry.key_size, GetValue(entry),
+                  entry.value_size) == entry.checksum;
+}
+
+ShaderCacheArchive::ShaderCacheArchive(const fml::UniqueFD& directory,
+                                       bool read_only,
+                                       size_t max_size)
+    : directory_(directory.is_valid() ? fml::Duplicate(directory.get())
+                                      : fml::UniqueFD{}),
+      read_only_(read_only),
+      max_size_(max_size) {
+  if (!directory_.is_valid()) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "ShaderCacheArchive::Open");
+  std::shared_ptr<const Snapshot> snapshot;
+  if (read_only_) {
+    std::shared_ptr<Snapshot> read = ReadSnapshot(fml::OpenFile(
+        directory_, kFileName, false, fml::FilePermission::kRead));
+    if (read && read->has_valid_header) {
+      snapshot = std::move(read);
+    }
+  } else {
+    lock_file_ = fml::OpenFile(directory_, kLockFileName, true,
+                               fml::FilePermission::kReadWrite);
+    std::scoped_lock write_lock(write_mutex_);
+    ScopedFileLock file_lock(lock_file_);
+    if (file_lock.locked()) {
+      fml::UniqueFD file;
+      snapshot = ReadFileLocked(&file);
+    }
+  }
+  if (!snapshot) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  snapshot_ = std::move(snapshot);
+  is_valid_ = true;
+}
+
+ShaderCacheArchive::~ShaderCacheArchive() = default;
+
+bool ShaderCacheArchive::IsValid() const {
+  std::scoped_lock lock(mutex_);
+  return is_valid_;
+}
+
+std::shared_ptr<ShaderCacheArchive::Snapshot> ShaderCacheArchive::ReadSnapshot(
+    const fml::UniqueFD& file) {
+  if (!file.is_valid()) {
+    return nullptr;
+  }
+  auto mapping = std::make_shared<fml::FileMapping>(file);
+  if (!mapping->IsValid()) {
+    return nullptr;
+  }
+
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->file_size = mapping->GetSize();
+  const uint8_t* data = mapping->GetMapping();
+  snapshot->mapping = std::move(mapping);
+
+  ArchiveHeader header;
+  if (snapshot->file_size < sizeof(header)) {
+    return snapshot;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kArchiveMagic || header.version != kArchiveVersion) {
+    return snapshot;
+  }
+  snapshot->has_valid_header = true;
+
+  size_t offset = sizeof(ArchiveHeader);
+  while (offset + sizeof(RecordHeader) <= snapshot->file_size) {
+    RecordHeader record;
+    std::memcpy(&record, data + offset, sizeof(record));
+    size_t remaining = snapshot->file_size - offset - sizeof(record);
+    if (record.magic != kRecordMagic || record.key_size == 0u ||
+        record.key_size > remaining ||
+        record.value_size > remaining - record.key_size) {
+      break;
+    }
+    IndexEntry entry{
+        .offset = offset,
+        .key_size = record.key_size,
+        .value_size = record.value_size,
+        .checksum = record.checksum,
+    };
+    auto key = MakeIndexKey(data + offset + sizeof(record), record.key_size);
+    auto [found, inserted] = snapshot->index.try_emplace(std::move(key), entry);
+    if (!inserted) {
+      snapshot->live_size -= found->second.GetRecordSize();
+      found->second = entry;
+    }
+    snapshot->live_size += entry.GetRecordSize();
+    offset += entry.GetRecordSize();
+  }
+  snapshot->records_end = offset;
+  return snapshot;
+}
+
+std::shared_ptr<const ShaderCacheArchive::Snapshot>
+ShaderCacheArchive::GetSnapshot() const {
+  std::scoped_lock lock(mutex_);
+  return snapshot_;
+}
+
+void ShaderCacheArchive::Publish(std::shared_ptr<const Snapshot> snapshot,
+                                 const std::vector<std::string>& used_keys) {
+  std::scoped_lock lock(mutex_);
+  snapshot_ = std::move(snapshot);
+  for (const auto& key : used_keys) {
+    last_uses_[key] = ++use_count_;
+  }
+  // Forget the entries that are gone from the file.
+  for (auto it = last_uses_.begin(); it != last_uses_.end();) {
+    if (snapshot_->index.count(it->first) == 0u) {
+      it = last_uses_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::shared_ptr<ShaderCacheArchive::Snapshot>
+ShaderCacheArchive::ReadFileLocked(fml::UniqueFD* file) {
+  // Other processes may have written to the file, or replaced it, since the
+  // last snapshot was taken.
+  *file = fml::OpenFile(directory_, kFileName, true,
+                        fml::FilePermission::kReadWrite);
+  std::shared_ptr<Snapshot> snapshot = ReadSnapshot(*file);
+  if (!snapshot) {
+    return nullptr;
+  }
+  if (!snapshot->has_valid_header) {
+    // A new archive, or one written in a format this engine doesn't know.
+    snapshot = RewriteLocked(*snapshot, {});
+    *file = fml::OpenFile(directory_, kFileName, false,
+                          fml::FilePermission::kReadWrite);
+    return snapshot;
+  }
+
+  // Drop the partial record left by an append that was interrupted. Appends
+  // start at the end of the last complete record even if this fails, and no
+  // process reads past that, so shrinking the file doesn't pull mapped
+  // records out from under anyone.
+  if (snapshot->records_end < snapshot->file_size) {
+    FML_LOG(INFO) << "Discarding "
+                  << snapshot->file_size - snapshot->records_end
+                  << " bytes of incomplete shader cache records.";
+    if (fml::TruncateFile(*file, snapshot->records_end)) {
+      snapshot->file_size = snapshot->records_end;
+    }
+  }
+  return snapshot;
+}
+
+sk_sp<SkData> ShaderCacheArchive::Load(const SkData& key) {
+  std::string index_key = MakeIndexKey(key.data(), key.size());
+  std::shared_ptr<const Snapshot> snapshot;
+  const IndexEntry* entry = nullptr;
+  {
+    std::scoped_lock lock(mutex_);
+    if (!is_valid_) {
+      return nullptr;
+    }
+    auto found = snapshot_->index.find(index_key);
+    if (found == snapshot_->index.end()) {
+      return nullptr;
+    }
+    snapshot = snapshot_;
+    entry = &found->second;
+    last_uses_[std::move(index_key)] = ++use_count_;
+  }
+  // The snapshot keeps the mapping alive while the value is copied.
+  if (!snapshot->Verify(*entry)) {
+    FML_LOG(INFO) << "Ignoring a corrupt shader cache record.";
+    return nullptr;
+  }
+  return SkData::MakeWithCopy(snapshot->GetValue(*entry), entry->value_size);
+}
+
+std::vector<std::pair<const std::string*,
+                      const ShaderCacheArchive::IndexEntry*>>
+ShaderCacheArchive::GetEntriesByLastUse(const Snapshot& snapshot) const {
+  struct OrderedEntry {
+    uint64_t last_use;
+    const std::string* key;
+    const IndexEntry* entry;
+  };
+  std::vector<OrderedEntry> order;
+  order.reserve(snapshot.index.size());
+  {
+    std::scoped_lock lock(mutex_);
+    for (const auto& [key, entry] : snapshot.index) {
+      auto found = last_uses_.find(key);
+      order.push_back(OrderedEntry{
+          .last_use = found == last_uses_.end() ? 0u : found->second,
+          .key = &key,
+          .entry = &entry,
+      });
+    }
+  }
+  // Records are in the file in the order they were last used.
+  std::sort(order.begin(), order.end(),
+            [](const OrderedEntry& a, const OrderedEntry& b) {
+              if (a.last_use != b.last_use) {
+                return a.last_use < b.last_use;
+              }
+              return a.entry->offset < b.entry->offset;
+            });
+
+  std::vector<std::pair<const std::string*, const IndexEntry*>> result;
+  result.reserve(order.size());
+  for (const OrderedEntry& ordered : order) {
+    result.emplace_back(ordered.key, ordered.entry);
+  }
+  return result;
+}
+
+std::vector<ShaderCacheArchive::Entry> ShaderCacheArchive::LoadAll() {
+  std::vector<Entry> result;
+  std::shared_ptr<const Snapshot> snapshot = GetSnapshot();
+  if (!snapshot) {
+    return result;
+  }
+
+  auto entries = GetEntriesByLastUse(*snapshot);
+  result.reserve(entries.size());
+  for (const auto& [key, entry] : entries) {
+    if (!snapshot->Verify(*entry)) {
+      continue;
+    }
+    result.push_back(Entry{
+        .key = SkData::MakeWithCopy(key->data(), key->size()),
+        .value = SkData::MakeWithCopy(snapshot->GetValue(*entry),
+                                      entry->value_size),
+    });
+  }
+  return result;
+}
+
+bool ShaderCacheArchive::Store(const SkData& key, const SkData& value) {
+  return Store({Entry{
+      .key = SkData::MakeWithoutCopy(key.data(), key.size()),
+      .value = SkData::MakeWithoutCopy(value.data(), value.size()),
+  }});
+}
+
+bool ShaderCacheArchive::Store(const std::vector<Entry>& entries) {
+  if (read_only_ || !IsValid()) {
+    return false;
+  }
+  TRACE_EVENT0("flutter", "ShaderCacheArchive::Store");
+
+  std::vector<uint8_t> records;
+  std::vector<std::string> keys;
+  for (const auto& entry : entries) {
+    if (!entry.key || entry.key->size() == 0u || !entry.value ||
+        entry.key->size() > std::numeric_limits<uint32_t>::max() ||
+        entry.value->size() > std::numeric_limits<uint32_t>::max()) {
+      continue;
+    }
+    AppendRecord(records, entry.key->bytes(), entry.key->size(),
+                 entry.value->bytes(), entry.value->size());
+    keys.push_back(MakeIndexKey(entry.key->data(), entry.key->size()));
+  }
+  if (records.empty()) {
+    return false;
+  }
+
+  std::scoped_lock write_lock(write_mutex_);
+  ScopedFileLock file_lock(lock_file_);
+  if (!file_lock.locked()) {
+    return false;
+  }
+  fml::UniqueFD file;
+  std::shared_ptr<Snapshot> current = ReadFileLocked(&file);
+  if (!current) {
+    return false;
+  }
+
+  // The file is only ever extended, as snapshots of it may be mapped by this
+  // and other processes. An interrupted write leaves a partial record, which
+  // the next write overwrites.
+  if (!fml::WriteFileAt(file, current->records_end,
+                        fml::DataMapping(std::move(records)))) {
+    return false;
+  }
+  std::shared_ptr<Snapshot> snapshot = ReadSnapshot(file);
+  file.reset();
+  if (!snapshot || !snapshot->has_valid_header) {
+    return false;
+  }
+  Publish(snapshot, keys);
+
+  if (ShouldCompact(*snapshot)) {
+    CompactLocked(*snapshot);
+  }
+  return true;
+}
+
+bool ShaderCacheArchive::ShouldCompact(const Snapshot& snapshot) const {
+  if (snapshot.records_end > max_size_) {
+    return true;
+  }
+  size_t superseded_size =
+      snapshot.records_end - sizeof(ArchiveHeader) - snapshot.live_size;
+  return snapshot.records_end >= kMinSizeToCompactSupersededRecords &&
+         superseded_size > snapshot.live_size;
+}
+
+bool ShaderCacheArchive::Compact() {
+  if (read_only_ || !IsValid()) {
+    return false;
+  }
+  std::scoped_lock write_lock(write_mutex_);
+  ScopedFileLock file_lock(lock_file_);
+  if (!file_lock.locked()) {
+    return false;
+  }
+  fml::UniqueFD file;
+  std::shared_ptr<Snapshot> current = ReadFileLocked(&file);
+  if (!current) {
+    return false;
+  }
+  return CompactLocked(*current);
+}
+
+bool ShaderCacheArchive::CompactLocked(const Snapshot& snapshot) {
+  TRACE_EVENT0("flutter", "ShaderCacheArchive::Compact");
+  auto entries = GetEntriesByLastUse(snapshot);
+
+  // When trimming, leave some room so that the next few stores don't need to
+  // compact the archive again.
+  size_t budget = max_size_ > sizeof(ArchiveHeader)
+                      ? max_size_ - sizeof(ArchiveHeader)
+                      : 0u;
+  if (snapshot.live_size > budget) {
+    budget -= budget / 4;
+  }
+
+  // Keep the most recently used entries that fit.
+  std::vector<std::pair<const std::string*, const IndexEntry*>> kept;
+  size_t kept_size = 0u;
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    const IndexEntry* entry = it->second;
+    if (kept_size + entry->GetRecordSize() > budget) {
+      continue;
+    }
+    if (!snapshot.Verify(*entry)) {
+      continue;
+    }
+    kept.push_back(*it);
+    kept_size += entry->GetRecordSize();
+  }
+  std::reverse(kept.begin(), kept.end());
+
+  std::shared_ptr<Snapshot> compacted = RewriteLocked(snapshot, kept);
+  if (!compacted) {
+    return false;
+  }
+  Publish(std::move(compacted), {});
+  return true;
+}
+
+bool ShaderCacheArchive::Clear() {
+  if (read_only_ || !IsValid()) {
+    return false;
+  }
+  std::scoped_lock write_lock(write_mutex_);
+  ScopedFileLock file_lock(lock_file_);
+  if (!file_lock.locked()) {
+    return false;
+  }
+  std::shared_ptr<Snapshot> cleared = RewriteLocked(Snapshot{}, {});
+  if (!cleared) {
+    return false;
+  }
+  Publish(std::move(cleared), {});
+  return true;
+}
+
+std::shared_ptr<ShaderCacheArchive::Snapshot> ShaderCacheArchive::RewriteLocked(
+    const Snapshot& snapshot,
+    const std::vector<std::pair<const std::string*, const IndexEntry*>>&
+        entries) {
+  std::vector<uint8_t> buffer;
+  ArchiveHeader header;
+  const auto* header_bytes = reinterpret_cast<const uint8_t*>(&header);
+  buffer.insert(buffer.end(), header_bytes, header_bytes + sizeof(header));
+  for (const auto& [key, entry] : entries) {
+    AppendRecord(buffer, snapshot.GetKey(*entry), entry->key_size,
+                 snapshot.GetValue(*entry), entry->value_size);
+  }
+
+  // The file is replaced rather than rewritten in place, so that an
+  // interrupted rewrite leaves the previous archive intact and the snapshots
+  // that map the previous file stay valid.
+  if (!fml::WriteAtomically(directory_, kFileName,
+                            fml::DataMapping(std::move(buffer)))) {
+    FML_LOG(WARNING) << "Could not write the shader cache archive.";
+    return nullptr;
+  }
+  std::shared_ptr<Snapshot> rewritten = ReadSnapshot(
+      fml::OpenFile(directory_, kFileName, false, fml::FilePermission::kRead));
+  if (!rewritten || !rewritten->has_valid_header) {
+    return nullptr;
+  }
+  return rewritten;
+}
+
+size_t ShaderCacheArchive::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  return snapshot_ ? snapshot_->index.size() : 0u;
+}
+
+size_t ShaderCacheArchive::GetFileSize() const {
+  std::scoped_lock lock(mutex_);
+  return snapshot_ ? snapshot_->file_size : 0u;
+}
+
+size_t ShaderCacheArchive::GetLiveSize() const {
+  std::scoped_lock lock(mutex_);
+  return snapshot_ ? snapshot_->live_size : 0u;
+}
+
+size_t ShaderCacheArchive::GetMaxSize() const {
+  return max_size_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,204 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_ARCHIVE_H_
+#define FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_ARCHIVE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+/// A key-value store of shader cache entries kept in a single file.
+///
+/// The archive file is memory mapped when the archive is opened and an index
+/// of its entries is built from the record headers, so looking up entries
+/// needs no further file system calls. New entries are appended to the end of
+/// the file. Storing an entry again supersedes the earlier record, which
+/// remains in the file until the archive is compacted.
+///
+/// The archive never grows much past its maximum size. When it does, or when
+/// most of the file is superseded records, it is compacted by rewriting the
+/// live entries, dropping the least recently used ones. The records are
+/// written from least to most recently used, which preserves the usage order
+/// across launches.
+///
+/// Values are checksummed and verified when they are loaded, so a record torn
+/// by a crash during an append is dropped rather than returned.
+///
+/// All methods are thread-safe. Lookups work on an immutable snapshot of the
+/// mapping and the index, which writers replace once they are done with the
+/// file, so lookups never wait for file system calls. Writers hold a lock on
+/// a lock file next to the archive, so that engines in other processes can
+/// share the cache directory. The file is never shrunk in place below a
+/// record another process may have mapped; compaction replaces the file.
+class ShaderCacheArchive {
+ public:
+  struct Entry {
+    sk_sp<SkData> key;
+    sk_sp<SkData> value;
+  };
+
+  static constexpr char kFileName[] = "io.flutter.shader_archive";
+
+  static constexpr char kLockFileName[] = "io.flutter.shader_archive.lock";
+
+  static constexpr size_t kDefaultMaxSize = 16u * 1024u * 1024u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Opens the archive in the given directory, creating it unless
+  ///             the archive is read-only.
+  ///
+  /// @param[in]  directory  The directory of the archive file.
+  /// @param[in]  read_only  Whether to never write to the archive. Stores and
+  ///                        compactions fail for read-only archives.
+  /// @param[in]  max_size   The size in bytes that compaction trims the
+  ///                        archive file to.
+  ///
+  ShaderCacheArchive(const fml::UniqueFD& directory,
+                     bool read_only,
+                     size_t max_size = kDefaultMaxSize);
+
+  ~ShaderCacheArchive();
+
+  bool IsValid() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Finds the value stored for a key, and marks the entry as the
+  ///             most recently used.
+  ///
+  /// @return     A copy of the value, or nullptr if there is no valid value
+  ///             for the key.
+  ///
+  sk_sp<SkData> Load(const SkData& key);
+
+  //----------------------------------------------------------------------------
+  /// @return     Copies of all entries with valid values, from least to most
+  ///             recently used.
+  ///
+  std::vector<Entry> LoadAll();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Appends entries to the archive with a single write, and
+  ///             compacts the archive if needed.
+  ///
+  /// @return     Whether the entries were written.
+  ///
+  bool Store(const std::vector<Entry>& entries);
+
+  bool Store(const SkData& key, const SkData& value);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Rewrites the archive with only its live entries, dropping the
+  ///             least recently used entries until it fits its maximum size.
+  ///
+  /// @return     Whether the archive was rewritten.
+  ///
+  bool Compact();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Removes all entries from the archive.
+  ///
+  bool Clear();
+
+  size_t GetEntryCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The size of the archive file in bytes, including superseded
+  ///             records.
+  ///
+  size_t GetFileSize() const;
+
+  //----------------------------------------------------------------------------
+  /// @return     The size in bytes of the records of the live entries.
+  ///
+  size_t GetLiveSize() const;
+
+  size_t GetMaxSize() const;
+
+ private:
+  struct IndexEntry {
+    size_t offset = 0u;
+    size_t key_size = 0u;
+    size_t value_size = 0u;
+    uint32_t checksum = 0u;
+
+    size_t GetRecordSize() const;
+  };
+
+  // The archive file as it was when it was last read or written. Snapshots
+  // are never modified once they are published.
+  struct Snapshot {
+    std::shared_ptr<const fml::FileMapping> mapping;
+    std::unordered_map<std::string, IndexEntry> index;
+    // The size of the file, and the end of its last complete record.
+    size_t file_size = 0u;
+    size_t records_end = 0u;
+    size_t live_size = 0u;
+    bool has_valid_header = false;
+
+    const uint8_t* GetKey(const IndexEntry& entry) const;
+
+    const uint8_t* GetValue(const IndexEntry& entry) const;
+
+    bool Verify(const IndexEntry& entry) const;
+  };
+
+  const fml::UniqueFD directory_;
+  const bool read_only_;
+  const size_t max_size_;
+  fml::UniqueFD lock_file_;
+
+  // Held by writers for as long as they access the file.
+  std::mutex write_mutex_;
+
+  // Guards the members below. Only held briefly.
+  mutable std::mutex mutex_;
+  std::shared_ptr<const Snapshot> snapshot_;
+  // When entries were last stored or loaded by this archive. Entries that
+  // weren't are older than all of these, and ordered by their position in the
+  // file.
+  std::unordered_map<std::string, uint64_t> last_uses_;
+  uint64_t use_count_ = 0u;
+  bool is_valid_ = false;
+
+  static std::shared_ptr<Snapshot> ReadSnapshot(const fml::UniqueFD& file);
+
+  std::shared_ptr<const Snapshot> GetSnapshot() const;
+
+  void Publish(std::shared_ptr<const Snapshot> snapshot,
+               const std::vector<std::string>& used_keys);
+
+  std::vector<std::pair<const std::string*, const IndexEntry*>>
+  GetEntriesByLastUse(const Snapshot& snapshot) const;
+
+  bool ShouldCompact(const Snapshot& snapshot) const;
+
+  // The methods below must only be called with |write_mutex_| and the lock
+  // on |lock_file_| held.
+
+  std::shared_ptr<Snapshot> ReadFileLocked(fml::UniqueFD* file);
+
+  bool CompactLocked(const Snapshot& snapshot);
+
+  std::shared_ptr<Snapshot> RewriteLocked(
+      const Snapshot& snapshot,
+      const std::vector<std::pair<const std::string*, const IndexEntry*>>&
+          entries);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShaderCacheArchive);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_SHADER_CACHE_ARCHIVE_H_
@@ -150,6 +150,9 @@ struct Settings {
   bool trace_startup = false;
   bool trace_systrace = false;
   std::string trace_to_file;
+  // If not empty, trace events are recorded in-process instead of being sent
+  // to the Dart timeline and are written to this path on VM shutdown.
+  std::string trace_to_recorder;
   bool enable_timeline_event_handler = true;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
@@ -228,6 +231,27 @@ struct Settings {
   // must be available to the application.
   bool enable_vulkan_validation = false;
 
+  // Record the layer trees of the views of a frame on the concurrent worker
+  // threads before drawing them. Only layer trees that are drawn without the
+  // raster cache and have no texture, platform view or performance overlay
+  // layers are recorded; the others are prerolled and painted on the raster
+  // thread as usual. The frames of all views are still acquired and submitted
+  // on the raster thread, in order. If the views share retained layers, their
+  // layer trees are recorded one after another on the raster thread instead.
+  bool enable_concurrent_view_rasterization = false;
+
+  // When the frame pipeline is full, let the UI thread keep producing frames
+  // and have each new frame replace the newest frame that the raster thread
+  // hasn't started on yet, instead of skipping the new frame. This trades
+  // throughput for lower input-to-photon latency when rasterization can't
+  // keep up.
+  bool enable_frame_pipeline_latest_wins = false;
+
+  // Rasterize frames of software surfaces in horizontal bands on the
+  // concurrent worker threads instead of on the raster thread alone. Only
+  // the embedder API's software renderer supports this.
+  bool enable_tiled_software_rasterization = false;
+
   // Enable GPU tracing in GLES backends.
   // Some devices claim to support the required APIs but crash on their usage.
   bool enable_opengl_gpu_tracing = false;
@@ -3,8 +3,12 @@
 // found in the LICENSE file.
 
 #include "flutter/display_list/benchmarking/dl_benchmarks.h"
+
+#include <cstdlib>
+
 #include "flutter/display_list/dl_builder.h"
 #include "flutter/display_list/dl_op_flags.h"
+#include "flutter/display_list/dl_serialization.h"
 #include "flutter/display_list/skia/dl_sk_canvas.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
 
@@ -1339,6 +1343,80 @@ void BM_SaveLayer(benchmark::State& state,
   surface_provider->Snapshot(filename);
 }
 
+// A frame resembling a scrolling list: rows of cards, each with an image,
+// a line of text and a rounded border, inside a nested picture.
+static sk_sp<DisplayList> MakeSyntheticFrame(unsigned attributes) {
+  DlPaint paint = GetPaintForRun(attributes);
+  DlPaint image_paint;
+  DlPaint text_paint;
+  text_paint.setColor(DlColor::kBlack());
+  SkBitmap bitmap;
+  bitmap.allocPixels(SkImageInfo::MakeN32Premul(64, 64));
+  bitmap.eraseColor(SK_ColorBLUE);
+  sk_sp<DlImage> image = DlImage::Make(SkImages::RasterFromBitmap(bitmap));
+
+  DisplayListBuilder card_builder;
+  card_builder.DrawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(1000, 80), 8, 8),
+                         paint);
+  card_builder.DrawImage(image, SkPoint::Make(8, 8), DlImageSampling::kLinear,
+                         &image_paint);
+  card_builder.DrawTextBlob(
+      SkTextBlob::MakeFromString("List item", CreateTestFontOfSize(20)), 84,
+      48, text_paint);
+  sk_sp<DisplayList> card = card_builder.Build();
+
+  DisplayListBuilder builder;
+  builder.DrawColor(DlColor::kWhite(), DlBlendMode::kSrc);
+  for (int row = 0; row < 12; row++) {
+    builder.Save();
+    builder.Translate(12, 12 + row * 84);
+    builder.DrawDisplayList(card);
+    builder.Restore();
+  }
+  return builder.Build();
+}
+
+// Rasterizes a DisplayList recorded with DlSerialization, such as a
+// production frame captured on a device. The recording is read from the file
+// named by the FLUTTER_DISPLAY_LIST_RECORDING environment variable. Without
+// one, a synthetic frame is serialized and replayed instead.
+void BM_ReplayDisplayList(benchmark::State& state,
+                          BackendType backend_type,
+                          unsigned attributes) {
+  auto surface_provider = DlSurfaceProvider::Create(backend_type);
+
+  std::shared_ptr<const fml::Mapping> recording;
+  const char* recording_path = std::getenv("FLUTTER_DISPLAY_LIST_RECORDING");
+  if (recording_path) {
+    recording = fml::FileMapping::CreateReadOnly(recording_path);
+  } else {
+    recording = DlSerialization::Serialize(*MakeSyntheticFrame(attributes));
+  }
+  sk_sp<DisplayList> display_list =
+      recording ? DlSerialization::Deserialize(recording) : nullptr;
+  if (!display_list) {
+    state.SkipWithError("Unable to load the DisplayList recording");
+    return;
+  }
+
+  size_t length = kFixedCanvasSize;
+  surface_provider->InitializeSurface(length, length);
+  auto surface = surface_provider->GetPrimarySurface()->sk_surface();
+  auto canvas = DlSkCanvasAdapter(surface->getCanvas());
+
+  state.counters["DrawCallCount"] = display_list->op_count(true);
+  state.counters["RecordingBytes"] = recording->GetSize();
+
+  // We only want to time the actual rasterization.
+  for ([[maybe_unused]] auto _ : state) {
+    canvas.DrawDisplayList(display_list);
+    FlushSubmitCpuSync(surface);
+  }
+
+  auto filename = surface_provider->backend_name() + "-ReplayDisplayList.png";
+  surface_provider->Snapshot(filename);
+}
+
 #ifdef ENABLE_SOFTWARE_BENCHMARKS
 RUN_DISPLAYLIST_BENCHMARKS(Software)
 #endif
@@ -97,6 +97,9 @@ void BM_SaveLayer(benchmark::State& state,
                   BackendType backend_type,
                   unsigned attributes,
                   size_t save_depth);
+void BM_ReplayDisplayList(benchmark::State& state,
+                          BackendType backend_type,
+                          unsigned attributes);
 // clang-format off
 
 // DrawLine
@@ -534,6 +537,14 @@ void BM_SaveLayer(benchmark::State& state,
       ->UseRealTime()                                                   \
       ->Unit(benchmark::kMillisecond);
 
+// ReplayDisplayList
+#define REPLAY_DISPLAY_LIST_BENCHMARKS(BACKEND, ATTRIBUTES)              \
+  BENCHMARK_CAPTURE(BM_ReplayDisplayList, BACKEND,                      \
+                    BackendType::k##BACKEND##Backend,                  \
+                    ATTRIBUTES)                                         \
+      ->UseRealTime()                                                   \
+      ->Unit(benchmark::kMillisecond);
+
 // Applies stroke style and antialiasing
 #define STROKE_BENCHMARKS(BACKEND, ATTRIBUTES)                           \
   DRAW_LINE_BENCHMARKS(BACKEND, ATTRIBUTES)                              \
@@ -568,7 +579,8 @@ void BM_SaveLayer(benchmark::State& state,
   DRAW_IMAGE_NINE_BENCHMARKS(BACKEND, ATTRIBUTES)                        \
   DRAW_VERTICES_BENCHMARKS(BACKEND, ATTRIBUTES)                          \
   DRAW_SHADOW_BENCHMARKS(BACKEND, ATTRIBUTES)                            \
-  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)
+  SAVE_LAYER_BENCHMARKS(BACKEND, ATTRIBUTES)                             \
+  REPLAY_DISPLAY_LIST_BENCHMARKS(BACKEND, ATTRIBUTES)
 
 #define RUN_DISPLAYLIST_BENCHMARKS(BACKEND)                        \
   STROKE_BENCHMARKS(BACKEND, kStrokedStyle)                        \
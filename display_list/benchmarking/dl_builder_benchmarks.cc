@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/dl_serialization.h"
+#include "flutter/display_list/skia/dl_sk_tiled_rasterizer.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
 
 namespace flutter {
@@ -59,6 +61,34 @@ bool NeedPrepareRTree(DisplayListBuilderBenchmarkType type) {
 
 }  // namespace
 
+// Builds many small display lists per iteration, similar to an app that
+// rebuilds hundreds of pictures every frame, and reports how often the
+// system allocator was called for op storage.
+static void BM_DisplayListBuilderManyPictures(benchmark::State& state,
+                                              bool pooled) {
+  DisplayListStorage::TrimPool();
+  size_t picture_count = state.range(0);
+  std::vector<sk_sp<DisplayList>> display_lists;
+  display_lists.reserve(picture_count);
+  size_t start_allocations = DisplayListStorage::GetThreadAllocationCount();
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < picture_count; i++) {
+      DisplayListBuilder builder(DisplayListBuilder::kMaxCullRect,
+                                 /*prepare_rtree=*/false, pooled);
+      InvokeAllRenderingOps(builder);
+      display_lists.push_back(builder.Build());
+    }
+    // Previous frame's pictures are released before the next frame is built.
+    display_lists.clear();
+  }
+  size_t allocations =
+      DisplayListStorage::GetThreadAllocationCount() - start_allocations;
+  state.counters["AllocsPerPicture"] = benchmark::Counter(
+      static_cast<double>(allocations) / picture_count,
+      benchmark::Counter::kAvgIterations);
+  DisplayListStorage::TrimPool();
+}
+
 static void BM_DisplayListBuilderDefault(benchmark::State& state,
                                          DisplayListBuilderBenchmarkType type) {
   bool prepare_rtree = NeedPrepareRTree(type);
@@ -149,6 +179,67 @@ static void BM_DisplayListBuilderWithSaveLayerAndImageFilter(
   }
 }
 
+// Serializes a DisplayList holding every rendering op.
+static void BM_DisplayListSerialize(benchmark::State& state) {
+  DisplayListBuilder builder;
+  InvokeAllRenderingOps(builder);
+  sk_sp<DisplayList> display_list = builder.Build();
+  size_t bytes = 0;
+  while (state.KeepRunning()) {
+    std::unique_ptr<fml::Mapping> mapping =
+        DlSerialization::Serialize(*display_list);
+    bytes = mapping->GetSize();
+  }
+  state.counters["SerializedBytes"] = bytes;
+}
+
+// Reconstructs the DisplayList serialized by BM_DisplayListSerialize, for
+// comparison with building it from scratch in BM_DisplayListBuilderDefault.
+static void BM_DisplayListDeserialize(benchmark::State& state) {
+  DisplayListBuilder builder;
+  InvokeAllRenderingOps(builder);
+  std::shared_ptr<const fml::Mapping> mapping =
+      DlSerialization::Serialize(*builder.Build());
+  while (state.KeepRunning()) {
+    sk_sp<DisplayList> display_list = DlSerialization::Deserialize(mapping);
+    benchmark::DoNotOptimize(display_list);
+  }
+}
+
+// Rasterizes a full HD frame of antialiased shapes into a raster surface,
+// split into as many bands as the range argument, with one fewer worker
+// threads since the calling thread renders a band too.
+static void BM_DisplayListTiledSoftwareRasterization(benchmark::State& state) {
+  size_t bands = state.range(0);
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  if (bands > 1) {
+    loop = fml::ConcurrentMessageLoop::Create(bands - 1);
+  }
+  DlSkTiledRasterizer rasterizer(loop ? loop->GetTaskRunner() : nullptr,
+                                 bands);
+
+  constexpr int kWidth = 1920;
+  constexpr int kHeight = 1080;
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  builder.DrawColor(DlColor::kWhite(), DlBlendMode::kSrc);
+  DlPaint paint;
+  paint.setAntiAlias(true);
+  for (int y = 0; y < kHeight; y += 20) {
+    for (int x = 0; x < kWidth; x += 20) {
+      uint32_t rgb = (x * 7919 + y * 104729) & 0xFFFFFF;
+      paint.setColor(DlColor(0x80000000 | rgb));
+      builder.DrawCircle(SkPoint::Make(x + 10, y + 10), 14, paint);
+    }
+  }
+  sk_sp<DisplayList> display_list = builder.Build();
+  sk_sp<SkSurface> surface =
+      SkSurfaces::Raster(SkImageInfo::MakeN32Premul(kWidth, kHeight));
+
+  while (state.KeepRunning()) {
+    rasterizer.Rasterize(display_list, surface.get());
+  }
+}
+
 BENCHMARK_CAPTURE(BM_DisplayListBuilderDefault,
                   kDefault,
                   DisplayListBuilderBenchmarkType::kDefault)
@@ -251,4 +342,22 @@ BENCHMARK_CAPTURE(BM_DisplayListBuilderWithSaveLayerAndImageFilter,
                   DisplayListBuilderBenchmarkType::kBoundsAndRtree)
     ->Unit(benchmark::kMicrosecond);
 
+BENCHMARK(BM_DisplayListSerialize)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DisplayListDeserialize)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_DisplayListTiledSoftwareRasterization)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_DisplayListBuilderManyPictures, kMalloc, false)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_DisplayListBuilderManyPictures, kPooled, true)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
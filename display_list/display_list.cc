@@ -2,7 +2,12 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
 #include <type_traits>
+#include <vector>
 
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/dl_op_records.h"
@@ -14,6 +19,177 @@ const SaveLayerOptions SaveLayerOptions::kNoAttributes = SaveLayerOptions();
 const SaveLayerOptions SaveLayerOptions::kWithAttributes =
     kNoAttributes.with_renders_with_attributes();
 
+namespace {
+
+// A process-wide cache of malloc blocks used by pooled DisplayListStorage.
+// DisplayLists are usually built on the UI thread and released on the raster
+// thread, so blocks are returned to the same pool they are drawn from
+// regardless of the thread. Blocks are bucketed by power of two size so that
+// any block in a bucket can satisfy any request that rounds up to that
+// bucket.
+class StoragePool {
+ public:
+  static constexpr size_t kMinBlockShift = 12;  // 4KB
+  static constexpr size_t kMaxBlockShift = 20;  // 1MB
+  static constexpr size_t kMaxRetainedBytes = 4 * 1024 * 1024;
+
+  // Rounds count up to the capacity of the block that will be returned from
+  // Acquire, or returns 0 if blocks of that size are not pooled.
+  static size_t BlockCapacity(size_t count);
+
+  // Returns nullptr if no block of that capacity is pooled.
+  uint8_t* Acquire(size_t capacity);
+  void Release(uint8_t* ptr, size_t capacity);
+  void Trim();
+
+ private:
+  static size_t BucketIndex(size_t capacity);
+
+  std::mutex mutex_;
+  std::array<std::vector<uint8_t*>, kMaxBlockShift - kMinBlockShift + 1>
+      free_blocks_;
+  size_t retained_bytes_ = 0;
+};
+
+// Never destroyed, as storage may be released during static destruction.
+StoragePool& GetPool() {
+  static StoragePool* pool = new StoragePool();
+  return *pool;
+}
+
+thread_local size_t tls_allocation_count = 0;
+
+size_t StoragePool::BlockCapacity(size_t count) {
+  size_t capacity = size_t{1} << kMinBlockShift;
+  while (capacity < count) {
+    capacity <<= 1;
+  }
+  return capacity <= (size_t{1} << kMaxBlockShift) ? capacity : 0;
+}
+
+size_t StoragePool::BucketIndex(size_t capacity) {
+  size_t index = 0;
+  while ((size_t{1} << (kMinBlockShift + index)) < capacity) {
+    index++;
+  }
+  return index;
+}
+
+uint8_t* StoragePool::Acquire(size_t capacity) {
+  std::scoped_lock lock(mutex_);
+  auto& bucket = free_blocks_[BucketIndex(capacity)];
+  if (bucket.empty()) {
+    return nullptr;
+  }
+  uint8_t* ptr = bucket.back();
+  bucket.pop_back();
+  retained_bytes_ -= capacity;
+  return ptr;
+}
+
+void StoragePool::Release(uint8_t* ptr, size_t capacity) {
+  {
+    std::scoped_lock lock(mutex_);
+    if (retained_bytes_ + capacity <= kMaxRetainedBytes) {
+      free_blocks_[BucketIndex(capacity)].push_back(ptr);
+      retained_bytes_ += capacity;
+      return;
+    }
+  }
+  std::free(ptr);
+}
+
+void StoragePool::Trim() {
+  std::array<std::vector<uint8_t*>, kMaxBlockShift - kMinBlockShift + 1>
+      blocks;
+  {
+    std::scoped_lock lock(mutex_);
+    blocks.swap(free_blocks_);
+    retained_bytes_ = 0;
+  }
+  for (auto& bucket : blocks) {
+    for (uint8_t* ptr : bucket) {
+      std::free(ptr);
+    }
+  }
+}
+
+}  // namespace
+
+DisplayListStorage::DisplayListStorage(DisplayListStorage&& other)
+    : ptr_(other.ptr_), capacity_(other.capacity_), pooled_(other.pooled_) {
+  other.ptr_ = nullptr;
+  other.capacity_ = 0;
+}
+
+DisplayListStorage& DisplayListStorage::operator=(DisplayListStorage&& other) {
+  if (this != &other) {
+    Release();
+    ptr_ = other.ptr_;
+    capacity_ = other.capacity_;
+    pooled_ = other.pooled_;
+    other.ptr_ = nullptr;
+    other.capacity_ = 0;
+  }
+  return *this;
+}
+
+DisplayListStorage::~DisplayListStorage() {
+  Release();
+}
+
+void DisplayListStorage::Release() {
+  if (!ptr_) {
+    return;
+  }
+  if (pooled_ && StoragePool::BlockCapacity(capacity_) == capacity_) {
+    GetPool().Release(ptr_, capacity_);
+  } else {
+    std::free(ptr_);
+  }
+  ptr_ = nullptr;
+  capacity_ = 0;
+}
+
+void DisplayListStorage::realloc(size_t count) {
+  if (pooled_) {
+    if (count <= capacity_) {
+      // Pooled blocks are never shrunk so that they can be recycled.
+      return;
+    }
+    size_t capacity = StoragePool::BlockCapacity(count);
+    if (capacity > 0) {
+      uint8_t* ptr = GetPool().Acquire(capacity);
+      if (!ptr) {
+        ptr = static_cast<uint8_t*>(std::malloc(capacity));
+        tls_allocation_count++;
+      }
+      FML_CHECK(ptr);
+      if (ptr_) {
+        memcpy(ptr, ptr_, capacity_);
+      }
+      Release();
+      ptr_ = ptr;
+      capacity_ = capacity;
+      return;
+    }
+    // Too large to be pooled, fall through to a regular allocation. The
+    // block will be freed rather than recycled.
+  }
+  ptr_ = static_cast<uint8_t*>(std::realloc(ptr_, count));
+  FML_CHECK(ptr_);
+  capacity_ = count;
+  tls_allocation_count++;
+}
+
+size_t DisplayListStorage::GetThreadAllocationCount() {
+  return tls_allocation_count;
+}
+
+void DisplayListStorage::TrimPool() {
+  GetPool().Trim();
+}
+
 DisplayList::DisplayList()
     : byte_count_(0),
       op_count_(0),
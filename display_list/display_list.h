@@ -11,6 +11,7 @@
 #include "flutter/display_list/dl_sampling_options.h"
 #include "flutter/display_list/geometry/dl_rtree.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
 
 // The Flutter DisplayList mechanism encapsulates a persistent sequence of
 // rendering operations.
@@ -204,23 +205,47 @@ class SaveLayerOptions {
 };
 
 // Manages a buffer allocated with malloc.
+//
+// The buffer is either a malloc block resized exactly with std::realloc, or
+// a pooled block drawn from a process-wide recycling pool. Pooled blocks
+// have power of two capacities, are never shrunk, and are returned to the
+// pool when the storage is destroyed, on whichever thread that happens, so
+// that subsequent DisplayListBuilders can reuse them without going back to
+// the system allocator.
 class DisplayListStorage {
  public:
   DisplayListStorage() = default;
-  DisplayListStorage(DisplayListStorage&&) = default;
+  explicit DisplayListStorage(bool pooled) : pooled_(pooled) {}
+  DisplayListStorage(DisplayListStorage&& other);
+  DisplayListStorage& operator=(DisplayListStorage&& other);
+  ~DisplayListStorage();
 
-  uint8_t* get() const { return ptr_.get(); }
+  uint8_t* get() const { return ptr_; }
 
-  void realloc(size_t count) {
-    ptr_.reset(static_cast<uint8_t*>(std::realloc(ptr_.release(), count)));
-    FML_CHECK(ptr_);
-  }
+  // The number of bytes that can be stored without reallocating.
+  size_t capacity() const { return capacity_; }
+
+  bool is_pooled() const { return pooled_; }
+
+  // Resizes the buffer to hold at least count bytes, preserving existing
+  // contents. Non-pooled storage is resized to exactly count bytes.
+  void realloc(size_t count);
+
+  // The number of calls into the system allocator made by storage on the
+  // calling thread. Intended for tests and benchmarks.
+  static size_t GetThreadAllocationCount();
+
+  // Releases all blocks retained by the pool.
+  static void TrimPool();
 
  private:
-  struct FreeDeleter {
-    void operator()(uint8_t* p) { std::free(p); }
-  };
-  std::unique_ptr<uint8_t, FreeDeleter> ptr_;
+  void Release();
+
+  uint8_t* ptr_ = nullptr;
+  size_t capacity_ = 0;
+  bool pooled_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListStorage);
 };
 
 class Culler;
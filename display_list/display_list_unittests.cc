@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -250,6 +251,74 @@ TEST_F(DisplayListTest, BuilderCanBeReused) {
   ASSERT_TRUE(dl->Equals(dl2));
 }
 
+TEST_F(DisplayListTest, PooledBuilderMatchesUnpooledBuilder) {
+  DisplayListBuilder builder(kTestBounds);
+  builder.DrawRect(kTestBounds, DlPaint());
+  auto dl = builder.Build();
+
+  DisplayListBuilder pooled_builder(kTestBounds, /*prepare_rtree=*/false,
+                                    /*pool_storage=*/true);
+  pooled_builder.DrawRect(kTestBounds, DlPaint());
+  auto pooled_dl = pooled_builder.Build();
+  ASSERT_TRUE(dl->Equals(pooled_dl));
+  EXPECT_EQ(dl->bytes(), pooled_dl->bytes());
+
+  // The builder keeps using pooled storage after Build.
+  pooled_builder.DrawRect(kTestBounds, DlPaint());
+  auto pooled_dl2 = pooled_builder.Build();
+  ASSERT_TRUE(dl->Equals(pooled_dl2));
+}
+
+TEST_F(DisplayListTest, PooledStorageIsRecycled) {
+  DisplayListStorage::TrimPool();
+  DisplayListBuilder builder(kTestBounds, /*prepare_rtree=*/false,
+                             /*pool_storage=*/true);
+
+  builder.DrawRect(kTestBounds, DlPaint());
+  auto dl = builder.Build();
+  size_t allocations = DisplayListStorage::GetThreadAllocationCount();
+  dl.reset();
+
+  for (int i = 0; i < 10; i++) {
+    builder.DrawRect(kTestBounds, DlPaint());
+    builder.Build();
+  }
+  EXPECT_EQ(DisplayListStorage::GetThreadAllocationCount(), allocations);
+  DisplayListStorage::TrimPool();
+}
+
+TEST_F(DisplayListTest, PooledStorageReleasedOnAnotherThreadIsRecycled) {
+  DisplayListStorage::TrimPool();
+  DisplayListBuilder builder(kTestBounds, /*prepare_rtree=*/false,
+                             /*pool_storage=*/true);
+  builder.DrawRect(kTestBounds, DlPaint());
+  auto dl = builder.Build();
+  size_t allocations = DisplayListStorage::GetThreadAllocationCount();
+
+  // Like a picture recorded on the UI thread and dropped by the raster
+  // thread.
+  std::thread([dl = std::move(dl)]() mutable { dl.reset(); }).join();
+
+  builder.DrawRect(kTestBounds, DlPaint());
+  builder.Build();
+  EXPECT_EQ(DisplayListStorage::GetThreadAllocationCount(), allocations);
+  DisplayListStorage::TrimPool();
+}
+
+TEST_F(DisplayListTest, PooledStorageIsNotShrunk) {
+  DisplayListStorage storage(true);
+  storage.realloc(100);
+  EXPECT_EQ(storage.capacity(), 4096u);
+  storage.realloc(16);
+  EXPECT_EQ(storage.capacity(), 4096u);
+  storage.realloc(5000);
+  EXPECT_EQ(storage.capacity(), 8192u);
+
+  DisplayListStorage unpooled;
+  unpooled.realloc(100);
+  EXPECT_EQ(unpooled.capacity(), 100u);
+}
+
 TEST_F(DisplayListTest, SaveRestoreRestoresTransform) {
   SkRect cull_rect = SkRect::MakeLTRB(-10.0f, -10.0f, 500.0f, 500.0f);
   DisplayListBuilder builder(cull_rect);
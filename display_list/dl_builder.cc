@@ -47,9 +47,10 @@ void* DisplayListBuilder::Push(size_t pod, int render_op_inc, Args&&... args) {
     static_assert(is_power_of_two(DL_BUILDER_PAGE),
                   "This math needs updating for non-pow2.");
     // Next greater multiple of DL_BUILDER_PAGE.
-    allocated_ = (used_ + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1);
-    storage_.realloc(allocated_);
+    storage_.realloc((used_ + size + DL_BUILDER_PAGE) & ~(DL_BUILDER_PAGE - 1));
     FML_DCHECK(storage_.get());
+    // Pooled storage may round the allocation up.
+    allocated_ = storage_.capacity();
     memset(storage_.get() + used_, 0, allocated_ - used_);
   }
   FML_DCHECK(used_ + size <= allocated_);
@@ -85,14 +86,19 @@ sk_sp<DisplayList> DisplayListBuilder::Build() {
   tracker_.reset();
   current_ = DlPaint();
 
-  return sk_sp<DisplayList>(new DisplayList(
+  bool pooled = storage_.is_pooled();
+  auto display_list = sk_sp<DisplayList>(new DisplayList(
       std::move(storage_), bytes, count, nested_bytes, nested_count, bounds(),
       compatible, is_safe, affects_transparency, rtree()));
+  storage_ = DisplayListStorage(pooled);
+  return display_list;
 }
 
 DisplayListBuilder::DisplayListBuilder(const SkRect& cull_rect,
-                                       bool prepare_rtree)
-    : tracker_(cull_rect, SkMatrix::I()) {
+                                       bool prepare_rtree,
+                                       bool pool_storage)
+    : storage_(pool_storage),
+      tracker_(cull_rect, SkMatrix::I()) {
   if (prepare_rtree) {
     accumulator_ = std::make_unique<RTreeBoundsAccumulator>();
   } else {
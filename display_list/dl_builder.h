@@ -35,8 +35,11 @@ class DisplayListBuilder final : public virtual DlCanvas,
   explicit DisplayListBuilder(bool prepare_rtree)
       : DisplayListBuilder(kMaxCullRect, prepare_rtree) {}
 
+  // With |pool_storage|, the op buffers of the built DisplayLists are drawn
+  // from and returned to a recycling pool, see |DisplayListStorage|.
   explicit DisplayListBuilder(const SkRect& cull_rect = kMaxCullRect,
-                              bool prepare_rtree = false);
+                              bool prepare_rtree = false,
+                              bool pool_storage = false);
 
   ~DisplayListBuilder();
 
@@ -250,11 +253,14 @@ class DisplayListBuilder final : public virtual DlCanvas,
   // This method exposes the internal stateful DlOpReceiver implementation
   // of the DisplayListBuilder, primarily for testing purposes. Its use
   // is obsolete and forbidden in every other case and is only shared to a
-  // pair of "friend" accessors in the benchmark/unittest files.
+  // pair of "friend" accessors in the benchmark/unittest files and to the
+  // DlSerialization reader, which must reproduce the recorded ops exactly.
   DlOpReceiver& asReceiver() { return *this; }
 
   friend DlOpReceiver& DisplayListBuilderBenchmarkAccessor(
       DisplayListBuilder& builder);
+  friend DlOpReceiver& DisplayListBuilderDeserializationAccessor(
+      DisplayListBuilder& builder);
   friend DlOpReceiver& DisplayListBuilderTestingAccessor(
       DisplayListBuilder& builder);
   friend DlPaint DisplayListBuilderTestingAttributes(
@@ -0,0 +1,2109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/dl_serialization.h"
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/dl_op_receiver.h"
+
+#include "third_party/skia/include/core/SkColorSpace.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+
+namespace flutter {
+
+DlOpReceiver& DisplayListBuilderDeserializationAccessor(
+    DisplayListBuilder& builder) {
+  return builder.asReceiver();
+}
+
+namespace {
+
+// "FDLS" when read as little endian bytes.
+constexpr uint32_t kMagic = 0x534C4446;
+// Written in the native byte order so that data from a machine with a
+// different byte order is rejected rather than misread.
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+constexpr size_t kRecordAlignment = 4;
+// Image pixels are aligned further so that they can be handed to Skia in
+// place.
+constexpr size_t kPixelAlignment = 16;
+
+// Stands in for the index of a null object.
+constexpr uint32_t kNoIndex = std::numeric_limits<uint32_t>::max();
+
+// Bounds the recursion when reading nested image filters so that malformed
+// data can't exhaust the stack.
+constexpr int kMaxEffectDepth = 64;
+
+// The largest element count that the int parameters of the DlOpReceiver
+// methods can hold.
+constexpr uint32_t kMaxCount = std::numeric_limits<int>::max();
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t reserved;
+};
+
+enum class RecordType : uint32_t {
+  // Definitions of objects that later records refer to by index. The ops
+  // between a kBeginDisplayList and its kEndDisplayList make up one
+  // DisplayList; the outermost one is the DisplayList that was serialized.
+  kBeginDisplayList,
+  kEndDisplayList,
+  kDefineImage,
+  kDefineImageFilter,
+  kDefineTypeface,
+  kDefineTextBlob,
+
+  kSetAntiAlias,
+  kSetInvertColors,
+  kSetStrokeCap,
+  kSetStrokeJoin,
+  kSetDrawStyle,
+  kSetStrokeWidth,
+  kSetStrokeMiter,
+  kSetColor,
+  kSetBlendMode,
+  kSetColorSource,
+  kSetColorFilter,
+  kSetImageFilter,
+  kSetMaskFilter,
+  kSetPathEffect,
+
+  kSave,
+  kSaveLayer,
+  kRestore,
+
+  kTranslate,
+  kScale,
+  kRotate,
+  kSkew,
+  kTransform2DAffine,
+  kTransformFullPerspective,
+  kTransformReset,
+
+  kClipRect,
+  kClipRRect,
+  kClipPath,
+
+  kDrawColor,
+  kDrawPaint,
+  kDrawLine,
+  kDrawRect,
+  kDrawOval,
+  kDrawCircle,
+  kDrawRRect,
+  kDrawDRRect,
+  kDrawPath,
+  kDrawArc,
+  kDrawPoints,
+  kDrawVertices,
+  kDrawImage,
+  kDrawImageRect,
+  kDrawImageNine,
+  kDrawAtlas,
+  kDrawDisplayList,
+  kDrawTextBlob,
+  kDrawShadow,
+};
+
+// Every record starts with this header. |size| includes the header and the
+// padding that aligns the following record.
+struct RecordHeader {
+  RecordType type;
+  uint32_t size;
+};
+
+// The flags of a SaveLayerOptions, which doesn't expose its bits.
+constexpr uint32_t kRendersWithAttributes = 1 << 0;
+constexpr uint32_t kCanDistributeOpacity = 1 << 1;
+
+// The optional arrays of a DlVertices.
+constexpr uint32_t kHasTextureCoordinates = 1 << 0;
+constexpr uint32_t kHasColors = 1 << 1;
+constexpr uint32_t kHasIndices = 1 << 2;
+
+constexpr size_t AlignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// Appends records to a growable buffer.
+class RecordWriter {
+ public:
+  RecordWriter() {
+    Write(FileHeader{
+        .magic = kMagic,
+        .version = DlSerialization::kVersion,
+        .byte_order = kByteOrderMark,
+        .reserved = 0,
+    });
+  }
+
+  std::vector<uint8_t> TakeBuffer() { return std::move(buffer_); }
+
+  void BeginRecord(RecordType type) {
+    FML_DCHECK(record_start_ == kNoRecord);
+    record_start_ = buffer_.size();
+    Write(RecordHeader{.type = type, .size = 0});
+  }
+
+  void EndRecord() {
+    FML_DCHECK(record_start_ != kNoRecord);
+    Align(kRecordAlignment);
+    uint32_t size = static_cast<uint32_t>(buffer_.size() - record_start_);
+    memcpy(buffer_.data() + record_start_ + offsetof(RecordHeader, size),
+           &size, sizeof(size));
+    record_start_ = kNoRecord;
+  }
+
+  template <typename T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    WriteBytes(&value, sizeof(T));
+  }
+
+  void WriteBool(bool value) { Write<uint32_t>(value ? 1 : 0); }
+
+  template <typename E>
+  void WriteEnum(E value) {
+    Write(static_cast<uint32_t>(value));
+  }
+
+  // Writes |count| elements, padded so that the next value stays aligned.
+  template <typename T>
+  void WriteArray(const T* values, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(alignof(T) <= kRecordAlignment);
+    WriteBytes(values, count * sizeof(T));
+    Align(kRecordAlignment);
+  }
+
+  void WriteBytes(const void* data, size_t size) {
+    if (size > 0) {
+      memcpy(Reserve(size), data, size);
+    }
+  }
+
+  // Grows the buffer by |size| bytes and returns them for the caller to
+  // fill in. The pointer is invalidated by any further write.
+  uint8_t* Reserve(size_t size) {
+    size_t offset = buffer_.size();
+    buffer_.resize(offset + size);
+    return buffer_.data() + offset;
+  }
+
+  // Pads with zeros up to a multiple of |alignment| from the start of the
+  // data.
+  void Align(size_t alignment) {
+    buffer_.resize(AlignUp(buffer_.size(), alignment), 0);
+  }
+
+ private:
+  static constexpr size_t kNoRecord = std::numeric_limits<size_t>::max();
+
+  std::vector<uint8_t> buffer_;
+  size_t record_start_ = kNoRecord;
+};
+
+// Reads values from the bytes of a single record, failing rather than
+// reading past its end.
+class RecordReader {
+ public:
+  RecordReader(const uint8_t* base, size_t offset, size_t end)
+      : base_(base), offset_(offset), end_(end) {}
+
+  size_t offset() const { return offset_; }
+  size_t remaining() const { return end_ - offset_; }
+
+  const uint8_t* ReadBytes(size_t size) {
+    if (size > remaining()) {
+      return nullptr;
+    }
+    const uint8_t* bytes = base_ + offset_;
+    offset_ += size;
+    return bytes;
+  }
+
+  template <typename T>
+  bool Read(T* value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const uint8_t* bytes = ReadBytes(sizeof(T));
+    if (!bytes) {
+      return false;
+    }
+    memcpy(value, bytes, sizeof(T));
+    return true;
+  }
+
+  bool ReadBool(bool* value) {
+    uint32_t raw;
+    if (!Read(&raw) || raw > 1) {
+      return false;
+    }
+    *value = raw != 0;
+    return true;
+  }
+
+  template <typename E>
+  bool ReadEnum(E* value, E last) {
+    uint32_t raw;
+    if (!Read(&raw) || raw > static_cast<uint32_t>(last)) {
+      return false;
+    }
+    *value = static_cast<E>(raw);
+    return true;
+  }
+
+  // Points |values| at |count| elements in place.
+  template <typename T>
+  bool ReadArray(const T** values, size_t count) {
+    static_assert(alignof(T) <= kRecordAlignment);
+    if (count > remaining() / sizeof(T)) {
+      return false;
+    }
+    const uint8_t* bytes = ReadBytes(count * sizeof(T));
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(T) != 0) {
+      return false;
+    }
+    *values = reinterpret_cast<const T*>(bytes);
+    return Align(kRecordAlignment);
+  }
+
+  bool Align(size_t alignment) {
+    size_t aligned = AlignUp(offset_, alignment);
+    if (aligned > end_) {
+      return false;
+    }
+    offset_ = aligned;
+    return true;
+  }
+
+ private:
+  const uint8_t* base_;
+  size_t offset_;
+  const size_t end_;
+};
+
+void WriteMatrix(RecordWriter& writer, const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  writer.WriteArray(values, 9);
+}
+
+bool ReadMatrix(RecordReader& reader, SkMatrix* matrix) {
+  const SkScalar* values;
+  if (!reader.ReadArray(&values, 9)) {
+    return false;
+  }
+  matrix->set9(values);
+  return true;
+}
+
+void WriteRRect(RecordWriter& writer, const SkRRect& rrect) {
+  rrect.writeToMemory(writer.Reserve(SkRRect::kSizeInMemory));
+}
+
+bool ReadRRect(RecordReader& reader, SkRRect* rrect) {
+  const uint8_t* bytes = reader.ReadBytes(SkRRect::kSizeInMemory);
+  return bytes && rrect->readFromMemory(bytes, SkRRect::kSizeInMemory) ==
+                      SkRRect::kSizeInMemory;
+}
+
+void WritePath(RecordWriter& writer, const SkPath& path) {
+  size_t size = path.writeToMemory(nullptr);
+  writer.Write<uint32_t>(size);
+  path.writeToMemory(writer.Reserve(size));
+  writer.Align(kRecordAlignment);
+}
+
+bool ReadPath(RecordReader& reader, SkPath* path) {
+  uint32_t size;
+  if (!reader.Read(&size)) {
+    return false;
+  }
+  const uint8_t* bytes = reader.ReadBytes(size);
+  return bytes && path->readFromMemory(bytes, size) == size &&
+         reader.Align(kRecordAlignment);
+}
+
+// Records the ops of a DisplayList, and of everything it references, as it
+// is dispatched.
+class DisplayListWriter final : public virtual DlOpReceiver {
+ public:
+  DisplayListWriter() = default;
+
+  std::unique_ptr<fml::Mapping> Write(const DisplayList& display_list) {
+    DefineDisplayList(display_list);
+    if (!valid_) {
+      return nullptr;
+    }
+    return std::make_unique<fml::DataMapping>(writer_.TakeBuffer());
+  }
+
+  void setAntiAlias(bool aa) override {
+    writer_.BeginRecord(RecordType::kSetAntiAlias);
+    writer_.WriteBool(aa);
+    writer_.EndRecord();
+  }
+  void setInvertColors(bool invert) override {
+    writer_.BeginRecord(RecordType::kSetInvertColors);
+    writer_.WriteBool(invert);
+    writer_.EndRecord();
+  }
+  void setStrokeCap(DlStrokeCap cap) override {
+    writer_.BeginRecord(RecordType::kSetStrokeCap);
+    writer_.WriteEnum(cap);
+    writer_.EndRecord();
+  }
+  void setStrokeJoin(DlStrokeJoin join) override {
+    writer_.BeginRecord(RecordType::kSetStrokeJoin);
+    writer_.WriteEnum(join);
+    writer_.EndRecord();
+  }
+  void setDrawStyle(DlDrawStyle style) override {
+    writer_.BeginRecord(RecordType::kSetDrawStyle);
+    writer_.WriteEnum(style);
+    writer_.EndRecord();
+  }
+  void setStrokeWidth(float width) override {
+    writer_.BeginRecord(RecordType::kSetStrokeWidth);
+    writer_.Write(width);
+    writer_.EndRecord();
+  }
+  void setStrokeMiter(float limit) override {
+    writer_.BeginRecord(RecordType::kSetStrokeMiter);
+    writer_.Write(limit);
+    writer_.EndRecord();
+  }
+  void setColor(DlColor color) override {
+    writer_.BeginRecord(RecordType::kSetColor);
+    writer_.Write(color.argb());
+    writer_.EndRecord();
+  }
+  void setBlendMode(DlBlendMode mode) override {
+    writer_.BeginRecord(RecordType::kSetBlendMode);
+    writer_.WriteEnum(mode);
+    writer_.EndRecord();
+  }
+  void setColorSource(const DlColorSource* source) override {
+    // The image of an image color source is defined up front because
+    // definitions can't be written in the middle of another record.
+    uint32_t image_index = kNoIndex;
+    if (source && source->asImage()) {
+      image_index = DefineImage(source->asImage()->image().get());
+    }
+    writer_.BeginRecord(RecordType::kSetColorSource);
+    WriteColorSource(source, image_index);
+    writer_.EndRecord();
+  }
+  void setColorFilter(const DlColorFilter* filter) override {
+    writer_.BeginRecord(RecordType::kSetColorFilter);
+    WriteColorFilter(filter);
+    writer_.EndRecord();
+  }
+  void setImageFilter(const DlImageFilter* filter) override {
+    uint32_t filter_index = DefineImageFilter(filter);
+    writer_.BeginRecord(RecordType::kSetImageFilter);
+    writer_.Write(filter_index);
+    writer_.EndRecord();
+  }
+  void setMaskFilter(const DlMaskFilter* filter) override {
+    writer_.BeginRecord(RecordType::kSetMaskFilter);
+    if (!filter) {
+      writer_.Write(kNoIndex);
+    } else {
+      writer_.WriteEnum(filter->type());
+      switch (filter->type()) {
+        case DlMaskFilterType::kBlur: {
+          const DlBlurMaskFilter* blur = filter->asBlur();
+          writer_.WriteEnum(blur->style());
+          writer_.Write(blur->sigma());
+          writer_.WriteBool(blur->respectCTM());
+          break;
+        }
+      }
+    }
+    writer_.EndRecord();
+  }
+  void setPathEffect(const DlPathEffect* effect) override {
+    writer_.BeginRecord(RecordType::kSetPathEffect);
+    if (!effect) {
+      writer_.Write(kNoIndex);
+    } else {
+      writer_.WriteEnum(effect->type());
+      switch (effect->type()) {
+        case DlPathEffectType::kDash: {
+          const DlDashPathEffect* dash = effect->asDash();
+          writer_.Write(dash->phase());
+          writer_.Write<uint32_t>(dash->count());
+          writer_.WriteArray(dash->intervals(), dash->count());
+          break;
+        }
+      }
+    }
+    writer_.EndRecord();
+  }
+
+  void save() override {
+    writer_.BeginRecord(RecordType::kSave);
+    writer_.EndRecord();
+  }
+  void saveLayer(const SkRect* bounds,
+                 const SaveLayerOptions options,
+                 const DlImageFilter* backdrop) override {
+    uint32_t backdrop_index = DefineImageFilter(backdrop);
+    uint32_t flags = 0;
+    if (options.renders_with_attributes()) {
+      flags |= kRendersWithAttributes;
+    }
+    if (options.can_distribute_opacity()) {
+      flags |= kCanDistributeOpacity;
+    }
+    writer_.BeginRecord(RecordType::kSaveLayer);
+    writer_.Write(flags);
+    writer_.WriteBool(bounds != nullptr);
+    writer_.Write(bounds ? *bounds : SkRect::MakeEmpty());
+    writer_.Write(backdrop_index);
+    writer_.EndRecord();
+  }
+  void restore() override {
+    writer_.BeginRecord(RecordType::kRestore);
+    writer_.EndRecord();
+  }
+
+  void translate(SkScalar tx, SkScalar ty) override {
+    writer_.BeginRecord(RecordType::kTranslate);
+    writer_.Write(tx);
+    writer_.Write(ty);
+    writer_.EndRecord();
+  }
+  void scale(SkScalar sx, SkScalar sy) override {
+    writer_.BeginRecord(RecordType::kScale);
+    writer_.Write(sx);
+    writer_.Write(sy);
+    writer_.EndRecord();
+  }
+  void rotate(SkScalar degrees) override {
+    writer_.BeginRecord(RecordType::kRotate);
+    writer_.Write(degrees);
+    writer_.EndRecord();
+  }
+  void skew(SkScalar sx, SkScalar sy) override {
+    writer_.BeginRecord(RecordType::kSkew);
+    writer_.Write(sx);
+    writer_.Write(sy);
+    writer_.EndRecord();
+  }
+  // clang-format off
+  void transform2DAffine(SkScalar mxx, SkScalar mxy, SkScalar mxt,
+                         SkScalar myx, SkScalar myy, SkScalar myt) override {
+    const SkScalar values[] = {mxx, mxy, mxt,
+                               myx, myy, myt};
+    writer_.BeginRecord(RecordType::kTransform2DAffine);
+    writer_.WriteArray(values, 6);
+    writer_.EndRecord();
+  }
+  void transformFullPerspective(
+      SkScalar mxx, SkScalar mxy, SkScalar mxz, SkScalar mxt,
+      SkScalar myx, SkScalar myy, SkScalar myz, SkScalar myt,
+      SkScalar mzx, SkScalar mzy, SkScalar mzz, SkScalar mzt,
+      SkScalar mwx, SkScalar mwy, SkScalar mwz, SkScalar mwt) override {
+    const SkScalar values[] = {mxx, mxy, mxz, mxt,
+                               myx, myy, myz, myt,
+                               mzx, mzy, mzz, mzt,
+                               mwx, mwy, mwz, mwt};
+    writer_.BeginRecord(RecordType::kTransformFullPerspective);
+    writer_.WriteArray(values, 16);
+    writer_.EndRecord();
+  }
+  // clang-format on
+  void transformReset() override {
+    writer_.BeginRecord(RecordType::kTransformReset);
+    writer_.EndRecord();
+  }
+
+  void clipRect(const SkRect& rect, ClipOp clip_op, bool is_aa) override {
+    writer_.BeginRecord(RecordType::kClipRect);
+    writer_.Write(rect);
+    writer_.WriteEnum(clip_op);
+    writer_.WriteBool(is_aa);
+    writer_.EndRecord();
+  }
+  void clipRRect(const SkRRect& rrect, ClipOp clip_op, bool is_aa) override {
+    writer_.BeginRecord(RecordType::kClipRRect);
+    WriteRRect(writer_, rrect);
+    writer_.WriteEnum(clip_op);
+    writer_.WriteBool(is_aa);
+    writer_.EndRecord();
+  }
+  void clipPath(const SkPath& path, ClipOp clip_op, bool is_aa) override {
+    writer_.BeginRecord(RecordType::kClipPath);
+    WritePath(writer_, path);
+    writer_.WriteEnum(clip_op);
+    writer_.WriteBool(is_aa);
+    writer_.EndRecord();
+  }
+
+  void drawColor(DlColor color, DlBlendMode mode) override {
+    writer_.BeginRecord(RecordType::kDrawColor);
+    writer_.Write(color.argb());
+    writer_.WriteEnum(mode);
+    writer_.EndRecord();
+  }
+  void drawPaint() override {
+    writer_.BeginRecord(RecordType::kDrawPaint);
+    writer_.EndRecord();
+  }
+  void drawLine(const SkPoint& p0, const SkPoint& p1) override {
+    writer_.BeginRecord(RecordType::kDrawLine);
+    writer_.Write(p0);
+    writer_.Write(p1);
+    writer_.EndRecord();
+  }
+  void drawRect(const SkRect& rect) override {
+    writer_.BeginRecord(RecordType::kDrawRect);
+    writer_.Write(rect);
+    writer_.EndRecord();
+  }
+  void drawOval(const SkRect& bounds) override {
+    writer_.BeginRecord(RecordType::kDrawOval);
+    writer_.Write(bounds);
+    writer_.EndRecord();
+  }
+  void drawCircle(const SkPoint& center, SkScalar radius) override {
+    writer_.BeginRecord(RecordType::kDrawCircle);
+    writer_.Write(center);
+    writer_.Write(radius);
+    writer_.EndRecord();
+  }
+  void drawRRect(const SkRRect& rrect) override {
+    writer_.BeginRecord(RecordType::kDrawRRect);
+    WriteRRect(writer_, rrect);
+    writer_.EndRecord();
+  }
+  void drawDRRect(const SkRRect& outer, const SkRRect& inner) override {
+    writer_.BeginRecord(RecordType::kDrawDRRect);
+    WriteRRect(writer_, outer);
+    WriteRRect(writer_, inner);
+    writer_.EndRecord();
+  }
+  void drawPath(const SkPath& path) override {
+    writer_.BeginRecord(RecordType::kDrawPath);
+    WritePath(writer_, path);
+    writer_.EndRecord();
+  }
+  void drawArc(const SkRect& oval_bounds,
+               SkScalar start_degrees,
+               SkScalar sweep_degrees,
+               bool use_center) override {
+    writer_.BeginRecord(RecordType::kDrawArc);
+    writer_.Write(oval_bounds);
+    writer_.Write(start_degrees);
+    writer_.Write(sweep_degrees);
+    writer_.WriteBool(use_center);
+    writer_.EndRecord();
+  }
+  void drawPoints(PointMode mode,
+                  uint32_t count,
+                  const SkPoint points[]) override {
+    writer_.BeginRecord(RecordType::kDrawPoints);
+    writer_.WriteEnum(mode);
+    writer_.Write(count);
+    writer_.WriteArray(points, count);
+    writer_.EndRecord();
+  }
+  void drawVertices(const DlVertices* vertices, DlBlendMode mode) override {
+    uint32_t flags = 0;
+    if (vertices->texture_coordinates()) {
+      flags |= kHasTextureCoordinates;
+    }
+    if (vertices->colors()) {
+      flags |= kHasColors;
+    }
+    if (vertices->indices()) {
+      flags |= kHasIndices;
+    }
+    uint32_t vertex_count = vertices->vertex_count();
+    writer_.BeginRecord(RecordType::kDrawVertices);
+    writer_.WriteEnum(vertices->mode());
+    writer_.Write(flags);
+    writer_.Write(vertex_count);
+    writer_.WriteArray(vertices->vertices(), vertex_count);
+    if (flags & kHasTextureCoordinates) {
+      writer_.WriteArray(vertices->texture_coordinates(), vertex_count);
+    }
+    if (flags & kHasColors) {
+      writer_.WriteArray(vertices->colors(), vertex_count);
+    }
+    if (flags & kHasIndices) {
+      writer_.Write<uint32_t>(vertices->index_count());
+      writer_.WriteArray(vertices->indices(), vertices->index_count());
+    }
+    writer_.WriteEnum(mode);
+    writer_.EndRecord();
+  }
+  void drawImage(const sk_sp<DlImage> image,
+                 const SkPoint point,
+                 DlImageSampling sampling,
+                 bool render_with_attributes) override {
+    uint32_t image_index = DefineImage(image.get());
+    writer_.BeginRecord(RecordType::kDrawImage);
+    writer_.Write(image_index);
+    writer_.Write(point);
+    writer_.WriteEnum(sampling);
+    writer_.WriteBool(render_with_attributes);
+    writer_.EndRecord();
+  }
+  void drawImageRect(const sk_sp<DlImage> image,
+                     const SkRect& src,
+                     const SkRect& dst,
+                     DlImageSampling sampling,
+                     bool render_with_attributes,
+                     SrcRectConstraint constraint) override {
+    uint32_t image_index = DefineImage(image.get());
+    writer_.BeginRecord(RecordType::kDrawImageRect);
+    writer_.Write(image_index);
+    writer_.Write(src);
+    writer_.Write(dst);
+    writer_.WriteEnum(sampling);
+    writer_.WriteBool(render_with_attributes);
+    writer_.WriteEnum(constraint);
+    writer_.EndRecord();
+  }
+  void drawImageNine(const sk_sp<DlImage> image,
+                     const SkIRect& center,
+                     const SkRect& dst,
+                     DlFilterMode filter,
+                     bool render_with_attributes) override {
+    uint32_t image_index = DefineImage(image.get());
+    writer_.BeginRecord(RecordType::kDrawImageNine);
+    writer_.Write(image_index);
+    writer_.Write(center);
+    writer_.Write(dst);
+    writer_.WriteEnum(filter);
+    writer_.WriteBool(render_with_attributes);
+    writer_.EndRecord();
+  }
+  void drawAtlas(const sk_sp<DlImage> atlas,
+                 const SkRSXform xform[],
+                 const SkRect tex[],
+                 const DlColor colors[],
+                 int count,
+                 DlBlendMode mode,
+                 DlImageSampling sampling,
+                 const SkRect* cull_rect,
+                 bool render_with_attributes) override {
+    uint32_t image_index = DefineImage(atlas.get());
+    writer_.BeginRecord(RecordType::kDrawAtlas);
+    writer_.Write(image_index);
+    writer_.Write<uint32_t>(count);
+    writer_.WriteArray(xform, count);
+    writer_.WriteArray(tex, count);
+    writer_.WriteBool(colors != nullptr);
+    if (colors) {
+      writer_.WriteArray(colors, count);
+    }
+    writer_.WriteEnum(mode);
+    writer_.WriteEnum(sampling);
+    writer_.WriteBool(cull_rect != nullptr);
+    writer_.Write(cull_rect ? *cull_rect : SkRect::MakeEmpty());
+    writer_.WriteBool(render_with_attributes);
+    writer_.EndRecord();
+  }
+  void drawDisplayList(const sk_sp<DisplayList> display_list,
+                       SkScalar opacity) override {
+    uint32_t display_list_index = DefineDisplayList(*display_list);
+    writer_.BeginRecord(RecordType::kDrawDisplayList);
+    writer_.Write(display_list_index);
+    writer_.Write(opacity);
+    writer_.EndRecord();
+  }
+  void drawTextBlob(const sk_sp<SkTextBlob> blob,
+                    SkScalar x,
+                    SkScalar y) override {
+    uint32_t blob_index = DefineTextBlob(blob.get());
+    writer_.BeginRecord(RecordType::kDrawTextBlob);
+    writer_.Write(blob_index);
+    writer_.Write(x);
+    writer_.Write(y);
+    writer_.EndRecord();
+  }
+  void drawTextFrame(const std::shared_ptr<impeller::TextFrame>& text_frame,
+                     SkScalar x,
+                     SkScalar y) override {
+    // Text frames hold glyph atlas state that has no portable form.
+    valid_ = false;
+  }
+  void drawShadow(const SkPath& path,
+                  const DlColor color,
+                  const SkScalar elevation,
+                  bool transparent_occluder,
+                  SkScalar dpr) override {
+    writer_.BeginRecord(RecordType::kDrawShadow);
+    WritePath(writer_, path);
+    writer_.Write(color.argb());
+    writer_.Write(elevation);
+    writer_.WriteBool(transparent_occluder);
+    writer_.Write(dpr);
+    writer_.EndRecord();
+  }
+
+ private:
+  RecordWriter writer_;
+  // Cleared when something that can't be serialized is encountered.
+  bool valid_ = true;
+
+  // The indices of objects that have already been defined, keyed by their
+  // address. Every object is kept alive by the DisplayList being written.
+  std::unordered_map<const DisplayList*, uint32_t> display_lists_;
+  std::unordered_map<const DlImage*, uint32_t> images_;
+  std::unordered_map<const DlImageFilter*, uint32_t> image_filters_;
+  std::unordered_map<const SkTextBlob*, uint32_t> text_blobs_;
+  // Keyed by their ID instead, as the text blobs that refer to them only
+  // hand out plain pointers.
+  std::unordered_map<SkTypefaceID, uint32_t> typefaces_;
+
+  uint32_t DefineDisplayList(const DisplayList& display_list) {
+    auto found = display_lists_.find(&display_list);
+    if (found != display_lists_.end()) {
+      return found->second;
+    }
+    writer_.BeginRecord(RecordType::kBeginDisplayList);
+    writer_.WriteBool(display_list.has_rtree());
+    writer_.EndRecord();
+    display_list.Dispatch(*this);
+    writer_.BeginRecord(RecordType::kEndDisplayList);
+    writer_.EndRecord();
+    // Indices are assigned as lists end, so a nested list defined while
+    // writing this one gets the lower index.
+    uint32_t index = display_lists_.size();
+    display_lists_.emplace(&display_list, index);
+    return index;
+  }
+
+  uint32_t DefineImage(const DlImage* image) {
+    if (!image) {
+      return kNoIndex;
+    }
+    auto found = images_.find(image);
+    if (found != images_.end()) {
+      return found->second;
+    }
+    sk_sp<SkImage> sk_image = image->skia_image();
+    if (!sk_image || image->isTextureBacked()) {
+      valid_ = false;
+      return kNoIndex;
+    }
+    // Decodes lazily generated images; raster images are returned as is.
+    sk_sp<SkImage> raster_image = sk_image->makeRasterImage();
+    SkPixmap pixmap;
+    if (!raster_image || !raster_image->peekPixels(&pixmap)) {
+      valid_ = false;
+      return kNoIndex;
+    }
+    const SkImageInfo& info = pixmap.info();
+    sk_sp<SkData> color_space =
+        info.colorSpace() ? info.colorSpace()->serialize() : nullptr;
+    size_t row_bytes = info.minRowBytes();
+
+    writer_.BeginRecord(RecordType::kDefineImage);
+    writer_.Write<int32_t>(info.width());
+    writer_.Write<int32_t>(info.height());
+    writer_.WriteEnum(info.colorType());
+    writer_.WriteEnum(info.alphaType());
+    writer_.Write<uint32_t>(color_space ? color_space->size() : 0);
+    if (color_space) {
+      writer_.WriteBytes(color_space->data(), color_space->size());
+    }
+    writer_.Align(kPixelAlignment);
+    for (int y = 0; y < info.height(); y++) {
+      writer_.WriteBytes(pixmap.addr(0, y), row_bytes);
+    }
+    writer_.EndRecord();
+
+    uint32_t index = images_.size();
+    images_.emplace(image, index);
+    return index;
+  }
+
+  uint32_t DefineImageFilter(const DlImageFilter* filter) {
+    if (!filter) {
+      return kNoIndex;
+    }
+    auto found = image_filters_.find(filter);
+    if (found != image_filters_.end()) {
+      return found->second;
+    }
+    writer_.BeginRecord(RecordType::kDefineImageFilter);
+    WriteImageFilter(filter);
+    writer_.EndRecord();
+    uint32_t index = image_filters_.size();
+    image_filters_.emplace(filter, index);
+    return index;
+  }
+
+  uint32_t DefineTypeface(SkTypeface* typeface) {
+    auto found = typefaces_.find(typeface->uniqueID());
+    if (found != typefaces_.end()) {
+      return found->second;
+    }
+    sk_sp<SkData> data =
+        typeface->serialize(SkTypeface::SerializeBehavior::kDoIncludeData);
+    if (!data) {
+      valid_ = false;
+      return kNoIndex;
+    }
+    writer_.BeginRecord(RecordType::kDefineTypeface);
+    writer_.Write<uint32_t>(data->size());
+    writer_.WriteBytes(data->data(), data->size());
+    writer_.EndRecord();
+    uint32_t index = typefaces_.size();
+    typefaces_.emplace(typeface->uniqueID(), index);
+    return index;
+  }
+
+  uint32_t DefineTextBlob(const SkTextBlob* blob) {
+    if (!blob) {
+      return kNoIndex;
+    }
+    auto found = text_blobs_.find(blob);
+    if (found != text_blobs_.end()) {
+      return found->second;
+    }
+    // The typefaces are defined first, so that the blob only holds their
+    // indices rather than a copy of the font data.
+    SkTextBlob::Iter::Run run;
+    for (SkTextBlob::Iter runs(*blob); runs.next(&run);) {
+      if (run.fTypeface) {
+        DefineTypeface(run.fTypeface);
+      }
+    }
+    if (!valid_) {
+      return kNoIndex;
+    }
+    SkSerialProcs procs;
+    procs.fTypefaceProc = [](SkTypeface* typeface,
+                             void* ctx) -> sk_sp<SkData> {
+      auto* typefaces =
+          static_cast<std::unordered_map<SkTypefaceID, uint32_t>*>(ctx);
+      auto found = typefaces->find(typeface->uniqueID());
+      if (found == typefaces->end()) {
+        return nullptr;
+      }
+      return SkData::MakeWithCopy(&found->second, sizeof(found->second));
+    };
+    procs.fTypefaceCtx = &typefaces_;
+    sk_sp<SkData> data = blob->serialize(procs);
+    if (!data) {
+      valid_ = false;
+      return kNoIndex;
+    }
+    writer_.BeginRecord(RecordType::kDefineTextBlob);
+    writer_.Write<uint32_t>(data->size());
+    writer_.WriteBytes(data->data(), data->size());
+    writer_.EndRecord();
+    uint32_t index = text_blobs_.size();
+    text_blobs_.emplace(blob, index);
+    return index;
+  }
+
+  void WriteColorSource(const DlColorSource* source, uint32_t image_index) {
+    if (!source) {
+      writer_.Write(kNoIndex);
+      return;
+    }
+    writer_.WriteEnum(source->type());
+    const DlGradientColorSourceBase* gradient = nullptr;
+    switch (source->type()) {
+      case DlColorSourceType::kColor:
+        writer_.Write(source->asColor()->color().argb());
+        return;
+      case DlColorSourceType::kImage: {
+        const DlImageColorSource* image_source = source->asImage();
+        writer_.Write(image_index);
+        writer_.WriteEnum(image_source->horizontal_tile_mode());
+        writer_.WriteEnum(image_source->vertical_tile_mode());
+        writer_.WriteEnum(image_source->sampling());
+        WriteMatrix(writer_, image_source->matrix());
+        return;
+      }
+      case DlColorSourceType::kLinearGradient: {
+        const DlLinearGradientColorSource* linear = source->asLinearGradient();
+        writer_.Write(linear->start_point());
+        writer_.Write(linear->end_point());
+        gradient = linear;
+        break;
+      }
+      case DlColorSourceType::kRadialGradient: {
+        const DlRadialGradientColorSource* radial = source->asRadialGradient();
+        writer_.Write(radial->center());
+        writer_.Write(radial->radius());
+        gradient = radial;
+        break;
+      }
+      case DlColorSourceType::kConicalGradient: {
+        const DlConicalGradientColorSource* conical =
+            source->asConicalGradient();
+        writer_.Write(conical->start_center());
+        writer_.Write(conical->start_radius());
+        writer_.Write(conical->end_center());
+        writer_.Write(conical->end_radius());
+        gradient = conical;
+        break;
+      }
+      case DlColorSourceType::kSweepGradient: {
+        const DlSweepGradientColorSource* sweep = source->asSweepGradient();
+        writer_.Write(sweep->center());
+        writer_.Write(sweep->start());
+        writer_.Write(sweep->end());
+        gradient = sweep;
+        break;
+      }
+      case DlColorSourceType::kRuntimeEffect:
+#ifdef IMPELLER_ENABLE_3D
+      case DlColorSourceType::kScene:
+#endif  // IMPELLER_ENABLE_3D
+        // Runtime effects and scenes refer to compiled shaders and scene
+        // graphs that only exist in the running process.
+        valid_ = false;
+        return;
+    }
+    writer_.Write<uint32_t>(gradient->stop_count());
+    writer_.WriteArray(gradient->colors(), gradient->stop_count());
+    writer_.WriteArray(gradient->stops(), gradient->stop_count());
+    writer_.WriteEnum(gradient->tile_mode());
+    WriteMatrix(writer_, gradient->matrix());
+  }
+
+  void WriteColorFilter(const DlColorFilter* filter) {
+    if (!filter) {
+      writer_.Write(kNoIndex);
+      return;
+    }
+    writer_.WriteEnum(filter->type());
+    switch (filter->type()) {
+      case DlColorFilterType::kBlend: {
+        const DlBlendColorFilter* blend = filter->asBlend();
+        writer_.Write(blend->color().argb());
+        writer_.WriteEnum(blend->mode());
+        break;
+      }
+      case DlColorFilterType::kMatrix: {
+        float matrix[20];
+        filter->asMatrix()->get_matrix(matrix);
+        writer_.WriteArray(matrix, 20);
+        break;
+      }
+      case DlColorFilterType::kSrgbToLinearGamma:
+      case DlColorFilterType::kLinearToSrgbGamma:
+        break;
+    }
+  }
+
+  // Image filters nested inside another filter are written inline; only
+  // the filters set directly on ops are shared.
+  void WriteImageFilter(const DlImageFilter* filter) {
+    if (!filter) {
+      writer_.Write(kNoIndex);
+      return;
+    }
+    writer_.WriteEnum(filter->type());
+    switch (filter->type()) {
+      case DlImageFilterType::kBlur: {
+        const DlBlurImageFilter* blur = filter->asBlur();
+        writer_.Write(blur->sigma_x());
+        writer_.Write(blur->sigma_y());
+        writer_.WriteEnum(blur->tile_mode());
+        break;
+      }
+      case DlImageFilterType::kDilate: {
+        const DlDilateImageFilter* dilate = filter->asDilate();
+        writer_.Write(dilate->radius_x());
+        writer_.Write(dilate->radius_y());
+        break;
+      }
+      case DlImageFilterType::kErode: {
+        const DlErodeImageFilter* erode = filter->asErode();
+        writer_.Write(erode->radius_x());
+        writer_.Write(erode->radius_y());
+        break;
+      }
+      case DlImageFilterType::kMatrix: {
+        const DlMatrixImageFilter* matrix = filter->asMatrix();
+        WriteMatrix(writer_, matrix->matrix());
+        writer_.WriteEnum(matrix->sampling());
+        break;
+      }
+      case DlImageFilterType::kCompose: {
+        const DlComposeImageFilter* compose = filter->asCompose();
+        WriteImageFilter(compose->outer().get());
+        WriteImageFilter(compose->inner().get());
+        break;
+      }
+      case DlImageFilterType::kColorFilter:
+        WriteColorFilter(filter->asColorFilter()->color_filter().get());
+        break;
+      case DlImageFilterType::kLocalMatrix: {
+        const DlLocalMatrixImageFilter* local_matrix = filter->asLocalMatrix();
+        WriteMatrix(writer_, local_matrix->matrix());
+        WriteImageFilter(local_matrix->image_filter().get());
+        break;
+      }
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListWriter);
+};
+
+// Rebuilds the DisplayLists in serialized data by replaying their records
+// into DisplayListBuilders.
+class DisplayListReader {
+ public:
+  explicit DisplayListReader(std::shared_ptr<const fml::Mapping> mapping)
+      : mapping_(std::move(mapping)) {}
+
+  sk_sp<DisplayList> Read() {
+    const uint8_t* base = mapping_->GetMapping();
+    size_t size = mapping_->GetSize();
+    if (!base || reinterpret_cast<uintptr_t>(base) % kRecordAlignment != 0) {
+      return nullptr;
+    }
+    RecordReader file(base, 0, size);
+    FileHeader header;
+    if (!file.Read(&header) || header.magic != kMagic ||
+        header.version != DlSerialization::kVersion ||
+        header.byte_order != kByteOrderMark) {
+      return nullptr;
+    }
+    sk_sp<DisplayList> root;
+    while (file.remaining() > 0) {
+      if (root) {
+        // Nothing may follow the outermost DisplayList.
+        return nullptr;
+      }
+      size_t record_start = file.offset();
+      RecordHeader record_header;
+      if (!file.Read(&record_header) ||
+          record_header.size < sizeof(RecordHeader) ||
+          record_header.size % kRecordAlignment != 0 ||
+          record_header.size - sizeof(RecordHeader) > file.remaining()) {
+        return nullptr;
+      }
+      size_t record_end = record_start + record_header.size;
+      RecordReader record(base, file.offset(), record_end);
+      if (!ReadRecord(record_header.type, record, &root) ||
+          record.remaining() >= kRecordAlignment) {
+        return nullptr;
+      }
+      file.ReadBytes(record_end - file.offset());
+    }
+    return root;
+  }
+
+ private:
+  const std::shared_ptr<const fml::Mapping> mapping_;
+
+  // The builders of the DisplayLists currently being read, innermost last.
+  std::vector<std::unique_ptr<DisplayListBuilder>> builders_;
+
+  std::vector<sk_sp<DisplayList>> display_lists_;
+  std::vector<sk_sp<DlImage>> images_;
+  std::vector<std::shared_ptr<const DlImageFilter>> image_filters_;
+  std::vector<sk_sp<SkTextBlob>> text_blobs_;
+  std::vector<sk_sp<SkTypeface>> typefaces_;
+
+  template <typename T>
+  static bool ReadIndex(RecordReader& reader,
+                        const std::vector<T>& table,
+                        T* value) {
+    uint32_t index;
+    if (!reader.Read(&index)) {
+      return false;
+    }
+    if (index == kNoIndex) {
+      *value = T();
+      return true;
+    }
+    if (index >= table.size()) {
+      return false;
+    }
+    *value = table[index];
+    return true;
+  }
+
+  bool ReadRecord(RecordType type,
+                  RecordReader& reader,
+                  sk_sp<DisplayList>* root) {
+    switch (type) {
+      case RecordType::kBeginDisplayList: {
+        bool prepare_rtree;
+        if (!reader.ReadBool(&prepare_rtree)) {
+          return false;
+        }
+        builders_.push_back(std::make_unique<DisplayListBuilder>(
+            DisplayListBuilder::kMaxCullRect, prepare_rtree));
+        return true;
+      }
+      case RecordType::kEndDisplayList: {
+        if (builders_.empty()) {
+          return false;
+        }
+        sk_sp<DisplayList> display_list = builders_.back()->Build();
+        builders_.pop_back();
+        if (builders_.empty()) {
+          *root = std::move(display_list);
+        } else {
+          display_lists_.push_back(std::move(display_list));
+        }
+        return true;
+      }
+      case RecordType::kDefineImage:
+        return ReadImage(reader);
+      case RecordType::kDefineImageFilter: {
+        std::shared_ptr<const DlImageFilter> filter;
+        if (!ReadImageFilter(reader, &filter, 0) || !filter) {
+          return false;
+        }
+        image_filters_.push_back(std::move(filter));
+        return true;
+      }
+      case RecordType::kDefineTypeface: {
+        uint32_t size;
+        if (!reader.Read(&size)) {
+          return false;
+        }
+        const uint8_t* bytes = reader.ReadBytes(size);
+        if (!bytes || !reader.Align(kRecordAlignment)) {
+          return false;
+        }
+        SkMemoryStream stream(bytes, size, /*copyData=*/false);
+        sk_sp<SkTypeface> typeface = SkTypeface::MakeDeserialize(&stream);
+        if (!typeface) {
+          return false;
+        }
+        typefaces_.push_back(std::move(typeface));
+        return true;
+      }
+      case RecordType::kDefineTextBlob: {
+        uint32_t size;
+        if (!reader.Read(&size)) {
+          return false;
+        }
+        const uint8_t* bytes = reader.ReadBytes(size);
+        if (!bytes || !reader.Align(kRecordAlignment)) {
+          return false;
+        }
+        // The typefaces are referred to by their index.
+        SkDeserialProcs procs;
+        procs.fTypefaceProc = [](const void* data, size_t length,
+                                 void* ctx) -> sk_sp<SkTypeface> {
+          auto* typefaces = static_cast<std::vector<sk_sp<SkTypeface>>*>(ctx);
+          uint32_t index;
+          if (length != sizeof(index)) {
+            return nullptr;
+          }
+          memcpy(&index, data, sizeof(index));
+          if (index >= typefaces->size()) {
+            return nullptr;
+          }
+          return (*typefaces)[index];
+        };
+        procs.fTypefaceCtx = &typefaces_;
+        sk_sp<SkTextBlob> blob = SkTextBlob::Deserialize(bytes, size, procs);
+        if (!blob) {
+          return false;
+        }
+        text_blobs_.push_back(std::move(blob));
+        return true;
+      }
+      default:
+        if (builders_.empty()) {
+          return false;
+        }
+        return ReadOp(
+            type, reader,
+            DisplayListBuilderDeserializationAccessor(*builders_.back()));
+    }
+  }
+
+  bool ReadOp(RecordType type, RecordReader& reader, DlOpReceiver& receiver) {
+    switch (type) {
+      case RecordType::kSetAntiAlias: {
+        bool aa;
+        if (!reader.ReadBool(&aa)) {
+          return false;
+        }
+        receiver.setAntiAlias(aa);
+        return true;
+      }
+      case RecordType::kSetInvertColors: {
+        bool invert;
+        if (!reader.ReadBool(&invert)) {
+          return false;
+        }
+        receiver.setInvertColors(invert);
+        return true;
+      }
+      case RecordType::kSetStrokeCap: {
+        DlStrokeCap cap;
+        if (!reader.ReadEnum(&cap, DlStrokeCap::kLastCap)) {
+          return false;
+        }
+        receiver.setStrokeCap(cap);
+        return true;
+      }
+      case RecordType::kSetStrokeJoin: {
+        DlStrokeJoin join;
+        if (!reader.ReadEnum(&join, DlStrokeJoin::kLastJoin)) {
+          return false;
+        }
+        receiver.setStrokeJoin(join);
+        return true;
+      }
+      case RecordType::kSetDrawStyle: {
+        DlDrawStyle style;
+        if (!reader.ReadEnum(&style, DlDrawStyle::kLastStyle)) {
+          return false;
+        }
+        receiver.setDrawStyle(style);
+        return true;
+      }
+      case RecordType::kSetStrokeWidth: {
+        float width;
+        if (!reader.Read(&width)) {
+          return false;
+        }
+        receiver.setStrokeWidth(width);
+        return true;
+      }
+      case RecordType::kSetStrokeMiter: {
+        float limit;
+        if (!reader.Read(&limit)) {
+          return false;
+        }
+        receiver.setStrokeMiter(limit);
+        return true;
+      }
+      case RecordType::kSetColor: {
+        uint32_t argb;
+        if (!reader.Read(&argb)) {
+          return false;
+        }
+        receiver.setColor(DlColor(argb));
+        return true;
+      }
+      case RecordType::kSetBlendMode: {
+        DlBlendMode mode;
+        if (!reader.ReadEnum(&mode, DlBlendMode::kLastMode)) {
+          return false;
+        }
+        receiver.setBlendMode(mode);
+        return true;
+      }
+      case RecordType::kSetColorSource: {
+        std::shared_ptr<DlColorSource> source;
+        if (!ReadColorSource(reader, &source)) {
+          return false;
+        }
+        receiver.setColorSource(source.get());
+        return true;
+      }
+      case RecordType::kSetColorFilter: {
+        std::shared_ptr<const DlColorFilter> filter;
+        if (!ReadColorFilter(reader, &filter)) {
+          return false;
+        }
+        receiver.setColorFilter(filter.get());
+        return true;
+      }
+      case RecordType::kSetImageFilter: {
+        std::shared_ptr<const DlImageFilter> filter;
+        if (!ReadIndex(reader, image_filters_, &filter)) {
+          return false;
+        }
+        receiver.setImageFilter(filter.get());
+        return true;
+      }
+      case RecordType::kSetMaskFilter: {
+        std::shared_ptr<DlMaskFilter> filter;
+        if (!ReadMaskFilter(reader, &filter)) {
+          return false;
+        }
+        receiver.setMaskFilter(filter.get());
+        return true;
+      }
+      case RecordType::kSetPathEffect: {
+        std::shared_ptr<DlPathEffect> effect;
+        if (!ReadPathEffect(reader, &effect)) {
+          return false;
+        }
+        receiver.setPathEffect(effect.get());
+        return true;
+      }
+
+      case RecordType::kSave:
+        receiver.save();
+        return true;
+      case RecordType::kSaveLayer: {
+        uint32_t flags;
+        bool has_bounds;
+        SkRect bounds;
+        std::shared_ptr<const DlImageFilter> backdrop;
+        if (!reader.Read(&flags) || !reader.ReadBool(&has_bounds) ||
+            !reader.Read(&bounds) ||
+            !ReadIndex(reader, image_filters_, &backdrop)) {
+          return false;
+        }
+        SaveLayerOptions options;
+        if (flags & kRendersWithAttributes) {
+          options = options.with_renders_with_attributes();
+        }
+        if (flags & kCanDistributeOpacity) {
+          options = options.with_can_distribute_opacity();
+        }
+        receiver.saveLayer(has_bounds ? &bounds : nullptr, options,
+                           backdrop.get());
+        return true;
+      }
+      case RecordType::kRestore:
+        receiver.restore();
+        return true;
+
+      case RecordType::kTranslate: {
+        SkScalar tx, ty;
+        if (!reader.Read(&tx) || !reader.Read(&ty)) {
+          return false;
+        }
+        receiver.translate(tx, ty);
+        return true;
+      }
+      case RecordType::kScale: {
+        SkScalar sx, sy;
+        if (!reader.Read(&sx) || !reader.Read(&sy)) {
+          return false;
+        }
+        receiver.scale(sx, sy);
+        return true;
+      }
+      case RecordType::kRotate: {
+        SkScalar degrees;
+        if (!reader.Read(&degrees)) {
+          return false;
+        }
+        receiver.rotate(degrees);
+        return true;
+      }
+      case RecordType::kSkew: {
+        SkScalar sx, sy;
+        if (!reader.Read(&sx) || !reader.Read(&sy)) {
+          return false;
+        }
+        receiver.skew(sx, sy);
+        return true;
+      }
+      case RecordType::kTransform2DAffine: {
+        const SkScalar* m;
+        if (!reader.ReadArray(&m, 6)) {
+          return false;
+        }
+        receiver.transform2DAffine(m[0], m[1], m[2],  //
+                                   m[3], m[4], m[5]);
+        return true;
+      }
+      case RecordType::kTransformFullPerspective: {
+        const SkScalar* m;
+        if (!reader.ReadArray(&m, 16)) {
+          return false;
+        }
+        receiver.transformFullPerspective(m[0], m[1], m[2], m[3],    //
+                                          m[4], m[5], m[6], m[7],    //
+                                          m[8], m[9], m[10], m[11],  //
+                                          m[12], m[13], m[14], m[15]);
+        return true;
+      }
+      case RecordType::kTransformReset:
+        receiver.transformReset();
+        return true;
+
+      case RecordType::kClipRect: {
+        SkRect rect;
+        DlCanvas::ClipOp clip_op;
+        bool is_aa;
+        if (!reader.Read(&rect) ||
+            !reader.ReadEnum(&clip_op, DlCanvas::ClipOp::kIntersect) ||
+            !reader.ReadBool(&is_aa)) {
+          return false;
+        }
+        receiver.clipRect(rect, clip_op, is_aa);
+        return true;
+      }
+      case RecordType::kClipRRect: {
+        SkRRect rrect;
+        DlCanvas::ClipOp clip_op;
+        bool is_aa;
+        if (!ReadRRect(reader, &rrect) ||
+            !reader.ReadEnum(&clip_op, DlCanvas::ClipOp::kIntersect) ||
+            !reader.ReadBool(&is_aa)) {
+          return false;
+        }
+        receiver.clipRRect(rrect, clip_op, is_aa);
+        return true;
+      }
+      case RecordType::kClipPath: {
+        SkPath path;
+        DlCanvas::ClipOp clip_op;
+        bool is_aa;
+        if (!ReadPath(reader, &path) ||
+            !reader.ReadEnum(&clip_op, DlCanvas::ClipOp::kIntersect) ||
+            !reader.ReadBool(&is_aa)) {
+          return false;
+        }
+        receiver.clipPath(path, clip_op, is_aa);
+        return true;
+      }
+
+      case RecordType::kDrawColor: {
+        uint32_t argb;
+        DlBlendMode mode;
+        if (!reader.Read(&argb) ||
+            !reader.ReadEnum(&mode, DlBlendMode::kLastMode)) {
+          return false;
+        }
+        receiver.drawColor(DlColor(argb), mode);
+        return true;
+      }
+      case RecordType::kDrawPaint:
+        receiver.drawPaint();
+        return true;
+      case RecordType::kDrawLine: {
+        SkPoint p0, p1;
+        if (!reader.Read(&p0) || !reader.Read(&p1)) {
+          return false;
+        }
+        receiver.drawLine(p0, p1);
+        return true;
+      }
+      case RecordType::kDrawRect: {
+        SkRect rect;
+        if (!reader.Read(&rect)) {
+          return false;
+        }
+        receiver.drawRect(rect);
+        return true;
+      }
+      case RecordType::kDrawOval: {
+        SkRect bounds;
+        if (!reader.Read(&bounds)) {
+          return false;
+        }
+        receiver.drawOval(bounds);
+        return true;
+      }
+      case RecordType::kDrawCircle: {
+        SkPoint center;
+        SkScalar radius;
+        if (!reader.Read(&center) || !reader.Read(&radius)) {
+          return false;
+        }
+        receiver.drawCircle(center, radius);
+        return true;
+      }
+      case RecordType::kDrawRRect: {
+        SkRRect rrect;
+        if (!ReadRRect(reader, &rrect)) {
+          return false;
+        }
+        receiver.drawRRect(rrect);
+        return true;
+      }
+      case RecordType::kDrawDRRect: {
+        SkRRect outer, inner;
+        if (!ReadRRect(reader, &outer) || !ReadRRect(reader, &inner)) {
+          return false;
+        }
+        receiver.drawDRRect(outer, inner);
+        return true;
+      }
+      case RecordType::kDrawPath: {
+        SkPath path;
+        if (!ReadPath(reader, &path)) {
+          return false;
+        }
+        receiver.drawPath(path);
+        return true;
+      }
+      case RecordType::kDrawArc: {
+        SkRect oval_bounds;
+        SkScalar start_degrees, sweep_degrees;
+        bool use_center;
+        if (!reader.Read(&oval_bounds) || !reader.Read(&start_degrees) ||
+            !reader.Read(&sweep_degrees) || !reader.ReadBool(&use_center)) {
+          return false;
+        }
+        receiver.drawArc(oval_bounds, start_degrees, sweep_degrees,
+                         use_center);
+        return true;
+      }
+      case RecordType::kDrawPoints: {
+        DlCanvas::PointMode mode;
+        uint32_t count;
+        const SkPoint* points;
+        if (!reader.ReadEnum(&mode, DlCanvas::PointMode::kPolygon) ||
+            !reader.Read(&count) ||
+            count > static_cast<uint32_t>(DlOpReceiver::kMaxDrawPointsCount) ||
+            !reader.ReadArray(&points, count)) {
+          return false;
+        }
+        receiver.drawPoints(mode, count, points);
+        return true;
+      }
+      case RecordType::kDrawVertices:
+        return ReadVertices(reader, receiver);
+      case RecordType::kDrawImage: {
+        sk_sp<DlImage> image;
+        SkPoint point;
+        DlImageSampling sampling;
+        bool render_with_attributes;
+        if (!ReadIndex(reader, images_, &image) || !reader.Read(&point) ||
+            !reader.ReadEnum(&sampling, DlImageSampling::kCubic) ||
+            !reader.ReadBool(&render_with_attributes)) {
+          return false;
+        }
+        receiver.drawImage(image, point, sampling, render_with_attributes);
+        return true;
+      }
+      case RecordType::kDrawImageRect: {
+        sk_sp<DlImage> image;
+        SkRect src, dst;
+        DlImageSampling sampling;
+        bool render_with_attributes;
+        DlCanvas::SrcRectConstraint constraint;
+        if (!ReadIndex(reader, images_, &image) || !reader.Read(&src) ||
+            !reader.Read(&dst) ||
+            !reader.ReadEnum(&sampling, DlImageSampling::kCubic) ||
+            !reader.ReadBool(&render_with_attributes) ||
+            !reader.ReadEnum(&constraint,
+                             DlCanvas::SrcRectConstraint::kFast)) {
+          return false;
+        }
+        receiver.drawImageRect(image, src, dst, sampling,
+                               render_with_attributes, constraint);
+        return true;
+      }
+      case RecordType::kDrawImageNine: {
+        sk_sp<DlImage> image;
+        SkIRect center;
+        SkRect dst;
+        DlFilterMode filter;
+        bool render_with_attributes;
+        if (!ReadIndex(reader, images_, &image) || !reader.Read(&center) ||
+            !reader.Read(&dst) ||
+            !reader.ReadEnum(&filter, DlFilterMode::kLast) ||
+            !reader.ReadBool(&render_with_attributes)) {
+          return false;
+        }
+        receiver.drawImageNine(image, center, dst, filter,
+                               render_with_attributes);
+        return true;
+      }
+      case RecordType::kDrawAtlas:
+        return ReadAtlas(reader, receiver);
+      case RecordType::kDrawDisplayList: {
+        sk_sp<DisplayList> display_list;
+        SkScalar opacity;
+        if (!ReadIndex(reader, display_lists_, &display_list) ||
+            !display_list || !reader.Read(&opacity)) {
+          return false;
+        }
+        receiver.drawDisplayList(display_list, opacity);
+        return true;
+      }
+      case RecordType::kDrawTextBlob: {
+        sk_sp<SkTextBlob> blob;
+        SkScalar x, y;
+        if (!ReadIndex(reader, text_blobs_, &blob) || !blob ||
+            !reader.Read(&x) || !reader.Read(&y)) {
+          return false;
+        }
+        receiver.drawTextBlob(blob, x, y);
+        return true;
+      }
+      case RecordType::kDrawShadow: {
+        SkPath path;
+        uint32_t argb;
+        SkScalar elevation, dpr;
+        bool transparent_occluder;
+        if (!ReadPath(reader, &path) || !reader.Read(&argb) ||
+            !reader.Read(&elevation) ||
+            !reader.ReadBool(&transparent_occluder) || !reader.Read(&dpr)) {
+          return false;
+        }
+        receiver.drawShadow(path, DlColor(argb), elevation,
+                            transparent_occluder, dpr);
+        return true;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  bool ReadVertices(RecordReader& reader, DlOpReceiver& receiver) {
+    DlVertexMode vertex_mode;
+    uint32_t flags;
+    uint32_t vertex_count;
+    const SkPoint* vertices;
+    const SkPoint* texture_coordinates = nullptr;
+    const DlColor* colors = nullptr;
+    uint32_t index_count = 0;
+    const uint16_t* indices = nullptr;
+    DlBlendMode mode;
+    if (!reader.ReadEnum(&vertex_mode, DlVertexMode::kTriangleFan) ||
+        !reader.Read(&flags) || !reader.Read(&vertex_count) ||
+        vertex_count > kMaxCount ||
+        !reader.ReadArray(&vertices, vertex_count)) {
+      return false;
+    }
+    if ((flags & kHasTextureCoordinates) &&
+        !reader.ReadArray(&texture_coordinates, vertex_count)) {
+      return false;
+    }
+    if ((flags & kHasColors) && !reader.ReadArray(&colors, vertex_count)) {
+      return false;
+    }
+    if ((flags & kHasIndices) &&
+        (!reader.Read(&index_count) ||
+         index_count > kMaxCount ||
+         !reader.ReadArray(&indices, index_count))) {
+      return false;
+    }
+    if (!reader.ReadEnum(&mode, DlBlendMode::kLastMode)) {
+      return false;
+    }
+    std::shared_ptr<DlVertices> dl_vertices =
+        DlVertices::Make(vertex_mode, vertex_count, vertices,
+                         texture_coordinates, colors, index_count, indices);
+    receiver.drawVertices(dl_vertices.get(), mode);
+    return true;
+  }
+
+  bool ReadAtlas(RecordReader& reader, DlOpReceiver& receiver) {
+    sk_sp<DlImage> atlas;
+    uint32_t count;
+    const SkRSXform* xforms;
+    const SkRect* tex;
+    bool has_colors;
+    const DlColor* colors = nullptr;
+    DlBlendMode mode;
+    DlImageSampling sampling;
+    bool has_cull_rect;
+    SkRect cull_rect;
+    bool render_with_attributes;
+    if (!ReadIndex(reader, images_, &atlas) || !reader.Read(&count) ||
+        count > kMaxCount ||
+        !reader.ReadArray(&xforms, count) || !reader.ReadArray(&tex, count) ||
+        !reader.ReadBool(&has_colors) ||
+        (has_colors && !reader.ReadArray(&colors, count)) ||
+        !reader.ReadEnum(&mode, DlBlendMode::kLastMode) ||
+        !reader.ReadEnum(&sampling, DlImageSampling::kCubic) ||
+        !reader.ReadBool(&has_cull_rect) || !reader.Read(&cull_rect) ||
+        !reader.ReadBool(&render_with_attributes)) {
+      return false;
+    }
+    receiver.drawAtlas(atlas, xforms, tex, colors, count, mode, sampling,
+                       has_cull_rect ? &cull_rect : nullptr,
+                       render_with_attributes);
+    return true;
+  }
+
+  bool ReadImage(RecordReader& reader) {
+    int32_t width, height;
+    SkColorType color_type;
+    SkAlphaType alpha_type;
+    uint32_t color_space_size;
+    if (!reader.Read(&width) || !reader.Read(&height) || width <= 0 ||
+        height <= 0 ||
+        !reader.ReadEnum(&color_type, kLastEnum_SkColorType) ||
+        !reader.ReadEnum(&alpha_type, kLastEnum_SkAlphaType) ||
+        !reader.Read(&color_space_size)) {
+      return false;
+    }
+    sk_sp<SkColorSpace> color_space;
+    if (color_space_size > 0) {
+      const uint8_t* bytes = reader.ReadBytes(color_space_size);
+      if (!bytes ||
+          !(color_space = SkColorSpace::Deserialize(bytes, color_space_size))) {
+        return false;
+      }
+    }
+    SkImageInfo info =
+        SkImageInfo::Make(width, height, color_type, alpha_type, color_space);
+    size_t row_bytes = info.minRowBytes();
+    size_t byte_size = info.computeByteSize(row_bytes);
+    if (info.bytesPerPixel() == 0 ||
+        SkImageInfo::ByteSizeOverflowed(byte_size) ||
+        !reader.Align(kPixelAlignment)) {
+      return false;
+    }
+    const uint8_t* pixels = reader.ReadBytes(byte_size);
+    if (!pixels || !reader.Align(kRecordAlignment)) {
+      return false;
+    }
+    sk_sp<SkData> data;
+    if (reinterpret_cast<uintptr_t>(pixels) % kPixelAlignment == 0) {
+      // Borrow the pixels, keeping the mapping alive until Skia is done
+      // with them.
+      data = SkData::MakeWithProc(
+          pixels, byte_size,
+          [](const void* ptr, void* context) {
+            delete static_cast<std::shared_ptr<const fml::Mapping>*>(context);
+          },
+          new std::shared_ptr<const fml::Mapping>(mapping_));
+    } else {
+      data = SkData::MakeWithCopy(pixels, byte_size);
+    }
+    sk_sp<SkImage> image =
+        SkImages::RasterFromData(info, std::move(data), row_bytes);
+    if (!image) {
+      return false;
+    }
+    images_.push_back(DlImage::Make(std::move(image)));
+    return true;
+  }
+
+  bool ReadColorSource(RecordReader& reader,
+                       std::shared_ptr<DlColorSource>* source) {
+    uint32_t raw_type;
+    if (!reader.Read(&raw_type)) {
+      return false;
+    }
+    if (raw_type == kNoIndex) {
+      *source = nullptr;
+      return true;
+    }
+    switch (static_cast<DlColorSourceType>(raw_type)) {
+      case DlColorSourceType::kColor: {
+        uint32_t argb;
+        if (!reader.Read(&argb)) {
+          return false;
+        }
+        *source = std::make_shared<DlColorColorSource>(DlColor(argb));
+        return true;
+      }
+      case DlColorSourceType::kImage: {
+        sk_sp<DlImage> image;
+        DlTileMode horizontal_tile_mode, vertical_tile_mode;
+        DlImageSampling sampling;
+        SkMatrix matrix;
+        if (!ReadIndex(reader, images_, &image) || !image ||
+            !reader.ReadEnum(&horizontal_tile_mode, DlTileMode::kDecal) ||
+            !reader.ReadEnum(&vertical_tile_mode, DlTileMode::kDecal) ||
+            !reader.ReadEnum(&sampling, DlImageSampling::kCubic) ||
+            !ReadMatrix(reader, &matrix)) {
+          return false;
+        }
+        *source = std::make_shared<DlImageColorSource>(
+            std::move(image), horizontal_tile_mode, vertical_tile_mode,
+            sampling, &matrix);
+        return true;
+      }
+      case DlColorSourceType::kLinearGradient: {
+        SkPoint start_point, end_point;
+        if (!reader.Read(&start_point) || !reader.Read(&end_point)) {
+          return false;
+        }
+        return ReadGradient(
+            reader, [&](uint32_t stop_count, const DlColor* colors,
+                        const float* stops, DlTileMode tile_mode,
+                        const SkMatrix* matrix) {
+              *source =
+                  DlColorSource::MakeLinear(start_point, end_point, stop_count,
+                                            colors, stops, tile_mode, matrix);
+            });
+      }
+      case DlColorSourceType::kRadialGradient: {
+        SkPoint center;
+        SkScalar radius;
+        if (!reader.Read(&center) || !reader.Read(&radius)) {
+          return false;
+        }
+        return ReadGradient(
+            reader, [&](uint32_t stop_count, const DlColor* colors,
+                        const float* stops, DlTileMode tile_mode,
+                        const SkMatrix* matrix) {
+              *source = DlColorSource::MakeRadial(
+                  center, radius, stop_count, colors, stops, tile_mode, matrix);
+            });
+      }
+      case DlColorSourceType::kConicalGradient: {
+        SkPoint start_center, end_center;
+        SkScalar start_radius, end_radius;
+        if (!reader.Read(&start_center) || !reader.Read(&start_radius) ||
+            !reader.Read(&end_center) || !reader.Read(&end_radius)) {
+          return false;
+        }
+        return ReadGradient(
+            reader, [&](uint32_t stop_count, const DlColor* colors,
+                        const float* stops, DlTileMode tile_mode,
+                        const SkMatrix* matrix) {
+              *source = DlColorSource::MakeConical(
+                  start_center, start_radius, end_center, end_radius,
+                  stop_count, colors, stops, tile_mode, matrix);
+            });
+      }
+      case DlColorSourceType::kSweepGradient: {
+        SkPoint center;
+        SkScalar start, end;
+        if (!reader.Read(&center) || !reader.Read(&start) ||
+            !reader.Read(&end)) {
+          return false;
+        }
+        return ReadGradient(
+            reader, [&](uint32_t stop_count, const DlColor* colors,
+                        const float* stops, DlTileMode tile_mode,
+                        const SkMatrix* matrix) {
+              *source = DlColorSource::MakeSweep(center, start, end,
+                                                 stop_count, colors, stops,
+                                                 tile_mode, matrix);
+            });
+      }
+      default:
+        return false;
+    }
+  }
+
+  // Reads the fields shared by all gradients and passes them to |make|.
+  template <typename MakeGradient>
+  bool ReadGradient(RecordReader& reader, const MakeGradient& make) {
+    uint32_t stop_count;
+    const DlColor* colors;
+    const float* stops;
+    DlTileMode tile_mode;
+    SkMatrix matrix;
+    if (!reader.Read(&stop_count) || !reader.ReadArray(&colors, stop_count) ||
+        !reader.ReadArray(&stops, stop_count) ||
+        !reader.ReadEnum(&tile_mode, DlTileMode::kDecal) ||
+        !ReadMatrix(reader, &matrix)) {
+      return false;
+    }
+    make(stop_count, colors, stops, tile_mode, &matrix);
+    return true;
+  }
+
+  bool ReadColorFilter(RecordReader& reader,
+                       std::shared_ptr<const DlColorFilter>* filter) {
+    uint32_t raw_type;
+    if (!reader.Read(&raw_type)) {
+      return false;
+    }
+    if (raw_type == kNoIndex) {
+      *filter = nullptr;
+      return true;
+    }
+    switch (static_cast<DlColorFilterType>(raw_type)) {
+      case DlColorFilterType::kBlend: {
+        uint32_t argb;
+        DlBlendMode mode;
+        if (!reader.Read(&argb) ||
+            !reader.ReadEnum(&mode, DlBlendMode::kLastMode)) {
+          return false;
+        }
+        *filter = std::make_shared<DlBlendColorFilter>(DlColor(argb), mode);
+        return true;
+      }
+      case DlColorFilterType::kMatrix: {
+        const float* matrix;
+        if (!reader.ReadArray(&matrix, 20)) {
+          return false;
+        }
+        *filter = std::make_shared<DlMatrixColorFilter>(matrix);
+        return true;
+      }
+      case DlColorFilterType::kSrgbToLinearGamma:
+        *filter = DlSrgbToLinearGammaColorFilter::kInstance;
+        return true;
+      case DlColorFilterType::kLinearToSrgbGamma:
+        *filter = DlLinearToSrgbGammaColorFilter::kInstance;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  bool ReadImageFilter(RecordReader& reader,
+                       std::shared_ptr<const DlImageFilter>* filter,
+                       int depth) {
+    uint32_t raw_type;
+    if (depth > kMaxEffectDepth || !reader.Read(&raw_type)) {
+      return false;
+    }
+    if (raw_type == kNoIndex) {
+      *filter = nullptr;
+      return true;
+    }
+    switch (static_cast<DlImageFilterType>(raw_type)) {
+      case DlImageFilterType::kBlur: {
+        SkScalar sigma_x, sigma_y;
+        DlTileMode tile_mode;
+        if (!reader.Read(&sigma_x) || !reader.Read(&sigma_y) ||
+            !reader.ReadEnum(&tile_mode, DlTileMode::kDecal)) {
+          return false;
+        }
+        *filter =
+            std::make_shared<DlBlurImageFilter>(sigma_x, sigma_y, tile_mode);
+        return true;
+      }
+      case DlImageFilterType::kDilate: {
+        SkScalar radius_x, radius_y;
+        if (!reader.Read(&radius_x) || !reader.Read(&radius_y)) {
+          return false;
+        }
+        *filter = std::make_shared<DlDilateImageFilter>(radius_x, radius_y);
+        return true;
+      }
+      case DlImageFilterType::kErode: {
+        SkScalar radius_x, radius_y;
+        if (!reader.Read(&radius_x) || !reader.Read(&radius_y)) {
+          return false;
+        }
+        *filter = std::make_shared<DlErodeImageFilter>(radius_x, radius_y);
+        return true;
+      }
+      case DlImageFilterType::kMatrix: {
+        SkMatrix matrix;
+        DlImageSampling sampling;
+        if (!ReadMatrix(reader, &matrix) ||
+            !reader.ReadEnum(&sampling, DlImageSampling::kCubic)) {
+          return false;
+        }
+        *filter = std::make_shared<DlMatrixImageFilter>(matrix, sampling);
+        return true;
+      }
+      case DlImageFilterType::kCompose: {
+        std::shared_ptr<const DlImageFilter> outer, inner;
+        if (!ReadImageFilter(reader, &outer, depth + 1) ||
+            !ReadImageFilter(reader, &inner, depth + 1)) {
+          return false;
+        }
+        *filter = std::make_shared<DlComposeImageFilter>(std::move(outer),
+                                                         std::move(inner));
+        return true;
+      }
+      case DlImageFilterType::kColorFilter: {
+        std::shared_ptr<const DlColorFilter> color_filter;
+        if (!ReadColorFilter(reader, &color_filter)) {
+          return false;
+        }
+        *filter =
+            std::make_shared<DlColorFilterImageFilter>(std::move(color_filter));
+        return true;
+      }
+      case DlImageFilterType::kLocalMatrix: {
+        SkMatrix matrix;
+        std::shared_ptr<const DlImageFilter> inner;
+        if (!ReadMatrix(reader, &matrix) ||
+            !ReadImageFilter(reader, &inner, depth + 1)) {
+          return false;
+        }
+        *filter = std::make_shared<DlLocalMatrixImageFilter>(
+            matrix, inner ? inner->shared() : nullptr);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  bool ReadMaskFilter(RecordReader& reader,
+                      std::shared_ptr<DlMaskFilter>* filter) {
+    uint32_t raw_type;
+    if (!reader.Read(&raw_type)) {
+      return false;
+    }
+    if (raw_type == kNoIndex) {
+      *filter = nullptr;
+      return true;
+    }
+    switch (static_cast<DlMaskFilterType>(raw_type)) {
+      case DlMaskFilterType::kBlur: {
+        DlBlurStyle style;
+        SkScalar sigma;
+        bool respect_ctm;
+        if (!reader.ReadEnum(&style, DlBlurStyle::kInner) ||
+            !reader.Read(&sigma) || !reader.ReadBool(&respect_ctm)) {
+          return false;
+        }
+        *filter = std::make_shared<DlBlurMaskFilter>(style, sigma, respect_ctm);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  bool ReadPathEffect(RecordReader& reader,
+                      std::shared_ptr<DlPathEffect>* effect) {
+    uint32_t raw_type;
+    if (!reader.Read(&raw_type)) {
+      return false;
+    }
+    if (raw_type == kNoIndex) {
+      *effect = nullptr;
+      return true;
+    }
+    switch (static_cast<DlPathEffectType>(raw_type)) {
+      case DlPathEffectType::kDash: {
+        SkScalar phase;
+        uint32_t count;
+        const SkScalar* intervals;
+        if (!reader.Read(&phase) || !reader.Read(&count) ||
+            count > kMaxCount ||
+            !reader.ReadArray(&intervals, count)) {
+          return false;
+        }
+        *effect = DlDashPathEffect::Make(intervals, count, phase);
+        return *effect != nullptr;
+      }
+      default:
+        return false;
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DisplayListReader);
+};
+
+}  // namespace
+
+std::unique_ptr<fml::Mapping> DlSerialization::Serialize(
+    const DisplayList& display_list) {
+  DisplayListWriter writer;
+  return writer.Write(display_list);
+}
+
+sk_sp<DisplayList> DlSerialization::Deserialize(
+    const std::shared_ptr<const fml::Mapping>& mapping) {
+  if (!mapping) {
+    return nullptr;
+  }
+  DisplayListReader reader(mapping);
+  return reader.Read();
+}
+
+}  // namespace flutter
@@ -0,0 +1,74 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_DL_SERIALIZATION_H_
+#define FLUTTER_DISPLAY_LIST_DL_SERIALIZATION_H_
+
+#include <memory>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Converts DisplayLists to and from a compact, versioned binary
+///             format that can be written to disk and memory mapped back in,
+///             for example to record production frames for offline replay
+///             or to ship pre-recorded static pictures with an application.
+///
+/// The format is a header followed by a stream of 4-byte aligned records
+/// that mirror the |DlOpReceiver| methods. Objects that ops refer to by
+/// pointer - nested DisplayLists, images, shared image filters and text
+/// blobs, and the typefaces of the text blobs - are written once as
+/// definition records and then referenced by index, so a DisplayList that is
+/// drawn many times, or a font used by many text runs, is only stored once.
+///
+/// Deserialization validates every record and replays it into a
+/// |DisplayListBuilder|. Large payloads are read in place: image pixels are
+/// borrowed from the mapping rather than copied, and point, vertex and atlas
+/// arrays are handed to the builder directly from the mapping.
+///
+/// The format stores values in the native byte order and is only intended
+/// to be read back by an engine built from the same version of the format.
+///
+class DlSerialization {
+ public:
+  /// The version of the binary format. Data written with any other version
+  /// is rejected by |Deserialize|.
+  static constexpr uint32_t kVersion = 2;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes |display_list| along with every DisplayList,
+  ///             image, image filter and text blob it references.
+  ///
+  /// @return     The serialized bytes, or nullptr if the DisplayList refers
+  ///             to content with no portable representation: texture backed
+  ///             images, Impeller text frames, runtime effects and 3D
+  ///             scenes.
+  ///
+  static std::unique_ptr<fml::Mapping> Serialize(
+      const DisplayList& display_list);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reconstructs a DisplayList previously written by
+  ///             |Serialize|.
+  ///
+  /// Images in the returned DisplayList keep |mapping| alive for as long as
+  /// they reference its pixels. The mapping must be at least 4-byte aligned,
+  /// which holds for file mappings and heap allocations.
+  ///
+  /// @return     The DisplayList, or nullptr if |mapping| was written with a
+  ///             different format version or is malformed.
+  ///
+  static sk_sp<DisplayList> Deserialize(
+      const std::shared_ptr<const fml::Mapping>& mapping);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(DlSerialization);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_DL_SERIALIZATION_H_
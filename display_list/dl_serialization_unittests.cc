@@ -0,0 +1,278 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/dl_serialization.h"
+#include "flutter/display_list/geometry/dl_rtree.h"
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/display_list/utils/dl_receiver_utils.h"
+#include "flutter/testing/testing.h"
+
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+DlOpReceiver& DisplayListBuilderTestingAccessor(DisplayListBuilder& builder);
+
+namespace testing {
+
+namespace {
+
+sk_sp<DisplayList> RoundTrip(const DisplayList& display_list) {
+  std::shared_ptr<const fml::Mapping> mapping =
+      DlSerialization::Serialize(display_list);
+  if (!mapping) {
+    return nullptr;
+  }
+  return DlSerialization::Deserialize(mapping);
+}
+
+bool MappingsAreEqual(const fml::Mapping& a, const fml::Mapping& b) {
+  return a.GetSize() == b.GetSize() &&
+         memcmp(a.GetMapping(), b.GetMapping(), a.GetSize()) == 0;
+}
+
+sk_sp<DlImage> MakeRasterImage(int width, int height) {
+  sk_sp<SkSurface> surface =
+      SkSurfaces::Raster(SkImageInfo::MakeN32Premul(width, height));
+  surface->getCanvas()->clear(SK_ColorMAGENTA);
+  return DlImage::Make(surface->makeImageSnapshot());
+}
+
+// Records the image of the last drawImage call.
+class ImageCapturer final : public IgnoreAttributeDispatchHelper,
+                            public IgnoreClipDispatchHelper,
+                            public IgnoreTransformDispatchHelper,
+                            public IgnoreDrawDispatchHelper {
+ public:
+  void drawImage(const sk_sp<DlImage> image,
+                 const SkPoint point,
+                 DlImageSampling sampling,
+                 bool render_with_attributes) override {
+    image_ = image;
+  }
+
+  sk_sp<DlImage> image() const { return image_; }
+
+ private:
+  sk_sp<DlImage> image_;
+};
+
+// An image that claims to live on the GPU.
+class TextureBackedImage final : public DlImage {
+ public:
+  sk_sp<SkImage> skia_image() const override { return nullptr; }
+  std::shared_ptr<impeller::Texture> impeller_texture() const override {
+    return nullptr;
+  }
+  bool isOpaque() const override { return true; }
+  bool isTextureBacked() const override { return true; }
+  bool isUIThreadSafe() const override { return true; }
+  SkISize dimensions() const override { return SkISize::Make(10, 10); }
+  size_t GetApproximateByteSize() const override { return sizeof(*this); }
+};
+
+}  // namespace
+
+TEST(DisplayListSerialization, SingleOpDisplayListsRoundTrip) {
+  for (auto& group : CreateAllGroups()) {
+    // These ops hold images or text blobs that are compared by identity, so
+    // the reconstructed objects are never Equals() to the originals.
+    bool compares_identity =
+        group.op_name == "SetColorSource" || group.op_name == "DrawImage" ||
+        group.op_name == "DrawImageRect" || group.op_name == "DrawImageNine" ||
+        group.op_name == "DrawAtlas" || group.op_name == "DrawTextBlob";
+    for (size_t i = 0; i < group.variants.size(); i++) {
+      DisplayListBuilder builder;
+      group.variants[i].Invoke(DisplayListBuilderTestingAccessor(builder));
+      sk_sp<DisplayList> dl = builder.Build();
+      auto desc = group.op_name + "(variant " + std::to_string(i + 1) + ")";
+
+      std::shared_ptr<const fml::Mapping> mapping =
+          DlSerialization::Serialize(*dl);
+      ASSERT_NE(mapping, nullptr) << desc;
+      sk_sp<DisplayList> copy = DlSerialization::Deserialize(mapping);
+      ASSERT_NE(copy, nullptr) << desc;
+
+      ASSERT_EQ(copy->op_count(false), dl->op_count(false)) << desc;
+      ASSERT_EQ(copy->bytes(false), dl->bytes(false)) << desc;
+      ASSERT_EQ(copy->op_count(true), dl->op_count(true)) << desc;
+      ASSERT_EQ(copy->bytes(true), dl->bytes(true)) << desc;
+      ASSERT_EQ(copy->bounds(), dl->bounds()) << desc;
+      if (!compares_identity) {
+        ASSERT_TRUE(copy->Equals(*dl)) << desc;
+      }
+
+      // Typeface serialization isn't guaranteed to be stable, but everything
+      // else must serialize to the same bytes the second time around.
+      if (group.op_name != "DrawTextBlob") {
+        std::unique_ptr<fml::Mapping> second =
+            DlSerialization::Serialize(*copy);
+        ASSERT_NE(second, nullptr) << desc;
+        ASSERT_TRUE(MappingsAreEqual(*mapping, *second)) << desc;
+      }
+    }
+  }
+}
+
+TEST(DisplayListSerialization, PreservesRTree) {
+  DisplayListBuilder builder(/*prepare_rtree=*/true);
+  builder.DrawRect(SkRect::MakeLTRB(10, 10, 20, 20), DlPaint());
+  builder.DrawRect(SkRect::MakeLTRB(50, 50, 60, 60), DlPaint());
+  sk_sp<DisplayList> dl = builder.Build();
+  ASSERT_TRUE(dl->has_rtree());
+
+  sk_sp<DisplayList> copy = RoundTrip(*dl);
+  ASSERT_NE(copy, nullptr);
+  EXPECT_TRUE(copy->has_rtree());
+  EXPECT_EQ(copy->rtree()->region().getRects(),
+            dl->rtree()->region().getRects());
+}
+
+TEST(DisplayListSerialization, SharedDisplayListIsWrittenOnce) {
+  DisplayListBuilder nested_builder;
+  for (int i = 0; i < 100; i++) {
+    nested_builder.DrawCircle(SkPoint::Make(i, i), 5, DlPaint());
+  }
+  sk_sp<DisplayList> nested = nested_builder.Build();
+  std::unique_ptr<fml::Mapping> nested_mapping =
+      DlSerialization::Serialize(*nested);
+  ASSERT_NE(nested_mapping, nullptr);
+
+  DisplayListBuilder once_builder;
+  once_builder.DrawDisplayList(nested);
+  std::unique_ptr<fml::Mapping> once =
+      DlSerialization::Serialize(*once_builder.Build());
+  ASSERT_NE(once, nullptr);
+
+  DisplayListBuilder twice_builder;
+  twice_builder.DrawDisplayList(nested);
+  twice_builder.Translate(100, 100);
+  twice_builder.DrawDisplayList(nested);
+  sk_sp<DisplayList> twice = twice_builder.Build();
+  std::unique_ptr<fml::Mapping> twice_mapping =
+      DlSerialization::Serialize(*twice);
+  ASSERT_NE(twice_mapping, nullptr);
+
+  EXPECT_LT(twice_mapping->GetSize() - once->GetSize(),
+            nested_mapping->GetSize());
+
+  sk_sp<DisplayList> copy = RoundTrip(*twice);
+  ASSERT_NE(copy, nullptr);
+  EXPECT_TRUE(copy->Equals(*twice));
+}
+
+TEST(DisplayListSerialization, SharedTypefaceIsWrittenOnce) {
+  SkFont font = CreateTestFontOfSize(20);
+  sk_sp<SkTextBlob> first = SkTextBlob::MakeFromString("First", font);
+  sk_sp<SkTextBlob> second = SkTextBlob::MakeFromString("Second", font);
+  DisplayListBuilder builder;
+  builder.DrawTextBlob(first, 10, 10, DlPaint());
+  builder.DrawTextBlob(second, 10, 40, DlPaint());
+  sk_sp<DisplayList> dl = builder.Build();
+
+  std::unique_ptr<fml::Mapping> mapping = DlSerialization::Serialize(*dl);
+  ASSERT_NE(mapping, nullptr);
+
+  // The start of the font file is stored once, in the typeface definition.
+  sk_sp<SkData> font_data = OpenFixtureAsSkData("Roboto-Regular.ttf");
+  ASSERT_NE(font_data, nullptr);
+  ASSERT_GE(font_data->size(), 256u);
+  const uint8_t* font_start = font_data->bytes();
+  const uint8_t* begin = mapping->GetMapping();
+  const uint8_t* end = begin + mapping->GetSize();
+  size_t copies = 0;
+  for (const uint8_t* found = std::search(begin, end, font_start,
+                                          font_start + 256);
+       found != end;
+       found = std::search(found + 1, end, font_start, font_start + 256)) {
+    copies++;
+  }
+  EXPECT_EQ(copies, 1u);
+
+  EXPECT_NE(RoundTrip(*dl), nullptr);
+}
+
+TEST(DisplayListSerialization, ImagePixelsAreBorrowedFromMapping) {
+  sk_sp<DlImage> image = MakeRasterImage(32, 32);
+  DisplayListBuilder builder;
+  builder.DrawImage(image, SkPoint::Make(0, 0), DlImageSampling::kLinear);
+  sk_sp<DisplayList> dl = builder.Build();
+
+  std::shared_ptr<const fml::Mapping> mapping =
+      DlSerialization::Serialize(*dl);
+  ASSERT_NE(mapping, nullptr);
+  sk_sp<DisplayList> copy = DlSerialization::Deserialize(mapping);
+  ASSERT_NE(copy, nullptr);
+
+  ImageCapturer capturer;
+  copy->Dispatch(capturer);
+  ASSERT_NE(capturer.image(), nullptr);
+  SkPixmap pixmap;
+  ASSERT_TRUE(capturer.image()->skia_image()->peekPixels(&pixmap));
+  const uint8_t* pixels = static_cast<const uint8_t*>(pixmap.addr());
+  const uint8_t* start = mapping->GetMapping();
+  EXPECT_GE(pixels, start);
+  EXPECT_LE(pixels + pixmap.computeByteSize(), start + mapping->GetSize());
+
+  // The image keeps the mapping alive.
+  mapping.reset();
+  EXPECT_EQ(pixmap.getColor(16, 16), SK_ColorMAGENTA);
+}
+
+TEST(DisplayListSerialization, RejectsOtherVersions) {
+  DisplayListBuilder builder;
+  builder.DrawRect(SkRect::MakeLTRB(10, 10, 20, 20), DlPaint());
+  std::unique_ptr<fml::Mapping> mapping =
+      DlSerialization::Serialize(*builder.Build());
+  ASSERT_NE(mapping, nullptr);
+
+  // The version follows the 4 byte magic number.
+  std::vector<uint8_t> bytes(mapping->GetMapping(),
+                             mapping->GetMapping() + mapping->GetSize());
+  uint32_t version = DlSerialization::kVersion + 1;
+  memcpy(bytes.data() + 4, &version, sizeof(version));
+  EXPECT_EQ(DlSerialization::Deserialize(
+                std::make_shared<fml::DataMapping>(std::move(bytes))),
+            nullptr);
+}
+
+TEST(DisplayListSerialization, RejectsTruncatedData) {
+  DisplayListBuilder nested_builder;
+  nested_builder.DrawOval(SkRect::MakeLTRB(0, 0, 10, 20), DlPaint());
+  DisplayListBuilder builder;
+  builder.DrawImage(MakeRasterImage(4, 4), SkPoint::Make(5, 5),
+                    DlImageSampling::kNearestNeighbor);
+  builder.DrawDisplayList(nested_builder.Build());
+  builder.DrawPath(SkPath::Circle(50, 50, 10), DlPaint());
+  std::unique_ptr<fml::Mapping> mapping =
+      DlSerialization::Serialize(*builder.Build());
+  ASSERT_NE(mapping, nullptr);
+
+  for (size_t size = 0; size < mapping->GetSize(); size++) {
+    std::vector<uint8_t> bytes(mapping->GetMapping(),
+                               mapping->GetMapping() + size);
+    EXPECT_EQ(DlSerialization::Deserialize(
+                  std::make_shared<fml::DataMapping>(std::move(bytes))),
+              nullptr)
+        << "truncated to " << size << " bytes";
+  }
+}
+
+TEST(DisplayListSerialization, TextureBackedImagesAreNotSerialized) {
+  DisplayListBuilder builder;
+  builder.DrawImage(sk_make_sp<TextureBackedImage>(), SkPoint::Make(0, 0),
+                    DlImageSampling::kLinear);
+  EXPECT_EQ(DlSerialization::Serialize(*builder.Build()), nullptr);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,163 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/skia/dl_sk_tiled_rasterizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "flutter/display_list/skia/dl_sk_dispatcher.h"
+#include "flutter/display_list/utils/dl_receiver_utils.h"
+#include "flutter/fml/trace_event.h"
+
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+
+namespace {
+
+// Looks for a saveLayer with a backdrop filter, including in nested
+// DisplayLists.
+class BackdropFilterFinder final : public IgnoreAttributeDispatchHelper,
+                                   public IgnoreClipDispatchHelper,
+                                   public IgnoreTransformDispatchHelper,
+                                   public IgnoreDrawDispatchHelper {
+ public:
+  static bool Find(const DisplayList& display_list) {
+    BackdropFilterFinder finder;
+    display_list.Dispatch(finder);
+    return finder.found_;
+  }
+
+  void saveLayer(const SkRect* bounds,
+                 const SaveLayerOptions options,
+                 const DlImageFilter* backdrop) override {
+    found_ = found_ || backdrop != nullptr;
+  }
+
+  void drawDisplayList(const sk_sp<DisplayList> display_list,
+                       SkScalar opacity) override {
+    if (!found_) {
+      display_list->Dispatch(*this);
+    }
+  }
+
+ private:
+  bool found_ = false;
+};
+
+// The bands of a surface that are being rendered, shared between the
+// calling thread and the worker tasks.
+struct BandRenderingState {
+  BandRenderingState(sk_sp<DisplayList> display_list,
+                     const SkPixmap& pixmap,
+                     const SkSurfaceProps& props,
+                     size_t band_count)
+      : display_list(std::move(display_list)),
+        pixmap(pixmap),
+        props(props),
+        band_count(band_count),
+        remaining(band_count) {}
+
+  const sk_sp<DisplayList> display_list;
+  const SkPixmap pixmap;
+  const SkSurfaceProps props;
+  const size_t band_count;
+  std::atomic_size_t next_band = 0u;
+  std::atomic_size_t remaining;
+  std::mutex mutex;
+  std::condition_variable done;
+};
+
+SkIRect GetBandBounds(const BandRenderingState& state, size_t band) {
+  int height = state.pixmap.height();
+  int top = static_cast<int>(height * band / state.band_count);
+  int bottom = static_cast<int>(height * (band + 1) / state.band_count);
+  return SkIRect::MakeLTRB(0, top, state.pixmap.width(), bottom);
+}
+
+void RenderBand(const BandRenderingState& state, size_t band) {
+  TRACE_EVENT0("flutter", "DlSkTiledRasterizer::RenderBand");
+  SkIRect bounds = GetBandBounds(state, band);
+  SkPixmap band_pixmap;
+  if (!state.pixmap.extractSubset(&band_pixmap, bounds)) {
+    return;
+  }
+  std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+      band_pixmap.info(), band_pixmap.writable_addr(), band_pixmap.rowBytes(),
+      &state.props);
+  if (!canvas) {
+    return;
+  }
+  canvas->translate(0, -bounds.top());
+  DlSkCanvasDispatcher dispatcher(canvas.get());
+  state.display_list->Dispatch(dispatcher, bounds);
+}
+
+// Renders bands until there are none left to claim.
+void RenderClaimedBands(BandRenderingState& state) {
+  while (true) {
+    size_t band = state.next_band.fetch_add(1u);
+    if (band >= state.band_count) {
+      return;
+    }
+    RenderBand(state, band);
+    if (state.remaining.fetch_sub(1u) == 1u) {
+      std::scoped_lock lock(state.mutex);
+      state.done.notify_all();
+    }
+  }
+}
+
+}  // namespace
+
+DlSkTiledRasterizer::DlSkTiledRasterizer(
+    std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+    size_t max_bands)
+    : worker_task_runner_(std::move(worker_task_runner)),
+      max_bands_(std::max<size_t>(max_bands, 1u)) {}
+
+DlSkTiledRasterizer::~DlSkTiledRasterizer() = default;
+
+size_t DlSkTiledRasterizer::Rasterize(const sk_sp<DisplayList>& display_list,
+                                      SkSurface* surface) {
+  TRACE_EVENT0("flutter", "DlSkTiledRasterizer::Rasterize");
+  FML_DCHECK(display_list);
+  FML_DCHECK(surface);
+
+  // The bands write to the pixels directly, so any snapshot of the surface
+  // must be detached from them first.
+  surface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+  SkPixmap pixmap;
+  if (!surface->peekPixels(&pixmap)) {
+    return 0;
+  }
+
+  size_t band_count = 1;
+  if (worker_task_runner_ && !BackdropFilterFinder::Find(*display_list)) {
+    size_t max_bands_for_height =
+        std::max(pixmap.height() / kMinBandHeight, 1);
+    band_count = std::min(max_bands_, max_bands_for_height);
+  }
+
+  auto state = std::make_shared<BandRenderingState>(
+      display_list, pixmap, surface->props(), band_count);
+
+  // The worker tasks hold on to the state, as they may only start after all
+  // bands have been claimed.
+  for (size_t i = 1; i < band_count; i++) {
+    worker_task_runner_->PostTask(
+        [state]() { RenderClaimedBands(*state); });
+  }
+  RenderClaimedBands(*state);
+
+  std::unique_lock lock(state->mutex);
+  state->done.wait(lock, [&state]() { return state->remaining == 0u; });
+  return band_count;
+}
+
+}  // namespace flutter
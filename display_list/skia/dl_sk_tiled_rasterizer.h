@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_DISPLAY_LIST_SKIA_DL_SK_TILED_RASTERIZER_H_
+#define FLUTTER_DISPLAY_LIST_SKIA_DL_SK_TILED_RASTERIZER_H_
+
+#include <memory>
+
+#include "flutter/display_list/display_list.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Rasterizes a DisplayList into a CPU backed surface by splitting
+///             the surface into horizontal bands and rendering the bands in
+///             parallel on a pool of worker threads.
+///
+/// Each band replays only the ops that intersect it, which is cheap when
+/// the DisplayList was built with an RTree. The calling thread renders a
+/// band itself and waits for the others to complete, so |Rasterize|
+/// returns with the whole surface painted.
+///
+/// Backdrop filters read the pixels that surround them, which a band doesn't
+/// have, so DisplayLists that use them are rasterized as a single band.
+///
+class DlSkTiledRasterizer {
+ public:
+  /// Bands are never made shorter than this many rows, so that small
+  /// surfaces aren't split into bands whose setup outweighs their drawing.
+  static constexpr int kMinBandHeight = 64;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a rasterizer that splits surfaces into at most
+  ///             |max_bands| bands.
+  ///
+  /// @param[in]  worker_task_runner  The task runner of the worker threads.
+  ///                                 If null, every band is rendered on the
+  ///                                 calling thread.
+  /// @param[in]  max_bands           The maximum number of bands, typically
+  ///                                 one more than the number of workers.
+  ///
+  DlSkTiledRasterizer(
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
+      size_t max_bands);
+
+  ~DlSkTiledRasterizer();
+
+  size_t max_bands() const { return max_bands_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draws |display_list| over the current contents of |surface|,
+  ///             which must be backed by CPU memory.
+  ///
+  /// @return     The number of bands that were rendered, or 0 if |surface|
+  ///             has no directly accessible pixels.
+  ///
+  size_t Rasterize(const sk_sp<DisplayList>& display_list, SkSurface* surface);
+
+ private:
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  const size_t max_bands_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DlSkTiledRasterizer);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_DISPLAY_LIST_SKIA_DL_SK_TILED_RASTERIZER_H_
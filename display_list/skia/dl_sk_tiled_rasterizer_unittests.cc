@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/display_list/skia/dl_sk_tiled_rasterizer.h"
+
+#include <cstring>
+
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/effects/dl_image_filter.h"
+#include "flutter/display_list/skia/dl_sk_canvas.h"
+#include "flutter/testing/testing.h"
+
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr int kWidth = 200;
+constexpr int kHeight = 300;
+
+sk_sp<SkSurface> MakeSurface() {
+  return SkSurfaces::Raster(SkImageInfo::MakeN32Premul(kWidth, kHeight));
+}
+
+// Draws shapes that straddle the band boundaries.
+sk_sp<DisplayList> MakeDisplayList(bool prepare_rtree) {
+  DisplayListBuilder builder(prepare_rtree);
+  builder.DrawColor(DlColor::kWhite(), DlBlendMode::kSrc);
+  DlPaint paint;
+  for (int i = 0; i < 20; i++) {
+    paint.setColor(DlColor(0xFF000000 | (i * 0x0B0D07)));
+    builder.DrawRect(SkRect::MakeXYWH(i * 9, i * 14, 30, 47), paint);
+  }
+  SkPath path;
+  path.moveTo(10, 10);
+  path.lineTo(190, 150);
+  path.lineTo(30, 290);
+  path.close();
+  paint.setColor(DlColor::kBlue().withAlpha(0x80));
+  builder.DrawPath(path, paint);
+  return builder.Build();
+}
+
+bool PixelsAreEqual(SkSurface* a, SkSurface* b) {
+  SkPixmap pixmap_a, pixmap_b;
+  if (!a->peekPixels(&pixmap_a) || !b->peekPixels(&pixmap_b)) {
+    return false;
+  }
+  for (int y = 0; y < kHeight; y++) {
+    if (memcmp(pixmap_a.addr(0, y), pixmap_b.addr(0, y),
+               pixmap_a.info().minRowBytes()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(DlSkTiledRasterizer, MatchesUntiledRendering) {
+  auto loop = fml::ConcurrentMessageLoop::Create(3);
+  DlSkTiledRasterizer rasterizer(loop->GetTaskRunner(), 4);
+
+  for (bool prepare_rtree : {false, true}) {
+    sk_sp<DisplayList> display_list = MakeDisplayList(prepare_rtree);
+
+    sk_sp<SkSurface> expected = MakeSurface();
+    DlSkCanvasAdapter(expected->getCanvas()).DrawDisplayList(display_list);
+
+    sk_sp<SkSurface> actual = MakeSurface();
+    EXPECT_EQ(rasterizer.Rasterize(display_list, actual.get()), 4u);
+    EXPECT_TRUE(PixelsAreEqual(expected.get(), actual.get()))
+        << "prepare_rtree: " << prepare_rtree;
+  }
+}
+
+TEST(DlSkTiledRasterizer, LimitsBandsToSurfaceHeight) {
+  auto loop = fml::ConcurrentMessageLoop::Create(3);
+  DlSkTiledRasterizer rasterizer(loop->GetTaskRunner(), 16);
+
+  sk_sp<SkSurface> surface = MakeSurface();
+  EXPECT_EQ(rasterizer.Rasterize(MakeDisplayList(true), surface.get()),
+            static_cast<size_t>(kHeight / DlSkTiledRasterizer::kMinBandHeight));
+}
+
+TEST(DlSkTiledRasterizer, RendersOnCallingThreadWithoutWorkers) {
+  DlSkTiledRasterizer rasterizer(nullptr, 4);
+  sk_sp<DisplayList> display_list = MakeDisplayList(true);
+
+  sk_sp<SkSurface> expected = MakeSurface();
+  DlSkCanvasAdapter(expected->getCanvas()).DrawDisplayList(display_list);
+
+  sk_sp<SkSurface> actual = MakeSurface();
+  EXPECT_EQ(rasterizer.Rasterize(display_list, actual.get()), 1u);
+  EXPECT_TRUE(PixelsAreEqual(expected.get(), actual.get()));
+}
+
+TEST(DlSkTiledRasterizer, BackdropFiltersAreNotTiled) {
+  auto loop = fml::ConcurrentMessageLoop::Create(3);
+  DlSkTiledRasterizer rasterizer(loop->GetTaskRunner(), 4);
+
+  DisplayListBuilder nested_builder;
+  DlBlurImageFilter backdrop(5, 5, DlTileMode::kClamp);
+  nested_builder.SaveLayer(nullptr, nullptr, &backdrop);
+  nested_builder.Restore();
+
+  DisplayListBuilder builder;
+  builder.DrawDisplayList(MakeDisplayList(false));
+  builder.DrawDisplayList(nested_builder.Build());
+
+  sk_sp<SkSurface> surface = MakeSurface();
+  EXPECT_EQ(rasterizer.Rasterize(builder.Build(), surface.get()), 1u);
+}
+
+TEST(DlSkTiledRasterizer, RejectsSurfacesWithoutPixels) {
+  DlSkTiledRasterizer rasterizer(nullptr, 4);
+  sk_sp<SkSurface> surface = SkSurfaces::Null(kWidth, kHeight);
+  EXPECT_EQ(rasterizer.Rasterize(MakeDisplayList(false), surface.get()), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
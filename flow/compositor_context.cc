@@ -40,7 +40,7 @@ std::optional<SkRect> FrameDamage::ComputeClipRect(
 
     damage_ =
         context.ComputeDamage(additional_damage_, horizontal_clip_alignment_,
-                              vertical_clip_alignment_);
+                              vertical_clip_alignment_, merge_policy_);
     return SkRect::Make(damage_->buffer_damage);
   }
   return std::nullopt;
@@ -49,12 +49,18 @@ std::optional<SkRect> FrameDamage::ComputeClipRect(
 CompositorContext::CompositorContext()
     : texture_registry_(std::make_shared<TextureRegistry>()),
       raster_time_(fixed_refresh_rate_updater_),
-      ui_time_(fixed_refresh_rate_updater_) {}
+      ui_time_(fixed_refresh_rate_updater_) {
+  raster_cache_.SetUnusedEntryRetentionFrames(
+      RasterCacheUtil::kDefaultUnusedEntryRetentionFrames);
+}
 
 CompositorContext::CompositorContext(Stopwatch::RefreshRateUpdater& updater)
     : texture_registry_(std::make_shared<TextureRegistry>()),
       raster_time_(updater),
-      ui_time_(updater) {}
+      ui_time_(updater) {
+  raster_cache_.SetUnusedEntryRetentionFrames(
+      RasterCacheUtil::kDefaultUnusedEntryRetentionFrames);
+}
 
 CompositorContext::~CompositorContext() = default;
 
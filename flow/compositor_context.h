@@ -67,6 +67,11 @@ class FrameDamage {
     vertical_clip_alignment_ = vertical;
   }
 
+  // Specifies how damage is split into multiple disjoint rectangles.
+  void SetDamageMergePolicy(const DamageMergePolicy& merge_policy) {
+    merge_policy_ = merge_policy;
+  }
+
   // Calculates clip rect for current rasterization. This is diff of layer tree
   // and previous layer tree + any additional provided damage.
   // If previous layer tree is not specified, clip rect will be nullopt,
@@ -88,6 +93,17 @@ class FrameDamage {
                : std::nullopt;
   }
 
+  // See Damage::frame_damage_rects.
+  std::vector<SkIRect> GetFrameDamageRects() const {
+    return damage_ ? damage_->frame_damage_rects : std::vector<SkIRect>();
+  }
+
+  // See Damage::buffer_damage_rects.
+  std::vector<SkIRect> GetBufferDamageRects() const {
+    return (damage_ && !ignore_damage_) ? damage_->buffer_damage_rects
+                                        : std::vector<SkIRect>();
+  }
+
   // Remove reported buffer_damage to inform clients that a partial repaint
   // should not be performed on this frame.
   // frame_damage is required to correctly track accumulated damage for
@@ -100,6 +116,7 @@ class FrameDamage {
   const LayerTree* prev_layer_tree_ = nullptr;
   int vertical_clip_alignment_ = 1;
   int horizontal_clip_alignment_ = 1;
+  DamageMergePolicy merge_policy_;
   bool ignore_damage_ = false;
 };
 
@@ -3,10 +3,21 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/diff_context.h"
+
+#include <limits>
+
 #include "flutter/flow/layers/layer.h"
 
 namespace flutter {
 
+namespace {
+
+// Damage consisting of more disjoint rectangles than this is reported as a
+// single bounding rectangle.
+constexpr size_t kMaxDamageRectsToMerge = 64;
+
+}  // namespace
+
 DiffContext::DiffContext(SkISize frame_size,
                          PaintRegionMap& this_frame_paint_region_map,
                          const PaintRegionMap& last_frame_paint_region_map,
@@ -109,13 +120,21 @@ void DiffContext::AlignRect(SkIRect& rect,
   rect = SkIRect::MakeLTRB(left, top, right, bottom);
 }
 
-Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
-                                  int horizontal_clip_alignment,
-                                  int vertical_clip_alignment) const {
+Damage DiffContext::ComputeDamage(
+    const SkIRect& accumulated_buffer_damage,
+    int horizontal_clip_alignment,
+    int vertical_clip_alignment,
+    const DamageMergePolicy& merge_policy) const {
   SkRect buffer_damage = SkRect::Make(accumulated_buffer_damage);
   buffer_damage.join(damage_);
   SkRect frame_damage(damage_);
 
+  std::vector<SkIRect> frame_rects;
+  frame_rects.reserve(damage_rects_.size());
+  for (const auto& r : damage_rects_) {
+    frame_rects.push_back(r.roundOut());
+  }
+
   for (const auto& r : readbacks_) {
     SkRect paint_rect = SkRect::Make(r.paint_rect);
     SkRect readback_rect = SkRect::Make(r.readback_rect);
@@ -127,9 +146,14 @@ Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
       frame_damage.join(paint_rect);
       buffer_damage.join(readback_rect);
       buffer_damage.join(paint_rect);
+      frame_rects.push_back(r.readback_rect);
+      frame_rects.push_back(r.paint_rect);
     }
   }
 
+  std::vector<SkIRect> buffer_rects(frame_rects);
+  buffer_rects.push_back(accumulated_buffer_damage);
+
   Damage res;
   buffer_damage.roundOut(&res.buffer_damage);
   frame_damage.roundOut(&res.frame_damage);
@@ -144,9 +168,109 @@ Damage DiffContext::ComputeDamage(const SkIRect& accumulated_buffer_damage,
     AlignRect(res.frame_damage, horizontal_clip_alignment,
               vertical_clip_alignment);
   }
+
+  res.frame_damage_rects =
+      ComputeDamageRects(frame_rects, res.frame_damage,
+                         horizontal_clip_alignment, vertical_clip_alignment,
+                         merge_policy);
+  res.buffer_damage_rects =
+      ComputeDamageRects(buffer_rects, res.buffer_damage,
+                         horizontal_clip_alignment, vertical_clip_alignment,
+                         merge_policy);
   return res;
 }
 
+std::vector<SkIRect> DiffContext::ComputeDamageRects(
+    const std::vector<SkIRect>& rects,
+    const SkIRect& bounds,
+    int horizontal_clip_alignment,
+    int vertical_clip_alignment,
+    const DamageMergePolicy& merge_policy) const {
+  if (bounds.isEmpty()) {
+    return {};
+  }
+  if (merge_policy.max_rects <= 1) {
+    return {bounds};
+  }
+
+  std::vector<SkIRect> clipped_rects;
+  clipped_rects.reserve(rects.size());
+  for (const auto& r : rects) {
+    SkIRect clipped;
+    if (clipped.intersect(r, bounds)) {
+      // Bounds are already aligned, so aligned rects remain within bounds.
+      if (horizontal_clip_alignment > 1 || vertical_clip_alignment > 1) {
+        AlignRect(clipped, horizontal_clip_alignment, vertical_clip_alignment);
+      }
+      clipped_rects.push_back(clipped);
+    }
+  }
+
+  std::vector<SkIRect> result = DlRegion(clipped_rects).getRects(true);
+
+  // Merging is quadratic in number of rectangles for each step; Collapse
+  // pathologically fragmented damage to bounds instead.
+  if (result.size() > kMaxDamageRectsToMerge) {
+    return {bounds};
+  }
+
+  auto area = [](const SkIRect& r) {
+    return static_cast<int64_t>(r.width()) * r.height();
+  };
+
+  // Greedily merge the pair of rectangles that introduces the least amount of
+  // undamaged area until the result fits within max_rects and there is no
+  // pair left that can be merged cheaply.
+  while (result.size() > 1) {
+    size_t best_i = 0;
+    size_t best_j = 0;
+    int64_t best_waste = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < result.size(); ++i) {
+      for (size_t j = i + 1; j < result.size(); ++j) {
+        SkIRect joined = result[i];
+        joined.join(result[j]);
+        int64_t waste = area(joined) - area(result[i]) - area(result[j]);
+        if (waste < best_waste) {
+          best_waste = waste;
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+
+    bool over_limit = result.size() > merge_policy.max_rects;
+    int64_t pair_area = area(result[best_i]) + area(result[best_j]);
+    if (!over_limit &&
+        best_waste > merge_policy.merge_waste_ratio * pair_area) {
+      break;
+    }
+
+    SkIRect merged = result[best_i];
+    merged.join(result[best_j]);
+    result.erase(result.begin() + best_j);
+    result.erase(result.begin() + best_i);
+
+    // The merged rectangle may now overlap other rectangles; absorb them to
+    // keep the result disjoint.
+    bool absorbed = true;
+    while (absorbed) {
+      absorbed = false;
+      for (auto it = result.begin(); it != result.end();) {
+        if (SkIRect::Intersects(merged, *it)) {
+          merged.join(*it);
+          it = result.erase(it);
+          absorbed = true;
+        } else {
+          ++it;
+        }
+      }
+    }
+    result.push_back(merged);
+  }
+
+  return result;
+}
+
 SkRect DiffContext::MapRect(const SkRect& rect) {
   SkRect mapped_rect(rect);
   clip_tracker_.mapRect(&mapped_rect);
@@ -240,12 +364,16 @@ PaintRegion DiffContext::CurrentSubtreeRegion() const {
 void DiffContext::AddDamage(const PaintRegion& damage) {
   FML_DCHECK(damage.is_valid());
   for (const auto& r : damage) {
-    damage_.join(r);
+    AddDamage(r);
   }
 }
 
 void DiffContext::AddDamage(const SkRect& rect) {
+  if (rect.isEmpty()) {
+    return;
+  }
   damage_.join(rect);
+  damage_rects_.push_back(rect);
 }
 
 void DiffContext::SetLayerPaintRegion(const Layer* layer,
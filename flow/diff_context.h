@@ -10,6 +10,7 @@
 #include <optional>
 #include <vector>
 #include "display_list/utils/dl_matrix_clip_tracker.h"
+#include "flutter/display_list/geometry/dl_region.h"
 #include "flutter/flow/paint_region.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkM44.h"
@@ -35,6 +36,29 @@ struct Damage {
   // upfront may be useful for tile based GPUs.
   // Corresponds to "buffer damage" from EGL_KHR_partial_update.
   SkIRect buffer_damage;
+
+  // Disjoint rectangles covering frame_damage. All rectangles are contained
+  // within frame_damage. The number of rectangles is limited by
+  // DamageMergePolicy::max_rects; with the default policy this contains at
+  // most frame_damage itself.
+  std::vector<SkIRect> frame_damage_rects;
+
+  // Disjoint rectangles covering buffer_damage, see frame_damage_rects.
+  std::vector<SkIRect> buffer_damage_rects;
+};
+
+// Controls how damage rectangles are combined when computing Damage.
+struct DamageMergePolicy {
+  // Maximum number of disjoint rectangles reported in
+  // Damage::frame_damage_rects and Damage::buffer_damage_rects. Value of 1
+  // (default) collapses all damage into a single bounding rectangle.
+  size_t max_rects = 1;
+
+  // Two rectangles are merged even when under max_rects if the area of their
+  // bounding rectangle exceeds the sum of their areas by no more than this
+  // fraction. Merging nearby rectangles reduces per-rectangle overhead
+  // (scissor changes, blits) at the cost of repainting some undamaged pixels.
+  float merge_waste_ratio = 0.25f;
 };
 
 // Layer Unique Id to PaintRegion
@@ -143,9 +167,14 @@ class DiffContext {
   //
   // clip_alignment controls the alignment of resulting frame and surface
   // damage.
-  Damage ComputeDamage(const SkIRect& additional_damage,
-                       int horizontal_clip_alignment = 0,
-                       int vertical_clip_alignment = 0) const;
+  //
+  // merge_policy controls how many disjoint rectangles are reported alongside
+  // the bounding frame and buffer damage.
+  Damage ComputeDamage(
+      const SkIRect& additional_damage,
+      int horizontal_clip_alignment = 0,
+      int vertical_clip_alignment = 0,
+      const DamageMergePolicy& merge_policy = DamageMergePolicy()) const;
 
   // Adds the region to current damage. Used for removed layers, where instead
   // of diffing the layer its paint region is direcly added to damage.
@@ -249,6 +278,10 @@ class DiffContext {
 
   SkRect damage_ = SkRect::MakeEmpty();
 
+  // Individual damage rectangles accumulated for current frame, in screen
+  // coordinates. damage_ is the bounds of these rectangles.
+  std::vector<SkRect> damage_rects_;
+
   PaintRegionMap& this_frame_paint_region_map_;
   const PaintRegionMap& last_frame_paint_region_map_;
   bool has_raster_cache_;
@@ -260,6 +293,15 @@ class DiffContext {
                  int horizontal_alignment,
                  int vertical_clip_alignment) const;
 
+  // Converts rects to disjoint rectangles contained within bounds and merges
+  // them according to merge_policy.
+  std::vector<SkIRect> ComputeDamageRects(
+      const std::vector<SkIRect>& rects,
+      const SkIRect& bounds,
+      int horizontal_clip_alignment,
+      int vertical_clip_alignment,
+      const DamageMergePolicy& merge_policy) const;
+
   struct Readback {
     // Index of rects_ entry that this readback belongs to. Used to
     // determine if subtree has any readback
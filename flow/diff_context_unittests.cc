@@ -32,5 +32,104 @@ TEST_F(DiffContextTest, ClipAlignment) {
   EXPECT_EQ(damage.buffer_damage, SkIRect::MakeLTRB(16, 16, 64, 64));
 }
 
+TEST_F(DiffContextTest, SingleDamageRectByDefault) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20))));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(900, 900, 910, 910))));
+  auto damage = DiffLayerTree(t1, MockLayerTree());
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 910, 910));
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], damage.frame_damage);
+  ASSERT_EQ(damage.buffer_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.buffer_damage_rects[0], damage.buffer_damage);
+}
+
+TEST_F(DiffContextTest, MultipleDamageRects) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20))));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(900, 900, 910, 910))));
+
+  DamageMergePolicy policy;
+  policy.max_rects = 4;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 0, 0,
+                              true, false, policy);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(10, 10, 910, 910));
+  ASSERT_EQ(damage.frame_damage_rects.size(), 2u);
+  EXPECT_EQ(DlRegion(damage.frame_damage_rects).getRects(),
+            DlRegion(std::vector<SkIRect>{SkIRect::MakeLTRB(10, 10, 20, 20),
+                                          SkIRect::MakeLTRB(900, 900, 910,
+                                                            910)})
+                .getRects());
+
+  damage = DiffLayerTree(t1, MockLayerTree(),
+                         SkIRect::MakeLTRB(500, 10, 510, 20), 0, 0, true, false,
+                         policy);
+  EXPECT_EQ(damage.frame_damage_rects.size(), 2u);
+  EXPECT_EQ(damage.buffer_damage_rects.size(), 3u);
+}
+
+TEST_F(DiffContextTest, DamageRectsAreLimited) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20))));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(30, 10, 40, 20))));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(900, 900, 910, 910))));
+
+  DamageMergePolicy policy;
+  policy.max_rects = 2;
+  policy.merge_waste_ratio = 0;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 0, 0,
+                              true, false, policy);
+  ASSERT_EQ(damage.frame_damage_rects.size(), 2u);
+  // The two nearby rectangles are merged, the distant one is kept separate.
+  EXPECT_EQ(DlRegion(damage.frame_damage_rects).getRects(),
+            DlRegion(std::vector<SkIRect>{SkIRect::MakeLTRB(10, 10, 40, 20),
+                                          SkIRect::MakeLTRB(900, 900, 910,
+                                                            910)})
+                .getRects());
+  EXPECT_FALSE(SkIRect::Intersects(damage.frame_damage_rects[0],
+                                   damage.frame_damage_rects[1]));
+}
+
+TEST_F(DiffContextTest, NearbyDamageRectsAreMerged) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(10, 10, 20, 20))));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(21, 10, 31, 20))));
+
+  DamageMergePolicy policy;
+  policy.max_rects = 4;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 0, 0,
+                              true, false, policy);
+  ASSERT_EQ(damage.frame_damage_rects.size(), 1u);
+  EXPECT_EQ(damage.frame_damage_rects[0], SkIRect::MakeLTRB(10, 10, 31, 20));
+}
+
+TEST_F(DiffContextTest, DamageRectsAreAligned) {
+  MockLayerTree t1;
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(30, 30, 50, 50))));
+  t1.root()->Add(CreateDisplayListLayer(
+      CreateDisplayList(SkRect::MakeLTRB(830, 830, 850, 850))));
+
+  DamageMergePolicy policy;
+  policy.max_rects = 4;
+  auto damage = DiffLayerTree(t1, MockLayerTree(), SkIRect::MakeEmpty(), 16,
+                              16, true, false, policy);
+  EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(16, 16, 864, 864));
+  EXPECT_EQ(DlRegion(damage.frame_damage_rects).getRects(),
+            DlRegion(std::vector<SkIRect>{SkIRect::MakeLTRB(16, 16, 64, 64),
+                                          SkIRect::MakeLTRB(816, 816, 864,
+                                                            864)})
+                .getRects());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -22,7 +22,8 @@ static bool IsDisplayListWorthRasterizing(
     const DisplayList* display_list,
     bool will_change,
     bool is_complex,
-    DisplayListComplexityCalculator* complexity_calculator) {
+    DisplayListComplexityCalculator* complexity_calculator,
+    unsigned int* complexity_score) {
   if (will_change) {
     // If the display list is going to change in the future, there is no point
     // in doing to extra work to rasterize.
@@ -42,8 +43,8 @@ static bool IsDisplayListWorthRasterizing(
     return true;
   }
 
-  unsigned int complexity_score = complexity_calculator->Compute(display_list);
-  return complexity_calculator->ShouldBeCached(complexity_score);
+  *complexity_score = complexity_calculator->Compute(display_list);
+  return complexity_calculator->ShouldBeCached(*complexity_score);
 }
 
 DisplayListRasterCacheItem::DisplayListRasterCacheItem(
@@ -71,13 +72,15 @@ std::unique_ptr<DisplayListRasterCacheItem> DisplayListRasterCacheItem::Make(
 void DisplayListRasterCacheItem::PrerollSetup(PrerollContext* context,
                                               const SkMatrix& matrix) {
   cache_state_ = CacheState::kNone;
+  complexity_score_ = 0;
   DisplayListComplexityCalculator* complexity_calculator =
       context->gr_context ? DisplayListComplexityCalculator::GetForBackend(
                                 context->gr_context->backend())
                           : DisplayListComplexityCalculator::GetForSoftware();
 
   if (!IsDisplayListWorthRasterizing(display_list(), will_change_, is_complex_,
-                                     complexity_calculator)) {
+                                     complexity_calculator,
+                                     &complexity_score_)) {
     // We only deal with display lists that are worthy of rasterization.
     return;
   }
@@ -164,6 +167,8 @@ bool DisplayListRasterCacheItem::TryToPrepareRasterCache(
       .matrix             = transformation_matrix_,
       .logical_rect       = bounds,
       .flow_type          = flow_type,
+      .rasterization_cost = complexity_score_,
+      .device_cull_rect   = context.state_stack.device_cull_rect(),
       // clang-format on
   };
   return context.raster_cache->UpdateCacheEntry(
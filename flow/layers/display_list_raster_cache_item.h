@@ -55,6 +55,9 @@ class DisplayListRasterCacheItem : public RasterCacheItem {
   SkPoint offset_;
   bool is_complex_;
   bool will_change_;
+  // The complexity score of the display list, or 0 if it was not computed
+  // because the display list was hinted to be complex.
+  unsigned int complexity_score_ = 0;
 };
 
 }  // namespace flutter
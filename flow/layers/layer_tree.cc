@@ -4,10 +4,13 @@
 
 #include "flutter/flow/layers/layer_tree.h"
 
+#include <unordered_map>
+
 #include "flutter/display_list/skia/dl_sk_canvas.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/frame_timings.h"
 #include "flutter/flow/layer_snapshot_store.h"
+#include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/flow/raster_cache.h"
@@ -40,6 +43,11 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
     return false;
   }
 
+  if (recording_) {
+    raster_cache_items_.clear();
+    return recording_needs_readback_;
+  }
+
   SkColorSpace* color_space = GetColorSpace(frame.canvas());
   frame.context().raster_cache().SetCheckboardCacheImages(
       checkerboard_raster_cache_images_);
@@ -107,6 +115,13 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
     return;
   }
 
+  if (recording_) {
+    if (frame.canvas()) {
+      frame.canvas()->DrawDisplayList(recording_);
+    }
+    return;
+  }
+
   LayerStateStack state_stack;
 
   // DrawCheckerboard is not supported on Impeller.
@@ -214,4 +229,111 @@ sk_sp<DisplayList> LayerTree::Flatten(
   return builder.Build();
 }
 
+// Whether painting the layer and its children depends on nothing but the
+// layers. See |LayerTree::Record|.
+static bool CanRecordLayer(const Layer* layer) {
+  if (layer->as_texture_layer() || layer->as_platform_view_layer() ||
+      layer->as_performance_overlay_layer()) {
+    return false;
+  }
+  if (const ContainerLayer* container = layer->as_container_layer()) {
+    for (const auto& child : container->layers()) {
+      if (!CanRecordLayer(child.get())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool LayerTree::ShareLayers(const std::vector<LayerTree*>& layer_trees) {
+  // The index of the first layer tree each layer was found in.
+  std::unordered_map<const Layer*, size_t> owners;
+  std::vector<const Layer*> pending;
+  for (size_t i = 0; i < layer_trees.size(); i++) {
+    pending.push_back(layer_trees[i]->root_layer());
+    while (!pending.empty()) {
+      const Layer* layer = pending.back();
+      pending.pop_back();
+      if (!layer) {
+        continue;
+      }
+      auto [owner, inserted] = owners.try_emplace(layer, i);
+      if (!inserted) {
+        if (owner->second != i) {
+          return true;
+        }
+        // Already visited as part of this layer tree.
+        continue;
+      }
+      if (const ContainerLayer* container = layer->as_container_layer()) {
+        for (const auto& child : container->layers()) {
+          pending.push_back(child.get());
+        }
+      }
+    }
+  }
+  return false;
+}
+
+bool LayerTree::Record() {
+  TRACE_EVENT0("flutter", "LayerTree::Record");
+
+  // Checkerboarding and leaf layer tracing need the layers to be painted into
+  // the frame.
+  if (!root_layer_ || checkerboard_offscreen_layers_ ||
+      enable_leaf_layer_tracing_ || !CanRecordLayer(root_layer_.get())) {
+    return false;
+  }
+
+  SkRect bounds = SkRect::Make(frame_size_);
+  DisplayListBuilder builder(bounds);
+
+  const FixedRefreshRateStopwatch unused_stopwatch;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(bounds);
+  raster_cache_items_.clear();
+  PrerollContext preroll_context{
+      // clang-format off
+      .raster_cache                  = nullptr,
+      .gr_context                    = nullptr,
+      .view_embedder                 = nullptr,
+      .state_stack                   = preroll_state_stack,
+      .dst_color_space               = nullptr,
+      .surface_needs_readback        = false,
+      .raster_time                   = unused_stopwatch,
+      .ui_time                       = unused_stopwatch,
+      .texture_registry              = nullptr,
+      // clang-format on
+  };
+
+  LayerStateStack paint_state_stack;
+  paint_state_stack.set_delegate(&builder);
+  PaintContext paint_context = {
+      // clang-format off
+      .state_stack                   = paint_state_stack,
+      .canvas                        = &builder,
+      .gr_context                    = nullptr,
+      .dst_color_space               = nullptr,
+      .view_embedder                 = nullptr,
+      .raster_time                   = unused_stopwatch,
+      .ui_time                       = unused_stopwatch,
+      .texture_registry              = nullptr,
+      .raster_cache                  = nullptr,
+      .layer_snapshot_store          = nullptr,
+      .enable_leaf_layer_tracing     = false,
+      // clang-format on
+  };
+
+  root_layer_->Preroll(&preroll_context);
+  if (root_layer_->needs_painting(paint_context)) {
+    root_layer_->Paint(paint_context);
+  }
+
+  recording_needs_readback_ = preroll_context.surface_needs_readback;
+  recording_ = builder.Build();
+  return true;
+}
+
 }  // namespace flutter
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "flutter/common/graphics/texture.h"
 #include "flutter/flow/compositor_context.h"
@@ -54,6 +55,26 @@ class LayerTree {
       const std::shared_ptr<TextureRegistry>& texture_registry = nullptr,
       GrDirectContext* gr_context = nullptr);
 
+  // Prerolls and paints the layer tree into a display list, which |Preroll|
+  // and |Paint| then use instead of walking the layers.
+  //
+  // Recording needs no frame and uses neither the raster cache nor the
+  // texture registry, so unlike |Preroll| and |Paint| it may run on any
+  // thread. Layer trees with layers whose painting depends on state owned by
+  // the raster thread, which are texture, platform view and performance
+  // overlay layers, are not recorded.
+  //
+  // Returns whether the layer tree was recorded.
+  bool Record();
+
+  bool is_recorded() const { return recording_ != nullptr; }
+
+  // Whether a layer is part of more than one of the layer trees, such as an
+  // engine layer that is retained in the scenes of two views. Recording
+  // prerolls the layers, so such layer trees must not be recorded
+  // concurrently.
+  static bool ShareLayers(const std::vector<LayerTree*>& layer_trees);
+
   Layer* root_layer() const { return root_layer_.get(); }
   const SkISize& frame_size() const { return frame_size_; }
 
@@ -93,6 +114,9 @@ class LayerTree {
 
   std::vector<RasterCacheItem*> raster_cache_items_;
 
+  sk_sp<DisplayList> recording_;
+  bool recording_needs_readback_ = false;
+
   FML_DISALLOW_COPY_AND_ASSIGN(LayerTree);
 };
 
@@ -7,6 +7,7 @@
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
@@ -138,6 +139,84 @@ TEST_F(LayerTreeTest, Multiple) {
                                                child_path2, child_paint2}}}));
 }
 
+TEST_F(LayerTreeTest, RecordedTreeIsPaintedFromRecording) {
+  const SkRect child_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const DlPaint child_paint = DlPaint(DlColor::kCyan());
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  auto layer_tree = BuildLayerTree(LayerTree::Config{
+      .root_layer = layer,
+  });
+  EXPECT_FALSE(layer_tree->is_recorded());
+  ASSERT_TRUE(layer_tree->Record());
+  EXPECT_TRUE(layer_tree->is_recorded());
+  EXPECT_EQ(mock_layer->paint_bounds(), child_bounds);
+  EXPECT_EQ(layer->paint_bounds(), child_bounds);
+
+  EXPECT_FALSE(layer_tree->Preroll(frame()));
+  layer_tree->Paint(frame());
+
+  DisplayListBuilder expected_builder(SkRect::MakeWH(64, 64));
+  expected_builder.DrawPath(child_path, child_paint);
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawDisplayListData{expected_builder.Build(),
+                                                   SK_Scalar1}}}));
+}
+
+TEST_F(LayerTreeTest, TreesWithTexturesAreNotRecorded) {
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(std::make_shared<MockLayer>(SkPath().addRect(5, 6, 20, 21)));
+  layer->Add(std::make_shared<TextureLayer>(SkPoint::Make(1, 2),
+                                            SkSize::Make(10, 10), 0, false,
+                                            DlImageSampling::kNearestNeighbor));
+
+  auto layer_tree = BuildLayerTree(LayerTree::Config{
+      .root_layer = layer,
+  });
+  EXPECT_FALSE(layer_tree->Record());
+  EXPECT_FALSE(layer_tree->is_recorded());
+}
+
+TEST_F(LayerTreeTest, TreesWithCheckerboardingAreNotRecorded) {
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(std::make_shared<MockLayer>(SkPath().addRect(5, 6, 20, 21)));
+
+  auto layer_tree = BuildLayerTree(LayerTree::Config{
+      .root_layer = layer,
+      .checkerboard_offscreen_layers = true,
+  });
+  EXPECT_FALSE(layer_tree->Record());
+}
+
+TEST_F(LayerTreeTest, TreesWithRetainedLayersShareLayers) {
+  auto retained_layer = std::make_shared<ContainerLayer>();
+  retained_layer->Add(
+      std::make_shared<MockLayer>(SkPath().addRect(5, 6, 20, 21)));
+
+  auto layer1 = std::make_shared<ContainerLayer>();
+  layer1->Add(retained_layer);
+  auto layer_tree1 = BuildLayerTree(LayerTree::Config{
+      .root_layer = layer1,
+  });
+  auto layer2 = std::make_shared<ContainerLayer>();
+  layer2->Add(std::make_shared<MockLayer>(SkPath().addRect(5, 6, 20, 21)));
+  auto layer_tree2 = BuildLayerTree(LayerTree::Config{
+      .root_layer = layer2,
+  });
+  EXPECT_FALSE(LayerTree::ShareLayers({layer_tree1.get(), layer_tree2.get()}));
+
+  // A layer used twice within one layer tree is only prerolled by one thread.
+  layer1->Add(retained_layer);
+  EXPECT_FALSE(LayerTree::ShareLayers({layer_tree1.get(), layer_tree2.get()}));
+
+  layer2->Add(retained_layer);
+  EXPECT_TRUE(LayerTree::ShareLayers({layer_tree1.get(), layer_tree2.get()}));
+}
+
 TEST_F(LayerTreeTest, MultipleWithEmpty) {
   const SkPath child_path1 = SkPath().addRect(5.0f, 6.0f, 20.5f, 21.5f);
   const DlPaint child_paint1 = DlPaint(DlColor::kMidGrey());
@@ -4,7 +4,9 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <vector>
 
 #include "flutter/common/constants.h"
@@ -28,10 +30,10 @@ RasterCacheResult::RasterCacheResult(sk_sp<DlImage> image,
                                      const SkRect& logical_rect,
                                      const char* type,
                                      sk_sp<const DlRTree> rtree)
-    : image_(std::move(image)),
-      logical_rect_(logical_rect),
+    : logical_rect_(logical_rect),
       flow_(type),
-      rtree_(std::move(rtree)) {}
+      rtree_(std::move(rtree)),
+      image_(std::move(image)) {}
 
 void RasterCacheResult::draw(DlCanvas& canvas,
                              const DlPaint* paint,
@@ -68,6 +70,205 @@ void RasterCacheResult::draw(DlCanvas& canvas,
   }
 }
 
+// The whole pixels of the translation of |matrix|, which move tiles without
+// changing their contents.
+static SkIPoint GetTileOffset(const SkMatrix& matrix) {
+  return SkIPoint::Make(SkScalarFloorToInt(matrix.getTranslateX()),
+                        SkScalarFloorToInt(matrix.getTranslateY()));
+}
+
+// The matrix that maps contents drawn with |matrix| to tile space.
+static SkMatrix GetTileMatrix(const SkMatrix& matrix) {
+  SkIPoint offset = GetTileOffset(matrix);
+  SkMatrix tile_matrix = matrix;
+  tile_matrix.postTranslate(-offset.fX, -offset.fY);
+  return tile_matrix;
+}
+
+// Maps |device_rect| from the device space of |matrix| to tile space.
+static SkRect ToTileSpace(const SkRect& device_rect, const SkMatrix& matrix) {
+  SkIPoint offset = GetTileOffset(matrix);
+  return device_rect.makeOffset(-offset.fX, -offset.fY);
+}
+
+static int GetTileCount(int size) {
+  return (size + RasterCacheUtil::kTileSize - 1) / RasterCacheUtil::kTileSize;
+}
+
+TiledRasterCacheResult::TiledRasterCacheResult(const SkRect& logical_rect,
+                                               const SkMatrix& matrix,
+                                               const char* type,
+                                               sk_sp<const DlRTree> rtree)
+    : RasterCacheResult(nullptr, logical_rect, type, std::move(rtree)),
+      matrix_(GetTileMatrix(matrix)),
+      tile_bounds_(
+          RasterCacheUtil::GetRoundedOutDeviceBounds(logical_rect, matrix_)
+              .round()),
+      columns_(GetTileCount(tile_bounds_.width())),
+      rows_(GetTileCount(tile_bounds_.height())),
+      tiles_(columns_ * rows_) {}
+
+bool TiledRasterCacheResult::MatchesMatrix(const SkMatrix& matrix) const {
+  // Removing the whole pixels of a large translation loses a little precision,
+  // which must not cause the tiles to be rebuilt on every frame.
+  SkMatrix tile_matrix = GetTileMatrix(matrix);
+  for (int i = 0; i < 9; i++) {
+    if (!SkScalarNearlyEqual(tile_matrix[i], matrix_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+SkIRect TiledRasterCacheResult::GetTileBounds(size_t index) const {
+  int column = index % columns_;
+  int row = index / columns_;
+  SkIRect tile_bounds = SkIRect::MakeXYWH(
+      tile_bounds_.fLeft + column * RasterCacheUtil::kTileSize,
+      tile_bounds_.fTop + row * RasterCacheUtil::kTileSize,
+      RasterCacheUtil::kTileSize, RasterCacheUtil::kTileSize);
+  // The last column and row of tiles may be smaller.
+  tile_bounds.intersect(tile_bounds_);
+  return tile_bounds;
+}
+
+std::vector<size_t> TiledRasterCacheResult::GetTilesIntersecting(
+    const SkRect& rect) const {
+  std::vector<size_t> indices;
+  SkIRect bounds = rect.roundOut();
+  if (!bounds.intersect(tile_bounds_)) {
+    return indices;
+  }
+  int left = tile_bounds_.fLeft;
+  int top = tile_bounds_.fTop;
+  int first_column = (bounds.fLeft - left) / RasterCacheUtil::kTileSize;
+  int last_column = (bounds.fRight - 1 - left) / RasterCacheUtil::kTileSize;
+  int first_row = (bounds.fTop - top) / RasterCacheUtil::kTileSize;
+  int last_row = (bounds.fBottom - 1 - top) / RasterCacheUtil::kTileSize;
+  for (int row = first_row; row <= last_row; row++) {
+    for (int column = first_column; column <= last_column; column++) {
+      indices.push_back(row * columns_ + column);
+    }
+  }
+  return indices;
+}
+
+bool TiledRasterCacheResult::IsTileEmpty(size_t index) const {
+  SkMatrix inverse;
+  if (!rtree_ || !matrix_.invert(&inverse)) {
+    return false;
+  }
+  SkRect tile_bounds = SkRect::Make(GetTileBounds(index));
+  std::vector<int> results;
+  rtree_->search(inverse.mapRect(tile_bounds), &results);
+  return results.empty();
+}
+
+std::vector<SkIRect> TiledRasterCacheResult::GetMissingTiles(
+    const SkRect& device_rect,
+    const SkMatrix& matrix) const {
+  FML_DCHECK(MatchesMatrix(matrix));
+  std::vector<SkIRect> missing_tiles;
+  for (size_t index : GetTilesIntersecting(ToTileSpace(device_rect, matrix))) {
+    if (!tiles_[index] && !IsTileEmpty(index)) {
+      missing_tiles.push_back(GetTileBounds(index));
+    }
+  }
+  return missing_tiles;
+}
+
+void TiledRasterCacheResult::SetTileImage(const SkIRect& tile_bounds,
+                                          sk_sp<DlImage> image) {
+  auto indices = GetTilesIntersecting(SkRect::Make(tile_bounds));
+  FML_DCHECK(indices.size() == 1u);
+  auto& tile = tiles_[indices.front()];
+  if (tile) {
+    tile_bytes_ -= tile->GetApproximateByteSize();
+  }
+  tile = std::move(image);
+  if (tile) {
+    tile_bytes_ += tile->GetApproximateByteSize();
+  }
+}
+
+void TiledRasterCacheResult::DropTilesOutside(const SkRect& device_rect,
+                                              const SkMatrix& matrix) {
+  SkRect rect = ToTileSpace(device_rect, matrix);
+  for (size_t index = 0; index < tiles_.size(); index++) {
+    auto& tile = tiles_[index];
+    if (tile && !SkRect::Make(GetTileBounds(index)).intersects(rect)) {
+      tile_bytes_ -= tile->GetApproximateByteSize();
+      tile.reset();
+    }
+  }
+}
+
+size_t TiledRasterCacheResult::rasterized_tile_count() const {
+  return std::count_if(tiles_.begin(), tiles_.end(),
+                       [](const sk_sp<DlImage>& tile) { return !!tile; });
+}
+
+bool TiledRasterCacheResult::can_draw(const DlCanvas& canvas) const {
+  auto matrix = RasterCacheUtil::GetIntegralTransCTM(canvas.GetTransform());
+  if (!MatchesMatrix(matrix)) {
+    return false;
+  }
+  for (size_t index : GetTilesIntersecting(
+           ToTileSpace(canvas.GetDestinationClipBounds(), matrix))) {
+    if (!tiles_[index] && !IsTileEmpty(index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TiledRasterCacheResult::draw(DlCanvas& canvas,
+                                  const DlPaint* paint,
+                                  bool preserve_rtree) const {
+  DlAutoCanvasRestore auto_restore(&canvas, true);
+
+  auto matrix = RasterCacheUtil::GetIntegralTransCTM(canvas.GetTransform());
+  FML_DCHECK(MatchesMatrix(matrix));
+  SkIPoint offset = GetTileOffset(matrix);
+  auto visible_tiles = GetTilesIntersecting(
+      ToTileSpace(canvas.GetDestinationClipBounds(), matrix));
+  canvas.TransformReset();
+  flow_.Step();
+  for (size_t index : visible_tiles) {
+    const auto& image = tiles_[index];
+    if (!image) {
+      // The tile is empty.
+      continue;
+    }
+    SkIRect tile_bounds = GetTileBounds(index).makeOffset(offset);
+    if (!preserve_rtree || !rtree_) {
+      canvas.DrawImage(image,
+                       SkPoint::Make(tile_bounds.fLeft, tile_bounds.fTop),
+                       DlImageSampling::kNearestNeighbor, paint);
+      continue;
+    }
+    // See |RasterCacheResult::draw|, only the parts of the tile that are
+    // covered by the R-Tree are drawn.
+    SkMatrix inverse;
+    if (!matrix.invert(&inverse)) {
+      continue;
+    }
+    auto rects = rtree_->region(inverse.mapRect(SkRect::Make(tile_bounds)))
+                     .getRects(true);
+    for (auto rect : rects) {
+      SkRect device_rect = RasterCacheUtil::GetRoundedOutDeviceBounds(
+          SkRect::Make(rect), matrix);
+      if (!device_rect.intersect(SkRect::Make(tile_bounds))) {
+        continue;
+      }
+      SkRect src_rect =
+          device_rect.makeOffset(-tile_bounds.fLeft, -tile_bounds.fTop);
+      canvas.DrawImageRect(image, src_rect, device_rect,
+                           DlImageSampling::kNearestNeighbor, paint);
+    }
+  }
+}
+
 RasterCache::RasterCache(size_t access_threshold,
                          size_t display_list_cache_limit_per_frame)
     : access_threshold_(access_threshold),
@@ -84,6 +285,22 @@ std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
   SkRect dest_rect =
       RasterCacheUtil::GetRoundedOutDeviceBounds(context.logical_rect, matrix);
 
+  auto image = RasterizeRect(context, matrix, dest_rect, draw_function,
+                             draw_checkerboard);
+  if (!image) {
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(
+      image, context.logical_rect, context.flow_type, std::move(rtree));
+}
+
+sk_sp<DlImage> RasterCache::RasterizeRect(
+    const RasterCache::Context& context,
+    const SkMatrix& matrix,
+    const SkRect& dest_rect,
+    const std::function<void(DlCanvas*)>& draw_function,
+    const std::function<void(DlCanvas*, const SkRect& rect)>& draw_checkerboard)
+    const {
   const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
       dest_rect.width(), dest_rect.height(), context.dst_color_space);
 
@@ -108,9 +325,86 @@ std::unique_ptr<RasterCacheResult> RasterCache::Rasterize(
     draw_checkerboard(&canvas, context.logical_rect);
   }
 
-  auto image = DlImage::Make(surface->makeImageSnapshot());
-  return std::make_unique<RasterCacheResult>(
-      image, context.logical_rect, context.flow_type, std::move(rtree));
+  return DlImage::Make(surface->makeImageSnapshot());
+}
+
+static double ComputeValue(unsigned int rasterization_cost, size_t bytes) {
+  return static_cast<double>(rasterization_cost) / std::max<size_t>(bytes, 1);
+}
+
+double RasterCache::GetValue(const Entry& entry) {
+  FML_DCHECK(entry.image);
+  // Tiled images are valued by the size of all of their tiles, like images
+  // that are not tiled, rather than by the size of the tiles that happen to
+  // be rasterized.
+  auto bytes =
+      SkImageInfo::MakeN32Premul(entry.image->image_dimensions())
+          .computeMinByteSize();
+  return ComputeValue(entry.rasterization_cost, bytes);
+}
+
+// Whether the contents are large enough that most of a single image of them
+// would not be visible, or that the image might exceed the maximum texture
+// size.
+static bool ShouldTile(const RasterCache::Context& context,
+                       const SkRect& dest_rect) {
+  if (context.device_cull_rect.isEmpty() ||
+      (dest_rect.width() <= RasterCacheUtil::kTileSize &&
+       dest_rect.height() <= RasterCacheUtil::kTileSize)) {
+    return false;
+  }
+  if (dest_rect.width() > RasterCacheUtil::kMaxUntiledImageDimension ||
+      dest_rect.height() > RasterCacheUtil::kMaxUntiledImageDimension) {
+    return true;
+  }
+  SkRect visible_rect;
+  if (!visible_rect.intersect(dest_rect, context.device_cull_rect)) {
+    return true;
+  }
+  return visible_rect.width() * visible_rect.height() * 2 <
+         dest_rect.width() * dest_rect.height();
+}
+
+bool RasterCache::UpdateTiles(
+    Entry& entry,
+    const Context& context,
+    const std::function<void(DlCanvas*)>& render_function) const {
+  TiledRasterCacheResult* tiles = entry.tiles;
+  FML_DCHECK(tiles);
+  auto matrix = RasterCacheUtil::GetIntegralTransCTM(context.matrix);
+
+  // Tiles next to the visible ones are kept to be ready for scrolling.
+  size_t bytes_before = tiles->image_bytes();
+  SkRect kept_rect = context.device_cull_rect.makeOutset(
+      RasterCacheUtil::kTileSize, RasterCacheUtil::kTileSize);
+  tiles->DropTilesOutside(kept_rect, matrix);
+  cached_bytes_ -= bytes_before - tiles->image_bytes();
+
+  auto missing_tiles = tiles->GetMissingTiles(context.device_cull_rect, matrix);
+  if (missing_tiles.empty()) {
+    return true;
+  }
+  size_t missing_bytes = 0;
+  for (const auto& tile_bounds : missing_tiles) {
+    missing_bytes += SkImageInfo::MakeN32Premul(tile_bounds.size())
+                         .computeMinByteSize();
+  }
+  if (!EvictToFit(missing_bytes, GetValue(entry), &entry)) {
+    return false;
+  }
+
+  void (*func)(DlCanvas*, const SkRect& rect) = DrawCheckerboard;
+  for (const auto& tile_bounds : missing_tiles) {
+    auto image = RasterizeRect(context, tiles->matrix(),
+                               SkRect::Make(tile_bounds), render_function,
+                               func);
+    if (!image) {
+      return false;
+    }
+    cached_bytes_ += image->GetApproximateByteSize();
+    tiles->SetTileImage(tile_bounds, std::move(image));
+  }
+  return true;
 }
 
 bool RasterCache::UpdateCacheEntry(
@@ -120,11 +414,47 @@ bool RasterCache::UpdateCacheEntry(
     sk_sp<const DlRTree> rtree) const {
   RasterCacheKey key = RasterCacheKey(id, raster_cache_context.matrix);
   Entry& entry = cache_[key];
+  if (entry.tiles &&
+      !entry.tiles->MatchesMatrix(RasterCacheUtil::GetIntegralTransCTM(
+          raster_cache_context.matrix))) {
+    // The translation moved the contents by a fraction of a pixel relative to
+    // the tiles, so they are rebuilt.
+    cached_bytes_ -= entry.image->image_bytes();
+    entry.image.reset();
+    entry.tiles = nullptr;
+  }
   if (!entry.image) {
-    void (*func)(DlCanvas*, const SkRect& rect) = DrawCheckerboard;
-    entry.image = Rasterize(raster_cache_context, std::move(rtree),
-                            render_function, func);
-    if (entry.image != nullptr) {
+    entry.rasterization_cost =
+        raster_cache_context.rasterization_cost > 0
+            ? raster_cache_context.rasterization_cost
+            : RasterCacheUtil::kDefaultRasterizationCost;
+    auto matrix =
+        RasterCacheUtil::GetIntegralTransCTM(raster_cache_context.matrix);
+    SkRect dest_rect = RasterCacheUtil::GetRoundedOutDeviceBounds(
+        raster_cache_context.logical_rect, matrix);
+    if (ShouldTile(raster_cache_context, dest_rect)) {
+      // The tiles are rasterized below.
+      auto tiles = std::make_unique<TiledRasterCacheResult>(
+          raster_cache_context.logical_rect, matrix,
+          raster_cache_context.flow_type, std::move(rtree));
+      entry.tiles = tiles.get();
+      entry.image = std::move(tiles);
+    } else {
+      size_t estimated_bytes =
+          SkImageInfo::MakeN32Premul(dest_rect.width(), dest_rect.height())
+              .computeMinByteSize();
+      if (!EvictToFit(estimated_bytes, ComputeValue(entry.rasterization_cost,
+                                                    estimated_bytes))) {
+        // Not worth evicting the images that would make room for this one.
+        return false;
+      }
+      void (*func)(DlCanvas*, const SkRect& rect) = DrawCheckerboard;
+      entry.image = Rasterize(raster_cache_context, std::move(rtree),
+                              render_function, func);
+      if (entry.image == nullptr) {
+        return false;
+      }
+      cached_bytes_ += entry.image->image_bytes();
       switch (id.type()) {
         case RasterCacheKeyType::kDisplayList: {
           display_list_cached_this_frame_++;
@@ -136,7 +466,19 @@ bool RasterCache::UpdateCacheEntry(
       return true;
     }
   }
-  return entry.image != nullptr;
+  if (!entry.tiles) {
+    return true;
+  }
+
+  // Tiles are rasterized as they become visible, so tiled entries are updated
+  // every frame.
+  size_t rasterized_tile_count = entry.tiles->rasterized_tile_count();
+  bool updated = UpdateTiles(entry, raster_cache_context, render_function);
+  if (id.type() == RasterCacheKeyType::kDisplayList &&
+      entry.tiles->rasterized_tile_count() > rasterized_tile_count) {
+    display_list_cached_this_frame_++;
+  }
+  return updated;
 }
 
 RasterCache::CacheInfo RasterCache::MarkSeen(const RasterCacheKeyID& id,
@@ -182,7 +524,7 @@ bool RasterCache::Draw(const RasterCacheKeyID& id,
 
   Entry& entry = it->second;
 
-  if (entry.image) {
+  if (entry.image && entry.image->can_draw(canvas)) {
     entry.image->draw(canvas, paint, preserve_rtree);
     return true;
   }
@@ -199,31 +541,97 @@ void RasterCache::BeginFrame() {
 void RasterCache::UpdateMetrics() {
   for (auto it = cache_.begin(); it != cache_.end(); ++it) {
     Entry& entry = it->second;
-    FML_DCHECK(entry.encountered_this_frame);
     if (entry.image) {
       RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
-      metrics.in_use_count++;
-      metrics.in_use_bytes += entry.image->image_bytes();
+      if (entry.encountered_this_frame) {
+        metrics.in_use_count++;
+        metrics.in_use_bytes += entry.image->image_bytes();
+      } else {
+        metrics.retained_count++;
+        metrics.retained_bytes += entry.image->image_bytes();
+      }
+    }
+    if (entry.encountered_this_frame) {
+      entry.frames_since_encountered = 0;
+    } else {
+      entry.frames_since_encountered++;
     }
     entry.encountered_this_frame = false;
   }
 }
 
+void RasterCache::EvictImage(EntryIterator it, bool over_budget) const {
+  Entry& entry = it->second;
+  FML_DCHECK(entry.image);
+  size_t bytes = entry.image->image_bytes();
+  RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
+  metrics.eviction_count++;
+  metrics.eviction_bytes += bytes;
+  if (over_budget) {
+    metrics.budget_eviction_count++;
+    metrics.budget_eviction_bytes += bytes;
+  }
+  cached_bytes_ -= bytes;
+  entry.image.reset();
+  entry.tiles = nullptr;
+}
+
+bool RasterCache::EvictToFit(size_t bytes,
+                             double value,
+                             const Entry* excluded) const {
+  if (bytes > byte_budget_) {
+    return false;
+  }
+  if (cached_bytes_ + bytes <= byte_budget_) {
+    return true;
+  }
+
+  std::vector<EntryIterator> candidates;
+  size_t evictable_bytes = 0;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    const Entry& entry = it->second;
+    if (entry.image && &entry != excluded &&
+        (!entry.encountered_this_frame || GetValue(entry) < value)) {
+      candidates.push_back(it);
+      evictable_bytes += entry.image->image_bytes();
+    }
+  }
+  if (cached_bytes_ - evictable_bytes + bytes > byte_budget_) {
+    return false;
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](EntryIterator a, EntryIterator b) {
+              if (a->second.encountered_this_frame !=
+                  b->second.encountered_this_frame) {
+                return !a->second.encountered_this_frame;
+              }
+              return GetValue(a->second) < GetValue(b->second);
+            });
+  for (auto it : candidates) {
+    if (cached_bytes_ + bytes <= byte_budget_) {
+      break;
+    }
+    EvictImage(it, true);
+  }
+  return true;
+}
+
 void RasterCache::EvictUnusedCacheEntries() {
-  std::vector<RasterCacheKey::Map<Entry>::iterator> dead;
+  std::vector<EntryIterator> dead;
 
   for (auto it = cache_.begin(); it != cache_.end(); ++it) {
     Entry& entry = it->second;
-    if (!entry.encountered_this_frame) {
+    if (!entry.encountered_this_frame &&
+        (!entry.image ||
+         entry.frames_since_encountered >= unused_entry_retention_frames_)) {
       dead.push_back(it);
     }
   }
 
   for (auto it : dead) {
     if (it->second.image) {
-      RasterCacheMetrics& metrics = GetMetricsForKind(it->first.kind());
-      metrics.eviction_count++;
-      metrics.eviction_bytes += it->second.image->image_bytes();
+      EvictImage(it, false);
     }
     cache_.erase(it);
   }
@@ -236,6 +644,7 @@ void RasterCache::EndFrame() {
 
 void RasterCache::Clear() {
   cache_.clear();
+  cached_bytes_ = 0;
   picture_metrics_ = {};
   layer_metrics_ = {};
 }
@@ -276,6 +685,15 @@ void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
   Clear();
 }
 
+void RasterCache::SetByteBudget(size_t byte_budget) {
+  byte_budget_ = byte_budget;
+  EvictToFit(0, std::numeric_limits<double>::infinity());
+}
+
+void RasterCache::SetUnusedEntryRetentionFrames(size_t frames) {
+  unused_entry_retention_frames_ = frames;
+}
+
 void RasterCache::TraceStatsToTimeline() const {
 #if !FLUTTER_RELEASE
   FML_TRACE_COUNTER(
@@ -311,7 +729,8 @@ size_t RasterCache::EstimatePictureCacheByteSize() const {
   return picture_cache_bytes;
 }
 
-RasterCacheMetrics& RasterCache::GetMetricsForKind(RasterCacheKeyKind kind) {
+RasterCacheMetrics& RasterCache::GetMetricsForKind(
+    RasterCacheKeyKind kind) const {
   switch (kind) {
     case RasterCacheKeyKind::kDisplayListMetrics:
       return picture_metrics_;
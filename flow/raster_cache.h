@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/display_list/dl_canvas.h"
 #include "flutter/flow/raster_cache_key.h"
@@ -37,6 +38,10 @@ class RasterCacheResult {
                     const DlPaint* paint,
                     bool preserve_rtree) const;
 
+  // Whether all of the cached contents that are visible on the canvas are
+  // available to |draw|.
+  virtual bool can_draw(const DlCanvas& canvas) const { return true; }
+
   virtual SkISize image_dimensions() const {
     return image_ ? image_->dimensions() : SkISize::Make(0, 0);
   };
@@ -45,11 +50,92 @@ class RasterCacheResult {
     return image_ ? image_->GetApproximateByteSize() : 0;
   };
 
- private:
-  sk_sp<DlImage> image_;
+ protected:
   SkRect logical_rect_;
   fml::tracing::TraceFlow flow_;
   sk_sp<const DlRTree> rtree_;
+
+ private:
+  sk_sp<DlImage> image_;
+};
+
+/**
+ * A RasterCacheResult for contents that are too large to cache as a single
+ * image. The device bounds of the contents are split into a grid of fixed
+ * size tiles that are only rasterized once they become visible. Tiles that
+ * the R-Tree of the contents shows to be empty are never rasterized.
+ *
+ * Raster cache keys ignore translation, so the same result is drawn while its
+ * contents scroll. Tiles are therefore kept in tile space: the device space of
+ * the matrix the result was created with, less the whole pixels of its
+ * translation. A matrix that only differs from it by whole pixels of
+ * translation draws the same tiles at an offset.
+ */
+class TiledRasterCacheResult : public RasterCacheResult {
+ public:
+  TiledRasterCacheResult(const SkRect& logical_rect,
+                         const SkMatrix& matrix,
+                         const char* type,
+                         sk_sp<const DlRTree> rtree = nullptr);
+
+  void draw(DlCanvas& canvas,
+            const DlPaint* paint,
+            bool preserve_rtree) const override;
+
+  bool can_draw(const DlCanvas& canvas) const override;
+
+  SkISize image_dimensions() const override { return tile_bounds_.size(); }
+
+  int64_t image_bytes() const override { return tile_bytes_; }
+
+  /**
+   * The matrix that tiles are rasterized with, which maps the contents to tile
+   * space.
+   */
+  const SkMatrix& matrix() const { return matrix_; }
+
+  /**
+   * Whether the tiles can be drawn with |matrix|, that is whether it only
+   * differs from the matrix of the tiles by whole pixels of translation.
+   */
+  bool MatchesMatrix(const SkMatrix& matrix) const;
+
+  /**
+   * Return the tile space bounds of the tiles that intersect |device_rect|,
+   * in the device space of |matrix|, and have contents, but that have not been
+   * rasterized yet.
+   */
+  std::vector<SkIRect> GetMissingTiles(const SkRect& device_rect,
+                                       const SkMatrix& matrix) const;
+
+  /**
+   * Set the image of the tile with the given tile space bounds, as returned by
+   * |GetMissingTiles|.
+   */
+  void SetTileImage(const SkIRect& tile_bounds, sk_sp<DlImage> image);
+
+  /**
+   * Drop the images of the tiles that do not intersect |device_rect|, in the
+   * device space of |matrix|.
+   */
+  void DropTilesOutside(const SkRect& device_rect, const SkMatrix& matrix);
+
+  size_t rasterized_tile_count() const;
+
+ private:
+  // The indices of the tiles that intersect |rect| in tile space.
+  std::vector<size_t> GetTilesIntersecting(const SkRect& rect) const;
+
+  SkIRect GetTileBounds(size_t index) const;
+
+  bool IsTileEmpty(size_t index) const;
+
+  const SkMatrix matrix_;
+  const SkIRect tile_bounds_;
+  const int columns_;
+  const int rows_;
+  std::vector<sk_sp<DlImage>> tiles_;
+  int64_t tile_bytes_ = 0;
 };
 
 class Layer;
@@ -68,6 +154,18 @@ struct RasterCacheMetrics {
    */
   size_t eviction_bytes = 0;
 
+  /**
+   * The number of cache entries with images evicted in this frame to keep the
+   * cache within its byte budget. These are included in |eviction_count|.
+   */
+  size_t budget_eviction_count = 0;
+
+  /**
+   * The size of all of the images evicted in this frame to keep the cache
+   * within its byte budget. These are included in |eviction_bytes|.
+   */
+  size_t budget_eviction_bytes = 0;
+
   /**
    * The number of cache entries with images used in this frame.
    */
@@ -78,15 +176,27 @@ struct RasterCacheMetrics {
    */
   size_t in_use_bytes = 0;
 
+  /**
+   * The number of cache entries with images that were not used in this frame
+   * but were kept alive in case they are used again soon.
+   */
+  size_t retained_count = 0;
+
+  /**
+   * The size of all of the images that were not used in this frame but were
+   * kept alive in case they are used again soon.
+   */
+  size_t retained_bytes = 0;
+
   /**
    * The total cache entries that had images during this frame.
    */
-  size_t total_count() const { return in_use_count; }
+  size_t total_count() const { return in_use_count + retained_count; }
 
   /**
    * The size of all of the cached images during this frame.
    */
-  size_t total_bytes() const { return in_use_bytes; }
+  size_t total_bytes() const { return in_use_bytes + retained_bytes; }
 };
 
 /**
@@ -104,14 +214,23 @@ struct RasterCacheMetrics {
  *         encountered by the current frame.
  * - Paint stage
  *   - RasterCache::EvictUnusedCacheEntries
- *       Evict cached images that are no longer used.
+ *       Evict cached images that have not been used for more than
+ *       `unused_entry_retention_frames` frames.
  *   - LayerTree::TryToPrepareRasterCache
- *       Create cache image for each cache entry if it does not exist.
+ *       Create cache image for each cache entry if it does not exist and it
+ *       fits in the byte budget, evicting less valuable images if needed.
  *   - LayerTree::Paint - for each layer in the tree:
  *       If layers or display lists are cached as cached images, the method
  *       `RasterCache::Draw` will be used to draw those cache images.
  *   - RasterCache::EndFrame:
  *       Computes used counts and memory then reports cache metrics.
+ *
+ * The images of the cache are kept within a byte budget. When a new image
+ * does not fit, cached images are evicted in order of increasing value, where
+ * the value of an image is the cost of rasterizing its contents per byte of
+ * the image. Images that were not used in the current frame are always
+ * evicted first, and a new image is only cached if enough images that are
+ * less valuable than it can be evicted to make room for it.
  */
 class RasterCache {
  public:
@@ -121,6 +240,13 @@ class RasterCache {
     const SkMatrix& matrix;
     const SkRect& logical_rect;
     const char* flow_type;
+    // The estimated cost of rasterizing the contents, as computed by a
+    // |DisplayListComplexityCalculator|, or 0 if the cost is unknown.
+    const unsigned int rasterization_cost = 0;
+    // The device area in which the contents are visible. Contents that are
+    // much larger than it are cached as tiles, see |TiledRasterCacheResult|.
+    // If empty, the contents are always cached as a single image.
+    const SkRect device_cull_rect = SkRect::MakeEmpty();
   };
   struct CacheInfo {
     const size_t accesses_since_visible;
@@ -168,6 +294,26 @@ class RasterCache {
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  /**
+   * @brief Set the maximum size in bytes of all of the cached images, evicting
+   * the least valuable images if the cache no longer fits.
+   */
+  void SetByteBudget(size_t byte_budget);
+
+  size_t byte_budget() const { return byte_budget_; }
+
+  /**
+   * @brief Set the number of frames that the image of an entry is kept alive
+   * after the last frame it was encountered in, so that content that is
+   * briefly hidden does not need to be rasterized again. If the number is 0,
+   * images are evicted as soon as a frame does not encounter them.
+   */
+  void SetUnusedEntryRetentionFrames(size_t frames);
+
+  size_t unused_entry_retention_frames() const {
+    return unused_entry_retention_frames_;
+  }
+
   const RasterCacheMetrics& picture_metrics() const { return picture_metrics_; }
   const RasterCacheMetrics& layer_metrics() const { return layer_metrics_; }
 
@@ -185,6 +331,12 @@ class RasterCache {
    */
   size_t GetPictureCachedEntriesCount() const;
 
+  /**
+   * @brief The size in bytes of all of the cached images, which is kept within
+   * the byte budget.
+   */
+  size_t GetCachedBytes() const { return cached_bytes_; }
+
   /**
    * @brief Estimate how much memory is used by picture raster cache entries in
    * bytes.
@@ -251,18 +403,56 @@ class RasterCache {
     bool encountered_this_frame = false;
     bool visible_this_frame = false;
     size_t accesses_since_visible = 0;
+    size_t frames_since_encountered = 0;
+    unsigned int rasterization_cost = 0;
     std::unique_ptr<RasterCacheResult> image;
+    // The |image| if it is tiled, or nullptr.
+    TiledRasterCacheResult* tiles = nullptr;
   };
 
+  using EntryIterator = RasterCacheKey::Map<Entry>::iterator;
+
+  // The cost of rasterizing the contents of an entry per byte of its image.
+  static double GetValue(const Entry& entry);
+
+  // Evicts the least valuable images until |bytes| more fit in the budget.
+  // Only images that were not encountered in this frame or that are valued
+  // below |value| are evicted, and never the image of |excluded|. If that does
+  // not free enough bytes, nothing is evicted and false is returned.
+  bool EvictToFit(size_t bytes,
+                  double value,
+                  const Entry* excluded = nullptr) const;
+
+  // Rasterizes |dest_rect| of the device space of |matrix|.
+  sk_sp<DlImage> RasterizeRect(
+      const RasterCache::Context& context,
+      const SkMatrix& matrix,
+      const SkRect& dest_rect,
+      const std::function<void(DlCanvas*)>& draw_function,
+      const std::function<void(DlCanvas*, const SkRect& rect)>&
+          draw_checkerboard) const;
+
+  // Rasterizes the missing tiles of the entry that are visible in the device
+  // cull rect of the context, and drops the tiles that are far from it.
+  // Returns whether all of the visible tiles are rasterized.
+  bool UpdateTiles(Entry& entry,
+                   const Context& context,
+                   const std::function<void(DlCanvas*)>& render_function) const;
+
+  void EvictImage(EntryIterator it, bool over_budget) const;
+
   void UpdateMetrics();
 
-  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind);
+  RasterCacheMetrics& GetMetricsForKind(RasterCacheKeyKind kind) const;
 
   const size_t access_threshold_;
   const size_t display_list_cache_limit_per_frame_;
+  size_t byte_budget_ = RasterCacheUtil::kDefaultByteBudget;
+  size_t unused_entry_retention_frames_ = 0;
   mutable size_t display_list_cached_this_frame_ = 0;
-  RasterCacheMetrics layer_metrics_;
-  RasterCacheMetrics picture_metrics_;
+  mutable size_t cached_bytes_ = 0;
+  mutable RasterCacheMetrics layer_metrics_;
+  mutable RasterCacheMetrics picture_metrics_;
   mutable RasterCacheKey::Map<Entry> cache_;
   bool checkerboard_images_ = false;
 
@@ -2,9 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <optional>
+#include <variant>
+
 #include "flutter/display_list/benchmarking/dl_complexity.h"
 #include "flutter/display_list/display_list.h"
 #include "flutter/display_list/dl_builder.h"
+#include "flutter/display_list/image/dl_image_skia.h"
 #include "flutter/display_list/testing/dl_test_snippets.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/display_list_layer.h"
@@ -17,6 +22,8 @@
 #include "flutter/flow/testing/mock_raster_cache.h"
 #include "flutter/testing/assertions_skia.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/core/SkPoint.h"
 
@@ -359,6 +366,354 @@ TEST(RasterCache, EvictUnusedCacheEntries) {
   cache.EndFrame();
 }
 
+TEST(RasterCache, UnusedEntriesAreRetainedForRetentionFrames) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetUnusedEntryRetentionFrames(2);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list = GetSampleDisplayList();
+
+  MockCanvas dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item(display_list, SkPoint(), true,
+                                               false);
+
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+    cache.EvictUnusedCacheEntries();
+    RasterCacheItemTryToRasterCache(display_list_item, paint_context);
+    cache.EndFrame();
+  }
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 25624u);
+
+  // The display list is hidden for a frame and then shown again, which draws
+  // it from the cache without rasterizing it again.
+  cache.BeginFrame();
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 25624u);
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().retained_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().retained_bytes, 25624u);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(display_list_item.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().retained_count, 0u);
+
+  // The image is evicted once it has not been used for more than the
+  // retention frames.
+  for (int i = 0; i < 2; i++) {
+    cache.BeginFrame();
+    cache.EvictUnusedCacheEntries();
+    cache.EndFrame();
+    ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 25624u);
+  }
+  cache.BeginFrame();
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 0u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_bytes, 25624u);
+  ASSERT_EQ(cache.picture_metrics().budget_eviction_count, 0u);
+  ASSERT_EQ(cache.GetCachedEntriesCount(), 0u);
+}
+
+TEST(RasterCache, ImagesAreCachedWithinByteBudget) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetUnusedEntryRetentionFrames(3);
+  // Room for a single 80x80 image.
+  cache.SetByteBudget(30000);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto display_list_1 = GetSampleDisplayList();
+  auto display_list_2 = GetSampleDisplayList();
+
+  MockCanvas dummy_canvas(1000, 1000);
+  DlPaint paint;
+
+  LayerStateStack preroll_state_stack;
+  preroll_state_stack.set_preroll_delegate(kGiantRect, matrix);
+  LayerStateStack paint_state_stack;
+  preroll_state_stack.set_delegate(&dummy_canvas);
+
+  FixedRefreshRateStopwatch raster_time;
+  FixedRefreshRateStopwatch ui_time;
+  PrerollContextHolder preroll_context_holder = GetSamplePrerollContextHolder(
+      preroll_state_stack, &cache, &raster_time, &ui_time);
+  PaintContextHolder paint_context_holder = GetSamplePaintContextHolder(
+      paint_state_stack, &cache, &raster_time, &ui_time);
+  auto& preroll_context = preroll_context_holder.preroll_context;
+  auto& paint_context = paint_context_holder.paint_context;
+
+  DisplayListRasterCacheItem display_list_item_1(display_list_1, SkPoint(),
+                                                 true, false);
+  DisplayListRasterCacheItem display_list_item_2(display_list_2, SkPoint(),
+                                                 true, false);
+
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  cache.EndFrame();
+
+  // Both display lists are equally valuable, so the image of the first is not
+  // evicted to make room for the second while both are in use.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_1, preroll_context, matrix);
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_1, paint_context));
+  ASSERT_FALSE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_TRUE(display_list_item_1.Draw(paint_context, &dummy_canvas, &paint));
+  ASSERT_FALSE(display_list_item_2.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+  ASSERT_EQ(cache.GetCachedBytes(), 25624u);
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 0u);
+
+  // An image that is not in use is evicted to make room for one that is.
+  cache.BeginFrame();
+  RasterCacheItemPreroll(display_list_item_2, preroll_context, matrix);
+  cache.EvictUnusedCacheEntries();
+  ASSERT_TRUE(
+      RasterCacheItemTryToRasterCache(display_list_item_2, paint_context));
+  ASSERT_TRUE(display_list_item_2.Draw(paint_context, &dummy_canvas, &paint));
+  cache.EndFrame();
+  ASSERT_EQ(cache.GetCachedBytes(), 25624u);
+  ASSERT_EQ(cache.picture_metrics().in_use_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().retained_count, 0u);
+  ASSERT_EQ(cache.picture_metrics().eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().budget_eviction_count, 1u);
+  ASSERT_EQ(cache.picture_metrics().budget_eviction_bytes, 25624u);
+}
+
+TEST(RasterCache, CheaperImagesAreEvictedFirst) {
+  flutter::RasterCache cache;
+  cache.SetByteBudget(30000);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkRect logical_rect = SkRect::MakeWH(80, 80);
+  auto make_context = [&](unsigned int rasterization_cost) {
+    return RasterCache::Context{
+        // clang-format off
+        .gr_context         = nullptr,
+        .dst_color_space    = nullptr,
+        .matrix             = matrix,
+        .logical_rect       = logical_rect,
+        .flow_type          = "RasterCacheFlow::DisplayList",
+        .rasterization_cost = rasterization_cost,
+        // clang-format on
+    };
+  };
+  auto draw = [](DlCanvas* canvas) {};
+  RasterCacheKeyID cheap_id(1, RasterCacheKeyType::kDisplayList);
+  RasterCacheKeyID expensive_id(2, RasterCacheKeyType::kDisplayList);
+  RasterCacheKeyID cheapest_id(3, RasterCacheKeyType::kDisplayList);
+
+  cache.BeginFrame();
+  cache.MarkSeen(cheap_id, matrix, true);
+  ASSERT_TRUE(cache.UpdateCacheEntry(cheap_id, make_context(1000), draw));
+  cache.MarkSeen(expensive_id, matrix, true);
+  ASSERT_TRUE(cache.UpdateCacheEntry(expensive_id, make_context(100000), draw));
+  cache.MarkSeen(cheapest_id, matrix, true);
+  ASSERT_FALSE(cache.UpdateCacheEntry(cheapest_id, make_context(10), draw));
+
+  MockCanvas dummy_canvas(1000, 1000);
+  ASSERT_FALSE(cache.Draw(cheap_id, dummy_canvas, nullptr));
+  ASSERT_TRUE(cache.Draw(expensive_id, dummy_canvas, nullptr));
+  ASSERT_FALSE(cache.Draw(cheapest_id, dummy_canvas, nullptr));
+  ASSERT_EQ(cache.picture_metrics().budget_eviction_count, 1u);
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_count(), 1u);
+
+  // Images that do not fit in the budget are never cached.
+  cache.BeginFrame();
+  cache.SetByteBudget(10000);
+  ASSERT_EQ(cache.GetCachedBytes(), 0u);
+  ASSERT_FALSE(cache.Draw(expensive_id, dummy_canvas, nullptr));
+  ASSERT_FALSE(
+      cache.UpdateCacheEntry(expensive_id, make_context(100000), draw));
+  cache.EndFrame();
+}
+
+static size_t CountImageDraws(const MockCanvas& canvas) {
+  return std::count_if(
+      canvas.draw_calls().begin(), canvas.draw_calls().end(),
+      [](const MockCanvas::DrawCall& call) {
+        return std::holds_alternative<MockCanvas::DrawImageDataNoPaint>(
+            call.data);
+      });
+}
+
+// Returns the color of the pixel at |point| drawn by the images drawn to
+// |canvas|, or std::nullopt if no image covers it.
+static std::optional<SkColor> GetDrawnImagePixel(const MockCanvas& canvas,
+                                                 const SkIPoint& point) {
+  for (const auto& call : canvas.draw_calls()) {
+    auto* data = std::get_if<MockCanvas::DrawImageDataNoPaint>(&call.data);
+    if (!data) {
+      continue;
+    }
+    SkIRect image_bounds = SkIRect::MakeXYWH(
+        SkScalarRoundToInt(data->x), SkScalarRoundToInt(data->y),
+        data->image->dimensions().width(), data->image->dimensions().height());
+    if (!image_bounds.contains(point.fX, point.fY)) {
+      continue;
+    }
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(1, 1);
+    if (!data->image->skia_image()->readPixels(nullptr, bitmap.pixmap(),
+                                               point.fX - image_bounds.fLeft,
+                                               point.fY - image_bounds.fTop)) {
+      return std::nullopt;
+    }
+    return bitmap.getColor(0, 0);
+  }
+  return std::nullopt;
+}
+
+TEST(RasterCache, LargeDisplayListsAreCachedAsVisibleTiles) {
+  flutter::RasterCache cache;
+
+  // A tall display list, like the contents of a scroll view, with contents in
+  // the first, third and fifth rows of 512x512 tiles.
+  DisplayListBuilder builder(SkRect::MakeWH(1000, 4000),
+                             /*prepare_rtree=*/true);
+  builder.DrawRect(SkRect::MakeXYWH(10, 10, 100, 100), DlPaint());
+  builder.DrawRect(SkRect::MakeXYWH(10, 1100, 100, 100), DlPaint());
+  builder.DrawRect(SkRect::MakeXYWH(10, 2100, 100, 100), DlPaint());
+  auto display_list = builder.Build();
+  RasterCacheKeyID id(display_list->unique_id(),
+                      RasterCacheKeyType::kDisplayList);
+
+  // The display list is larger than a tile in both dimensions, so the tiles
+  // with contents, which are all in the first column, are full tiles.
+  ASSERT_GT(display_list->bounds().width(), RasterCacheUtil::kTileSize);
+  const size_t tile_bytes =
+      sizeof(DlImageSkia) +
+      SkImageInfo::MakeN32Premul(RasterCacheUtil::kTileSize,
+                                 RasterCacheUtil::kTileSize)
+          .computeMinByteSize();
+
+  SkMatrix matrix = SkMatrix::I();
+  auto update_cache_entry = [&](const SkRect& device_cull_rect) {
+    RasterCache::Context r_context = {
+        // clang-format off
+        .gr_context         = nullptr,
+        .dst_color_space    = nullptr,
+        .matrix             = matrix,
+        .logical_rect       = display_list->bounds(),
+        .flow_type          = "RasterCacheFlow::DisplayList",
+        .device_cull_rect   = device_cull_rect,
+        // clang-format on
+    };
+    return cache.UpdateCacheEntry(
+        id, r_context,
+        [&](DlCanvas* canvas) { canvas->DrawDisplayList(display_list); },
+        display_list->rtree());
+  };
+
+  // Only the two visible tiles with contents are rasterized.
+  cache.BeginFrame();
+  cache.MarkSeen(id, matrix, true);
+  ASSERT_TRUE(update_cache_entry(SkRect::MakeWH(1000, 1600)));
+  ASSERT_EQ(cache.GetCachedBytes(), 2u * tile_bytes);
+  {
+    MockCanvas canvas(1000, 1600);
+    ASSERT_TRUE(cache.Draw(id, canvas, nullptr));
+    ASSERT_EQ(CountImageDraws(canvas), 2u);
+  }
+  {
+    // The fifth row of tiles has contents but is not rasterized yet, so the
+    // display list cannot be drawn from the cache.
+    MockCanvas canvas(1000, 3000);
+    ASSERT_FALSE(cache.Draw(id, canvas, nullptr));
+  }
+  cache.EndFrame();
+  ASSERT_EQ(cache.picture_metrics().total_bytes(), 2u * tile_bytes);
+
+  // Scrolling down rasterizes the newly visible tiles and drops the ones that
+  // are far from the visible area.
+  cache.BeginFrame();
+  cache.MarkSeen(id, matrix, true);
+  ASSERT_TRUE(update_cache_entry(SkRect::MakeLTRB(0, 1500, 1000, 3000)));
+  ASSERT_EQ(cache.GetCachedBytes(), 2u * tile_bytes);
+  {
+    MockCanvas canvas(1000, 3000);
+    canvas.ClipRect(SkRect::MakeLTRB(0, 1500, 1000, 3000),
+                    DlCanvas::ClipOp::kIntersect, false);
+    ASSERT_TRUE(cache.Draw(id, canvas, nullptr));
+    ASSERT_EQ(CountImageDraws(canvas), 2u);
+  }
+  {
+    // The first row of tiles was dropped.
+    MockCanvas canvas(1000, 1600);
+    ASSERT_FALSE(cache.Draw(id, canvas, nullptr));
+  }
+  cache.EndFrame();
+
+  // Scrolling by translating the contents reuses the entry, whose key ignores
+  // translation, and the tiles that are already rasterized.
+  matrix = SkMatrix::Translate(0, -1000);
+  cache.BeginFrame();
+  cache.MarkSeen(id, matrix, true);
+  ASSERT_TRUE(update_cache_entry(SkRect::MakeWH(1000, 1600)));
+  ASSERT_EQ(cache.GetCachedBytes(), 2u * tile_bytes);
+  {
+    MockCanvas canvas(1000, 1600);
+    canvas.Translate(0, -1000);
+    ASSERT_TRUE(cache.Draw(id, canvas, nullptr));
+    ASSERT_EQ(CountImageDraws(canvas), 2u);
+    // The rectangles at y=1100 and y=2100 are drawn at y=100 and y=1100.
+    EXPECT_EQ(GetDrawnImagePixel(canvas, {50, 150}), SK_ColorBLACK);
+    EXPECT_EQ(GetDrawnImagePixel(canvas, {50, 1150}), SK_ColorBLACK);
+    EXPECT_EQ(GetDrawnImagePixel(canvas, {50, 50}), SK_ColorTRANSPARENT);
+  }
+  cache.EndFrame();
+
+  // Scrolling back rasterizes the first row of tiles with its own contents.
+  matrix = SkMatrix::I();
+  cache.BeginFrame();
+  cache.MarkSeen(id, matrix, true);
+  ASSERT_TRUE(update_cache_entry(SkRect::MakeWH(1000, 1600)));
+  ASSERT_EQ(cache.GetCachedBytes(), 3u * tile_bytes);
+  {
+    MockCanvas canvas(1000, 1600);
+    ASSERT_TRUE(cache.Draw(id, canvas, nullptr));
+    EXPECT_EQ(GetDrawnImagePixel(canvas, {50, 50}), SK_ColorBLACK);
+    EXPECT_EQ(GetDrawnImagePixel(canvas, {50, 150}), SK_ColorTRANSPARENT);
+    EXPECT_EQ(GetDrawnImagePixel(canvas, {50, 1150}), SK_ColorBLACK);
+  }
+  cache.EndFrame();
+}
+
 TEST(RasterCache, ComputeDeviceRectBasedOnFractionalTranslation) {
   SkRect logical_rect = SkRect::MakeLTRB(0, 0, 300.2, 300.3);
   SkMatrix ctm = SkMatrix::MakeAll(2.0, 0, 0, 0, 2.0, 0, 0, 0, 1);
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_UTIL_H_
 #define FLUTTER_FLOW_RASTER_CACHE_UTIL_H_
 
+#include <cstddef>
+
 #include "flutter/fml/logging.h"
 #include "include/core/SkM44.h"
 #include "include/core/SkMatrix.h"
@@ -19,6 +21,28 @@ struct RasterCacheUtil {
   // the work across multiple frames.
   static constexpr int kDefaultPictureAndDisplayListCacheLimitPerFrame = 3;
 
+  // The default max size of all of the images in the raster cache. When a new
+  // image would exceed the budget, less valuable images are evicted to make
+  // room for it or the new image is not cached.
+  static constexpr size_t kDefaultByteBudget = 64 * 1024 * 1024;
+
+  // The default number of frames that the raster cache keeps an image alive
+  // after it was last used, which is about a sixth of a second at 60Hz.
+  static constexpr size_t kDefaultUnusedEntryRetentionFrames = 10;
+
+  // The rasterization cost assumed for cache entries whose cost is unknown.
+  // This is the complexity score at which the GL and Metal complexity
+  // calculators consider a display list worth caching, roughly 1ms of work.
+  static constexpr unsigned int kDefaultRasterizationCost = 200000;
+
+  // The size in pixels of the tiles of tiled raster cache entries.
+  static constexpr int kTileSize = 512;
+
+  // Raster cache entries with a larger device width or height are always
+  // tiled, as a single image would likely exceed the maximum texture size or
+  // mostly cover content that is not visible.
+  static constexpr int kMaxUntiledImageDimension = 2048;
+
   // The ImageFilterLayer might cache the filtered output of this layer
   // if the layer remains stable (if it is not animating for instance).
   // If the ImageFilterLayer is not the same between rendered frames,
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/display_list/dl_builder.h"
@@ -42,6 +43,12 @@ class SurfaceFrame {
     int vertical_clip_alignment = 1;
     int horizontal_clip_alignment = 1;
 
+    // Maximum number of disjoint damage rectangles the target can consume
+    // when presenting. Values greater than 1 allow distant damaged areas to
+    // be reported separately (SubmitInfo::frame_damage_rects) instead of as
+    // one bounding rectangle.
+    size_t max_damage_rects = 1;
+
     // This is the area of framebuffer that lags behind the front buffer.
     //
     // Correctly providing exiting_damage is necessary for supporting double and
@@ -61,7 +68,8 @@ class SurfaceFrame {
                const SubmitCallback& submit_callback,
                SkISize frame_size,
                std::unique_ptr<GLContextResult> context_result = nullptr,
-               bool display_list_fallback = false);
+               bool display_list_fallback = false,
+               bool prepare_rtree = false);
 
   struct SubmitInfo {
     // The frame damage for frame n is the difference between frame n and
@@ -77,6 +85,14 @@ class SurfaceFrame {
     // Corresponds to EGL_KHR_partial_update
     std::optional<SkIRect> buffer_damage;
 
+    // Disjoint rectangles covering frame_damage. Empty if the frame damage is
+    // unspecified or empty. Contains at most
+    // FramebufferInfo::max_damage_rects entries.
+    std::vector<SkIRect> frame_damage_rects;
+
+    // Disjoint rectangles covering buffer_damage, see frame_damage_rects.
+    std::vector<SkIRect> buffer_damage_rects;
+
     // Time at which this frame is scheduled to be presented. This is a hint
     // that can be passed to the platform to drop queued frames.
     std::optional<fml::TimePoint> presentation_time;
@@ -18,7 +18,8 @@ Damage DiffContextTest::DiffLayerTree(MockLayerTree& layer_tree,
                                       int horizontal_clip_alignment,
                                       int vertical_clip_alignment,
                                       bool use_raster_cache,
-                                      bool impeller_enabled) {
+                                      bool impeller_enabled,
+                                      const DamageMergePolicy& merge_policy) {
   FML_CHECK(layer_tree.size() == old_layer_tree.size());
 
   DiffContext dc(layer_tree.size(), layer_tree.paint_region_map(),
@@ -28,7 +29,7 @@ Damage DiffContextTest::DiffLayerTree(MockLayerTree& layer_tree,
       SkRect::MakeIWH(layer_tree.size().width(), layer_tree.size().height()));
   layer_tree.root()->Diff(&dc, old_layer_tree.root());
   return dc.ComputeDamage(additional_damage, horizontal_clip_alignment,
-                          vertical_clip_alignment);
+                          vertical_clip_alignment, merge_policy);
 }
 
 sk_sp<DisplayList> DiffContextTest::CreateDisplayList(const SkRect& bounds,
@@ -7,23 +7,33 @@
 #include <algorithm>
 
 #include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+namespace {
+
+// The loop and queue index of the worker running on the current thread, if
+// any. Used to queue tasks posted from a worker on that worker's own queue.
+FML_THREAD_LOCAL ConcurrentMessageLoop* tls_worker_loop = nullptr;
+FML_THREAD_LOCAL size_t tls_worker_index = 0;
+
+}  // namespace
+
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(fml::Thread::ThreadConfig(
           std::string{"io.worker." + std::to_string(i + 1)}));
-      WorkerMain();
+      WorkerMain(i);
     });
   }
-
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
-  }
 }
 
 ConcurrentMessageLoop::~ConcurrentMessageLoop() {
@@ -47,54 +57,118 @@ void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     ExecuteTask(task);
     return;
   }
 
-  tasks_.push(task);
+  size_t worker_index =
+      tls_worker_loop == this
+          ? tls_worker_index
+          : next_worker_queue_.fetch_add(1, std::memory_order_relaxed) %
+                worker_count_;
+  WorkerQueue& queue = *worker_queues_[worker_index];
+  {
+    std::scoped_lock lock(queue.mutex);
+    queue.tasks.push_back(task);
+  }
+  pending_tasks_.fetch_add(1);
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  WakeWorkers(false);
+}
 
-  tasks_condition_.notify_one();
+void ConcurrentMessageLoop::WakeWorkers(bool wake_all) {
+  // The pending task count or shutdown flag was updated before this call, so
+  // a worker that is not counted as sleeping yet will observe the update
+  // before it waits.
+  if (sleeping_workers_.load() == 0) {
+    return;
+  }
+
+  // Acquire the mutex so that a worker that is between checking for work and
+  // waiting on the condition does not miss the notification. Unlock before
+  // notifying because the mutex has to be acquired on the other thread
+  // anyway.
+  { std::scoped_lock lock(sleep_mutex_); }
+
+  if (wake_all) {
+    sleep_condition_.notify_all();
+  } else {
+    sleep_condition_.notify_one();
+  }
+}
+
+bool ConcurrentMessageLoop::HasWork(const WorkerQueue& queue) const {
+  return pending_tasks_.load() > 0 || shutdown_.load() ||
+         queue.has_thread_tasks.load();
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
+void ConcurrentMessageLoop::WaitForWork(const WorkerQueue& queue) {
+  if (HasWork(queue)) {
+    return;
+  }
+  std::unique_lock lock(sleep_mutex_);
+  sleeping_workers_.fetch_add(1);
+  sleep_condition_.wait(lock, [&]() { return HasWork(queue); });
+  sleeping_workers_.fetch_sub(1);
+}
+
+bool ConcurrentMessageLoop::TryPopTask(size_t worker_index,
+                                       fml::closure& task) {
+  // Take the oldest task from this worker's own queue first, then try to
+  // steal the newest task from the other workers.
+  for (size_t i = 0; i < worker_count_; ++i) {
+    WorkerQueue& queue = *worker_queues_[(worker_index + i) % worker_count_];
+    std::scoped_lock lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    } else {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    pending_tasks_.fetch_sub(1);
+    return true;
+  }
+  return false;
+}
+
+std::vector<fml::closure> ConcurrentMessageLoop::TakeThreadTasks(
+    WorkerQueue& queue) {
+  std::vector<fml::closure> thread_tasks;
+  if (queue.has_thread_tasks.load()) {
+    std::scoped_lock lock(queue.mutex);
+    std::swap(thread_tasks, queue.thread_tasks);
+    queue.has_thread_tasks = false;
+  }
+  return thread_tasks;
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  tls_worker_loop = this;
+  tls_worker_index = worker_index;
+  WorkerQueue& queue = *worker_queues_[worker_index];
+
   while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return !tasks_.empty() || shutdown_ || HasThreadTasksLocked();
-    });
+    WaitForWork(queue);
 
-    // Shutdown cannot be read with the task mutex unlocked.
     bool shutdown_now = shutdown_;
     fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+    TryPopTask(worker_index, task);
+    std::vector<fml::closure> thread_tasks = TakeThreadTasks(queue);
 
-    if (!tasks_.empty()) {
-      task = tasks_.front();
-      tasks_.pop();
+    if (!task && thread_tasks.empty() && !shutdown_now) {
+      // Another worker took the task this worker woke up for.
+      continue;
     }
 
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
-    }
-
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
-
     TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
     // Execute the primary task we woke up for.
     if (task) {
@@ -110,6 +184,8 @@ void ConcurrentMessageLoop::WorkerMain() {
       break;
     }
   }
+
+  tls_worker_loop = nullptr;
 }
 
 void ConcurrentMessageLoop::ExecuteTask(const fml::closure& task) {
@@ -117,9 +193,8 @@ void ConcurrentMessageLoop::ExecuteTask(const fml::closure& task) {
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  WakeWorkers(true);
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
@@ -127,24 +202,12 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(const fml::closure& task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (const auto& queue : worker_queues_) {
+    std::scoped_lock lock(queue->mutex);
+    queue->thread_tasks.emplace_back(task);
+    queue->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  WakeWorkers(true);
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -170,13 +233,7 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
 }
 
 bool ConcurrentMessageLoop::RunsTasksOnCurrentThread() {
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    if (worker_thread_id == std::this_thread::get_id()) {
-      return true;
-    }
-  }
-  return false;
+  return tls_worker_loop == this;
 }
 
 }  // namespace fml
@@ -5,10 +5,13 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -43,22 +46,44 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  // Tasks owned by a single worker. Tasks posted from a worker are queued on
+  // that worker, tasks posted from other threads are distributed round-robin.
+  // Idle workers steal from the queues of other workers, so workers only
+  // contend on a queue lock when stealing.
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<fml::closure> tasks;
+    // Tasks from |PostTaskToAllWorkers| that must run on this worker.
+    std::vector<fml::closure> thread_tasks;
+    std::atomic<bool> has_thread_tasks = false;
+  };
+
   size_t worker_count_ = 0;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
-
-  void WorkerMain();
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  std::atomic<size_t> next_worker_queue_ = 0;
+  // Number of tasks in all worker queues.
+  std::atomic<size_t> pending_tasks_ = 0;
+  // Idle workers wait on this condition. Posting only takes the lock if
+  // there is a sleeping worker.
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_condition_;
+  std::atomic<size_t> sleeping_workers_ = 0;
+  std::atomic<bool> shutdown_ = false;
+
+  void WorkerMain(size_t worker_index);
 
   void PostTask(const fml::closure& task);
 
-  bool HasThreadTasksLocked() const;
+  void WaitForWork(const WorkerQueue& queue);
+
+  void WakeWorkers(bool wake_all);
+
+  bool HasWork(const WorkerQueue& queue) const;
+
+  bool TryPopTask(size_t worker_index, fml::closure& task);
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  std::vector<fml::closure> TakeThreadTasks(WorkerQueue& queue);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+namespace {
+
+constexpr size_t kTasksPerIteration = 1 << 14;
+
+// Roughly the cost of a small unit of work such as a tessellation or image
+// decode sub-task, so the benchmark measures scheduling rather than a no-op.
+void DoWork() {
+  volatile size_t sum = 0;
+  for (size_t i = 0; i < 256; i++) {
+    sum = sum + i;
+  }
+}
+
+int64_t MaxWorkers() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+// Many short tasks posted from a thread outside of the pool.
+static void BM_ConcurrentMessageLoopExternalPost(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  for (auto _ : state) {
+    CountDownLatch latch(kTasksPerIteration);
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      task_runner->PostTask([&latch]() {
+        DoWork();
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+// Tasks that fan out into further tasks from the worker threads, which is the
+// common pattern for parallel decoding and tessellation.
+static void BM_ConcurrentMessageLoopFanOut(benchmark::State& state) {  // NOLINT
+  constexpr size_t kFanOut = 64;
+  constexpr size_t kRoots = kTasksPerIteration / kFanOut;
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  for (auto _ : state) {
+    CountDownLatch latch(kRoots * kFanOut);
+    for (size_t i = 0; i < kRoots; i++) {
+      task_runner->PostTask([&latch, &task_runner]() {
+        for (size_t j = 0; j < kFanOut; j++) {
+          task_runner->PostTask([&latch]() {
+            DoWork();
+            latch.CountDown();
+          });
+        }
+      });
+    }
+    latch.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kRoots * kFanOut);
+}
+
+// Several external producers posting to the pool at the same time.
+static void BM_ConcurrentMessageLoopMultipleProducers(
+    benchmark::State& state) {  // NOLINT
+  constexpr size_t kProducers = 4;
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  for (auto _ : state) {
+    CountDownLatch latch(kTasksPerIteration);
+    std::vector<std::thread> producers;
+    producers.reserve(kProducers);
+    for (size_t p = 0; p < kProducers; p++) {
+      producers.emplace_back([&latch, &task_runner]() {
+        for (size_t i = 0; i < kTasksPerIteration / kProducers; i++) {
+          task_runner->PostTask([&latch]() {
+            DoWork();
+            latch.CountDown();
+          });
+        }
+      });
+    }
+    latch.Wait();
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopExternalPost)
+    ->RangeMultiplier(2)
+    ->Range(1, MaxWorkers())
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ConcurrentMessageLoopFanOut)
+    ->RangeMultiplier(2)
+    ->Range(1, MaxWorkers())
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ConcurrentMessageLoopMultipleProducers)
+    ->RangeMultiplier(2)
+    ->Range(1, MaxWorkers())
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmarking
+}  // namespace fml
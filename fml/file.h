@@ -72,6 +72,18 @@ bool IsFile(const std::string& path);
 
 bool TruncateFile(const fml::UniqueFD& file, size_t size);
 
+/// Writes |data| to |file| starting at |offset|, extending the file as
+/// needed. Unlike resizing the file with |TruncateFile|, this works on every
+/// platform while the file is mapped.
+bool WriteFileAt(const fml::UniqueFD& file, size_t offset, const Mapping& data);
+
+/// Blocks until the calling process holds an exclusive advisory lock on
+/// |file|. The lock only excludes other callers of |LockFile| on the same
+/// file, and is held until |UnlockFile| is called or the file is closed.
+bool LockFile(const fml::UniqueFD& file);
+
+bool UnlockFile(const fml::UniqueFD& file);
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path);
 
 bool UnlinkDirectory(const char* path);
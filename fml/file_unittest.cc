@@ -253,6 +253,31 @@ TEST(FileTest, AtomicWriteTest) {
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "precious_data"));
 }
 
+TEST(FileTest, CanWriteAtOffsetWhileMapped) {
+  fml::ScopedTemporaryDirectory dir;
+
+  {
+    auto file = fml::OpenFile(dir.fd(), "my_contents", true,
+                              fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(
+        fml::WriteFileAt(file, 0, fml::DataMapping(std::string("abc"))));
+    fml::FileMapping mapping(file);
+    ASSERT_EQ(mapping.GetSize(), 3u);
+
+    // Extend the file and overwrite part of it while it is mapped.
+    ASSERT_TRUE(
+        fml::WriteFileAt(file, 3, fml::DataMapping(std::string("def"))));
+    ASSERT_TRUE(fml::WriteFileAt(file, 1, fml::DataMapping(std::string("B"))));
+    ASSERT_EQ(ReadStringFromFile(file), "aBcdef");
+    ASSERT_EQ(mapping.GetMapping()[1], 'B');
+
+    ASSERT_TRUE(fml::LockFile(file));
+    ASSERT_TRUE(fml::UnlockFile(file));
+  }
+
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "my_contents"));
+}
+
 TEST(FileTest, IgnoreBaseDirWhenPathIsAbsolute) {
   fml::ScopedTemporaryDirectory dir;
 
@@ -7,6 +7,7 @@
 #include "flutter/fml/message_loop_task_queues.h"
 
 #include <algorithm>
+#include <initializer_list>
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -42,16 +43,100 @@ TaskQueueEntry::TaskQueueEntry(TaskQueueId created_for_arg)
   task_source = std::make_unique<TaskSource>(created_for);
 }
 
+// Holds the mutexes of a set of task queues along with every queue merged with
+// them, so that the tasks of a merged group can be inspected consistently.
+//
+// The merge state of a queue only changes while the mutexes of all queues in
+// both affected groups are held. A lock is therefore acquired by locking the
+// queues that are known to be needed, and retrying with a larger set if the
+// merge state of the locked queues refers to any queue that is not locked yet.
+// Mutexes are always acquired in ascending |TaskQueueId| order.
+//
+// Most locks are for a single queue that isn't merged with any other, which
+// takes just the mutex of that queue and builds no containers.
+class MessageLoopTaskQueues::GroupLock {
+ public:
+  GroupLock(const MessageLoopTaskQueues* queues,
+            std::initializer_list<TaskQueueId> queue_ids) {
+    if (queue_ids.size() == 1u) {
+      single_id_ = *queue_ids.begin();
+      single_entry_ = queues->GetEntry(single_id_);
+      single_entry_->mutex.lock();
+      if (single_entry_->subsumed_by == kUnmerged &&
+          single_entry_->owner_of.empty()) {
+        return;
+      }
+      single_entry_->mutex.unlock();
+      single_entry_ = nullptr;
+    }
+
+    wanted_ = queue_ids;
+    for (;;) {
+      for (const auto& queue_id : wanted_) {
+        entries_[queue_id] = queues->GetEntry(queue_id);
+      }
+      for (const auto& entry : entries_) {
+        entry.second->mutex.lock();
+      }
+      std::set<TaskQueueId> needed = wanted_;
+      for (const auto& entry : entries_) {
+        if (entry.second->subsumed_by != kUnmerged) {
+          needed.insert(entry.second->subsumed_by);
+        }
+        needed.insert(entry.second->owner_of.begin(),
+                      entry.second->owner_of.end());
+      }
+      if (needed.size() == wanted_.size()) {
+        return;
+      }
+      Unlock();
+      wanted_ = std::move(needed);
+    }
+  }
+
+  ~GroupLock() { Unlock(); }
+
+  TaskQueueEntry* Get(TaskQueueId queue_id) const {
+    if (single_entry_) {
+      FML_DCHECK(queue_id == single_id_);
+      return single_entry_.get();
+    }
+    auto found = entries_.find(queue_id);
+    FML_DCHECK(found != entries_.end());
+    return found->second.get();
+  }
+
+ private:
+  // Set when only a single unmerged queue is locked.
+  TaskQueueId single_id_ = kUnmerged;
+  std::shared_ptr<TaskQueueEntry> single_entry_;
+
+  std::set<TaskQueueId> wanted_;
+  std::map<TaskQueueId, std::shared_ptr<TaskQueueEntry>> entries_;
+
+  void Unlock() {
+    if (single_entry_) {
+      single_entry_->mutex.unlock();
+      return;
+    }
+    for (auto entry = entries_.rbegin(); entry != entries_.rend(); ++entry) {
+      entry->second->mutex.unlock();
+    }
+  }
+
+  FML_DISALLOW_COPY_ASSIGN_AND_MOVE(GroupLock);
+};
+
 MessageLoopTaskQueues* MessageLoopTaskQueues::GetInstance() {
   static MessageLoopTaskQueues* instance = new MessageLoopTaskQueues;
   return instance;
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
-  TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
-  ++task_queue_id_counter_;
-  queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>(loop_id);
+  TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_++);
+  auto& shard = registry_shards_[loop_id % kRegistryShardCount];
+  std::lock_guard guard(shard.mutex);
+  shard.entries[loop_id] = std::make_shared<TaskQueueEntry>(loop_id);
   return loop_id;
 }
 
@@ -62,26 +147,40 @@ MessageLoopTaskQueues::MessageLoopTaskQueues() : order_(0) {
 
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
+std::shared_ptr<TaskQueueEntry> MessageLoopTaskQueues::GetEntry(
+    TaskQueueId queue_id) const {
+  const auto& shard = registry_shards_[queue_id % kRegistryShardCount];
+  std::lock_guard guard(shard.mutex);
+  auto found = shard.entries.find(queue_id);
+  FML_CHECK(found != shard.entries.end())
+      << "Unknown task queue, queue_id=" << queue_id;
+  return found->second;
+}
+
+void MessageLoopTaskQueues::EraseEntry(TaskQueueId queue_id) {
+  auto& shard = registry_shards_[queue_id % kRegistryShardCount];
+  std::lock_guard guard(shard.mutex);
+  shard.entries.erase(queue_id);
+}
+
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  GroupLock lock(this, {queue_id});
+  const auto* queue_entry = lock.Get(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
-  auto& subsumed_set = queue_entry->owner_of;
-  for (auto& subsumed : subsumed_set) {
-    queue_entries_.erase(subsumed);
+  for (auto& subsumed : queue_entry->owner_of) {
+    EraseEntry(subsumed);
   }
-  // Erase owner queue_id at last to avoid &subsumed_set from being invalid
-  queue_entries_.erase(queue_id);
+  EraseEntry(queue_id);
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  GroupLock lock(this, {queue_id});
+  const auto* queue_entry = lock.Get(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == kUnmerged);
   auto& subsumed_set = queue_entry->owner_of;
   queue_entry->task_source->ShutDown();
   for (auto& subsumed : subsumed_set) {
-    queue_entries_.at(subsumed)->task_source->ShutDown();
+    lock.Get(subsumed)->task_source->ShutDown();
   }
 }
 
@@ -94,9 +193,9 @@ void MessageLoopTaskQueues::RegisterTask(
     const fml::closure& task,
     fml::TimePoint target_time,
     fml::TaskSourceGrade task_source_grade) {
-  std::lock_guard guard(queue_mutex_);
+  GroupLock lock(this, {queue_id});
   size_t order = order_++;
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  const auto* queue_entry = lock.Get(queue_id);
   queue_entry->task_source->RegisterTask(
       {order, task, target_time, task_source_grade});
   TaskQueueId loop_to_wake = queue_id;
@@ -105,51 +204,54 @@ void MessageLoopTaskQueues::RegisterTask(
   }
 
   // This can happen when the secondary tasks are paused.
-  if (HasPendingTasksUnlocked(loop_to_wake)) {
-    WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+  if (HasPendingTasksUnlocked(lock, loop_to_wake)) {
+    WakeUpUnlocked(lock, loop_to_wake,
+                   GetNextWakeTimeUnlocked(lock, loop_to_wake));
   }
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  return HasPendingTasksUnlocked(queue_id);
+  GroupLock lock(this, {queue_id});
+  return HasPendingTasksUnlocked(lock, queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
-  if (!HasPendingTasksUnlocked(queue_id)) {
+  GroupLock lock(this, {queue_id});
+  if (!HasPendingTasksUnlocked(lock, queue_id)) {
     return nullptr;
   }
-  TaskSource::TopTask top = PeekNextTaskUnlocked(queue_id);
+  TaskSource::TopTask top = PeekNextTaskUnlocked(lock, queue_id);
 
-  if (!HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, fml::TimePoint::Max());
+  if (!HasPendingTasksUnlocked(lock, queue_id)) {
+    WakeUpUnlocked(lock, queue_id, fml::TimePoint::Max());
   } else {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
+    WakeUpUnlocked(lock, queue_id, GetNextWakeTimeUnlocked(lock, queue_id));
   }
 
   if (top.task.GetTargetTime() > from_time) {
     return nullptr;
   }
   fml::closure invocation = top.task.GetTask();
-  queue_entries_.at(top.task_queue_id)
+  lock.Get(top.task_queue_id)
       ->task_source->PopTask(top.task.GetTaskSourceGrade());
   const auto task_source_grade = top.task.GetTaskSourceGrade();
   tls_task_source_grade.reset(new TaskSourceGradeHolder{task_source_grade});
   return invocation;
 }
 
-void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
+void MessageLoopTaskQueues::WakeUpUnlocked(const GroupLock& lock,
+                                           TaskQueueId queue_id,
                                            fml::TimePoint time) const {
-  if (queue_entries_.at(queue_id)->wakeable) {
-    queue_entries_.at(queue_id)->wakeable->WakeUp(time);
+  auto* wakeable = lock.Get(queue_id)->wakeable;
+  if (wakeable) {
+    wakeable->WakeUp(time);
   }
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
-  const auto& queue_entry = queue_entries_.at(queue_id);
+  GroupLock lock(this, {queue_id});
+  const auto* queue_entry = lock.Get(queue_id);
   if (queue_entry->subsumed_by != kUnmerged) {
     return 0;
   }
@@ -159,7 +261,7 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 
   auto& subsumed_set = queue_entry->owner_of;
   for (auto& subsumed : subsumed_set) {
-    const auto& subsumed_entry = queue_entries_.at(subsumed);
+    const auto* subsumed_entry = lock.Get(subsumed);
     total_tasks += subsumed_entry->task_source->GetNumPendingTasks();
   }
   return total_tasks;
@@ -168,33 +270,36 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
-  queue_entries_.at(queue_id)->task_observers[key] = callback;
+  auto entry = GetEntry(queue_id);
+  std::lock_guard guard(entry->mutex);
+  entry->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_observers.erase(key);
+  auto entry = GetEntry(queue_id);
+  std::lock_guard guard(entry->mutex);
+  entry->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  GroupLock lock(this, {queue_id});
   std::vector<fml::closure> observers;
 
-  if (queue_entries_.at(queue_id)->subsumed_by != kUnmerged) {
+  const auto* queue_entry = lock.Get(queue_id);
+  if (queue_entry->subsumed_by != kUnmerged) {
     return observers;
   }
 
-  for (const auto& observer : queue_entries_.at(queue_id)->task_observers) {
+  for (const auto& observer : queue_entry->task_observers) {
     observers.push_back(observer.second);
   }
 
-  auto& subsumed_set = queue_entries_.at(queue_id)->owner_of;
+  auto& subsumed_set = queue_entry->owner_of;
   for (auto& subsumed : subsumed_set) {
-    for (const auto& observer : queue_entries_.at(subsumed)->task_observers) {
+    for (const auto& observer : lock.Get(subsumed)->task_observers) {
       observers.push_back(observer.second);
     }
   }
@@ -204,19 +309,19 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
-  FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
-      << "Wakeable can only be set once.";
-  queue_entries_.at(queue_id)->wakeable = wakeable;
+  auto entry = GetEntry(queue_id);
+  std::lock_guard guard(entry->mutex);
+  FML_CHECK(!entry->wakeable) << "Wakeable can only be set once.";
+  entry->wakeable = wakeable;
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
-  auto& owner_entry = queue_entries_.at(owner);
-  auto& subsumed_entry = queue_entries_.at(subsumed);
+  GroupLock lock(this, {owner, subsumed});
+  auto* owner_entry = lock.Get(owner);
+  auto* subsumed_entry = lock.Get(subsumed);
   auto& subsumed_set = owner_entry->owner_of;
   if (subsumed_set.find(subsumed) != subsumed_set.end()) {
     return true;
@@ -254,16 +359,17 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   owner_entry->owner_of.insert(subsumed);
   subsumed_entry->subsumed_by = owner;
 
-  if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+  if (HasPendingTasksUnlocked(lock, owner)) {
+    WakeUpUnlocked(lock, owner, GetNextWakeTimeUnlocked(lock, owner));
   }
 
   return true;
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
-  std::lock_guard guard(queue_mutex_);
-  const auto& owner_entry = queue_entries_.at(owner);
+  GroupLock lock(this, {owner, subsumed});
+  auto* owner_entry = lock.Get(owner);
+  auto* subsumed_entry = lock.Get(subsumed);
   if (owner_entry->owner_of.empty()) {
     FML_LOG(WARNING)
         << "Thread unmerging failed: owner_entry doesn't own anyone, owner="
@@ -277,7 +383,7 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
         << ", owner_entry->subsumed_by=" << owner_entry->subsumed_by;
     return false;
   }
-  if (queue_entries_.at(subsumed)->subsumed_by == kUnmerged) {
+  if (subsumed_entry->subsumed_by == kUnmerged) {
     FML_LOG(WARNING) << "Thread unmerging failed: subsumed_entry wasn't "
                         "subsumed by others, owner="
                      << owner << ", subsumed=" << subsumed;
@@ -290,15 +396,15 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
     return false;
   }
 
-  queue_entries_.at(subsumed)->subsumed_by = kUnmerged;
+  subsumed_entry->subsumed_by = kUnmerged;
   owner_entry->owner_of.erase(subsumed);
 
-  if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+  if (HasPendingTasksUnlocked(lock, owner)) {
+    WakeUpUnlocked(lock, owner, GetNextWakeTimeUnlocked(lock, owner));
   }
 
-  if (HasPendingTasksUnlocked(subsumed)) {
-    WakeUpUnlocked(subsumed, GetNextWakeTimeUnlocked(subsumed));
+  if (HasPendingTasksUnlocked(lock, subsumed)) {
+    WakeUpUnlocked(lock, subsumed, GetNextWakeTimeUnlocked(lock, subsumed));
   }
 
   return true;
@@ -306,39 +412,43 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner, TaskQueueId subsumed) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
   if (owner == kUnmerged || subsumed == kUnmerged) {
     return false;
   }
-  auto& subsumed_set = queue_entries_.at(owner)->owner_of;
+  auto entry = GetEntry(owner);
+  std::lock_guard guard(entry->mutex);
+  auto& subsumed_set = entry->owner_of;
   return subsumed_set.find(subsumed) != subsumed_set.end();
 }
 
 std::set<TaskQueueId> MessageLoopTaskQueues::GetSubsumedTaskQueueId(
     TaskQueueId owner) const {
-  std::lock_guard guard(queue_mutex_);
-  return queue_entries_.at(owner)->owner_of;
+  auto entry = GetEntry(owner);
+  std::lock_guard guard(entry->mutex);
+  return entry->owner_of;
 }
 
 void MessageLoopTaskQueues::PauseSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->PauseSecondary();
+  auto entry = GetEntry(queue_id);
+  std::lock_guard guard(entry->mutex);
+  entry->task_source->PauseSecondary();
 }
 
 void MessageLoopTaskQueues::ResumeSecondarySource(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
-  queue_entries_.at(queue_id)->task_source->ResumeSecondary();
+  GroupLock lock(this, {queue_id});
+  lock.Get(queue_id)->task_source->ResumeSecondary();
   // Schedule a wake as needed.
-  if (HasPendingTasksUnlocked(queue_id)) {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
+  if (HasPendingTasksUnlocked(lock, queue_id)) {
+    WakeUpUnlocked(lock, queue_id, GetNextWakeTimeUnlocked(lock, queue_id));
   }
 }
 
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
+    const GroupLock& lock,
     TaskQueueId queue_id) const {
-  const auto& entry = queue_entries_.at(queue_id);
+  const auto* entry = lock.Get(queue_id);
   bool is_subsumed = entry->subsumed_by != kUnmerged;
   if (is_subsumed) {
     return false;
@@ -351,19 +461,21 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
   auto& subsumed_set = entry->owner_of;
   return std::any_of(
       subsumed_set.begin(), subsumed_set.end(), [&](const auto& subsumed) {
-        return !queue_entries_.at(subsumed)->task_source->IsEmpty();
+        return !lock.Get(subsumed)->task_source->IsEmpty();
       });
 }
 
 fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
+    const GroupLock& lock,
     TaskQueueId queue_id) const {
-  return PeekNextTaskUnlocked(queue_id).task.GetTargetTime();
+  return PeekNextTaskUnlocked(lock, queue_id).task.GetTargetTime();
 }
 
 TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
+    const GroupLock& lock,
     TaskQueueId owner) const {
-  FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
+  FML_DCHECK(HasPendingTasksUnlocked(lock, owner));
+  const auto* entry = lock.Get(owner);
   if (entry->owner_of.empty()) {
     FML_CHECK(!entry->task_source->IsEmpty());
     return entry->task_source->Top();
@@ -386,7 +498,7 @@ TaskSource::TopTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
   top_task_updater(owner_tasks);
 
   for (TaskQueueId subsumed : entry->owner_of) {
-    TaskSource* subsumed_tasks = queue_entries_.at(subsumed)->task_source.get();
+    TaskSource* subsumed_tasks = lock.Get(subsumed)->task_source.get();
     top_task_updater(subsumed_tasks);
   }
   // At least one task at the top because PeekNextTaskUnlocked() is called after
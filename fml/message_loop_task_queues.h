@@ -5,6 +5,8 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -46,6 +48,11 @@ class TaskQueueEntry {
 
   TaskQueueId created_for;
 
+  /// Guards all of the fields above. Operations that involve merged queues
+  /// hold the mutexes of every queue in the merged group, acquired in
+  /// ascending |TaskQueueId| order.
+  std::mutex mutex;
+
   explicit TaskQueueEntry(TaskQueueId created_for);
 
  private:
@@ -61,6 +68,11 @@ enum class FlushType {
 /// fml::MessageLoops.
 ///
 /// This also wakes up the loop at the required times.
+///
+/// There is no lock shared by all task queues. The registry of task queues is
+/// split into shards with their own locks, and the tasks of each task queue
+/// are guarded by a lock on its |TaskQueueEntry|. Threads posting to or
+/// draining different task queues only contend when those queues are merged.
 /// \see fml::MessageLoop
 /// \see fml::Wakeable
 class MessageLoopTaskQueues {
@@ -139,23 +151,42 @@ class MessageLoopTaskQueues {
 
  private:
   class MergedQueuesRunner;
+  class GroupLock;
+
+  // The number of shards the registry of task queues is split into. Task
+  // queue ids are allocated sequentially, so the handful of queues created by
+  // an engine (platform, UI, raster and IO) never share a shard.
+  static constexpr size_t kRegistryShardCount = 16;
+
+  struct RegistryShard {
+    mutable std::mutex mutex;
+    std::map<TaskQueueId, std::shared_ptr<TaskQueueEntry>> entries;
+  };
 
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
-  void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
+  std::shared_ptr<TaskQueueEntry> GetEntry(TaskQueueId queue_id) const;
+
+  void EraseEntry(TaskQueueId queue_id);
+
+  void WakeUpUnlocked(const GroupLock& lock,
+                      TaskQueueId queue_id,
+                      fml::TimePoint time) const;
 
-  bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
+  bool HasPendingTasksUnlocked(const GroupLock& lock,
+                               TaskQueueId queue_id) const;
 
-  TaskSource::TopTask PeekNextTaskUnlocked(TaskQueueId owner) const;
+  TaskSource::TopTask PeekNextTaskUnlocked(const GroupLock& lock,
+                                           TaskQueueId owner) const;
 
-  fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
+  fml::TimePoint GetNextWakeTimeUnlocked(const GroupLock& lock,
+                                         TaskQueueId queue_id) const;
 
-  mutable std::mutex queue_mutex_;
-  std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
+  std::array<RegistryShard, kRegistryShardCount> registry_shards_;
 
-  size_t task_queue_id_counter_ = 0;
+  std::atomic<size_t> task_queue_id_counter_ = 0;
 
   std::atomic_int order_;
 
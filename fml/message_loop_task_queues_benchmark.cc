@@ -64,7 +64,146 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
   }
 }
 
+// Each producer thread posts to and drains its own task queue, the way the
+// platform, UI, raster and IO threads use their queues. The queues are
+// independent, so throughput should scale with the number of threads.
+static void BM_IndependentQueuesContention(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const size_t num_threads = state.range(0);
+  const size_t num_tasks_per_thread = 1000;
+
+  std::vector<TaskQueueId> queue_ids;
+  for (size_t i = 0; i < num_threads; i++) {
+    queue_ids.push_back(task_queues->CreateTaskQueue());
+  }
+
+  for (auto _ : state) {
+    CountDownLatch tasks_done(num_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      threads.emplace_back([queue_id = queue_ids[i], &task_queues,
+                            &tasks_done]() {
+        const fml::TimePoint past = fml::TimePoint::Now();
+        for (size_t j = 0; j < num_tasks_per_thread; j++) {
+          task_queues->RegisterTask(queue_id, [] {}, past);
+          fml::closure invocation =
+              task_queues->GetNextTaskToRun(queue_id, past);
+          assert(invocation);
+        }
+        tasks_done.CountDown();
+      });
+    }
+    tasks_done.Wait();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  for (const auto& queue_id : queue_ids) {
+    task_queues->Dispose(queue_id);
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads *
+                          num_tasks_per_thread);
+}
+
+// Many producer threads post to a single task queue that is drained by one
+// consumer thread, like platform channels and engine threads posting to the
+// UI task runner.
+static void BM_MultipleProducersSingleQueue(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const size_t num_producers = state.range(0);
+  const size_t num_tasks_per_producer = 1000;
+  const size_t num_tasks = num_producers * num_tasks_per_producer;
+
+  auto queue_id = task_queues->CreateTaskQueue();
+
+  for (auto _ : state) {
+    std::vector<std::thread> producers;
+    producers.reserve(num_producers);
+    for (size_t i = 0; i < num_producers; i++) {
+      producers.emplace_back([queue_id, &task_queues]() {
+        const fml::TimePoint past = fml::TimePoint::Now();
+        for (size_t j = 0; j < num_tasks_per_producer; j++) {
+          task_queues->RegisterTask(queue_id, [] {}, past);
+        }
+      });
+    }
+    size_t num_invocations = 0;
+    while (num_invocations < num_tasks) {
+      fml::closure invocation =
+          task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now());
+      if (invocation) {
+        num_invocations++;
+      }
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+
+  task_queues->Dispose(queue_id);
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+// Producers post to two merged task queues while the owner drains both, as
+// happens when the raster thread is merged into the platform thread.
+static void BM_MergedQueuesContention(benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const size_t num_producers = state.range(0);
+  const size_t num_tasks_per_producer = 1000;
+  const size_t num_tasks = num_producers * num_tasks_per_producer;
+
+  auto owner = task_queues->CreateTaskQueue();
+  auto subsumed = task_queues->CreateTaskQueue();
+  task_queues->Merge(owner, subsumed);
+
+  for (auto _ : state) {
+    std::vector<std::thread> producers;
+    producers.reserve(num_producers);
+    for (size_t i = 0; i < num_producers; i++) {
+      producers.emplace_back(
+          [queue_id = i % 2 == 0 ? owner : subsumed, &task_queues]() {
+            const fml::TimePoint past = fml::TimePoint::Now();
+            for (size_t j = 0; j < num_tasks_per_producer; j++) {
+              task_queues->RegisterTask(queue_id, [] {}, past);
+            }
+          });
+    }
+    size_t num_invocations = 0;
+    while (num_invocations < num_tasks) {
+      fml::closure invocation =
+          task_queues->GetNextTaskToRun(owner, fml::TimePoint::Now());
+      if (invocation) {
+        num_invocations++;
+      }
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+
+  task_queues->Unmerge(owner, subsumed);
+  task_queues->Dispose(owner);
+  task_queues->Dispose(subsumed);
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
 BENCHMARK(BM_RegisterAndGetTasks);
+BENCHMARK(BM_IndependentQueuesContention)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_MultipleProducersSingleQueue)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_MergedQueuesContention)
+    ->RangeMultiplier(2)
+    ->Range(2, 8)
+    ->UseRealTime();
 
 }  // namespace benchmarking
 }  // namespace fml
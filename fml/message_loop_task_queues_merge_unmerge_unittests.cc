@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
 #include <thread>
 #include <utility>
 
@@ -316,5 +317,43 @@ TEST(MessageLoopTaskQueueMergeUnmerge,
   latch.Wait();
 }
 
+TEST(MessageLoopTaskQueueMergeUnmerge,
+     ConcurrentRegisterAndRunWhileMergingAndUnmerging) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+
+  auto platform_queue = task_queue->CreateTaskQueue();
+  auto raster_queue = task_queue->CreateTaskQueue();
+
+  constexpr int kTasksPerQueue = 1000;
+  std::atomic<int> tasks_run = 0;
+  std::atomic<bool> posting_done = false;
+
+  auto post_tasks = [&](TaskQueueId queue_id) {
+    for (int i = 0; i < kTasksPerQueue; i++) {
+      task_queue->RegisterTask(
+          queue_id, [&tasks_run]() { tasks_run++; }, ChronoTicksSinceEpoch());
+    }
+  };
+
+  std::thread platform_poster(post_tasks, platform_queue);
+  std::thread raster_poster(post_tasks, raster_queue);
+  std::thread merger([&]() {
+    while (!posting_done) {
+      task_queue->Merge(platform_queue, raster_queue);
+      CountRemainingTasks(task_queue, platform_queue, true);
+      task_queue->Unmerge(platform_queue, raster_queue);
+    }
+  });
+
+  platform_poster.join();
+  raster_poster.join();
+  posting_done = true;
+  merger.join();
+
+  CountRemainingTasks(task_queue, platform_queue, true);
+  CountRemainingTasks(task_queue, raster_queue, true);
+  ASSERT_EQ(tasks_run, 2 * kTasksPerQueue);
+}
+
 }  // namespace testing
 }  // namespace fml
@@ -6,7 +6,9 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
+#include <set>
 #include <thread>
 
 #include "flutter/fml/build_config.h"
@@ -212,3 +214,54 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsTasksPostedFromWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kOuterCount = 16;
+  const size_t kInnerCount = 64;
+  fml::CountDownLatch latch(kOuterCount * kInnerCount);
+  std::atomic<size_t> ran_on_worker = 0;
+  for (size_t i = 0; i < kOuterCount; ++i) {
+    task_runner->PostTask([&]() {
+      for (size_t j = 0; j < kInnerCount; ++j) {
+        task_runner->PostTask([&]() {
+          if (loop->RunsTasksOnCurrentThread()) {
+            ran_on_worker++;
+          }
+          latch.CountDown();
+        });
+      }
+    });
+  }
+  latch.Wait();
+  ASSERT_EQ(ran_on_worker, kOuterCount * kInnerCount);
+  ASSERT_FALSE(loop->RunsTasksOnCurrentThread());
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopPostsTaskToEveryWorker) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4u);
+  // Keep one worker busy so that the other workers have the chance to steal
+  // its tasks. Tasks for all workers must still run on every worker.
+  fml::CountDownLatch busy_started(1);
+  fml::AutoResetWaitableEvent release_busy;
+  loop->GetTaskRunner()->PostTask([&]() {
+    busy_started.CountDown();
+    release_busy.Wait();
+  });
+  busy_started.Wait();
+
+  fml::CountDownLatch latch(loop->GetWorkerCount());
+  std::mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  loop->PostTaskToAllWorkers([&]() {
+    {
+      std::scoped_lock lock(thread_ids_mutex);
+      thread_ids.insert(std::this_thread::get_id());
+    }
+    latch.CountDown();
+  });
+  release_busy.Signal();
+  latch.Wait();
+  ASSERT_EQ(thread_ids.size(), loop->GetWorkerCount());
+}
@@ -6,6 +6,7 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <sys/file.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -160,6 +161,42 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return ::ftruncate(file.get(), size) == 0;
 }
 
+bool WriteFileAt(const fml::UniqueFD& file,
+                 size_t offset,
+                 const Mapping& data) {
+  if (!file.is_valid() || data.GetMapping() == nullptr) {
+    return false;
+  }
+
+  size_t written = 0;
+  while (written < data.GetSize()) {
+    ssize_t result = FML_HANDLE_EINTR(
+        ::pwrite(file.get(), data.GetMapping() + written,
+                 data.GetSize() - written, offset + written));
+    if (result == -1) {
+      return false;
+    }
+    written += result;
+  }
+  return true;
+}
+
+bool LockFile(const fml::UniqueFD& file) {
+  if (!file.is_valid()) {
+    return false;
+  }
+
+  return FML_HANDLE_EINTR(::flock(file.get(), LOCK_EX)) == 0;
+}
+
+bool UnlockFile(const fml::UniqueFD& file) {
+  if (!file.is_valid()) {
+    return false;
+  }
+
+  return ::flock(file.get(), LOCK_UN) == 0;
+}
+
 bool UnlinkDirectory(const char* path) {
   return UnlinkDirectory(fml::UniqueFD{AT_FDCWD}, path);
 }
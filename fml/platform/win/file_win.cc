@@ -343,6 +343,48 @@ bool TruncateFile(const fml::UniqueFD& file, size_t size) {
   return true;
 }
 
+bool WriteFileAt(const fml::UniqueFD& file,
+                 size_t offset,
+                 const Mapping& data) {
+  if (!file.is_valid() || data.GetMapping() == nullptr) {
+    return false;
+  }
+
+  size_t written = 0;
+  while (written < data.GetSize()) {
+    ULARGE_INTEGER position;
+    position.QuadPart = offset + written;
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = position.LowPart;
+    overlapped.OffsetHigh = position.HighPart;
+    DWORD chunk = static_cast<DWORD>(
+        std::min<size_t>(data.GetSize() - written, MAXDWORD));
+    DWORD chunk_written = 0;
+    if (!::WriteFile(file.get(), data.GetMapping() + written, chunk,
+                     &chunk_written, &overlapped)) {
+      FML_DLOG(ERROR) << "Could not write file. " << GetLastErrorMessage();
+      return false;
+    }
+    written += chunk_written;
+  }
+  return true;
+}
+
+bool LockFile(const fml::UniqueFD& file) {
+  OVERLAPPED overlapped = {};
+  if (!::LockFileEx(file.get(), LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD,
+                    &overlapped)) {
+    FML_DLOG(ERROR) << "Could not lock file. " << GetLastErrorMessage();
+    return false;
+  }
+  return true;
+}
+
+bool UnlockFile(const fml::UniqueFD& file) {
+  OVERLAPPED overlapped = {};
+  return ::UnlockFileEx(file.get(), 0, MAXDWORD, MAXDWORD, &overlapped);
+}
+
 bool FileExists(const fml::UniqueFD& base_directory, const char* path) {
   return GetFileAttributesForUtf8Path(base_directory, path) !=
          INVALID_FILE_ATTRIBUTES;
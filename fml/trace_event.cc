@@ -53,6 +53,10 @@ void TraceSetTimelineEventHandler(TimelineEventHandler handler) {
   gTimelineEventHandler = handler;
 }
 
+TimelineEventHandler TraceGetTimelineEventHandler() {
+  return gTimelineEventHandler.load(std::memory_order_relaxed);
+}
+
 bool TraceHasTimelineEventHandler() {
   return static_cast<bool>(
       gTimelineEventHandler.load(std::memory_order_relaxed));
@@ -372,6 +376,10 @@ void TraceSetAllowlist(const std::vector<std::string>& allowlist) {}
 
 void TraceSetTimelineEventHandler(TimelineEventHandler handler) {}
 
+TimelineEventHandler TraceGetTimelineEventHandler() {
+  return nullptr;
+}
+
 bool TraceHasTimelineEventHandler() {
   return false;
 }
@@ -228,6 +228,8 @@ using TimelineMicrosSource = int64_t (*)();
 
 void TraceSetTimelineEventHandler(TimelineEventHandler handler);
 
+TimelineEventHandler TraceGetTimelineEventHandler();
+
 bool TraceHasTimelineEventHandler();
 
 void TraceSetTimelineMicrosSource(TimelineMicrosSource source);
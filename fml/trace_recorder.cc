@@ -0,0 +1,607 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+constexpr size_t kMaxLabelLength = 48;
+constexpr size_t kMaxArguments = 2;
+constexpr size_t kMaxArgumentNameLength = 24;
+constexpr size_t kMaxArgumentValueLength = 40;
+
+// Events are copied into fixed size records so that recording never
+// allocates. Labels and arguments that do not fit are truncated.
+struct RecordedEvent {
+  int64_t timestamp0;
+  int64_t timestamp1_or_async_id;
+  int64_t flow_id;
+  Dart_Timeline_Event_Type type;
+  uint8_t argument_count;
+  char label[kMaxLabelLength];
+  char argument_names[kMaxArguments][kMaxArgumentNameLength];
+  char argument_values[kMaxArguments][kMaxArgumentValueLength];
+};
+
+// A ring buffer written only by its owning thread. Readers validate each
+// slot with a sequence number (a seqlock) so that events being overwritten
+// during serialization are skipped instead of being reported torn.
+struct ThreadBuffer {
+  struct Slot {
+    std::atomic<uint64_t> sequence = 0;
+    RecordedEvent event;
+  };
+
+  ThreadBuffer(size_t capacity, int64_t thread_index)
+      : slots(new Slot[capacity]),
+        capacity(capacity),
+        thread_index(thread_index) {}
+
+  std::unique_ptr<Slot[]> slots;
+  const size_t capacity;
+  const int64_t thread_index;
+  // Index of the next event to be written.
+  std::atomic<uint64_t> next = 0;
+  // Events with an index below this were discarded by TraceRecorderClear.
+  std::atomic<uint64_t> floor = 0;
+};
+
+struct IndexedEvent {
+  int64_t thread_index;
+  RecordedEvent event;
+};
+
+std::atomic<bool> gRecorderEnabled = false;
+// The timeline event handler the recorder replaced, which is reinstalled
+// when it is disabled.
+std::atomic<TimelineEventHandler> gReplacedHandler = nullptr;
+std::atomic<size_t> gEventsPerThread = kTraceRecorderDefaultEventsPerThread;
+
+// Guards registration of thread buffers. Only taken the first time a thread
+// records an event and during serialization.
+std::mutex gBuffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>>& GetBuffers() {
+  static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  return buffers;
+}
+
+// Buffers are never destroyed, so events of threads that have exited can
+// still be serialized.
+thread_local ThreadBuffer* tls_buffer = nullptr;
+
+ThreadBuffer* GetThreadBuffer() {
+  if (tls_buffer == nullptr) {
+    std::scoped_lock lock(gBuffersMutex);
+    auto& buffers = GetBuffers();
+    buffers.push_back(std::make_unique<ThreadBuffer>(
+        gEventsPerThread.load(std::memory_order_relaxed), buffers.size()));
+    tls_buffer = buffers.back().get();
+  }
+  return tls_buffer;
+}
+
+void CopyTruncated(char* destination, size_t capacity, const char* source) {
+  if (source == nullptr) {
+    destination[0] = '\0';
+    return;
+  }
+  size_t length = strnlen(source, capacity - 1);
+  memcpy(destination, source, length);
+  destination[length] = '\0';
+}
+
+void RecordTimelineEvent(const char* label,
+                         int64_t timestamp0,
+                         int64_t timestamp1_or_async_id,
+                         intptr_t flow_id_count,
+                         const int64_t* flow_ids,
+                         Dart_Timeline_Event_Type type,
+                         intptr_t argument_count,
+                         const char** argument_names,
+                         const char** argument_values) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  uint64_t index = buffer->next.load(std::memory_order_relaxed);
+  ThreadBuffer::Slot& slot = buffer->slots[index % buffer->capacity];
+
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  RecordedEvent& event = slot.event;
+  if (timestamp0 < 0) {
+    // No timeline clock was installed (for instance when tracing to
+    // systrace), fall back to the engine clock.
+    timestamp0 = TimePoint::Now().ToEpochDelta().ToMicroseconds();
+  }
+  event.timestamp0 = timestamp0;
+  event.timestamp1_or_async_id = timestamp1_or_async_id;
+  event.flow_id = flow_id_count > 0 && flow_ids ? flow_ids[0] : 0;
+  event.type = type;
+  event.argument_count = static_cast<uint8_t>(
+      std::min<intptr_t>(argument_count, kMaxArguments));
+  CopyTruncated(event.label, kMaxLabelLength, label);
+  for (size_t i = 0; i < event.argument_count; i++) {
+    CopyTruncated(event.argument_names[i], kMaxArgumentNameLength,
+                  argument_names[i]);
+    CopyTruncated(event.argument_values[i], kMaxArgumentValueLength,
+                  argument_values[i]);
+  }
+
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  buffer->next.store(index + 1, std::memory_order_release);
+}
+
+// Collects a consistent snapshot of all recorded events, sorted by time.
+std::vector<IndexedEvent> CollectEvents(std::vector<int64_t>* thread_indices) {
+  std::vector<IndexedEvent> events;
+  std::scoped_lock lock(gBuffersMutex);
+  for (const auto& buffer : GetBuffers()) {
+    uint64_t end = buffer->next.load(std::memory_order_acquire);
+    uint64_t begin = buffer->floor.load(std::memory_order_relaxed);
+    if (end > buffer->capacity) {
+      begin = std::max<uint64_t>(begin, end - buffer->capacity);
+    }
+    if (begin < end && thread_indices) {
+      thread_indices->push_back(buffer->thread_index);
+    }
+    for (uint64_t index = begin; index < end; index++) {
+      const ThreadBuffer::Slot& slot = buffer->slots[index % buffer->capacity];
+      uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+      IndexedEvent indexed = {buffer->thread_index, slot.event};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence != 2 * index + 2 ||
+          slot.sequence.load(std::memory_order_relaxed) != sequence) {
+        // The slot was overwritten while being read.
+        continue;
+      }
+      events.push_back(indexed);
+    }
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const IndexedEvent& a, const IndexedEvent& b) {
+                     return a.event.timestamp0 < b.event.timestamp0;
+                   });
+  return events;
+}
+
+void AppendJSONString(std::string& out, const char* string) {
+  out.push_back('"');
+  for (const char* c = string; *c; c++) {
+    switch (*c) {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+          out.append(escaped);
+        } else {
+          out.push_back(*c);
+        }
+    }
+  }
+  out.push_back('"');
+}
+
+const char* ChromePhase(Dart_Timeline_Event_Type type) {
+  switch (type) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Instant:
+      return "i";
+    case Dart_Timeline_Event_Duration:
+      return "X";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Counter:
+      return "C";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+    case Dart_Timeline_Event_Metadata:
+      return "M";
+  }
+  return "i";
+}
+
+bool IsAsync(Dart_Timeline_Event_Type type) {
+  return type == Dart_Timeline_Event_Async_Begin ||
+         type == Dart_Timeline_Event_Async_End ||
+         type == Dart_Timeline_Event_Async_Instant;
+}
+
+bool IsFlow(Dart_Timeline_Event_Type type) {
+  return type == Dart_Timeline_Event_Flow_Begin ||
+         type == Dart_Timeline_Event_Flow_Step ||
+         type == Dart_Timeline_Event_Flow_End;
+}
+
+// Minimal protobuf encoder for the subset of the Perfetto trace format used
+// by the recorder. See perfetto/protos/perfetto/trace/trace_packet.proto.
+class ProtoWriter {
+ public:
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      buffer_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    buffer_.push_back(static_cast<char>(value));
+  }
+
+  void WriteVarintField(uint32_t field, uint64_t value) {
+    WriteVarint(field << 3);
+    WriteVarint(value);
+  }
+
+  void WriteBytesField(uint32_t field, const std::string& bytes) {
+    WriteVarint((field << 3) | 2);
+    WriteVarint(bytes.size());
+    buffer_.append(bytes);
+  }
+
+  void WriteStringField(uint32_t field, const char* string) {
+    WriteBytesField(field, std::string(string));
+  }
+
+  const std::string& buffer() const { return buffer_; }
+
+ private:
+  std::string buffer_;
+};
+
+// Field numbers from the Perfetto trace protos.
+namespace perfetto_fields {
+constexpr uint32_t kTracePacket = 1;
+
+constexpr uint32_t kPacketTimestamp = 8;
+constexpr uint32_t kPacketTrustedSequenceId = 10;
+constexpr uint32_t kPacketTrackEvent = 11;
+constexpr uint32_t kPacketTrackDescriptor = 60;
+
+constexpr uint32_t kTrackDescriptorUuid = 1;
+constexpr uint32_t kTrackDescriptorName = 2;
+constexpr uint32_t kTrackDescriptorThread = 4;
+constexpr uint32_t kTrackDescriptorParentUuid = 5;
+constexpr uint32_t kTrackDescriptorCounter = 8;
+
+constexpr uint32_t kThreadDescriptorPid = 1;
+constexpr uint32_t kThreadDescriptorTid = 2;
+constexpr uint32_t kThreadDescriptorName = 5;
+
+constexpr uint32_t kTrackEventDebugAnnotations = 4;
+constexpr uint32_t kTrackEventType = 9;
+constexpr uint32_t kTrackEventTrackUuid = 11;
+constexpr uint32_t kTrackEventCategories = 22;
+constexpr uint32_t kTrackEventName = 23;
+constexpr uint32_t kTrackEventCounterValue = 30;
+constexpr uint32_t kTrackEventFlowIds = 47;
+
+constexpr uint32_t kDebugAnnotationStringValue = 6;
+constexpr uint32_t kDebugAnnotationName = 10;
+
+constexpr uint64_t kTypeSliceBegin = 1;
+constexpr uint64_t kTypeSliceEnd = 2;
+constexpr uint64_t kTypeInstant = 3;
+constexpr uint64_t kTypeCounter = 4;
+}  // namespace perfetto_fields
+
+constexpr int32_t kPerfettoPid = 1;
+constexpr uint32_t kPerfettoSequenceId = 1;
+
+uint64_t ThreadTrackUuid(int64_t thread_index) {
+  return 0x1000 + thread_index;
+}
+
+uint64_t AsyncTrackUuid(int64_t async_id) {
+  return 0x8000000000000000ull | static_cast<uint64_t>(async_id);
+}
+
+uint64_t CounterTrackUuid(const std::string& name) {
+  return 0x4000000000000000ull |
+         (std::hash<std::string>()(name) & 0x3FFFFFFFFFFFFFFFull);
+}
+
+void WriteTrackDescriptorPacket(ProtoWriter& trace,
+                                const ProtoWriter& descriptor) {
+  ProtoWriter packet;
+  packet.WriteVarintField(perfetto_fields::kPacketTrustedSequenceId,
+                          kPerfettoSequenceId);
+  packet.WriteBytesField(perfetto_fields::kPacketTrackDescriptor,
+                         descriptor.buffer());
+  trace.WriteBytesField(perfetto_fields::kTracePacket, packet.buffer());
+}
+
+void WriteTrackEventPacket(ProtoWriter& trace,
+                           int64_t timestamp_micros,
+                           const ProtoWriter& track_event) {
+  ProtoWriter packet;
+  packet.WriteVarintField(perfetto_fields::kPacketTimestamp,
+                          static_cast<uint64_t>(timestamp_micros) * 1000);
+  packet.WriteVarintField(perfetto_fields::kPacketTrustedSequenceId,
+                          kPerfettoSequenceId);
+  packet.WriteBytesField(perfetto_fields::kPacketTrackEvent,
+                         track_event.buffer());
+  trace.WriteBytesField(perfetto_fields::kTracePacket, packet.buffer());
+}
+
+}  // namespace
+
+void TraceRecorderEnable(size_t events_per_thread) {
+#if FLUTTER_TIMELINE_ENABLED
+  FML_DCHECK(events_per_thread > 0);
+  gEventsPerThread = events_per_thread;
+  if (!gRecorderEnabled.exchange(true)) {
+    gReplacedHandler = TraceGetTimelineEventHandler();
+  }
+  TraceSetTimelineEventHandler(RecordTimelineEvent);
+#endif  // FLUTTER_TIMELINE_ENABLED
+}
+
+void TraceRecorderDisable() {
+  if (gRecorderEnabled.exchange(false)) {
+    TraceSetTimelineEventHandler(gReplacedHandler.exchange(nullptr));
+  }
+}
+
+bool TraceRecorderIsEnabled() {
+  return gRecorderEnabled;
+}
+
+void TraceRecorderClear() {
+  std::scoped_lock lock(gBuffersMutex);
+  for (const auto& buffer : GetBuffers()) {
+    buffer->floor.store(buffer->next.load(std::memory_order_acquire),
+                        std::memory_order_relaxed);
+  }
+}
+
+std::string TraceRecorderSerializeChromeJSON() {
+  std::vector<int64_t> thread_indices;
+  std::vector<IndexedEvent> events = CollectEvents(&thread_indices);
+
+  std::string out = "{\"traceEvents\":[";
+  bool first = true;
+  auto begin_event = [&]() {
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+  };
+
+  for (int64_t thread_index : thread_indices) {
+    begin_event();
+    out.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":");
+    out.append(std::to_string(kPerfettoPid));
+    out.append(",\"tid\":");
+    out.append(std::to_string(thread_index));
+    out.append(",\"args\":{\"name\":\"Thread ");
+    out.append(std::to_string(thread_index));
+    out.append("\"}}");
+  }
+
+  for (const IndexedEvent& indexed : events) {
+    const RecordedEvent& event = indexed.event;
+    begin_event();
+    out.append("{\"name\":");
+    AppendJSONString(out, event.label);
+    out.append(",\"cat\":\"flutter\",\"ph\":\"");
+    out.append(ChromePhase(event.type));
+    out.append("\",\"ts\":");
+    out.append(std::to_string(event.timestamp0));
+    out.append(",\"pid\":");
+    out.append(std::to_string(kPerfettoPid));
+    out.append(",\"tid\":");
+    out.append(std::to_string(indexed.thread_index));
+    if (event.type == Dart_Timeline_Event_Duration) {
+      out.append(",\"dur\":");
+      out.append(std::to_string(event.timestamp1_or_async_id -
+                                event.timestamp0));
+    } else if (IsAsync(event.type) || IsFlow(event.type)) {
+      char id[32];
+      snprintf(id, sizeof(id), "\"0x%" PRIx64 "\"",
+               static_cast<uint64_t>(event.timestamp1_or_async_id));
+      out.append(",\"id\":");
+      out.append(id);
+    } else if (event.type == Dart_Timeline_Event_Instant) {
+      out.append(",\"s\":\"t\"");
+    }
+    if (event.argument_count > 0) {
+      out.append(",\"args\":{");
+      for (size_t i = 0; i < event.argument_count; i++) {
+        if (i > 0) {
+          out.push_back(',');
+        }
+        AppendJSONString(out, event.argument_names[i]);
+        out.push_back(':');
+        if (event.type == Dart_Timeline_Event_Counter) {
+          // Counter values must be numbers for the trace viewers to plot them.
+          out.append(std::to_string(
+              strtoll(event.argument_values[i], nullptr, 10)));
+        } else {
+          AppendJSONString(out, event.argument_values[i]);
+        }
+      }
+      out.push_back('}');
+    }
+    out.push_back('}');
+  }
+  out.append("],\"displayTimeUnit\":\"ms\"}");
+  return out;
+}
+
+std::string TraceRecorderSerializePerfetto() {
+  namespace pf = perfetto_fields;
+
+  std::vector<int64_t> thread_indices;
+  std::vector<IndexedEvent> events = CollectEvents(&thread_indices);
+
+  ProtoWriter trace;
+  for (int64_t thread_index : thread_indices) {
+    ProtoWriter thread;
+    thread.WriteVarintField(pf::kThreadDescriptorPid, kPerfettoPid);
+    thread.WriteVarintField(pf::kThreadDescriptorTid, thread_index);
+    thread.WriteBytesField(pf::kThreadDescriptorName,
+                           "Thread " + std::to_string(thread_index));
+    ProtoWriter descriptor;
+    descriptor.WriteVarintField(pf::kTrackDescriptorUuid,
+                                ThreadTrackUuid(thread_index));
+    descriptor.WriteBytesField(pf::kTrackDescriptorThread, thread.buffer());
+    WriteTrackDescriptorPacket(trace, descriptor);
+  }
+
+  std::set<uint64_t> described_tracks;
+  auto describe_track = [&](uint64_t uuid, const std::string& name,
+                            uint64_t parent_uuid, bool is_counter) {
+    if (!described_tracks.insert(uuid).second) {
+      return;
+    }
+    ProtoWriter descriptor;
+    descriptor.WriteVarintField(pf::kTrackDescriptorUuid, uuid);
+    descriptor.WriteBytesField(pf::kTrackDescriptorName, name);
+    descriptor.WriteVarintField(pf::kTrackDescriptorParentUuid, parent_uuid);
+    if (is_counter) {
+      descriptor.WriteBytesField(pf::kTrackDescriptorCounter, "");
+    }
+    WriteTrackDescriptorPacket(trace, descriptor);
+  };
+
+  for (const IndexedEvent& indexed : events) {
+    const RecordedEvent& event = indexed.event;
+    uint64_t thread_track = ThreadTrackUuid(indexed.thread_index);
+
+    if (event.type == Dart_Timeline_Event_Counter) {
+      // Each counter argument becomes its own counter track.
+      for (size_t i = 0; i < event.argument_count; i++) {
+        std::string name =
+            std::string(event.label) + "." + event.argument_names[i];
+        uint64_t uuid = CounterTrackUuid(name);
+        describe_track(uuid, name, thread_track, true);
+        ProtoWriter track_event;
+        track_event.WriteVarintField(pf::kTrackEventType, pf::kTypeCounter);
+        track_event.WriteVarintField(pf::kTrackEventTrackUuid, uuid);
+        track_event.WriteVarintField(
+            pf::kTrackEventCounterValue,
+            static_cast<uint64_t>(
+                strtoll(event.argument_values[i], nullptr, 10)));
+        WriteTrackEventPacket(trace, event.timestamp0, track_event);
+      }
+      continue;
+    }
+
+    if (event.type == Dart_Timeline_Event_Metadata) {
+      continue;
+    }
+
+    uint64_t track = thread_track;
+    if (IsAsync(event.type)) {
+      track = AsyncTrackUuid(event.timestamp1_or_async_id);
+      describe_track(track, event.label, thread_track, false);
+    }
+
+    uint64_t type = pf::kTypeInstant;
+    switch (event.type) {
+      case Dart_Timeline_Event_Begin:
+      case Dart_Timeline_Event_Async_Begin:
+      case Dart_Timeline_Event_Duration:
+        type = pf::kTypeSliceBegin;
+        break;
+      case Dart_Timeline_Event_End:
+      case Dart_Timeline_Event_Async_End:
+        type = pf::kTypeSliceEnd;
+        break;
+      default:
+        break;
+    }
+
+    ProtoWriter track_event;
+    track_event.WriteVarintField(pf::kTrackEventType, type);
+    track_event.WriteVarintField(pf::kTrackEventTrackUuid, track);
+    if (type != pf::kTypeSliceEnd) {
+      track_event.WriteStringField(pf::kTrackEventCategories, "flutter");
+      track_event.WriteStringField(pf::kTrackEventName, event.label);
+      for (size_t i = 0; i < event.argument_count; i++) {
+        ProtoWriter annotation;
+        annotation.WriteStringField(pf::kDebugAnnotationName,
+                                    event.argument_names[i]);
+        annotation.WriteStringField(pf::kDebugAnnotationStringValue,
+                                    event.argument_values[i]);
+        track_event.WriteBytesField(pf::kTrackEventDebugAnnotations,
+                                    annotation.buffer());
+      }
+    }
+    if (IsFlow(event.type)) {
+      track_event.WriteVarintField(
+          pf::kTrackEventFlowIds,
+          static_cast<uint64_t>(event.timestamp1_or_async_id));
+    } else if (event.flow_id != 0) {
+      track_event.WriteVarintField(pf::kTrackEventFlowIds,
+                                   static_cast<uint64_t>(event.flow_id));
+    }
+    WriteTrackEventPacket(trace, event.timestamp0, track_event);
+
+    if (event.type == Dart_Timeline_Event_Duration) {
+      ProtoWriter end_event;
+      end_event.WriteVarintField(pf::kTrackEventType, pf::kTypeSliceEnd);
+      end_event.WriteVarintField(pf::kTrackEventTrackUuid, track);
+      WriteTrackEventPacket(trace, event.timestamp1_or_async_id, end_event);
+    }
+  }
+  return trace.buffer();
+}
+
+bool TraceRecorderWriteToFile(const std::string& path) {
+  constexpr char kJSONExtension[] = ".json";
+  constexpr size_t kJSONExtensionLength = sizeof(kJSONExtension) - 1;
+  bool is_json = path.size() >= kJSONExtensionLength &&
+                 path.compare(path.size() - kJSONExtensionLength,
+                              kJSONExtensionLength, kJSONExtension) == 0;
+  std::string contents = is_json ? TraceRecorderSerializeChromeJSON()
+                                 : TraceRecorderSerializePerfetto();
+
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    FML_LOG(ERROR) << "Could not open trace file " << path;
+    return false;
+  }
+  file.write(contents.data(), contents.size());
+  return file.good();
+}
+
+}  // namespace tracing
+}  // namespace fml
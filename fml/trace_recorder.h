@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RECORDER_H_
+#define FLUTTER_FML_TRACE_RECORDER_H_
+
+#include <cstddef>
+#include <string>
+
+namespace fml {
+namespace tracing {
+
+// The default number of events retained per thread by the trace recorder.
+// Once a thread has recorded more events, its oldest events are overwritten.
+constexpr size_t kTraceRecorderDefaultEventsPerThread = 1 << 13;
+
+//------------------------------------------------------------------------------
+/// @brief      Starts recording trace events into in-process, per-thread ring
+///             buffers instead of forwarding them to the Dart timeline.
+///
+///             The recorder is installed as the timeline event handler, so
+///             all `TRACE_EVENT*` macros are routed to it. When the recorder
+///             is not enabled, it is not on the tracing path at all.
+///
+///             Recording an event never takes a lock. Each thread writes only
+///             to its own buffer, which is registered once on the first
+///             event recorded by that thread.
+///
+/// @param[in]  events_per_thread  The capacity of buffers created for threads
+///                                that have not recorded any events yet.
+///
+void TraceRecorderEnable(
+    size_t events_per_thread = kTraceRecorderDefaultEventsPerThread);
+
+//------------------------------------------------------------------------------
+/// @brief      Stops recording trace events. Events recorded so far are kept
+///             and can still be serialized. The timeline event handler that
+///             was installed when the recorder was enabled is reinstalled.
+///
+void TraceRecorderDisable();
+
+bool TraceRecorderIsEnabled();
+
+//------------------------------------------------------------------------------
+/// @brief      Discards all events recorded so far.
+///
+void TraceRecorderClear();
+
+//------------------------------------------------------------------------------
+/// @brief      Serializes the recorded events in the Chrome trace event JSON
+///             format, which can be loaded in chrome://tracing and Perfetto.
+///
+std::string TraceRecorderSerializeChromeJSON();
+
+//------------------------------------------------------------------------------
+/// @brief      Serializes the recorded events as a Perfetto protobuf trace.
+///
+std::string TraceRecorderSerializePerfetto();
+
+//------------------------------------------------------------------------------
+/// @brief      Writes the recorded events to the file at the specified path.
+///             Paths ending in `.json` are written in the Chrome trace event
+///             JSON format, all other paths as a Perfetto protobuf trace.
+///
+/// @return     Whether the file was written successfully.
+///
+bool TraceRecorderWriteToFile(const std::string& path);
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RECORDER_H_
@@ -0,0 +1,154 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/trace_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+#if FLUTTER_TIMELINE_ENABLED
+
+class TraceRecorderTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    TraceRecorderEnable();
+    TraceRecorderClear();
+  }
+
+  void TearDown() override {
+    TraceRecorderDisable();
+    TraceRecorderClear();
+  }
+};
+
+static size_t CountOccurrences(const std::string& haystack,
+                               const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    count++;
+  }
+  return count;
+}
+
+TEST_F(TraceRecorderTest, RecordsScopedEvents) {
+  ASSERT_TRUE(TraceRecorderIsEnabled());
+  { TRACE_EVENT0("flutter", "RecorderTestEvent"); }
+
+  std::string json = TraceRecorderSerializeChromeJSON();
+  EXPECT_EQ(CountOccurrences(json, "\"name\":\"RecorderTestEvent\""), 2u);
+  EXPECT_NE(json.find("\"ph\":\"B\""), std::string::npos);
+  EXPECT_NE(json.find("\"ph\":\"E\""), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, RecordsArgumentsAndEscapesStrings) {
+  { TRACE_EVENT1("flutter", "Quoted\"Event", "key", "value\\"); }
+
+  std::string json = TraceRecorderSerializeChromeJSON();
+  EXPECT_NE(json.find("\"name\":\"Quoted\\\"Event\""), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"key\":\"value\\\\\"}"), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, RecordsEventsFromMultipleThreads) {
+  constexpr int kThreadCount = 4;
+  constexpr int kEventsPerThread = 100;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([] {
+      for (int j = 0; j < kEventsPerThread; j++) {
+        TRACE_EVENT0("flutter", "ThreadedEvent");
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::string json = TraceRecorderSerializeChromeJSON();
+  EXPECT_EQ(CountOccurrences(json, "\"name\":\"ThreadedEvent\""),
+            2u * kThreadCount * kEventsPerThread);
+}
+
+TEST_F(TraceRecorderTest, OverwritesOldestEventsWhenFull) {
+  TraceRecorderEnable(16);
+  std::thread thread([] {
+    for (int i = 0; i < 100; i++) {
+      TRACE_EVENT_INSTANT0("flutter", "OverflowEvent");
+    }
+  });
+  thread.join();
+
+  std::string json = TraceRecorderSerializeChromeJSON();
+  EXPECT_EQ(CountOccurrences(json, "\"name\":\"OverflowEvent\""), 16u);
+}
+
+TEST_F(TraceRecorderTest, ClearDiscardsEvents) {
+  { TRACE_EVENT0("flutter", "ClearedEvent"); }
+  TraceRecorderClear();
+  { TRACE_EVENT0("flutter", "KeptEvent"); }
+
+  std::string json = TraceRecorderSerializeChromeJSON();
+  EXPECT_EQ(json.find("ClearedEvent"), std::string::npos);
+  EXPECT_NE(json.find("KeptEvent"), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, DisabledRecorderDoesNotRecord) {
+  TraceRecorderDisable();
+  EXPECT_FALSE(TraceHasTimelineEventHandler());
+  { TRACE_EVENT0("flutter", "DisabledEvent"); }
+
+  std::string json = TraceRecorderSerializeChromeJSON();
+  EXPECT_EQ(json.find("DisabledEvent"), std::string::npos);
+}
+
+static void NoopTimelineEventHandler(const char* label,
+                                     int64_t timestamp0,
+                                     int64_t timestamp1_or_async_id,
+                                     intptr_t flow_id_count,
+                                     const int64_t* flow_ids,
+                                     Dart_Timeline_Event_Type type,
+                                     intptr_t argument_count,
+                                     const char** argument_names,
+                                     const char** argument_values) {}
+
+TEST_F(TraceRecorderTest, DisableRestoresReplacedHandler) {
+  TraceRecorderDisable();
+  TraceSetTimelineEventHandler(NoopTimelineEventHandler);
+
+  TraceRecorderEnable();
+  TraceRecorderEnable();
+  EXPECT_NE(TraceGetTimelineEventHandler(), NoopTimelineEventHandler);
+  TraceRecorderDisable();
+  EXPECT_EQ(TraceGetTimelineEventHandler(), NoopTimelineEventHandler);
+
+  TraceSetTimelineEventHandler(nullptr);
+}
+
+TEST_F(TraceRecorderTest, SerializesPerfetto) {
+  EXPECT_TRUE(TraceRecorderSerializePerfetto().empty());
+
+  { TRACE_EVENT0("flutter", "PerfettoEvent"); }
+  FML_TRACE_COUNTER("flutter", "PerfettoCounter", 0, "count", 3);
+
+  std::string proto = TraceRecorderSerializePerfetto();
+  ASSERT_FALSE(proto.empty());
+  // Every top level field is a length delimited TracePacket (field 1).
+  EXPECT_EQ(proto[0], 0x0A);
+  EXPECT_NE(proto.find("PerfettoEvent"), std::string::npos);
+  EXPECT_NE(proto.find("PerfettoCounter.count"), std::string::npos);
+}
+
+#endif  // FLUTTER_TIMELINE_ENABLED
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
@@ -56,6 +56,7 @@ bool AiksContext::Render(const Picture& picture,
     if (reset_host_buffer) {
       content_context_->GetTransientsBuffer().Reset();
     }
+    content_context_->SavePipelineVariantManifest();
   });
   if (picture.pass) {
     return picture.pass->Render(*content_context_, render_target);
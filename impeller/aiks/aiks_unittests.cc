@@ -1994,6 +1994,66 @@ TEST_P(AiksTest, DrawRectAbsorbsClearsNegative) {
   ASSERT_EQ(render_pass->GetCommands().size(), 2llu);
 }
 
+TEST_P(AiksTest, BatchesRunsOfSolidColorRects) {
+  Canvas canvas;
+  for (int i = 0; i < 10; i++) {
+    canvas.DrawRect(Rect::MakeXYWH(i * 20, i * 10, 40, 40),
+                    {.color = Color::Red().WithAlpha(0.1f * (i + 1))});
+  }
+
+  Picture picture = canvas.EndRecordingAsPicture();
+  std::shared_ptr<ContextSpy> spy = ContextSpy::Make();
+  std::shared_ptr<Context> real_context = GetContext();
+  std::shared_ptr<ContextMock> mock_context = spy->MakeContext(real_context);
+  AiksContext renderer(mock_context, nullptr);
+  std::shared_ptr<Image> image = picture.ToImage(renderer, {300, 300});
+
+  ASSERT_EQ(spy->render_passes_.size(), 1llu);
+  std::shared_ptr<RenderPass> render_pass = spy->render_passes_[0];
+  ASSERT_EQ(render_pass->GetCommands().size(), 1llu);
+  EXPECT_EQ(picture.pass->GetBatchStats().batch_count, 1u);
+  EXPECT_EQ(picture.pass->GetBatchStats().batched_entity_count, 10u);
+}
+
+TEST_P(AiksTest, SolidColorRectBatchIsDrawnAroundDisjointContent) {
+  Canvas canvas;
+  canvas.DrawRect(Rect::MakeXYWH(0, 0, 50, 50), {.color = Color::Red()});
+  canvas.DrawCircle({200, 200}, 20, {.color = Color::Blue()});
+  canvas.DrawRect(Rect::MakeXYWH(50, 0, 50, 50), {.color = Color::Green()});
+
+  Picture picture = canvas.EndRecordingAsPicture();
+  std::shared_ptr<ContextSpy> spy = ContextSpy::Make();
+  std::shared_ptr<Context> real_context = GetContext();
+  std::shared_ptr<ContextMock> mock_context = spy->MakeContext(real_context);
+  AiksContext renderer(mock_context, nullptr);
+  std::shared_ptr<Image> image = picture.ToImage(renderer, {300, 300});
+
+  ASSERT_EQ(spy->render_passes_.size(), 1llu);
+  std::shared_ptr<RenderPass> render_pass = spy->render_passes_[0];
+  ASSERT_EQ(render_pass->GetCommands().size(), 2llu);
+  EXPECT_EQ(picture.pass->GetBatchStats().batch_count, 1u);
+  EXPECT_EQ(picture.pass->GetBatchStats().batched_entity_count, 2u);
+}
+
+TEST_P(AiksTest, SolidColorRectBatchIsFlushedBeforeOverlappingContent) {
+  Canvas canvas;
+  canvas.DrawRect(Rect::MakeXYWH(0, 0, 50, 50), {.color = Color::Red()});
+  canvas.DrawCircle({50, 25}, 20, {.color = Color::Blue()});
+  canvas.DrawRect(Rect::MakeXYWH(50, 0, 50, 50), {.color = Color::Green()});
+
+  Picture picture = canvas.EndRecordingAsPicture();
+  std::shared_ptr<ContextSpy> spy = ContextSpy::Make();
+  std::shared_ptr<Context> real_context = GetContext();
+  std::shared_ptr<ContextMock> mock_context = spy->MakeContext(real_context);
+  AiksContext renderer(mock_context, nullptr);
+  std::shared_ptr<Image> image = picture.ToImage(renderer, {300, 300});
+
+  ASSERT_EQ(spy->render_passes_.size(), 1llu);
+  std::shared_ptr<RenderPass> render_pass = spy->render_passes_[0];
+  ASSERT_EQ(render_pass->GetCommands().size(), 3llu);
+  EXPECT_EQ(picture.pass->GetBatchStats().batch_count, 0u);
+}
+
 TEST_P(AiksTest, ClipRectElidesNoOpClips) {
   Canvas canvas(Rect::MakeXYWH(0, 0, 100, 100));
   canvas.ClipRect(Rect::MakeXYWH(0, 0, 100, 100));
@@ -126,6 +126,11 @@ Path ToPath(const SkPath& path, Point shift) {
   builder.Shift(shift);
   auto sk_bounds = path.getBounds().makeOutset(shift.x, shift.y);
   builder.SetBounds(ToRect(sk_bounds));
+  // Paths that are no longer volatile keep their generation ID, and therefore
+  // their geometry, across frames. See |flutter::VolatilePathTracker|.
+  if (!path.isVolatile() && shift.IsZero()) {
+    builder.SetCacheKey(path.getGenerationID());
+  }
   return builder.TakePath(fill_type);
 }
 
@@ -2,11 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "display_list/dl_color.h"
 #include "display_list/dl_tile_mode.h"
 #include "flutter/testing/testing.h"
 #include "impeller/display_list/skia_conversions.h"
 #include "impeller/geometry/scalar.h"
+#include "impeller/tessellator/tessellator.h"
 
 namespace impeller {
 namespace testing {
@@ -174,5 +177,80 @@ TEST(SkiaConversionsTest, GradientConversionNonMonotonic) {
   ASSERT_TRUE(ScalarNearlyEqual(converted_stops[3], 1.0f));
 }
 
+TEST(SkiaConversionsTest, NonVolatilePathHasCacheKey) {
+  SkPath sk_path;
+  sk_path.moveTo(0, 0);
+  sk_path.cubicTo(10, 0, 10, 10, 0, 10);
+
+  auto path = skia_conversions::ToPath(sk_path);
+  EXPECT_NE(path.GetCacheKey(), 0u);
+  EXPECT_EQ(skia_conversions::ToPath(sk_path).GetCacheKey(),
+            path.GetCacheKey());
+
+  sk_path.lineTo(0, 0);
+  EXPECT_NE(skia_conversions::ToPath(sk_path).GetCacheKey(),
+            path.GetCacheKey());
+}
+
+TEST(SkiaConversionsTest, CachedFillsDependOnFillType) {
+  // Two overlapping squares, whose overlap is only filled with the nonzero
+  // fill type.
+  SkPath sk_path;
+  sk_path.addRect(SkRect::MakeXYWH(0, 0, 100, 100));
+  sk_path.addRect(SkRect::MakeXYWH(50, 50, 100, 100));
+
+  struct Fill {
+    std::vector<float> vertices;
+    std::vector<uint16_t> indices;
+
+    bool operator==(const Fill& other) const {
+      return vertices == other.vertices && indices == other.indices;
+    }
+  };
+  auto tessellate = [](Tessellator& tessellator, const Path& path) {
+    Fill fill;
+    auto result = tessellator.Tessellate(
+        path, 1.0f,
+        [&fill](const float* vertices, size_t vertices_count,
+                const uint16_t* indices, size_t indices_count) {
+          fill.vertices.assign(vertices, vertices + vertices_count * 2);
+          fill.indices.assign(indices, indices + indices_count);
+          return true;
+        });
+    EXPECT_EQ(result, Tessellator::Result::kSuccess);
+    return fill;
+  };
+
+  Tessellator tessellator;
+  sk_path.setFillType(SkPathFillType::kWinding);
+  auto nonzero_path = skia_conversions::ToPath(sk_path);
+  auto nonzero_fill = tessellate(tessellator, nonzero_path);
+
+  sk_path.setFillType(SkPathFillType::kEvenOdd);
+  auto even_odd_path = skia_conversions::ToPath(sk_path);
+  // Changing the fill type does not change the generation ID.
+  ASSERT_EQ(even_odd_path.GetCacheKey(), nonzero_path.GetCacheKey());
+  auto even_odd_fill = tessellate(tessellator, even_odd_path);
+  EXPECT_EQ(tessellator.GetPathCache().GetStats().fill_misses, 2u);
+
+  // Each fill matches the one of a tessellator that has not cached the other.
+  Tessellator uncached_tessellator;
+  EXPECT_TRUE(even_odd_fill == tessellate(uncached_tessellator, even_odd_path));
+  EXPECT_FALSE(even_odd_fill == nonzero_fill);
+  EXPECT_TRUE(tessellate(tessellator, nonzero_path) == nonzero_fill);
+  EXPECT_EQ(tessellator.GetPathCache().GetStats().fill_hits, 1u);
+}
+
+TEST(SkiaConversionsTest, VolatileOrShiftedPathHasNoCacheKey) {
+  SkPath sk_path;
+  sk_path.moveTo(0, 0);
+  sk_path.lineTo(10, 10);
+
+  EXPECT_EQ(skia_conversions::ToPath(sk_path, Point(1, 1)).GetCacheKey(), 0u);
+
+  sk_path.setIsVolatile(true);
+  EXPECT_EQ(skia_conversions::ToPath(sk_path).GetCacheKey(), 0u);
+}
+
 }  // namespace testing
 }  // namespace impeller
@@ -73,6 +73,10 @@ bool ClipContents::CanInheritOpacity(const Entity& entity) const {
 
 void ClipContents::SetInheritedOpacity(Scalar opacity) {}
 
+const Geometry* ClipContents::GetPositionGeometry() const {
+  return geometry_.get();
+}
+
 bool ClipContents::Render(const ContentContext& renderer,
                           const Entity& entity,
                           RenderPass& pass) const {
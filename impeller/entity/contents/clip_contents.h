@@ -48,6 +48,9 @@ class ClipContents final : public Contents {
   // |Contents|
   void SetInheritedOpacity(Scalar opacity) override;
 
+  // |Contents|
+  const Geometry* GetPositionGeometry() const override;
+
  private:
   std::shared_ptr<Geometry> geometry_;
   Entity::ClipOperation clip_op_ = Entity::ClipOperation::kIntersect;
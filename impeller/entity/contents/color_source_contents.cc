@@ -46,6 +46,10 @@ std::optional<Rect> ColorSourceContents::GetCoverage(
   return geometry_->GetCoverage(entity.GetTransform());
 };
 
+const Geometry* ColorSourceContents::GetPositionGeometry() const {
+  return geometry_.get();
+}
+
 bool ColorSourceContents::CanInheritOpacity(const Entity& entity) const {
   return true;
 }
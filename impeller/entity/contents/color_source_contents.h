@@ -94,6 +94,9 @@ class ColorSourceContents : public Contents {
   // |Contents|
   std::optional<Rect> GetCoverage(const Entity& entity) const override;
 
+  // |Contents|
+  const Geometry* GetPositionGeometry() const override;
+
   // |Contents|
   bool CanInheritOpacity(const Entity& entity) const override;
 
@@ -4,8 +4,11 @@
 
 #include "impeller/entity/contents/content_context.h"
 
+#include <algorithm>
 #include <memory>
+#include <thread>
 
+#include "flutter/fml/trace_event.h"
 #include "impeller/base/strings.h"
 #include "impeller/core/formats.h"
 #include "impeller/entity/contents/framebuffer_blend_contents.h"
@@ -154,6 +157,35 @@ void ContentContextOptions::ApplyToPipelineDescriptor(
   desc.SetPolygonMode(wireframe ? PolygonMode::kLine : PolygonMode::kFill);
 }
 
+std::optional<ContentContextOptions> ContentContextOptions::FromKey(
+    uint64_t key) {
+  auto field = [key](int shift) -> uint8_t { return (key >> shift) & 0xff; };
+  ContentContextOptions options{
+      .sample_count = static_cast<SampleCount>(field(56)),
+      .blend_mode = static_cast<BlendMode>(field(48)),
+      .stencil_compare = static_cast<CompareFunction>(field(40)),
+      .stencil_operation = static_cast<StencilOperation>(field(32)),
+      .primitive_type = static_cast<PrimitiveType>(field(24)),
+      .color_attachment_pixel_format = static_cast<PixelFormat>(field(16)),
+      .has_depth_stencil_attachments = ((key >> 2) & 1) != 0,
+      .wireframe = ((key >> 1) & 1) != 0,
+      .is_for_rrect_blur_clear = (key & 1) != 0,
+  };
+  // Reject keys with unused bits set and fields out of the range of their
+  // enums, as applying them to a pipeline descriptor is undefined.
+  if (options.ToKey() != key ||
+      (options.sample_count != SampleCount::kCount1 &&
+       options.sample_count != SampleCount::kCount4) ||
+      options.blend_mode > Entity::kLastPipelineBlendMode ||
+      options.stencil_compare > CompareFunction::kGreaterEqual ||
+      options.stencil_operation > StencilOperation::kDecrementWrap ||
+      options.primitive_type > PrimitiveType::kPoint ||
+      options.color_attachment_pixel_format > PixelFormat::kD32FloatS8UInt) {
+    return std::nullopt;
+  }
+  return options;
+}
+
 template <typename PipelineT>
 static std::unique_ptr<PipelineT> CreateDefaultPipeline(
     const Context& context) {
@@ -171,6 +203,9 @@ static std::unique_ptr<PipelineT> CreateDefaultPipeline(
   return std::make_unique<PipelineT>(context, desc);
 }
 
+// The most worker tasks that prepare vertices concurrently for a frame.
+static constexpr size_t kMaxWorkerTessellatorCount = 4u;
+
 ContentContext::ContentContext(
     std::shared_ptr<Context> context,
     std::shared_ptr<TypographerContext> typographer_context,
@@ -191,6 +226,14 @@ ContentContext::ContentContext(
     return;
   }
 
+  if (context_->GetConcurrentWorkerTaskRunner()) {
+    auto worker_tessellator_count = std::min<size_t>(
+        kMaxWorkerTessellatorCount, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < worker_tessellator_count; i++) {
+      worker_tessellators_.push_back(std::make_shared<Tessellator>());
+    }
+  }
+
   auto options = ContentContextOptions{
       .sample_count = SampleCount::kCount4,
       .color_attachment_pixel_format =
@@ -480,6 +523,11 @@ std::shared_ptr<Tessellator> ContentContext::GetTessellator() const {
   return tessellator_;
 }
 
+const std::vector<std::shared_ptr<Tessellator>>&
+ContentContext::GetWorkerTessellators() const {
+  return worker_tessellators_;
+}
+
 std::shared_ptr<Context> ContentContext::GetContext() const {
   return context_;
 }
@@ -492,6 +540,142 @@ void ContentContext::SetWireframe(bool wireframe) {
   wireframe_ = wireframe;
 }
 
+std::string ContentContext::VariantsBase::MakeName(
+    std::string_view vertex_shader_label,
+    const PipelineDescriptor& desc) {
+  // Pipelines that share shaders differ in their specialization constants.
+  std::string name =
+      SPrintF("%.*s/%s", static_cast<int>(vertex_shader_label.size()),
+              vertex_shader_label.data(), desc.GetLabel().c_str());
+  for (Scalar constant : desc.GetSpecializationConstants()) {
+    name += SPrintF(" %g", constant);
+  }
+  return name;
+}
+
+std::vector<ContentContext::VariantsBase*> ContentContext::GetAllVariants()
+    const {
+  return {
+#ifdef IMPELLER_DEBUG
+      &checkerboard_pipelines_,
+#endif  // IMPELLER_DEBUG
+      &solid_fill_pipelines_,
+      &linear_gradient_fill_pipelines_,
+      &radial_gradient_fill_pipelines_,
+      &conical_gradient_fill_pipelines_,
+      &sweep_gradient_fill_pipelines_,
+      &linear_gradient_ssbo_fill_pipelines_,
+      &radial_gradient_ssbo_fill_pipelines_,
+      &conical_gradient_ssbo_fill_pipelines_,
+      &sweep_gradient_ssbo_fill_pipelines_,
+      &rrect_blur_pipelines_,
+      &texture_blend_pipelines_,
+      &texture_pipelines_,
+      &texture_strict_src_pipelines_,
+#ifdef IMPELLER_ENABLE_OPENGLES
+      &texture_external_pipelines_,
+      &tiled_texture_external_pipelines_,
+#endif  // IMPELLER_ENABLE_OPENGLES
+      &position_uv_pipelines_,
+      &tiled_texture_pipelines_,
+      &gaussian_blur_noalpha_decal_pipelines_,
+      &gaussian_blur_noalpha_nodecal_pipelines_,
+      &kernel_decal_pipelines_,
+      &kernel_nodecal_pipelines_,
+      &border_mask_blur_pipelines_,
+      &morphology_filter_pipelines_,
+      &color_matrix_color_filter_pipelines_,
+      &linear_to_srgb_filter_pipelines_,
+      &srgb_to_linear_filter_pipelines_,
+      &clip_pipelines_,
+      &glyph_atlas_pipelines_,
+      &glyph_atlas_color_pipelines_,
+      &geometry_color_pipelines_,
+      &yuv_to_rgb_filter_pipelines_,
+      &porter_duff_blend_pipelines_,
+      &blend_color_pipelines_,
+      &blend_colorburn_pipelines_,
+      &blend_colordodge_pipelines_,
+      &blend_darken_pipelines_,
+      &blend_difference_pipelines_,
+      &blend_exclusion_pipelines_,
+      &blend_hardlight_pipelines_,
+      &blend_hue_pipelines_,
+      &blend_lighten_pipelines_,
+      &blend_luminosity_pipelines_,
+      &blend_multiply_pipelines_,
+      &blend_overlay_pipelines_,
+      &blend_saturation_pipelines_,
+      &blend_screen_pipelines_,
+      &blend_softlight_pipelines_,
+      &framebuffer_blend_color_pipelines_,
+      &framebuffer_blend_colorburn_pipelines_,
+      &framebuffer_blend_colordodge_pipelines_,
+      &framebuffer_blend_darken_pipelines_,
+      &framebuffer_blend_difference_pipelines_,
+      &framebuffer_blend_exclusion_pipelines_,
+      &framebuffer_blend_hardlight_pipelines_,
+      &framebuffer_blend_hue_pipelines_,
+      &framebuffer_blend_lighten_pipelines_,
+      &framebuffer_blend_luminosity_pipelines_,
+      &framebuffer_blend_multiply_pipelines_,
+      &framebuffer_blend_overlay_pipelines_,
+      &framebuffer_blend_saturation_pipelines_,
+      &framebuffer_blend_screen_pipelines_,
+      &framebuffer_blend_softlight_pipelines_
+  };
+}
+
+size_t ContentContext::SetPipelineVariantManifest(
+    std::shared_ptr<PipelineVariantManifest> manifest) {
+  pipeline_variant_manifest_ = std::move(manifest);
+  if (!IsValid() || !pipeline_variant_manifest_) {
+    return 0u;
+  }
+  TRACE_EVENT0("impeller", "PrewarmPipelineVariants");
+
+  std::unordered_map<std::string_view, VariantsBase*> variants_by_name;
+  for (VariantsBase* variants : GetAllVariants()) {
+    if (!variants->GetName().empty()) {
+      variants_by_name[variants->GetName()] = variants;
+    }
+  }
+
+  // Variants of pipelines that are unknown to this engine or unsupported by
+  // this device are skipped.
+  size_t prewarmed_count = 0u;
+  for (const auto& variant : pipeline_variant_manifest_->GetVariants()) {
+    auto found = variants_by_name.find(variant.pipeline_name);
+    if (found == variants_by_name.end()) {
+      continue;
+    }
+    auto options = ContentContextOptions::FromKey(variant.options_key);
+    if (!options.has_value()) {
+      continue;
+    }
+    if (found->second->PrewarmVariant(*context_, options.value())) {
+      prewarmed_count++;
+    }
+  }
+  return prewarmed_count;
+}
+
+void ContentContext::SavePipelineVariantManifest() const {
+  if (!pipeline_variant_manifest_ ||
+      !pipeline_variant_manifest_->HasUnsavedVariants()) {
+    return;
+  }
+  auto worker_task_runner = context_->GetConcurrentWorkerTaskRunner();
+  if (!worker_task_runner) {
+    // The manifest is small, and this only happens on frames that already
+    // waited for new variants to be created.
+    pipeline_variant_manifest_->Save();
+    return;
+  }
+  worker_task_runner->PostTask(
+      [manifest = pipeline_variant_manifest_]() { manifest->Save(); });
+}
+
 std::shared_ptr<Pipeline<PipelineDescriptor>>
 ContentContext::GetCachedRuntimeEffectPipeline(
     const std::string& unique_entrypoint_name,
@@ -8,7 +8,10 @@
 #include <initializer_list>
 #include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
@@ -16,6 +19,7 @@
 #include "impeller/base/validation.h"
 #include "impeller/core/formats.h"
 #include "impeller/core/host_buffer.h"
+#include "impeller/entity/contents/pipeline_variant_manifest.h"
 #include "impeller/entity/entity.h"
 #include "impeller/renderer/capabilities.h"
 #include "impeller/renderer/pipeline.h"
@@ -289,26 +293,37 @@ struct ContentContextOptions {
   bool wireframe = false;
   bool is_for_rrect_blur_clear = false;
 
+  /// A key that uniquely identifies these options. The key of a set of
+  /// options is stable across launches of the same engine, which allows it to
+  /// be persisted.
+  constexpr uint64_t ToKey() const {
+    static_assert(sizeof(sample_count) == 1);
+    static_assert(sizeof(blend_mode) == 1);
+    static_assert(sizeof(sample_count) == 1);
+    static_assert(sizeof(stencil_compare) == 1);
+    static_assert(sizeof(stencil_operation) == 1);
+    static_assert(sizeof(primitive_type) == 1);
+    static_assert(sizeof(color_attachment_pixel_format) == 1);
+
+    return (is_for_rrect_blur_clear ? 1llu : 0llu) << 0 |
+           (wireframe ? 1llu : 0llu) << 1 |
+           (has_depth_stencil_attachments ? 1llu : 0llu) << 2 |
+           // enums
+           static_cast<uint64_t>(color_attachment_pixel_format) << 16 |
+           static_cast<uint64_t>(primitive_type) << 24 |
+           static_cast<uint64_t>(stencil_operation) << 32 |
+           static_cast<uint64_t>(stencil_compare) << 40 |
+           static_cast<uint64_t>(blend_mode) << 48 |
+           static_cast<uint64_t>(sample_count) << 56;
+  }
+
+  /// The options identified by a key returned by `ToKey`, or std::nullopt if
+  /// the key does not identify options that can be applied to a pipeline.
+  static std::optional<ContentContextOptions> FromKey(uint64_t key);
+
   struct Hash {
     constexpr uint64_t operator()(const ContentContextOptions& o) const {
-      static_assert(sizeof(o.sample_count) == 1);
-      static_assert(sizeof(o.blend_mode) == 1);
-      static_assert(sizeof(o.sample_count) == 1);
-      static_assert(sizeof(o.stencil_compare) == 1);
-      static_assert(sizeof(o.stencil_operation) == 1);
-      static_assert(sizeof(o.primitive_type) == 1);
-      static_assert(sizeof(o.color_attachment_pixel_format) == 1);
-
-      return (o.is_for_rrect_blur_clear ? 1llu : 0llu) << 0 |
-             (o.wireframe ? 1llu : 0llu) << 1 |
-             (o.has_depth_stencil_attachments ? 1llu : 0llu) << 2 |
-             // enums
-             static_cast<uint64_t>(o.color_attachment_pixel_format) << 16 |
-             static_cast<uint64_t>(o.primitive_type) << 24 |
-             static_cast<uint64_t>(o.stencil_operation) << 32 |
-             static_cast<uint64_t>(o.stencil_compare) << 40 |
-             static_cast<uint64_t>(o.blend_mode) << 48 |
-             static_cast<uint64_t>(o.sample_count) << 56;
+      return o.ToKey();
     }
   };
 
@@ -352,6 +367,13 @@ class ContentContext {
 
   std::shared_ptr<Tessellator> GetTessellator() const;
 
+  /// Tessellators for use by the tasks that prepare vertices on the worker
+  /// threads of the context. Empty if the context has no workers.
+  ///
+  /// @see  `PrepareVerticesConcurrently`
+  const std::vector<std::shared_ptr<Tessellator>>& GetWorkerTessellators()
+      const;
+
 #ifdef IMPELLER_DEBUG
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetCheckerboardPipeline(
       ContentContextOptions opts) const {
@@ -760,6 +782,29 @@ class ContentContext {
   void ClearCachedRuntimeEffectPipeline(
       const std::string& unique_entrypoint_name) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Records the pipeline variants created from now on in the
+  ///             manifest, and starts creating the variants recorded in it by
+  ///             previous launches without waiting for them.
+  ///
+  ///             This is meant to be called once, before the first frame, so
+  ///             that variants need not be created while rendering frames.
+  ///
+  /// @param[in]  manifest  The manifest. May be nullptr, which stops recording
+  ///                       variants.
+  ///
+  /// @return     The number of variants that were started.
+  ///
+  size_t SetPipelineVariantManifest(
+      std::shared_ptr<PipelineVariantManifest> manifest);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Saves the variants recorded in the pipeline variant manifest
+  ///             since it was last saved, if any. The manifest is written on a
+  ///             worker thread if the context has one.
+  ///
+  void SavePipelineVariantManifest() const;
+
   /// @brief Retrieve the currnent host buffer for transient storage.
   ///
   /// This is only safe to use from the raster threads. Other threads should
@@ -796,8 +841,29 @@ class ContentContext {
                              RuntimeEffectPipelineKey::Equal>
       runtime_effect_pipelines_;
 
+  class VariantsBase {
+   public:
+    virtual ~VariantsBase() = default;
+
+    /// The name of the pipeline the variants are derived from, which is the
+    /// same across launches of the engine. Empty until the default pipeline
+    /// is set.
+    const std::string& GetName() const { return name_; }
+
+    /// Starts creating the variant for the options if it has not been created
+    /// yet, without waiting for it. Returns whether creation was started.
+    virtual bool PrewarmVariant(const Context& context,
+                                const ContentContextOptions& options) = 0;
+
+   protected:
+    static std::string MakeName(std::string_view vertex_shader_label,
+                                const PipelineDescriptor& desc);
+
+    std::string name_;
+  };
+
   template <class PipelineT>
-  class Variants {
+  class Variants : public VariantsBase {
    public:
     Variants() = default;
 
@@ -809,6 +875,9 @@ class ContentContext {
     void SetDefault(const ContentContextOptions& options,
                     std::unique_ptr<PipelineT> pipeline) {
       default_options_ = options;
+      if (auto desc = pipeline->GetDescriptor(); desc.has_value()) {
+        name_ = MakeName(PipelineT::VertexShader::kLabel, desc.value());
+      }
       Set(options, std::move(pipeline));
     }
 
@@ -843,6 +912,27 @@ class ContentContext {
 
     size_t GetPipelineCount() const { return pipelines_.size(); }
 
+    // |VariantsBase|
+    bool PrewarmVariant(const Context& context,
+                        const ContentContextOptions& options) override {
+      if (Get(options) != nullptr) {
+        return false;
+      }
+      auto prototype = GetDefault();
+      if (prototype == nullptr) {
+        return false;
+      }
+      auto desc = prototype->GetDescriptor();
+      if (!desc.has_value()) {
+        return false;
+      }
+      options.ApplyToPipelineDescriptor(*desc);
+      desc->SetLabel(
+          SPrintF("%s V#%zu", desc->GetLabel().c_str(), GetPipelineCount()));
+      Set(options, std::make_unique<PipelineT>(context, desc));
+      return true;
+    }
+
    private:
     std::optional<ContentContextOptions> default_options_;
     std::unordered_map<ContentContextOptions,
@@ -995,16 +1085,26 @@ class ContentContext {
     auto variant = std::make_unique<TypedPipeline>(std::move(variant_future));
     auto variant_pipeline = variant->WaitAndGet();
     container.Set(opts, std::move(variant));
+    if (pipeline_variant_manifest_) {
+      pipeline_variant_manifest_->RecordVariant(container.GetName(),
+                                                opts.ToKey());
+    }
     return variant_pipeline;
   }
 
+  /// Every container of pipeline variants, including those of pipelines the
+  /// device does not support.
+  std::vector<VariantsBase*> GetAllVariants() const;
+
   bool is_valid_ = false;
   std::shared_ptr<Tessellator> tessellator_;
+  std::vector<std::shared_ptr<Tessellator>> worker_tessellators_;
 #if IMPELLER_ENABLE_3D
   std::shared_ptr<scene::SceneContext> scene_context_;
 #endif  // IMPELLER_ENABLE_3D
   std::shared_ptr<RenderTargetAllocator> render_target_cache_;
   std::shared_ptr<HostBuffer> host_buffer_;
+  std::shared_ptr<PipelineVariantManifest> pipeline_variant_manifest_;
   bool wireframe_ = false;
 
   ContentContext(const ContentContext&) = delete;
@@ -71,6 +71,33 @@ static std::shared_ptr<FakePipeline> CreateFakePipelineCallback() {
   return std::make_shared<FakePipeline>();
 }
 
+TEST(ContentContext, OptionsCanBeRecreatedFromKeys) {
+  ContentContextOptions options{
+      .sample_count = SampleCount::kCount4,
+      .blend_mode = BlendMode::kModulate,
+      .stencil_compare = CompareFunction::kGreaterEqual,
+      .stencil_operation = StencilOperation::kIncrementClamp,
+      .primitive_type = PrimitiveType::kTriangleStrip,
+      .color_attachment_pixel_format = PixelFormat::kB10G10R10XR,
+      .has_depth_stencil_attachments = false,
+      .wireframe = true,
+  };
+  auto recreated = ContentContextOptions::FromKey(options.ToKey());
+  ASSERT_TRUE(recreated.has_value());
+  EXPECT_TRUE(ContentContextOptions::Equal{}(options, recreated.value()));
+
+  // Advanced blends are not applied by pipelines.
+  auto advanced_blend = options;
+  advanced_blend.blend_mode = BlendMode::kColorBurn;
+  EXPECT_FALSE(
+      ContentContextOptions::FromKey(advanced_blend.ToKey()).has_value());
+  EXPECT_FALSE(ContentContextOptions::FromKey(options.ToKey() | 1u << 8)
+                   .has_value());
+  EXPECT_FALSE(ContentContextOptions::FromKey(
+                   (options.ToKey() & ~(0xffllu << 56)) | 2llu << 56)
+                   .has_value());
+}
+
 TEST(ContentContext, CachesPipelines) {
   auto context = std::make_shared<FakeContext>();
   ContentContext content_context(context, nullptr);
@@ -125,6 +125,14 @@ const FilterContents* Contents::AsFilter() const {
   return nullptr;
 }
 
+const SolidColorContents* Contents::AsSolidColor() const {
+  return nullptr;
+}
+
+const Geometry* Contents::GetPositionGeometry() const {
+  return nullptr;
+}
+
 bool Contents::ApplyColorFilter(
     const Contents::ColorFilterProc& color_filter_proc) {
   return false;
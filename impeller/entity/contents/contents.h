@@ -25,6 +25,8 @@ class Entity;
 class Surface;
 class RenderPass;
 class FilterContents;
+class SolidColorContents;
+class Geometry;
 
 ContentContextOptions OptionsFromPass(const RenderPass& pass);
 
@@ -173,6 +175,23 @@ class Contents {
   ///
   virtual const FilterContents* AsFilter() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief Cast to a solid color fill. Returns `nullptr` if this Contents is
+  ///        not a `SolidColorContents`.
+  ///
+  virtual const SolidColorContents* AsSolidColor() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief Returns the geometry whose position buffer is generated when this
+  ///        contents is rendered, or `nullptr` if there is none.
+  ///
+  ///        The vertices of this geometry may be prepared ahead of rendering
+  ///        on a worker thread.
+  ///
+  /// @see   `Geometry::PrepareVertices`
+  ///
+  virtual const Geometry* GetPositionGeometry() const;
+
   //----------------------------------------------------------------------------
   /// @brief      If possible, applies a color filter to this contents inputs on
   ///             the CPU.
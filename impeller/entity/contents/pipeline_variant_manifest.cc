@@ -0,0 +1,186 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/pipeline_variant_manifest.h"
+
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+static constexpr const char* kManifestFileName =
+    "flutter.impeller.pipeline_variants";
+
+// "IPVM" in little endian.
+static constexpr uint32_t kManifestMagic = 0x4d565049;
+static constexpr uint32_t kManifestVersion = 1u;
+
+struct ManifestHeader {
+  uint32_t magic = kManifestMagic;
+  uint32_t version = kManifestVersion;
+  uint32_t variant_count = 0u;
+};
+
+// Each variant is stored as this header followed by the pipeline name.
+struct VariantHeader {
+  uint64_t options_key = 0u;
+  uint32_t name_length = 0u;
+  uint32_t reserved = 0u;
+};
+
+// Pipeline names are short labels derived from the shader names.
+static constexpr uint32_t kMaxPipelineNameLength = 256u;
+
+PipelineVariantManifest::PipelineVariantManifest(fml::UniqueFD directory)
+    : directory_(std::move(directory)) {
+  if (!directory_.is_valid()) {
+    return;
+  }
+  auto mapping =
+      fml::FileMapping::CreateReadOnly(directory_, kManifestFileName);
+  if (!mapping) {
+    return;
+  }
+  auto variants = Deserialize(*mapping);
+  if (!variants.has_value()) {
+    FML_LOG(WARNING) << "Ignoring an invalid pipeline variant manifest.";
+    return;
+  }
+  for (auto& variant : variants.value()) {
+    if (recorded_.emplace(variant.pipeline_name, variant.options_key).second) {
+      variants_.push_back(std::move(variant));
+    }
+  }
+}
+
+PipelineVariantManifest::~PipelineVariantManifest() = default;
+
+std::vector<PipelineVariantManifest::Variant>
+PipelineVariantManifest::GetVariants() const {
+  std::scoped_lock lock(mutex_);
+  return variants_;
+}
+
+bool PipelineVariantManifest::RecordVariant(std::string_view pipeline_name,
+                                            uint64_t options_key) {
+  if (pipeline_name.empty() || pipeline_name.size() > kMaxPipelineNameLength) {
+    return false;
+  }
+  std::scoped_lock lock(mutex_);
+  if (variants_.size() >= kMaxVariantCount) {
+    return false;
+  }
+  if (!recorded_.emplace(std::string{pipeline_name}, options_key).second) {
+    return false;
+  }
+  variants_.push_back(Variant{
+      .pipeline_name = std::string{pipeline_name},
+      .options_key = options_key,
+  });
+  has_unsaved_variants_ = true;
+  return true;
+}
+
+bool PipelineVariantManifest::HasUnsavedVariants() const {
+  return has_unsaved_variants_;
+}
+
+bool PipelineVariantManifest::Save() {
+  std::scoped_lock save_lock(save_mutex_);
+  if (!directory_.is_valid() || did_fail_to_save_) {
+    return false;
+  }
+  if (!has_unsaved_variants_.exchange(false)) {
+    return true;
+  }
+  TRACE_EVENT0("impeller", "PipelineVariantManifest::Save");
+  auto data = Serialize(GetVariants());
+  if (!data || !fml::WriteAtomically(directory_, kManifestFileName, *data)) {
+    // The directory is most likely read-only. Don't try again for every new
+    // variant.
+    FML_LOG(WARNING) << "Could not save the pipeline variant manifest.";
+    did_fail_to_save_ = true;
+    return false;
+  }
+  return true;
+}
+
+std::shared_ptr<fml::Mapping> PipelineVariantManifest::Serialize(
+    const std::vector<Variant>& variants) {
+  size_t size = sizeof(ManifestHeader);
+  for (const auto& variant : variants) {
+    size += sizeof(VariantHeader) + variant.pipeline_name.size();
+  }
+  auto data = std::make_shared<std::vector<uint8_t>>(size);
+
+  uint8_t* cursor = data->data();
+  ManifestHeader header;
+  header.variant_count = variants.size();
+  std::memcpy(cursor, &header, sizeof(header));
+  cursor += sizeof(header);
+  for (const auto& variant : variants) {
+    VariantHeader variant_header;
+    variant_header.options_key = variant.options_key;
+    variant_header.name_length = variant.pipeline_name.size();
+    std::memcpy(cursor, &variant_header, sizeof(variant_header));
+    cursor += sizeof(variant_header);
+    std::memcpy(cursor, variant.pipeline_name.data(),
+                variant.pipeline_name.size());
+    cursor += variant.pipeline_name.size();
+  }
+
+  return std::make_shared<fml::NonOwnedMapping>(
+      data->data(), data->size(), [data](auto, auto) {});
+}
+
+std::optional<std::vector<PipelineVariantManifest::Variant>>
+PipelineVariantManifest::Deserialize(const fml::Mapping& mapping) {
+  const uint8_t* cursor = mapping.GetMapping();
+  size_t remaining = mapping.GetSize();
+  if (cursor == nullptr || remaining < sizeof(ManifestHeader)) {
+    return std::nullopt;
+  }
+
+  ManifestHeader header;
+  std::memcpy(&header, cursor, sizeof(header));
+  cursor += sizeof(header);
+  remaining -= sizeof(header);
+  if (header.magic != kManifestMagic || header.version != kManifestVersion ||
+      header.variant_count > kMaxVariantCount) {
+    return std::nullopt;
+  }
+
+  std::vector<Variant> variants;
+  variants.reserve(header.variant_count);
+  for (uint32_t i = 0; i < header.variant_count; i++) {
+    if (remaining < sizeof(VariantHeader)) {
+      return std::nullopt;
+    }
+    VariantHeader variant_header;
+    std::memcpy(&variant_header, cursor, sizeof(variant_header));
+    cursor += sizeof(variant_header);
+    remaining -= sizeof(variant_header);
+    if (variant_header.name_length == 0u ||
+        variant_header.name_length > kMaxPipelineNameLength ||
+        remaining < variant_header.name_length) {
+      return std::nullopt;
+    }
+    variants.push_back(Variant{
+        .pipeline_name = std::string{reinterpret_cast<const char*>(cursor),
+                                     variant_header.name_length},
+        .options_key = variant_header.options_key,
+    });
+    cursor += variant_header.name_length;
+    remaining -= variant_header.name_length;
+  }
+  if (remaining != 0u) {
+    return std::nullopt;
+  }
+  return variants;
+}
+
+}  // namespace impeller
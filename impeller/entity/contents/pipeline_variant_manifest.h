@@ -0,0 +1,110 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_MANIFEST_H_
+#define FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_MANIFEST_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A record of the pipeline variants an application has created,
+///             kept on disk so that the next launch can create the same
+///             variants before they are first needed.
+///
+///             Variants are identified by the name of the pipeline they are
+///             derived from and the key of their `ContentContextOptions`.
+///             Variants may be recorded and saved from any thread.
+///
+class PipelineVariantManifest {
+ public:
+  struct Variant {
+    std::string pipeline_name;
+    uint64_t options_key = 0;
+
+    bool operator==(const Variant& other) const {
+      return pipeline_name == other.pipeline_name &&
+             options_key == other.options_key;
+    }
+  };
+
+  /// The most variants a manifest records. Variants recorded beyond this are
+  /// dropped, which keeps the manifest small if options are ever used in an
+  /// unbounded number of combinations.
+  static constexpr size_t kMaxVariantCount = 1024u;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a manifest stored in the given directory, and loads
+  ///             the variants recorded by previous launches from it.
+  ///
+  /// @param[in]  directory  The directory of the manifest. If this is not a
+  ///                        valid directory, variants are only recorded in
+  ///                        memory.
+  ///
+  explicit PipelineVariantManifest(fml::UniqueFD directory = {});
+
+  ~PipelineVariantManifest();
+
+  //----------------------------------------------------------------------------
+  /// @return     The recorded variants, in the order they were first recorded.
+  ///
+  std::vector<Variant> GetVariants() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records that a variant was created.
+  ///
+  /// @return     Whether the variant was not recorded before.
+  ///
+  bool RecordVariant(std::string_view pipeline_name, uint64_t options_key);
+
+  //----------------------------------------------------------------------------
+  /// @return     Whether variants were recorded since the manifest was loaded
+  ///             or last saved.
+  ///
+  bool HasUnsavedVariants() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Writes the manifest to its directory if there are unsaved
+  ///             variants.
+  ///
+  /// @return     Whether the manifest on disk is up to date.
+  ///
+  bool Save();
+
+  static std::shared_ptr<fml::Mapping> Serialize(
+      const std::vector<Variant>& variants);
+
+  static std::optional<std::vector<Variant>> Deserialize(
+      const fml::Mapping& mapping);
+
+ private:
+  const fml::UniqueFD directory_;
+  std::mutex save_mutex_;
+  mutable std::mutex mutex_;
+  std::vector<Variant> variants_;
+  std::set<std::pair<std::string, uint64_t>> recorded_;
+  std::atomic_bool has_unsaved_variants_ = false;
+  bool did_fail_to_save_ = false;
+
+  PipelineVariantManifest(const PipelineVariantManifest&) = delete;
+
+  PipelineVariantManifest& operator=(const PipelineVariantManifest&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_CONTENTS_PIPELINE_VARIANT_MANIFEST_H_
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+#include "impeller/entity/contents/pipeline_variant_manifest.h"
+
+namespace impeller {
+namespace testing {
+
+using Variant = PipelineVariantManifest::Variant;
+
+TEST(PipelineVariantManifestTest, CanSerializeAndDeserializeVariants) {
+  std::vector<Variant> variants = {
+      {.pipeline_name = "SolidFill/SolidFill Pipeline", .options_key = 1u},
+      {.pipeline_name = "AdvancedBlend/AdvancedBlend Pipeline 5 1",
+       .options_key = 0xff00000000000004},
+  };
+  auto data = PipelineVariantManifest::Serialize(variants);
+  ASSERT_TRUE(data);
+
+  auto deserialized = PipelineVariantManifest::Deserialize(*data);
+  ASSERT_TRUE(deserialized.has_value());
+  EXPECT_EQ(deserialized.value(), variants);
+}
+
+TEST(PipelineVariantManifestTest, RejectsInvalidData) {
+  auto data = PipelineVariantManifest::Serialize(
+      {{.pipeline_name = "SolidFill/SolidFill Pipeline", .options_key = 1u}});
+  ASSERT_TRUE(data);
+
+  // Truncated.
+  for (size_t size : {size_t{0u}, size_t{4u}, data->GetSize() - 1}) {
+    fml::NonOwnedMapping truncated(data->GetMapping(), size);
+    EXPECT_FALSE(PipelineVariantManifest::Deserialize(truncated).has_value());
+  }
+
+  // Trailing data.
+  std::vector<uint8_t> extended(data->GetMapping(),
+                                data->GetMapping() + data->GetSize());
+  extended.push_back(0u);
+  fml::NonOwnedMapping extended_mapping(extended.data(), extended.size());
+  EXPECT_FALSE(
+      PipelineVariantManifest::Deserialize(extended_mapping).has_value());
+
+  // Unknown format.
+  std::vector<uint8_t> corrupted(data->GetMapping(),
+                                 data->GetMapping() + data->GetSize());
+  corrupted[0] ^= 0xff;
+  fml::NonOwnedMapping corrupted_mapping(corrupted.data(), corrupted.size());
+  EXPECT_FALSE(
+      PipelineVariantManifest::Deserialize(corrupted_mapping).has_value());
+}
+
+TEST(PipelineVariantManifestTest, RecordsEachVariantOnce) {
+  PipelineVariantManifest manifest;
+  EXPECT_FALSE(manifest.HasUnsavedVariants());
+
+  EXPECT_TRUE(manifest.RecordVariant("SolidFill", 1u));
+  EXPECT_TRUE(manifest.RecordVariant("SolidFill", 2u));
+  EXPECT_TRUE(manifest.RecordVariant("TextureFill", 1u));
+  EXPECT_FALSE(manifest.RecordVariant("SolidFill", 1u));
+  EXPECT_FALSE(manifest.RecordVariant("", 1u));
+  EXPECT_TRUE(manifest.HasUnsavedVariants());
+
+  std::vector<Variant> expected = {
+      {.pipeline_name = "SolidFill", .options_key = 1u},
+      {.pipeline_name = "SolidFill", .options_key = 2u},
+      {.pipeline_name = "TextureFill", .options_key = 1u},
+  };
+  EXPECT_EQ(manifest.GetVariants(), expected);
+
+  // There is nowhere to save a manifest without a directory.
+  EXPECT_FALSE(manifest.Save());
+}
+
+TEST(PipelineVariantManifestTest, LoadsVariantsSavedByPreviousManifest) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  {
+    PipelineVariantManifest manifest(fml::Duplicate(temp_dir.fd().get()));
+    EXPECT_TRUE(manifest.GetVariants().empty());
+    manifest.RecordVariant("SolidFill", 1u);
+    EXPECT_TRUE(manifest.Save());
+    EXPECT_FALSE(manifest.HasUnsavedVariants());
+  }
+
+  PipelineVariantManifest manifest(fml::Duplicate(temp_dir.fd().get()));
+  std::vector<Variant> expected = {
+      {.pipeline_name = "SolidFill", .options_key = 1u},
+  };
+  EXPECT_EQ(manifest.GetVariants(), expected);
+  EXPECT_FALSE(manifest.HasUnsavedVariants());
+  EXPECT_FALSE(manifest.RecordVariant("SolidFill", 1u));
+}
+
+}  // namespace testing
+}  // namespace impeller
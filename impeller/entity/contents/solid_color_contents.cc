@@ -103,6 +103,10 @@ std::optional<Color> SolidColorContents::AsBackgroundColor(
              : std::optional<Color>();
 }
 
+const SolidColorContents* SolidColorContents::AsSolidColor() const {
+  return this;
+}
+
 bool SolidColorContents::ApplyColorFilter(
     const ColorFilterProc& color_filter_proc) {
   color_ = color_filter_proc(color_);
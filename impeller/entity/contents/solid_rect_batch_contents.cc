@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/contents/solid_rect_batch_contents.h"
+
+#include "flutter/fml/logging.h"
+#include "impeller/entity/contents/content_context.h"
+#include "impeller/entity/contents/solid_color_contents.h"
+#include "impeller/entity/entity.h"
+#include "impeller/entity/geometry/geometry.h"
+#include "impeller/renderer/render_pass.h"
+#include "impeller/renderer/vertex_buffer_builder.h"
+
+namespace impeller {
+
+SolidRectBatchContents::SolidRectBatchContents() = default;
+
+SolidRectBatchContents::~SolidRectBatchContents() = default;
+
+bool SolidRectBatchContents::CanBatch(const Entity& entity) {
+  if (entity.GetBlendMode() > Entity::kLastPipelineBlendMode ||
+      entity.GetTransform().HasPerspective()) {
+    return false;
+  }
+  const std::shared_ptr<Contents>& contents = entity.GetContents();
+  const SolidColorContents* solid_color =
+      contents ? contents->AsSolidColor() : nullptr;
+  // Transparent fills have no coverage, so they can't be ordered against the
+  // other entities of the pass.
+  if (!solid_color || solid_color->GetColor().IsTransparent()) {
+    return false;
+  }
+  const std::shared_ptr<Geometry>& geometry = solid_color->GetGeometry();
+  return geometry && geometry->AsFilledRect().has_value();
+}
+
+void SolidRectBatchContents::AddEntity(const Entity& entity) {
+  FML_DCHECK(CanBatch(entity));
+  const SolidColorContents* solid_color = entity.GetContents()->AsSolidColor();
+  Rect rect = solid_color->GetGeometry()->AsFilledRect().value();
+  const Matrix& transform = entity.GetTransform();
+
+  rects_.push_back(BatchedRect{
+      .points = rect.GetTransformedPoints(transform),
+      .premultiplied_color = solid_color->GetColor().Premultiply(),
+  });
+  coverage_ = Rect::Union(coverage_, rect.TransformBounds(transform));
+}
+
+size_t SolidRectBatchContents::GetRectCount() const {
+  return rects_.size();
+}
+
+std::optional<Rect> SolidRectBatchContents::GetCoverage(
+    const Entity& entity) const {
+  if (!coverage_.has_value()) {
+    return std::nullopt;
+  }
+  return coverage_->TransformBounds(entity.GetTransform());
+}
+
+bool SolidRectBatchContents::Render(const ContentContext& renderer,
+                                    const Entity& entity,
+                                    RenderPass& pass) const {
+  using VS = GeometryColorPipeline::VertexShader;
+  using FS = GeometryColorPipeline::FragmentShader;
+
+  if (rects_.empty()) {
+    return true;
+  }
+
+  VertexBufferBuilder<VS::PerVertexData> vertex_builder;
+  vertex_builder.Reserve(rects_.size() * 6);
+  constexpr size_t indices[6] = {0, 1, 2, 1, 2, 3};
+  for (const BatchedRect& rect : rects_) {
+    for (size_t i = 0; i < 6; i++) {
+      VS::PerVertexData data;
+      data.position = rect.points[indices[i]];
+      data.color = rect.premultiplied_color;
+      vertex_builder.AppendVertex(data);
+    }
+  }
+
+  auto& host_buffer = renderer.GetTransientsBuffer();
+
+  VS::FrameInfo frame_info;
+  frame_info.mvp = pass.GetOrthographicTransform() * entity.GetTransform();
+
+  FS::FragInfo frag_info;
+  frag_info.alpha = 1.0;
+
+  pass.SetCommandLabel("Solid Rect Batch");
+  auto options = OptionsFromPassAndEntity(pass, entity);
+  pass.SetPipeline(renderer.GetGeometryColorPipeline(options));
+  pass.SetStencilReference(entity.GetClipDepth());
+  pass.SetVertexBuffer(vertex_builder.CreateVertexBuffer(host_buffer));
+  VS::BindFrameInfo(pass, host_buffer.EmplaceUniform(frame_info));
+  FS::BindFragInfo(pass, host_buffer.EmplaceUniform(frag_info));
+  return pass.Draw().ok();
+}
+
+}  // namespace impeller
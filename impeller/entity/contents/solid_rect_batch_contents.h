@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_CONTENTS_SOLID_RECT_BATCH_CONTENTS_H_
+#define FLUTTER_IMPELLER_ENTITY_CONTENTS_SOLID_RECT_BATCH_CONTENTS_H_
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "impeller/entity/contents/contents.h"
+#include "impeller/geometry/color.h"
+#include "impeller/geometry/point.h"
+#include "impeller/geometry/rect.h"
+
+namespace impeller {
+
+/// Renders a run of solid color rectangle entities with a single draw.
+///
+/// `EntityPass` gathers consecutive entities that satisfy `CanBatch` and share
+/// a blend mode and clip depth into one of these contents. The rectangles are
+/// transformed on the CPU and drawn in order, so the result is identical to
+/// rendering each of the entities in turn.
+class SolidRectBatchContents final : public Contents {
+ public:
+  SolidRectBatchContents();
+
+  // |Contents|
+  ~SolidRectBatchContents() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief  Whether `entity` fills a rectangle with a visible solid color
+  ///         using a blend mode that can be drawn by a batch.
+  ///
+  static bool CanBatch(const Entity& entity);
+
+  //----------------------------------------------------------------------------
+  /// @brief  Appends the rectangle filled by `entity`, which must satisfy
+  ///         `CanBatch`, in the coordinate space of the entity's pass.
+  ///
+  void AddEntity(const Entity& entity);
+
+  size_t GetRectCount() const;
+
+  // |Contents|
+  bool Render(const ContentContext& renderer,
+              const Entity& entity,
+              RenderPass& pass) const override;
+
+  // |Contents|
+  std::optional<Rect> GetCoverage(const Entity& entity) const override;
+
+ private:
+  struct BatchedRect {
+    std::array<Point, 4> points;
+    Color premultiplied_color;
+  };
+
+  std::vector<BatchedRect> rects_;
+  std::optional<Rect> coverage_;
+
+  SolidRectBatchContents(const SolidRectBatchContents&) = delete;
+
+  SolidRectBatchContents& operator=(const SolidRectBatchContents&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_CONTENTS_SOLID_RECT_BATCH_CONTENTS_H_
@@ -7,6 +7,7 @@
 #include <cstring>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "impeller/core/formats.h"
 #include "impeller/core/sampler_descriptor.h"
@@ -79,45 +80,11 @@ bool TextContents::Render(const ContentContext& renderer,
     return false;
   }
 
-  // Information shared by all glyph draw calls.
-  pass.SetCommandLabel("TextFrame");
-  auto opts = OptionsFromPassAndEntity(pass, entity);
-  opts.primitive_type = PrimitiveType::kTriangle;
-  if (type == GlyphAtlas::Type::kAlphaBitmap) {
-    pass.SetPipeline(renderer.GetGlyphAtlasPipeline(opts));
-  } else {
-    pass.SetPipeline(renderer.GetGlyphAtlasColorPipeline(opts));
-  }
-  pass.SetStencilReference(entity.GetClipDepth());
-
   using VS = GlyphAtlasPipeline::VertexShader;
   using FS = GlyphAtlasPipeline::FragmentShader;
 
-  // Common vertex uniforms for all glyphs.
-  VS::FrameInfo frame_info;
-  frame_info.mvp = pass.GetOrthographicTransform();
-  frame_info.atlas_size =
-      Vector2{static_cast<Scalar>(atlas->GetTexture()->GetSize().width),
-              static_cast<Scalar>(atlas->GetTexture()->GetSize().height)};
-  frame_info.offset = offset_;
-  frame_info.is_translation_scale =
-      entity.GetTransform().IsTranslationScaleOnly();
-  frame_info.entity_transform = entity.GetTransform();
-  frame_info.text_color = ToVector(color.Premultiply());
-
-  VS::BindFrameInfo(pass,
-                    renderer.GetTransientsBuffer().EmplaceUniform(frame_info));
-
-  if (type == GlyphAtlas::Type::kColorBitmap) {
-    using FSS = GlyphAtlasColorPipeline::FragmentShader;
-    FSS::FragInfo frag_info;
-    frag_info.use_text_color = force_text_color_ ? 1.0 : 0.0;
-    FSS::BindFragInfo(pass,
-                      renderer.GetTransientsBuffer().EmplaceUniform(frag_info));
-  }
-
   SamplerDescriptor sampler_desc;
-  if (frame_info.is_translation_scale) {
+  if (entity.GetTransform().IsTranslationScaleOnly()) {
     sampler_desc.min_filter = MinMagFilter::kNearest;
     sampler_desc.mag_filter = MinMagFilter::kNearest;
   } else {
@@ -131,13 +98,6 @@ bool TextContents::Render(const ContentContext& renderer,
   }
   sampler_desc.mip_filter = MipFilter::kNearest;
 
-  FS::BindGlyphAtlasSampler(
-      pass,                 // command
-      atlas->GetTexture(),  // texture
-      renderer.GetContext()->GetSamplerLibrary()->GetSampler(
-          sampler_desc)  // sampler
-  );
-
   // Common vertex information for all glyphs.
   // All glyphs are given the same vertex information in the form of a
   // unit-sized quad. The size of the glyph is specified in per instance data
@@ -149,19 +109,50 @@ bool TextContents::Render(const ContentContext& renderer,
                                                 Point{0, 1}, Point{1, 0},
                                                 Point{0, 1}, Point{1, 1}};
 
-  auto& host_buffer = renderer.GetTransientsBuffer();
-  size_t vertex_count = 0;
-  for (const auto& run : frame_->GetRuns()) {
-    vertex_count += run.GetGlyphPositions().size();
+  // The glyphs on each page of the atlas are drawn with a separate draw call,
+  // so the vertices of the glyphs on a page are contiguous in the buffer.
+  const size_t page_count = atlas->GetPageCount();
+  std::vector<size_t> page_glyph_offsets(page_count, 0u);
+  std::vector<size_t> page_glyph_counts(page_count, 0u);
+  if (page_count == 1u) {
+    for (const auto& run : frame_->GetRuns()) {
+      page_glyph_counts[0] += run.GetGlyphPositions().size();
+    }
+  } else {
+    for (const TextRun& run : frame_->GetRuns()) {
+      const Font& font = run.GetFont();
+      Scalar rounded_scale =
+          TextFrame::RoundScaledFontSize(scale_, font.GetMetrics().point_size);
+      const FontGlyphAtlas* font_atlas =
+          atlas->GetFontGlyphAtlas(font, rounded_scale);
+      if (!font_atlas) {
+        continue;
+      }
+      for (const TextRun::GlyphPosition& glyph_position :
+           run.GetGlyphPositions()) {
+        auto atlas_position =
+            font_atlas->FindGlyphPosition(glyph_position.glyph);
+        if (atlas_position.has_value()) {
+          page_glyph_counts[atlas_position->page]++;
+        }
+      }
+    }
+  }
+  size_t glyph_count = 0;
+  for (size_t page = 0; page < page_count; page++) {
+    page_glyph_offsets[page] = glyph_count;
+    glyph_count += page_glyph_counts[page];
   }
-  vertex_count *= 6;
+  size_t vertex_count = glyph_count * unit_points.size();
 
+  auto& host_buffer = renderer.GetTransientsBuffer();
   auto buffer_view = host_buffer.Emplace(
       vertex_count * sizeof(VS::PerVertexData), alignof(VS::PerVertexData),
       [&](uint8_t* contents) {
         VS::PerVertexData vtx;
         VS::PerVertexData* vtx_contents =
             reinterpret_cast<VS::PerVertexData*>(contents);
+        std::vector<size_t> page_glyph_cursors = page_glyph_offsets;
         for (const TextRun& run : frame_->GetRuns()) {
           const Font& font = run.GetFont();
           Scalar rounded_scale = TextFrame::RoundScaledFontSize(
@@ -175,33 +166,94 @@ bool TextContents::Render(const ContentContext& renderer,
 
           for (const TextRun::GlyphPosition& glyph_position :
                run.GetGlyphPositions()) {
-            std::optional<Rect> maybe_atlas_glyph_bounds =
-                font_atlas->FindGlyphBounds(glyph_position.glyph);
-            if (!maybe_atlas_glyph_bounds.has_value()) {
+            std::optional<GlyphAtlasPosition> maybe_atlas_position =
+                font_atlas->FindGlyphPosition(glyph_position.glyph);
+            if (!maybe_atlas_position.has_value()) {
               VALIDATION_LOG << "Could not find glyph position in the atlas.";
               continue;
             }
-            const Rect& atlas_glyph_bounds = maybe_atlas_glyph_bounds.value();
+            const Rect& atlas_glyph_bounds = maybe_atlas_position->bounds;
             vtx.atlas_glyph_bounds = Vector4(atlas_glyph_bounds.GetXYWH());
             vtx.glyph_bounds = Vector4(glyph_position.glyph.bounds.GetXYWH());
             vtx.glyph_position = glyph_position.position;
 
+            size_t glyph_index =
+                page_glyph_cursors[maybe_atlas_position->page]++;
+            VS::PerVertexData* glyph_vertices =
+                vtx_contents + glyph_index * unit_points.size();
             for (const Point& point : unit_points) {
               vtx.unit_position = point;
-              std::memcpy(vtx_contents++, &vtx, sizeof(VS::PerVertexData));
+              std::memcpy(glyph_vertices++, &vtx, sizeof(VS::PerVertexData));
             }
           }
         }
       });
 
-  pass.SetVertexBuffer({
-      .vertex_buffer = std::move(buffer_view),
-      .index_buffer = {},
-      .vertex_count = vertex_count,
-      .index_type = IndexType::kNone,
-  });
-
-  return pass.Draw().ok();
+  for (size_t page = 0; page < page_count; page++) {
+    if (page_glyph_counts[page] == 0u) {
+      continue;
+    }
+    const std::shared_ptr<Texture>& texture = atlas->GetPageTexture(page);
+
+    // Information shared by all glyph draw calls.
+    pass.SetCommandLabel("TextFrame");
+    auto opts = OptionsFromPassAndEntity(pass, entity);
+    opts.primitive_type = PrimitiveType::kTriangle;
+    if (type == GlyphAtlas::Type::kAlphaBitmap) {
+      pass.SetPipeline(renderer.GetGlyphAtlasPipeline(opts));
+    } else {
+      pass.SetPipeline(renderer.GetGlyphAtlasColorPipeline(opts));
+    }
+    pass.SetStencilReference(entity.GetClipDepth());
+
+    // Common vertex uniforms for all glyphs.
+    VS::FrameInfo frame_info;
+    frame_info.mvp = pass.GetOrthographicTransform();
+    frame_info.atlas_size =
+        Vector2{static_cast<Scalar>(texture->GetSize().width),
+                static_cast<Scalar>(texture->GetSize().height)};
+    frame_info.offset = offset_;
+    frame_info.is_translation_scale =
+        entity.GetTransform().IsTranslationScaleOnly();
+    frame_info.entity_transform = entity.GetTransform();
+    frame_info.text_color = ToVector(color.Premultiply());
+
+    VS::BindFrameInfo(
+        pass, renderer.GetTransientsBuffer().EmplaceUniform(frame_info));
+
+    if (type == GlyphAtlas::Type::kColorBitmap) {
+      using FSS = GlyphAtlasColorPipeline::FragmentShader;
+      FSS::FragInfo frag_info;
+      frag_info.use_text_color = force_text_color_ ? 1.0 : 0.0;
+      FSS::BindFragInfo(
+          pass, renderer.GetTransientsBuffer().EmplaceUniform(frag_info));
+    }
+
+    FS::BindGlyphAtlasSampler(
+        pass,     // command
+        texture,  // texture
+        renderer.GetContext()->GetSamplerLibrary()->GetSampler(
+            sampler_desc)  // sampler
+    );
+
+    constexpr size_t kGlyphBytes =
+        unit_points.size() * sizeof(VS::PerVertexData);
+    BufferView page_buffer_view = buffer_view;
+    page_buffer_view.range = Range(
+        buffer_view.range.offset + page_glyph_offsets[page] * kGlyphBytes,
+        page_glyph_counts[page] * kGlyphBytes);
+    pass.SetVertexBuffer({
+        .vertex_buffer = std::move(page_buffer_view),
+        .index_buffer = {},
+        .vertex_count = page_glyph_counts[page] * unit_points.size(),
+        .index_type = IndexType::kNone,
+    });
+
+    if (!pass.Draw().ok()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 }  // namespace impeller
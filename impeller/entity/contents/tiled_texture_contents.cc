@@ -109,6 +109,12 @@ bool TiledTextureContents::IsOpaque() const {
   return texture_->IsOpaque();
 }
 
+const Geometry* TiledTextureContents::GetPositionGeometry() const {
+  // Tiled textures are rendered with the geometry's position and texture
+  // coordinate buffer instead.
+  return nullptr;
+}
+
 bool TiledTextureContents::Render(const ContentContext& renderer,
                                   const Entity& entity,
                                   RenderPass& pass) const {
@@ -36,6 +36,9 @@ class TiledTextureContents final : public ColorSourceContents {
               const Entity& entity,
               RenderPass& pass) const override;
 
+  // |Contents|
+  const Geometry* GetPositionGeometry() const override;
+
   void SetTexture(std::shared_ptr<Texture> texture);
 
   void SetTileModes(Entity::TileMode x_tile_mode, Entity::TileMode y_tile_mode);
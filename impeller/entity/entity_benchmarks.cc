@@ -0,0 +1,255 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/logging.h"
+#include "impeller/entity/geometry/geometry.h"
+#include "impeller/entity/geometry/prepare_vertices.h"
+#include "impeller/geometry/path_builder.h"
+#include "impeller/renderer/command.h"
+#include "impeller/renderer/render_pass.h"
+#include "impeller/tessellator/tessellator.h"
+
+// The heap allocations made by each thread, counted so that benchmarks can
+// report allocations alongside time.
+static thread_local size_t tls_allocation_count = 0u;
+
+void* operator new(size_t size) {
+  tls_allocation_count++;
+  void* allocation = std::malloc(size == 0u ? 1u : size);
+  FML_CHECK(allocation);
+  return allocation;
+}
+
+void operator delete(void* allocation) noexcept {
+  std::free(allocation);
+}
+
+void operator delete(void* allocation, size_t size) noexcept {
+  std::free(allocation);
+}
+
+namespace impeller {
+
+namespace {
+
+/// A line chart of |point_count| samples with its area filled underneath, in
+/// the style of a chart or map layer that changes every frame.
+Path CreateChartArea(size_t series, size_t point_count) {
+  PathBuilder builder;
+  builder.MoveTo({0, 400});
+  for (size_t i = 0; i < point_count; i++) {
+    Scalar x = i * 2.0f;
+    Scalar y = 200 + 150 * std::sin(i * 0.05f + series) *
+                         std::cos(i * 0.013f * (series + 1));
+    builder.QuadraticCurveTo({x + 0.5f, y - 3}, {x + 1, y});
+  }
+  builder.LineTo({point_count * 2.0f, 400});
+  builder.Close();
+  return builder.TakePath();
+}
+
+Path CreateChartLine(size_t series, size_t point_count) {
+  PathBuilder builder;
+  for (size_t i = 0; i < point_count; i++) {
+    Point point(i * 2.0f, 200 + 150 * std::sin(i * 0.05f + series));
+    if (i == 0) {
+      builder.MoveTo(point);
+    } else {
+      builder.LineTo(point);
+    }
+  }
+  return builder.TakePath();
+}
+
+class FakePipeline : public Pipeline<PipelineDescriptor> {
+ public:
+  FakePipeline() : Pipeline({}, PipelineDescriptor{}) {}
+
+  bool IsValid() const override { return true; }
+};
+
+class FakeDeviceBuffer : public DeviceBuffer {
+ public:
+  FakeDeviceBuffer() : DeviceBuffer(DeviceBufferDescriptor{}) {}
+
+  bool SetLabel(const std::string& label) override { return true; }
+
+  bool SetLabel(const std::string& label, Range range) override {
+    return true;
+  }
+
+  uint8_t* OnGetContents() const override { return nullptr; }
+
+  bool OnCopyHostBuffer(const uint8_t* source,
+                        Range source_range,
+                        size_t offset) override {
+    return true;
+  }
+};
+
+class FakeRenderPass : public RenderPass {
+ public:
+  FakeRenderPass() : RenderPass(nullptr, RenderTarget{}) {}
+
+  bool IsValid() const override { return true; }
+
+  void OnSetLabel(std::string label) override {}
+
+  bool OnEncodeCommands(const Context& context) const override {
+    return true;
+  }
+};
+
+/// The bindings of a typical solid color draw: a vertex buffer, and frame
+/// and fragment info uniforms.
+struct DrawBindings {
+  std::shared_ptr<Pipeline<PipelineDescriptor>> pipeline =
+      std::make_shared<FakePipeline>();
+  std::shared_ptr<DeviceBuffer> buffer = std::make_shared<FakeDeviceBuffer>();
+  ShaderMetadata frame_info_metadata = {.name = "FrameInfo"};
+  ShaderMetadata frag_info_metadata = {.name = "FragInfo"};
+  ShaderUniformSlot frame_info_slot = {.name = "FrameInfo", .ext_res_0 = 1u};
+  ShaderUniformSlot frag_info_slot = {.name = "FragInfo", .ext_res_0 = 2u};
+
+  VertexBuffer GetVertexBuffer() const {
+    return VertexBuffer{
+        .vertex_buffer = {.buffer = buffer, .range = Range(0u, 64u)},
+        .vertex_count = 4u,
+        .index_type = IndexType::kNone,
+    };
+  }
+
+  BufferView GetUniformView() const {
+    return {.buffer = buffer, .range = Range(64u, 64u)};
+  }
+};
+
+constexpr size_t kDrawsPerPass = 1000u;
+
+}  // namespace
+
+/// Records the draws of a busy pass into a |RenderPass|, as |EntityPass|
+/// does for each entity.
+static void BM_RecordDrawsIntoRenderPass(benchmark::State& state) {
+  DrawBindings bindings;
+  size_t allocation_count = 0u;
+  for (auto _ : state) {
+    FakeRenderPass pass;
+    size_t start_count = tls_allocation_count;
+    pass.ReserveCommands(kDrawsPerPass);
+    for (size_t i = 0; i < kDrawsPerPass; i++) {
+      pass.SetCommandLabel("Solid Fill");
+      pass.SetPipeline(bindings.pipeline);
+      pass.SetVertexBuffer(bindings.GetVertexBuffer());
+      pass.BindResource(ShaderStage::kVertex, DescriptorType::kUniformBuffer,
+                        bindings.frame_info_slot, bindings.frame_info_metadata,
+                        bindings.GetUniformView());
+      pass.BindResource(ShaderStage::kFragment, DescriptorType::kUniformBuffer,
+                        bindings.frag_info_slot, bindings.frag_info_metadata,
+                        bindings.GetUniformView());
+      pass.Draw();
+    }
+    allocation_count += tls_allocation_count - start_count;
+  }
+  state.SetItemsProcessed(state.iterations() * kDrawsPerPass);
+  state.counters["AllocationsPerDraw"] =
+      benchmark::Counter(static_cast<double>(allocation_count) / kDrawsPerPass,
+                         benchmark::Counter::kAvgIterations);
+}
+
+/// Records the same draws as |BM_RecordDrawsIntoRenderPass| as a vector of
+/// standalone |Command|s, for comparison.
+static void BM_RecordDrawsIntoCommands(benchmark::State& state) {
+  DrawBindings bindings;
+  size_t allocation_count = 0u;
+  for (auto _ : state) {
+    std::vector<Command> commands;
+    size_t start_count = tls_allocation_count;
+    commands.reserve(kDrawsPerPass);
+    for (size_t i = 0; i < kDrawsPerPass; i++) {
+      Command command;
+      DEBUG_COMMAND_INFO(command, "Solid Fill");
+      command.pipeline = bindings.pipeline;
+      command.BindVertices(bindings.GetVertexBuffer());
+      command.BindResource(ShaderStage::kVertex,
+                           DescriptorType::kUniformBuffer,
+                           bindings.frame_info_slot,
+                           bindings.frame_info_metadata,
+                           bindings.GetUniformView());
+      command.BindResource(ShaderStage::kFragment,
+                           DescriptorType::kUniformBuffer,
+                           bindings.frag_info_slot, bindings.frag_info_metadata,
+                           bindings.GetUniformView());
+      commands.emplace_back(std::move(command));
+    }
+    allocation_count += tls_allocation_count - start_count;
+  }
+  state.SetItemsProcessed(state.iterations() * kDrawsPerPass);
+  state.counters["AllocationsPerDraw"] =
+      benchmark::Counter(static_cast<double>(allocation_count) / kDrawsPerPass,
+                         benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_RecordDrawsIntoRenderPass)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RecordDrawsIntoCommands)->Unit(benchmark::kMicrosecond);
+
+/// Prepares the vertices of a scene of independent filled and stroked chart
+/// paths on the raster thread and |state.range(0)| worker threads, as
+/// |EntityPass| does before encoding. Zero workers is the cost of generating
+/// all vertices on the raster thread.
+static void BM_PrepareVerticesConcurrently(benchmark::State& state) {
+  constexpr size_t kSeriesCount = 32u;
+  constexpr size_t kPointCount = 1000u;
+
+  size_t worker_count = state.range(0);
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner;
+  std::vector<std::shared_ptr<Tessellator>> worker_tessellators;
+  if (worker_count > 0) {
+    loop = fml::ConcurrentMessageLoop::Create(worker_count);
+    worker_task_runner = loop->GetTaskRunner();
+    for (size_t i = 0; i < worker_count; i++) {
+      worker_tessellators.push_back(std::make_shared<Tessellator>());
+    }
+  }
+
+  std::vector<std::shared_ptr<Geometry>> geometries;
+  for (size_t i = 0; i < kSeriesCount; i++) {
+    geometries.push_back(
+        Geometry::MakeFillPath(CreateChartArea(i, kPointCount)));
+    geometries.push_back(Geometry::MakeStrokePath(
+        CreateChartLine(i, kPointCount), 3.0f, 4.0f, Cap::kRound,
+        Join::kRound));
+  }
+  auto transform = Matrix::MakeScale({1.5f, 1.5f, 1.0f});
+
+  Tessellator tessellator;
+  for (auto _ : state) {
+    std::vector<GeometryToPrepare> to_prepare;
+    to_prepare.reserve(geometries.size());
+    for (const auto& geometry : geometries) {
+      to_prepare.push_back({
+          .geometry = geometry.get(),
+          .transform = transform,
+      });
+    }
+    PrepareVerticesConcurrently(std::move(to_prepare), tessellator,
+                                worker_task_runner, worker_tessellators);
+  }
+  state.SetItemsProcessed(state.iterations() * geometries.size());
+}
+
+BENCHMARK(BM_PrepareVerticesConcurrently)
+    ->DenseRange(0, 4)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+}  // namespace impeller
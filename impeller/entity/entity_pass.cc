@@ -5,6 +5,7 @@
 #include "impeller/entity/entity_pass.h"
 
 #include <memory>
+#include <unordered_set>
 #include <utility>
 #include <variant>
 
@@ -19,8 +20,10 @@
 #include "impeller/entity/contents/filters/color_filter_contents.h"
 #include "impeller/entity/contents/filters/inputs/filter_input.h"
 #include "impeller/entity/contents/framebuffer_blend_contents.h"
+#include "impeller/entity/contents/solid_rect_batch_contents.h"
 #include "impeller/entity/contents/texture_contents.h"
 #include "impeller/entity/entity.h"
+#include "impeller/entity/geometry/prepare_vertices.h"
 #include "impeller/entity/inline_pass_context.h"
 #include "impeller/geometry/color.h"
 #include "impeller/geometry/rect.h"
@@ -44,6 +47,26 @@ std::tuple<std::optional<Color>, BlendMode> ElementAsBackgroundColor(
   }
   return {};
 }
+
+bool CanShareBatch(const Entity& a, const Entity& b) {
+  return a.GetBlendMode() == b.GetBlendMode() &&
+         a.GetClipDepth() == b.GetClipDepth();
+}
+
+Entity MakeBatchEntity(const std::vector<Entity>& batch) {
+  auto contents = std::make_shared<SolidRectBatchContents>();
+  for (const Entity& entity : batch) {
+    contents->AddEntity(entity);
+  }
+  Entity batch_entity;
+  batch_entity.SetContents(std::move(contents));
+  batch_entity.SetBlendMode(batch.front().GetBlendMode());
+  batch_entity.SetClipDepth(batch.front().GetClipDepth());
+  return batch_entity;
+}
+
+// Identifies the batching counter series in traces.
+constexpr int64_t kBatchingTraceID = 2406;
 }  // namespace
 
 const std::string EntityPass::kCaptureDocumentName = "EntityPass";
@@ -310,6 +333,58 @@ uint32_t EntityPass::GetTotalPassReads(ContentContext& renderer) const {
                    advanced_blend_reads_from_pass_texture_;
 }
 
+EntityPass::BatchStats EntityPass::GetBatchStats() const {
+  BatchStats stats = batch_stats_;
+  IterateAllElements([&stats](const Element& element) {
+    if (auto subpass = std::get_if<std::unique_ptr<EntityPass>>(&element)) {
+      const BatchStats& subpass_stats = subpass->get()->batch_stats_;
+      stats.batch_count += subpass_stats.batch_count;
+      stats.batched_entity_count += subpass_stats.batched_entity_count;
+    }
+    return true;
+  });
+  return stats;
+}
+
+// The fewest geometries worth spreading over the worker threads.
+static constexpr size_t kMinConcurrentlyPreparedGeometryCount = 2u;
+
+void EntityPass::PrepareVertices(ContentContext& renderer) const {
+  const auto& worker_task_runner =
+      renderer.GetContext()->GetConcurrentWorkerTaskRunner();
+  const auto& worker_tessellators = renderer.GetWorkerTessellators();
+  if (!worker_task_runner || worker_tessellators.empty()) {
+    return;
+  }
+
+  std::vector<GeometryToPrepare> geometries;
+  // A geometry shared by several entities must only be prepared once, as it
+  // must not be prepared on two threads at the same time.
+  std::unordered_set<const Geometry*> seen_geometries;
+  IterateAllEntities([&geometries, &seen_geometries](const Entity& entity) {
+    if (const auto& contents = entity.GetContents()) {
+      const Geometry* geometry = contents->GetPositionGeometry();
+      if (geometry && geometry->CanPrepareVertices() &&
+          seen_geometries.insert(geometry).second) {
+        geometries.push_back({
+            .geometry = geometry,
+            .transform = entity.GetTransform(),
+        });
+      }
+    }
+    return true;
+  });
+  if (geometries.size() < kMinConcurrentlyPreparedGeometryCount) {
+    // Not worth the overhead of posting tasks, generate vertices as they are
+    // rendered instead.
+    return;
+  }
+
+  PrepareVerticesConcurrently(std::move(geometries),
+                              *renderer.GetTessellator(), worker_task_runner,
+                              worker_tessellators);
+}
+
 bool EntityPass::Render(ContentContext& renderer,
                         const RenderTarget& render_target) const {
   auto capture =
@@ -341,6 +416,25 @@ bool EntityPass::Render(ContentContext& renderer,
     return true;
   });
 
+  PrepareVertices(renderer);
+
+  batch_stats_ = {};
+  IterateAllElements([](const Element& element) {
+    if (auto subpass = std::get_if<std::unique_ptr<EntityPass>>(&element)) {
+      subpass->get()->batch_stats_ = {};
+    }
+    return true;
+  });
+  fml::ScopedCleanupClosure report_batch_stats([this]() {
+    BatchStats stats = GetBatchStats();
+    FML_TRACE_COUNTER("impeller",            //
+                      "EntityPassBatching",  // series name
+                      kBatchingTraceID,      // series ID
+                      "Batches", static_cast<int64_t>(stats.batch_count),  //
+                      "BatchedEntities",
+                      static_cast<int64_t>(stats.batched_entity_count));
+  });
+
   ClipCoverageStack clip_coverage_stack = {ClipCoverageLayer{
       .coverage = Rect::MakeSize(root_render_target.GetRenderTargetSize()),
       .clip_depth = 0}};
@@ -888,6 +982,45 @@ bool EntityPass::OnRender(
                   renderer, clip_coverage_stack, global_pass_position);
   }
 
+  // Runs of solid color rectangles are merged into a single draw. The pending
+  // batch stays open while entities that don't overlap it are rendered, and is
+  // flushed before anything that could read its pixels or change the clip.
+  std::vector<Entity> batch;
+  std::optional<Rect> batch_coverage;
+  auto flush_batch = [&]() -> bool {
+    if (batch.empty()) {
+      return true;
+    }
+    if (batch.size() > 1u) {
+      batch_stats_.batch_count++;
+      batch_stats_.batched_entity_count += batch.size();
+    }
+    Entity batch_entity = batch.size() == 1u ? std::move(batch.front())
+                                             : MakeBatchEntity(batch);
+    batch.clear();
+    batch_coverage = std::nullopt;
+    return RenderElement(batch_entity, clip_depth_floor, pass_context,
+                         pass_depth, renderer, clip_coverage_stack,
+                         global_pass_position);
+  };
+  auto can_render_around_batch = [&](const Entity& entity) {
+    if (entity.GetBlendMode() > Entity::kLastPipelineBlendMode) {
+      return false;
+    }
+    std::optional<Rect> coverage = entity.GetCoverage();
+    if (!coverage.has_value() ||
+        coverage->IntersectsWithRect(batch_coverage.value())) {
+      return false;
+    }
+    auto current_clip_coverage = clip_coverage_stack.back().coverage;
+    if (current_clip_coverage.has_value()) {
+      current_clip_coverage =
+          current_clip_coverage->Shift(-global_pass_position);
+    }
+    return entity.GetClipCoverage(current_clip_coverage).type ==
+           Contents::ClipCoverage::Type::kNoChange;
+  };
+
   bool is_collapsing_clear_colors = !collapsed_parent_pass &&
                                     // Backdrop filters act as a entity before
                                     // everything and disrupt the optimization.
@@ -903,6 +1036,12 @@ bool EntityPass::OnRender(
       is_collapsing_clear_colors = false;
     }
 
+    // Subpasses may render into, or end, the current pass while they are
+    // resolved.
+    if (!std::holds_alternative<Entity>(element) && !flush_batch()) {
+      return false;
+    }
+
     EntityResult result =
         GetEntityForElement(element,               // element
                             renderer,              // renderer
@@ -925,6 +1064,25 @@ bool EntityPass::OnRender(
         continue;
     };
 
+    //--------------------------------------------------------------------------
+    /// Batch solid color rectangles.
+    ///
+
+    if (SolidRectBatchContents::CanBatch(result.entity)) {
+      if (!batch.empty() && !CanShareBatch(batch.front(), result.entity) &&
+          !flush_batch()) {
+        return false;
+      }
+      batch_coverage =
+          Rect::Union(batch_coverage, result.entity.GetCoverage());
+      batch.push_back(std::move(result.entity));
+      continue;
+    }
+    if (!batch.empty() && !can_render_around_batch(result.entity) &&
+        !flush_batch()) {
+      return false;
+    }
+
     //--------------------------------------------------------------------------
     /// Setup advanced blends.
     ///
@@ -985,6 +1143,9 @@ bool EntityPass::OnRender(
       return false;
     }
   }
+  if (!flush_batch()) {
+    return false;
+  }
 
 #ifdef IMPELLER_DEBUG
   //--------------------------------------------------------------------------
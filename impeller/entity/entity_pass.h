@@ -50,6 +50,14 @@ class EntityPass {
 
   using ClipCoverageStack = std::vector<ClipCoverageLayer>;
 
+  /// Counts the draws that rendered several entities at once.
+  struct BatchStats {
+    /// The number of draws that rendered a batch of more than one entity.
+    size_t batch_count = 0u;
+    /// The number of entities rendered by those draws.
+    size_t batched_entity_count = 0u;
+  };
+
   EntityPass();
 
   ~EntityPass();
@@ -181,6 +189,12 @@ class EntityPass {
   std::optional<Rect> GetElementsCoverage(
       std::optional<Rect> coverage_limit) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief  Returns the batching statistics of the most recent `Render`,
+  ///         including those of the subpasses that were rendered.
+  ///
+  BatchStats GetBatchStats() const;
+
  private:
   struct EntityResult {
     enum Status {
@@ -307,6 +321,7 @@ class EntityPass {
   std::unique_ptr<EntityPassClipRecorder> clip_replay_ =
       std::make_unique<EntityPassClipRecorder>();
   int32_t required_mip_count_ = 1;
+  mutable BatchStats batch_stats_;
 
   /// These values are incremented whenever something is added to the pass that
   /// requires reading from the backdrop texture. Currently, this can happen in
@@ -321,6 +336,10 @@ class EntityPass {
 
   uint32_t GetTotalPassReads(ContentContext& renderer) const;
 
+  /// Generates the vertices of expensive geometries in this pass and its
+  /// subpasses on the worker threads of the context, ahead of rendering.
+  void PrepareVertices(ContentContext& renderer) const;
+
   BackdropFilterProc backdrop_filter_proc_ = nullptr;
 
   std::shared_ptr<EntityPassDelegate> delegate_ =
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "fml/logging.h"
 #include "gtest/gtest.h"
 #include "impeller/core/formats.h"
@@ -36,6 +37,7 @@
 #include "impeller/entity/entity_playground.h"
 #include "impeller/entity/geometry/geometry.h"
 #include "impeller/entity/geometry/point_field_geometry.h"
+#include "impeller/entity/geometry/prepare_vertices.h"
 #include "impeller/entity/geometry/stroke_path_geometry.h"
 #include "impeller/geometry/color.h"
 #include "impeller/geometry/geometry_asserts.h"
@@ -2662,6 +2664,37 @@ TEST_P(EntityTest, FramebufferFetchPipelinesDeclareUsage) {
   EXPECT_TRUE(color_burn->GetDescriptor().UsesSubpassInput());
 }
 
+TEST_P(EntityTest, ContentContextPrewarmsRecordedPipelineVariants) {
+  auto manifest = std::make_shared<PipelineVariantManifest>();
+  ContentContextOptions options{
+      .blend_mode = BlendMode::kSource,
+      .color_attachment_pixel_format = PixelFormat::kR8G8B8A8UNormInt,
+  };
+
+  {
+    auto content_context =
+        ContentContext(GetContext(), TypographerContextSkia::Make());
+    EXPECT_EQ(content_context.SetPipelineVariantManifest(manifest), 0u);
+    ASSERT_TRUE(content_context.GetSolidFillPipeline(options));
+    ASSERT_TRUE(content_context.GetSolidFillPipeline(options));
+    ASSERT_EQ(manifest->GetVariants().size(), 1u);
+    EXPECT_EQ(manifest->GetVariants()[0].options_key, options.ToKey());
+  }
+
+  // Variants of pipelines that don't exist are skipped.
+  manifest->RecordVariant("NotAPipeline", options.ToKey());
+
+  auto content_context =
+      ContentContext(GetContext(), TypographerContextSkia::Make());
+  EXPECT_EQ(content_context.SetPipelineVariantManifest(manifest), 1u);
+  auto pipeline = content_context.GetSolidFillPipeline(options);
+  ASSERT_TRUE(pipeline);
+  EXPECT_FALSE(pipeline->GetDescriptor()
+                   .GetColorAttachmentDescriptor(0u)
+                   ->blending_enabled);
+  EXPECT_EQ(manifest->GetVariants().size(), 2u);
+}
+
 TEST_P(EntityTest, PipelineDescriptorEqAndHash) {
   auto desc_1 = std::make_shared<PipelineDescriptor>();
   auto desc_2 = std::make_shared<PipelineDescriptor>();
@@ -2701,6 +2734,93 @@ TEST_P(EntityTest, ContentContextOptionsHasReasonableHashFunctions) {
   EXPECT_NE(hash_c, hash_d);
 }
 
+static std::vector<uint8_t> GetBufferContents(const BufferView& view) {
+  if (!view) {
+    return {};
+  }
+  const uint8_t* contents = view.buffer->OnGetContents() + view.range.offset;
+  return std::vector<uint8_t>(contents, contents + view.range.length);
+}
+
+TEST_P(EntityTest, PreparedVerticesMatchGeneratedVertices) {
+  auto content_context = GetContentContext();
+  RenderTarget target;
+  testing::MockRenderPass pass(GetContext(), target);
+
+  auto path = PathBuilder{}
+                  .MoveTo({0, 0})
+                  .CubicCurveTo({100, 0}, {100, 100}, {0, 100})
+                  .QuadraticCurveTo({50, 50}, {0, 0})
+                  .MoveTo({20, 20})
+                  .LineTo({60, 20})
+                  .LineTo({40, 60})
+                  .Close()
+                  .TakePath();
+  std::vector<std::shared_ptr<Geometry>> geometries = {
+      Geometry::MakeFillPath(path.Clone()),
+      Geometry::MakeFillPath(
+          PathBuilder{}.AddCircle({50, 50}, 40).TakePath()),
+      Geometry::MakeStrokePath(path.Clone(), 4.0f, 4.0f, Cap::kRound,
+                               Join::kRound),
+  };
+  for (const auto& geometry : geometries) {
+    ASSERT_TRUE(geometry->CanPrepareVertices());
+  }
+
+  auto basis = Matrix::MakeScale({2.0f, 3.0f, 1.0f});
+  Entity entity;
+  entity.SetTransform(basis);
+  std::vector<GeometryResult> expected_results;
+  for (const auto& geometry : geometries) {
+    expected_results.push_back(
+        geometry->GetPositionBuffer(*content_context, entity, pass));
+  }
+
+  auto loop = fml::ConcurrentMessageLoop::Create(2u);
+  std::vector<GeometryToPrepare> to_prepare;
+  for (const auto& geometry : geometries) {
+    to_prepare.push_back({.geometry = geometry.get(), .transform = basis});
+  }
+  PrepareVerticesConcurrently(
+      std::move(to_prepare), *content_context->GetTessellator(),
+      loop->GetTaskRunner(),
+      {std::make_shared<Tessellator>(), std::make_shared<Tessellator>()});
+
+  // Vertices prepared for a basis are used for any translation of it.
+  entity.SetTransform(Matrix::MakeTranslation({10, 20, 0}) * basis);
+  for (size_t i = 0; i < geometries.size(); i++) {
+    auto result =
+        geometries[i]->GetPositionBuffer(*content_context, entity, pass);
+    const auto& expected = expected_results[i];
+    EXPECT_EQ(result.type, expected.type);
+    EXPECT_EQ(result.prevent_overdraw, expected.prevent_overdraw);
+    EXPECT_EQ(result.transform, pass.GetOrthographicTransform() *
+                                    entity.GetTransform());
+    EXPECT_EQ(result.vertex_buffer.vertex_count,
+              expected.vertex_buffer.vertex_count);
+    EXPECT_EQ(result.vertex_buffer.index_type,
+              expected.vertex_buffer.index_type);
+    EXPECT_EQ(GetBufferContents(result.vertex_buffer.vertex_buffer),
+              GetBufferContents(expected.vertex_buffer.vertex_buffer));
+    EXPECT_EQ(GetBufferContents(result.vertex_buffer.index_buffer),
+              GetBufferContents(expected.vertex_buffer.index_buffer));
+  }
+
+  // A different basis generates vertices for that basis instead.
+  entity.SetTransform(Matrix::MakeScale({8.0f, 8.0f, 1.0f}));
+  Entity unprepared_entity;
+  unprepared_entity.SetTransform(entity.GetTransform());
+  auto unprepared = Geometry::MakeFillPath(path.Clone());
+  auto result =
+      geometries[0]->GetPositionBuffer(*content_context, entity, pass);
+  auto expected =
+      unprepared->GetPositionBuffer(*content_context, unprepared_entity, pass);
+  EXPECT_EQ(result.vertex_buffer.vertex_count,
+            expected.vertex_buffer.vertex_count);
+  EXPECT_GT(result.vertex_buffer.vertex_count,
+            expected_results[0].vertex_buffer.vertex_count);
+}
+
 #ifdef FML_OS_LINUX
 TEST_P(EntityTest, FramebufferFetchVulkanBindingOffsetIsTheSame) {
   // Using framebuffer fetch on Vulkan requires that we maintain a subpass input
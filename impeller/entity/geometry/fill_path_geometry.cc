@@ -3,10 +3,42 @@
 // found in the LICENSE file.
 
 #include "impeller/entity/geometry/fill_path_geometry.h"
+
+#include <algorithm>
+
 #include "impeller/core/formats.h"
 
 namespace impeller {
 
+namespace {
+
+using UVVertexBuilder =
+    VertexBufferBuilder<TextureFillVertexShader::PerVertexData>;
+
+// Appends vertices with texture coordinates mapped from their positions.
+// The coordinates are transformed in batches through a stack buffer so that
+// a draw doesn't allocate for them.
+void AppendUVVertices(UVVertexBuilder& vertex_builder,
+                      const Point* points,
+                      size_t count,
+                      const Matrix& uv_transform) {
+  constexpr size_t kBatchSize = 64;
+  Point uvs[kBatchSize];
+  vertex_builder.Reserve(vertex_builder.GetVertexCount() + count);
+  for (size_t start = 0; start < count; start += kBatchSize) {
+    size_t batch = std::min(kBatchSize, count - start);
+    uv_transform.TransformPoints(points + start, uvs, batch);
+    for (size_t i = 0; i < batch; i++) {
+      TextureFillVertexShader::PerVertexData data;
+      data.position = points[start + i];
+      data.texture_coords = uvs[i];
+      vertex_builder.AppendVertex(data);
+    }
+  }
+}
+
+}  // namespace
+
 FillPathGeometry::FillPathGeometry(Path path, std::optional<Rect> inner_rect)
     : path_(std::move(path)), inner_rect_(inner_rect) {}
 
@@ -14,6 +46,10 @@ GeometryResult FillPathGeometry::GetPositionBuffer(
     const ContentContext& renderer,
     const Entity& entity,
     RenderPass& pass) const {
+  if (auto prepared = GetPreparedPositionBuffer(renderer, entity, pass)) {
+    return prepared.value();
+  }
+
   auto& host_buffer = renderer.GetTransientsBuffer();
   VertexBuffer vertex_buffer;
 
@@ -72,8 +108,6 @@ GeometryResult FillPathGeometry::GetPositionUVBuffer(
     const ContentContext& renderer,
     const Entity& entity,
     RenderPass& pass) const {
-  using VS = TextureFillVertexShader;
-
   auto uv_transform =
       texture_coverage.GetNormalizingTransform() * effect_transform;
 
@@ -82,14 +116,9 @@ GeometryResult FillPathGeometry::GetPositionUVBuffer(
     auto points = renderer.GetTessellator()->TessellateConvex(
         path_, entity.GetTransform().GetMaxBasisLength());
 
-    VertexBufferBuilder<VS::PerVertexData> vertex_builder;
-    vertex_builder.Reserve(points.size());
-    for (auto i = 0u; i < points.size(); i++) {
-      VS::PerVertexData data;
-      data.position = points[i];
-      data.texture_coords = uv_transform * points[i];
-      vertex_builder.AppendVertex(data);
-    }
+    UVVertexBuilder vertex_builder;
+    AppendUVVertices(vertex_builder, points.data(), points.size(),
+                     uv_transform);
 
     return GeometryResult{
         .type = PrimitiveType::kTriangleStrip,
@@ -100,19 +129,16 @@ GeometryResult FillPathGeometry::GetPositionUVBuffer(
     };
   }
 
-  VertexBufferBuilder<VS::PerVertexData> vertex_builder;
+  UVVertexBuilder vertex_builder;
   auto tesselation_result = renderer.GetTessellator()->Tessellate(
       path_, entity.GetTransform().GetMaxBasisLength(),
       [&vertex_builder, &uv_transform](
           const float* vertices, size_t vertices_count, const uint16_t* indices,
           size_t indices_count) {
-        for (auto i = 0u; i < vertices_count * 2; i += 2) {
-          VS::PerVertexData data;
-          Point vtx = {vertices[i], vertices[i + 1]};
-          data.position = vtx;
-          data.texture_coords = uv_transform * vtx;
-          vertex_builder.AppendVertex(data);
-        }
+        // The tessellator emits tightly packed x, y pairs.
+        AppendUVVertices(vertex_builder,
+                         reinterpret_cast<const Point*>(vertices),
+                         vertices_count, uv_transform);
         FML_DCHECK(vertex_builder.GetVertexCount() == vertices_count);
         if (indices != nullptr) {
           for (auto i = 0u; i < indices_count; i++) {
@@ -154,4 +180,52 @@ bool FillPathGeometry::CoversArea(const Matrix& transform,
   return coverage.Contains(rect);
 }
 
+bool FillPathGeometry::CanPrepareVertices() const {
+  // Paths with a cache key are better served by the path cache of the
+  // renderer's tessellator, which worker threads do not share.
+  return path_.GetCacheKey() == 0;
+}
+
+void FillPathGeometry::PrepareVertices(Tessellator& tessellator,
+                                       const Matrix& transform) const {
+  auto prepared = std::make_unique<PreparedVertices>();
+  prepared->basis = transform.Basis();
+  auto scale = transform.GetMaxBasisLength();
+
+  if (path_.GetFillType() == FillType::kNonZero &&  //
+      path_.IsConvex()) {
+    auto points = tessellator.TessellateConvex(path_, scale);
+    prepared->type = PrimitiveType::kTriangleStrip;
+    prepared->vertices.Reserve(points.size());
+    for (const auto& point : points) {
+      prepared->vertices.AppendVertex({.position = point});
+    }
+    SetPreparedVertices(std::move(prepared));
+    return;
+  }
+
+  auto& vertices = prepared->vertices;
+  auto tesselation_result = tessellator.Tessellate(
+      path_, scale,
+      [&vertices](const float* points, size_t points_count,
+                  const uint16_t* indices, size_t indices_count) {
+        vertices.Reserve(points_count);
+        for (auto i = 0u; i < points_count * 2; i += 2) {
+          vertices.AppendVertex({.position = {points[i], points[i + 1]}});
+        }
+        if (indices != nullptr) {
+          vertices.ReserveIndices(indices_count);
+          for (auto i = 0u; i < indices_count; i++) {
+            vertices.AppendIndex(indices[i]);
+          }
+        }
+        return true;
+      });
+  if (tesselation_result != Tessellator::Result::kSuccess) {
+    return;
+  }
+  prepared->type = PrimitiveType::kTriangle;
+  SetPreparedVertices(std::move(prepared));
+}
+
 }  // namespace impeller
@@ -23,6 +23,13 @@ class FillPathGeometry final : public Geometry {
   // |Geometry|
   bool CoversArea(const Matrix& transform, const Rect& rect) const override;
 
+  // |Geometry|
+  bool CanPrepareVertices() const override;
+
+  // |Geometry|
+  void PrepareVertices(Tessellator& tessellator,
+                       const Matrix& transform) const override;
+
  private:
   // |Geometry|
   GeometryResult GetPositionBuffer(const ContentContext& renderer,
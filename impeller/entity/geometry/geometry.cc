@@ -21,6 +21,35 @@
 
 namespace impeller {
 
+bool Geometry::CanPrepareVertices() const {
+  return false;
+}
+
+void Geometry::PrepareVertices(Tessellator& tessellator,
+                               const Matrix& transform) const {}
+
+void Geometry::SetPreparedVertices(
+    std::unique_ptr<PreparedVertices> vertices) const {
+  prepared_vertices_ = std::move(vertices);
+}
+
+std::optional<GeometryResult> Geometry::GetPreparedPositionBuffer(
+    const ContentContext& renderer,
+    const Entity& entity,
+    RenderPass& pass) const {
+  if (!prepared_vertices_ ||
+      prepared_vertices_->basis != entity.GetTransform().Basis()) {
+    return std::nullopt;
+  }
+  return GeometryResult{
+      .type = prepared_vertices_->type,
+      .vertex_buffer = prepared_vertices_->vertices.CreateVertexBuffer(
+          renderer.GetTransientsBuffer()),
+      .transform = pass.GetOrthographicTransform() * entity.GetTransform(),
+      .prevent_overdraw = prepared_vertices_->prevent_overdraw,
+  };
+}
+
 GeometryResult Geometry::ComputePositionGeometry(
     const ContentContext& renderer,
     const Tessellator::VertexGenerator& generator,
@@ -218,4 +247,8 @@ bool Geometry::IsAxisAlignedRect() const {
   return false;
 }
 
+std::optional<Rect> Geometry::AsFilledRect() const {
+  return std::nullopt;
+}
+
 }  // namespace impeller
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_IMPELLER_ENTITY_GEOMETRY_GEOMETRY_H_
 #define FLUTTER_IMPELLER_ENTITY_GEOMETRY_GEOMETRY_H_
 
+#include <memory>
+#include <optional>
+
 #include "impeller/core/formats.h"
 #include "impeller/core/vertex_buffer.h"
 #include "impeller/entity/contents/content_context.h"
@@ -31,6 +34,17 @@ static const GeometryResult kEmptyResult = {
         },
 };
 
+/// Vertices of a geometry that were generated ahead of rendering.
+///
+/// @see  `Geometry::PrepareVertices`
+struct PreparedVertices {
+  /// The basis of the transform the vertices were generated for.
+  Matrix basis;
+  PrimitiveType type = PrimitiveType::kTriangle;
+  bool prevent_overdraw = false;
+  VertexBufferBuilder<SolidFillVertexShader::PerVertexData> vertices;
+};
+
 enum GeometryVertexType {
   kPosition,
   kColor,
@@ -121,6 +135,32 @@ class Geometry {
 
   virtual bool IsAxisAlignedRect() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief    Returns the rectangle filled by this geometry in its local
+  ///           space, or `std::nullopt` if the geometry isn't exactly a filled
+  ///           rectangle under every transform.
+  ///
+  virtual std::optional<Rect> AsFilledRect() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief    Whether generating the vertices of this geometry is expensive
+  ///           enough that it is worth doing with `PrepareVertices` on a
+  ///           worker thread ahead of rendering.
+  ///
+  virtual bool CanPrepareVertices() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief    Generates the vertices of this geometry for an entity with the
+  ///           given transform. A later call to `GetPositionBuffer` for an
+  ///           entity whose transform has the same basis only uploads them.
+  ///
+  ///           This may be called from any thread, but not concurrently with
+  ///           any other method of this geometry. The tessellator must not be
+  ///           used by any other thread for the duration of the call.
+  ///
+  virtual void PrepareVertices(Tessellator& tessellator,
+                               const Matrix& transform) const;
+
  protected:
   static GeometryResult ComputePositionGeometry(
       const ContentContext& renderer,
@@ -134,6 +174,18 @@ class Geometry {
       const Matrix& uv_transform,
       const Entity& entity,
       RenderPass& pass);
+
+  void SetPreparedVertices(std::unique_ptr<PreparedVertices> vertices) const;
+
+  /// Uploads the vertices prepared for the basis of the entity's transform,
+  /// if there are any.
+  std::optional<GeometryResult> GetPreparedPositionBuffer(
+      const ContentContext& renderer,
+      const Entity& entity,
+      RenderPass& pass) const;
+
+ private:
+  mutable std::unique_ptr<PreparedVertices> prepared_vertices_;
 };
 
 }  // namespace impeller
@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/geometry/prepare_vertices.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+namespace {
+
+/// The state shared between the calling thread and the worker tasks. Worker
+/// tasks keep it alive, as they may start after the caller has returned.
+struct PreparationState {
+  explicit PreparationState(std::vector<GeometryToPrepare> p_geometries)
+      : geometries(std::move(p_geometries)), remaining(geometries.size()) {}
+
+  const std::vector<GeometryToPrepare> geometries;
+  std::atomic<size_t> next_index = 0;
+  std::atomic<size_t> remaining;
+  std::mutex mutex;
+  std::condition_variable done;
+};
+
+/// Prepares geometries until there are none left to claim. Geometries are
+/// claimed one at a time, as their costs vary widely.
+void PrepareClaimedGeometries(PreparationState& state,
+                              Tessellator& tessellator) {
+  while (true) {
+    size_t index = state.next_index.fetch_add(1);
+    if (index >= state.geometries.size()) {
+      return;
+    }
+    const auto& to_prepare = state.geometries[index];
+    to_prepare.geometry->PrepareVertices(tessellator, to_prepare.transform);
+    if (state.remaining.fetch_sub(1) == 1) {
+      std::scoped_lock lock(state.mutex);
+      state.done.notify_all();
+    }
+  }
+}
+
+}  // namespace
+
+void PrepareVerticesConcurrently(
+    std::vector<GeometryToPrepare> geometries,
+    Tessellator& tessellator,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner,
+    const std::vector<std::shared_ptr<Tessellator>>& worker_tessellators) {
+  TRACE_EVENT1("impeller", "PrepareVerticesConcurrently", "count",
+               std::to_string(geometries.size()).c_str());
+  if (geometries.empty()) {
+    return;
+  }
+
+  auto state = std::make_shared<PreparationState>(std::move(geometries));
+  if (worker_task_runner) {
+    // The calling thread takes on one share of the work itself.
+    size_t task_count = std::min(worker_tessellators.size(),
+                                 state->geometries.size() - 1);
+    for (size_t i = 0; i < task_count; i++) {
+      worker_task_runner->PostTask(
+          [state, worker_tessellator = worker_tessellators[i]]() {
+            PrepareClaimedGeometries(*state, *worker_tessellator);
+          });
+    }
+  }
+
+  PrepareClaimedGeometries(*state, tessellator);
+
+  // Wait for the geometries that workers are still preparing.
+  std::unique_lock lock(state->mutex);
+  state->done.wait(lock, [&state]() { return state->remaining == 0; });
+}
+
+}  // namespace impeller
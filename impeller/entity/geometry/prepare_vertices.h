@@ -0,0 +1,53 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_ENTITY_GEOMETRY_PREPARE_VERTICES_H_
+#define FLUTTER_IMPELLER_ENTITY_GEOMETRY_PREPARE_VERTICES_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "impeller/entity/geometry/geometry.h"
+#include "impeller/geometry/matrix.h"
+#include "impeller/tessellator/tessellator.h"
+
+namespace impeller {
+
+/// A geometry and the transform of the entity it will be rendered for.
+struct GeometryToPrepare {
+  const Geometry* geometry = nullptr;
+  Matrix transform;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Calls |Geometry::PrepareVertices| for each of the geometries,
+///             sharing the work between the calling thread and up to one task
+///             per worker tessellator posted to the worker task runner.
+///
+///             Returns once the vertices of every geometry are prepared. The
+///             calling thread does not wait for worker tasks that have not
+///             started by the time it runs out of work, so busy workers never
+///             delay the caller by more than the geometry they are preparing.
+///
+/// @param[in]  geometries           The geometries to prepare. Each must
+///                                  outlive the call.
+/// @param[in]  tessellator          The tessellator used on the calling
+///                                  thread.
+/// @param[in]  worker_task_runner   The task runner for the worker threads.
+///                                  May be nullptr, in which case all work is
+///                                  done on the calling thread.
+/// @param[in]  worker_tessellators  The tessellators used by the worker tasks.
+///                                  These must not be used by any other thread
+///                                  until this call returns.
+///
+void PrepareVerticesConcurrently(
+    std::vector<GeometryToPrepare> geometries,
+    Tessellator& tessellator,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner,
+    const std::vector<std::shared_ptr<Tessellator>>& worker_tessellators);
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_ENTITY_GEOMETRY_PREPARE_VERTICES_H_
@@ -56,4 +56,8 @@ bool RectGeometry::IsAxisAlignedRect() const {
   return true;
 }
 
+std::optional<Rect> RectGeometry::AsFilledRect() const {
+  return rect_;
+}
+
 }  // namespace impeller
@@ -447,6 +447,9 @@ GeometryResult StrokePathGeometry::GetPositionBuffer(
   if (determinant == 0) {
     return {};
   }
+  if (auto prepared = GetPreparedPositionBuffer(renderer, entity, pass)) {
+    return prepared.value();
+  }
 
   Scalar min_size = 1.0f / sqrt(std::abs(determinant));
   Scalar stroke_width = std::max(stroke_width_, min_size);
@@ -465,6 +468,31 @@ GeometryResult StrokePathGeometry::GetPositionBuffer(
   };
 }
 
+bool StrokePathGeometry::CanPrepareVertices() const {
+  return stroke_width_ >= 0.0;
+}
+
+void StrokePathGeometry::PrepareVertices(Tessellator& tessellator,
+                                         const Matrix& transform) const {
+  auto determinant = transform.GetDeterminant();
+  if (stroke_width_ < 0.0 || determinant == 0) {
+    return;
+  }
+
+  Scalar min_size = 1.0f / sqrt(std::abs(determinant));
+  Scalar stroke_width = std::max(stroke_width_, min_size);
+
+  auto prepared = std::make_unique<PreparedVertices>();
+  prepared->basis = transform.Basis();
+  prepared->type = PrimitiveType::kTriangleStrip;
+  prepared->prevent_overdraw = true;
+  prepared->vertices = CreateSolidStrokeVertices(
+      path_, stroke_width, miter_limit_ * stroke_width_ * 0.5,
+      GetJoinProc(stroke_join_), GetCapProc(stroke_cap_),
+      transform.GetMaxBasisLength());
+  SetPreparedVertices(std::move(prepared));
+}
+
 GeometryResult StrokePathGeometry::GetPositionUVBuffer(
     Rect texture_coverage,
     Matrix effect_transform,
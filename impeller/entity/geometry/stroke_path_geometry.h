@@ -28,6 +28,13 @@ class StrokePathGeometry final : public Geometry {
 
   Join GetStrokeJoin() const;
 
+  // |Geometry|
+  bool CanPrepareVertices() const override;
+
+  // |Geometry|
+  void PrepareVertices(Tessellator& tessellator,
+                       const Matrix& transform) const override;
+
  private:
   using VS = SolidFillVertexShader;
 
@@ -4,6 +4,7 @@
 
 #include "impeller/entity/geometry/vertices_geometry.h"
 
+#include <algorithm>
 #include <utility>
 
 #include <utility>
@@ -226,21 +227,28 @@ GeometryResult VerticesGeometry::GetPositionUVBuffer(
   auto uv_transform =
       texture_coverage.GetNormalizingTransform() * effect_transform;
   auto has_texture_coordinates = HasTextureCoordinates();
+  const Point* texture_coords =
+      has_texture_coordinates ? texture_coordinates_.data() : vertices_.data();
   std::vector<VS::PerVertexData> vertex_data(vertex_count);
   {
-    for (auto i = 0u; i < vertex_count; i++) {
-      auto vertex = vertices_[i];
-      auto texture_coord =
-          has_texture_coordinates ? texture_coordinates_[i] : vertices_[i];
-      auto uv = uv_transform * texture_coord;
-      // From experimentation we need to clamp these values to < 1.0 or else
-      // there can be flickering.
-      vertex_data[i] = {
-          .position = vertex,
-          .texture_coords =
-              Point(std::clamp(uv.x, 0.0f, 1.0f - kEhCloseEnough),
-                    std::clamp(uv.y, 0.0f, 1.0f - kEhCloseEnough)),
-      };
+    // Transform the coordinates in batches through a stack buffer rather
+    // than allocating for all of them.
+    constexpr size_t kBatchSize = 64;
+    Point uvs[kBatchSize];
+    for (size_t start = 0; start < vertex_count; start += kBatchSize) {
+      size_t batch = std::min(kBatchSize, vertex_count - start);
+      uv_transform.TransformPoints(texture_coords + start, uvs, batch);
+      for (size_t i = 0; i < batch; i++) {
+        auto uv = uvs[i];
+        // From experimentation we need to clamp these values to < 1.0 or
+        // else there can be flickering.
+        vertex_data[start + i] = {
+            .position = vertices_[start + i],
+            .texture_coords =
+                Point(std::clamp(uv.x, 0.0f, 1.0f - kEhCloseEnough),
+                      std::clamp(uv.y, 0.0f, 1.0f - kEhCloseEnough)),
+        };
+      }
     }
   }
 
@@ -4,6 +4,7 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 
+#include "impeller/geometry/matrix.h"
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/path_builder.h"
 #include "impeller/tessellator/tessellator.h"
@@ -82,11 +83,96 @@ static void BM_Convex(benchmark::State& state, Args&&... args) {
   state.counters["TotalPointCount"] = point_count;
 }
 
+/// Tessellates a path with a cache key, so every iteration after the first
+/// reuses the fill cached by the tessellator.
+template <class... Args>
+static void BM_CachedTessellation(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  auto path = PathBuilder{}
+                  .AddPath(std::get<Path>(args_tuple))
+                  .SetCacheKey(1)
+                  .TakePath();
+
+  Tessellator tessellator;
+  size_t point_count = 0u;
+  while (state.KeepRunning()) {
+    tessellator.Tessellate(
+        path, 1.0f,
+        [&point_count](const float* vertices, size_t vertices_count,
+                       const uint16_t* indices, size_t indices_count) {
+          point_count += indices_count > 0 ? indices_count : vertices_count;
+          return true;
+        });
+  }
+  state.counters["TotalPointCount"] = point_count;
+  state.counters["CacheHits"] =
+      tessellator.GetPathCache().GetStats().fill_hits;
+}
+
+static Matrix CreateTransform() {
+  return Matrix::MakeTranslation({10, 20, 30}) *
+         Matrix::MakeRotationZ(Radians{0.5}) *
+         Matrix::MakeScale({2.0, 3.0, 4.0});
+}
+
+static void BM_MatrixMultiply(benchmark::State& state) {
+  Matrix a = CreateTransform();
+  Matrix b = Matrix::MakeRotationX(Radians{0.3});
+  for (auto _ : state) {
+    a = a * b;
+    benchmark::DoNotOptimize(a);
+  }
+}
+
+static void BM_MatrixInvert(benchmark::State& state) {
+  Matrix matrix = CreateTransform();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matrix);
+    Matrix inverse = matrix.Invert();
+    benchmark::DoNotOptimize(inverse);
+  }
+}
+
+template <class... Args>
+static void BM_TransformPoints(benchmark::State& state, Args&&... args) {
+  auto args_tuple = std::make_tuple(std::move(args)...);
+  bool bulk = std::get<bool>(args_tuple);
+  Matrix matrix = CreateTransform();
+  std::vector<Point> points(state.range(0));
+  for (size_t i = 0; i < points.size(); i++) {
+    points[i] = Point(i * 0.5f, i * 0.25f);
+  }
+  std::vector<Point> transformed(points.size());
+  for (auto _ : state) {
+    if (bulk) {
+      matrix.TransformPoints(points.data(), transformed.data(), points.size());
+    } else {
+      for (size_t i = 0; i < points.size(); i++) {
+        transformed[i] = matrix * points[i];
+      }
+    }
+    benchmark::DoNotOptimize(transformed.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK(BM_MatrixMultiply);
+BENCHMARK(BM_MatrixInvert);
+BENCHMARK_CAPTURE(BM_TransformPoints, bulk, true)
+    ->RangeMultiplier(8)
+    ->Range(8, 4096);
+BENCHMARK_CAPTURE(BM_TransformPoints, per_point, false)
+    ->RangeMultiplier(8)
+    ->Range(8, 4096);
+
 BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline, CreateCubic(), false);
 BENCHMARK_CAPTURE(BM_Polyline, cubic_polyline_tess, CreateCubic(), true);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline, CreateQuadratic(), false);
 BENCHMARK_CAPTURE(BM_Polyline, quad_polyline_tess, CreateQuadratic(), true);
 BENCHMARK_CAPTURE(BM_Convex, rrect_convex, CreateRRect(), true);
+BENCHMARK_CAPTURE(BM_CachedTessellation, cubic_tess_cached, CreateCubic());
+BENCHMARK_CAPTURE(BM_CachedTessellation, quad_tess_cached, CreateQuadratic());
 
 namespace {
 
@@ -7,8 +7,147 @@
 #include <climits>
 #include <sstream>
 
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define IMPELLER_MATRIX_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__) && defined(__clang__)
+#include <arm_neon.h>
+#define IMPELLER_MATRIX_NEON 1
+#endif
+
 namespace impeller {
 
+namespace {
+
+// A minimal abstraction over four wide float vectors, so that the kernels
+// below are written once for SSE, NEON and the portable fallback.
+//
+// Fused multiply-add is deliberately not used so that transformed points are
+// bit for bit identical to those transformed one at a time.
+#if IMPELLER_MATRIX_SSE
+
+using F4 = __m128;
+
+inline F4 Load(const Scalar* p) {
+  return _mm_loadu_ps(p);
+}
+
+inline void Store(Scalar* p, F4 v) {
+  _mm_storeu_ps(p, v);
+}
+
+inline F4 Splat(Scalar s) {
+  return _mm_set1_ps(s);
+}
+
+inline F4 Add(F4 a, F4 b) {
+  return _mm_add_ps(a, b);
+}
+
+inline F4 Sub(F4 a, F4 b) {
+  return _mm_sub_ps(a, b);
+}
+
+inline F4 Mul(F4 a, F4 b) {
+  return _mm_mul_ps(a, b);
+}
+
+// Returns {a[A], a[B], b[C], b[D]}.
+template <int A, int B, int C, int D>
+inline F4 Shuffle(F4 a, F4 b) {
+  return _mm_shuffle_ps(a, b, _MM_SHUFFLE(D, C, B, A));
+}
+
+#elif IMPELLER_MATRIX_NEON
+
+using F4 = float32x4_t;
+
+inline F4 Load(const Scalar* p) {
+  return vld1q_f32(p);
+}
+
+inline void Store(Scalar* p, F4 v) {
+  vst1q_f32(p, v);
+}
+
+inline F4 Splat(Scalar s) {
+  return vdupq_n_f32(s);
+}
+
+inline F4 Add(F4 a, F4 b) {
+  return vaddq_f32(a, b);
+}
+
+inline F4 Sub(F4 a, F4 b) {
+  return vsubq_f32(a, b);
+}
+
+inline F4 Mul(F4 a, F4 b) {
+  return vmulq_f32(a, b);
+}
+
+// Returns {a[A], a[B], b[C], b[D]}.
+template <int A, int B, int C, int D>
+inline F4 Shuffle(F4 a, F4 b) {
+  return __builtin_shufflevector(a, b, A, B, C + 4, D + 4);
+}
+
+#else  // IMPELLER_MATRIX_SSE || IMPELLER_MATRIX_NEON
+
+struct F4 {
+  Scalar v[4];
+};
+
+inline F4 Load(const Scalar* p) {
+  return {p[0], p[1], p[2], p[3]};
+}
+
+inline void Store(Scalar* p, F4 v) {
+  for (int i = 0; i < 4; i++) {
+    p[i] = v.v[i];
+  }
+}
+
+inline F4 Splat(Scalar s) {
+  return {s, s, s, s};
+}
+
+inline F4 Add(F4 a, F4 b) {
+  return {a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]};
+}
+
+inline F4 Sub(F4 a, F4 b) {
+  return {a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]};
+}
+
+inline F4 Mul(F4 a, F4 b) {
+  return {a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]};
+}
+
+// Returns {a[A], a[B], b[C], b[D]}.
+template <int A, int B, int C, int D>
+inline F4 Shuffle(F4 a, F4 b) {
+  return {a.v[A], a.v[B], b.v[C], b.v[D]};
+}
+
+#endif  // IMPELLER_MATRIX_SSE || IMPELLER_MATRIX_NEON
+
+// Computes the 2x2 sub-determinants of rows R and S of the last two columns
+// of a matrix, arranged for the four columns of its adjugate.
+template <int R, int S>
+inline F4 SubFactors(F4 c1, F4 c2, F4 c3) {
+  const F4 swp0a = Shuffle<S, S, S, S>(c3, c2);
+  const F4 swp0b = Shuffle<R, R, R, R>(c3, c2);
+  const F4 swp00 = Shuffle<R, R, R, R>(c2, c1);
+  const F4 swp01 = Shuffle<0, 0, 0, 2>(swp0a, swp0a);
+  const F4 swp02 = Shuffle<0, 0, 0, 2>(swp0b, swp0b);
+  const F4 swp03 = Shuffle<S, S, S, S>(c2, c1);
+  return Sub(Mul(swp00, swp01), Mul(swp02, swp03));
+}
+
+}  // namespace
+
 Matrix::Matrix(const MatrixDecomposition& d) : Matrix() {
   /*
    *  Apply perspective.
@@ -95,68 +234,99 @@ Matrix Matrix::operator+(const Matrix& o) const {
 }
 
 Matrix Matrix::Invert() const {
-  Matrix tmp{
-      m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
-          m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10],
-
-      -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] -
-          m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10],
-
-      m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] +
-          m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6],
-
-      -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] -
-          m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6],
-
-      -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] -
-          m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10],
-
-      m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] +
-          m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10],
-
-      -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] -
-          m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6],
-
-      m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] +
-          m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6],
-
-      m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
-          m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9],
-
-      -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] -
-          m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9],
-
-      m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] +
-          m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5],
-
-      -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] -
-          m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5],
-
-      -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] -
-          m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9],
-
-      m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] +
-          m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9],
-
-      -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] -
-          m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5],
-
-      m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] +
-          m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5]};
-
-  Scalar det =
-      m[0] * tmp.m[0] + m[1] * tmp.m[4] + m[2] * tmp.m[8] + m[3] * tmp.m[12];
+  // The inverse is the adjugate divided by the determinant. Each column of
+  // the adjugate is computed at once from the 2x2 sub-determinants of the
+  // last two columns (Fac0 through Fac5), as in GLM's SSE implementation.
+  const F4 c0 = Load(m);
+  const F4 c1 = Load(m + 4);
+  const F4 c2 = Load(m + 8);
+  const F4 c3 = Load(m + 12);
+
+  const F4 fac0 = SubFactors<2, 3>(c1, c2, c3);
+  const F4 fac1 = SubFactors<1, 3>(c1, c2, c3);
+  const F4 fac2 = SubFactors<1, 2>(c1, c2, c3);
+  const F4 fac3 = SubFactors<0, 3>(c1, c2, c3);
+  const F4 fac4 = SubFactors<0, 2>(c1, c2, c3);
+  const F4 fac5 = SubFactors<0, 1>(c1, c2, c3);
+
+  // {c1[i], c0[i], c0[i], c0[i]} for each row i.
+  const F4 vec0 = Shuffle<0, 2, 2, 2>(Shuffle<0, 0, 0, 0>(c1, c0),
+                                      Shuffle<0, 0, 0, 0>(c1, c0));
+  const F4 vec1 = Shuffle<0, 2, 2, 2>(Shuffle<1, 1, 1, 1>(c1, c0),
+                                      Shuffle<1, 1, 1, 1>(c1, c0));
+  const F4 vec2 = Shuffle<0, 2, 2, 2>(Shuffle<2, 2, 2, 2>(c1, c0),
+                                      Shuffle<2, 2, 2, 2>(c1, c0));
+  const F4 vec3 = Shuffle<0, 2, 2, 2>(Shuffle<3, 3, 3, 3>(c1, c0),
+                                      Shuffle<3, 3, 3, 3>(c1, c0));
+
+  const Scalar kSignA[4] = {-1.0f, 1.0f, -1.0f, 1.0f};
+  const Scalar kSignB[4] = {1.0f, -1.0f, 1.0f, -1.0f};
+  const F4 sign_a = Load(kSignA);
+  const F4 sign_b = Load(kSignB);
+
+  const F4 inv0 = Mul(
+      sign_b,
+      Add(Sub(Mul(vec1, fac0), Mul(vec2, fac1)), Mul(vec3, fac2)));
+  const F4 inv1 = Mul(
+      sign_a,
+      Add(Sub(Mul(vec0, fac0), Mul(vec2, fac3)), Mul(vec3, fac4)));
+  const F4 inv2 = Mul(
+      sign_b,
+      Add(Sub(Mul(vec0, fac1), Mul(vec1, fac3)), Mul(vec3, fac5)));
+  const F4 inv3 = Mul(
+      sign_a,
+      Add(Sub(Mul(vec0, fac2), Mul(vec1, fac4)), Mul(vec2, fac5)));
+
+  // The determinant is the dot product of the first column with the first
+  // row of the adjugate.
+  const F4 row = Shuffle<0, 2, 0, 2>(Shuffle<0, 0, 0, 0>(inv0, inv1),
+                                     Shuffle<0, 0, 0, 0>(inv2, inv3));
+  Scalar products[4];
+  Store(products, Mul(c0, row));
+  Scalar det = (products[0] + products[1]) + (products[2] + products[3]);
 
   if (det == 0) {
     return {};
   }
 
-  det = 1.0 / det;
+  const F4 inv_det = Splat(1.0f / det);
+  Matrix result;
+  Store(result.m, Mul(inv0, inv_det));
+  Store(result.m + 4, Mul(inv1, inv_det));
+  Store(result.m + 8, Mul(inv2, inv_det));
+  Store(result.m + 12, Mul(inv3, inv_det));
+  return result;
+}
 
-  return {tmp.m[0] * det,  tmp.m[1] * det,  tmp.m[2] * det,  tmp.m[3] * det,
-          tmp.m[4] * det,  tmp.m[5] * det,  tmp.m[6] * det,  tmp.m[7] * det,
-          tmp.m[8] * det,  tmp.m[9] * det,  tmp.m[10] * det, tmp.m[11] * det,
-          tmp.m[12] * det, tmp.m[13] * det, tmp.m[14] * det, tmp.m[15] * det};
+void Matrix::TransformPoints(const Point* src, Point* dst, size_t count) const {
+  static_assert(sizeof(Point) == 2 * sizeof(Scalar));
+  if (m[3] != 0 || m[7] != 0 || m[15] != 1) {
+    // Perspective transforms need a divide per point.
+    for (size_t i = 0; i < count; i++) {
+      dst[i] = *this * src[i];
+    }
+    return;
+  }
+
+  // Transform two points per iteration, with the points interleaved as
+  // {x0, y0, x1, y1}.
+  const Scalar kScaleX[4] = {m[0], m[1], m[0], m[1]};
+  const Scalar kScaleY[4] = {m[4], m[5], m[4], m[5]};
+  const Scalar kTranslate[4] = {m[12], m[13], m[12], m[13]};
+  const F4 scale_x = Load(kScaleX);
+  const F4 scale_y = Load(kScaleY);
+  const F4 translate = Load(kTranslate);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    const F4 points = Load(&src[i].x);
+    const F4 xs = Shuffle<0, 0, 2, 2>(points, points);
+    const F4 ys = Shuffle<1, 1, 3, 3>(points, points);
+    Store(&dst[i].x,
+          Add(Add(Mul(xs, scale_x), Mul(ys, scale_y)), translate));
+  }
+  for (; i < count; i++) {
+    dst[i] = *this * src[i];
+  }
 }
 
 Scalar Matrix::GetDeterminant() const {
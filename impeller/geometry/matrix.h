@@ -430,6 +430,17 @@ struct Matrix {
     return result * w;
   }
 
+  //----------------------------------------------------------------------------
+  /// @brief      Transforms |count| points from |src| into |dst|, with the same
+  ///             results as applying |operator*| to each point up to floating
+  ///             point rounding.
+  ///
+  ///             Affine transforms are vectorized where SIMD is available.
+  ///             |src| and |dst| may be the same buffer, but must not
+  ///             otherwise overlap.
+  ///
+  void TransformPoints(const Point* src, Point* dst, size_t count) const;
+
   constexpr Vector4 TransformDirection(const Vector4& v) const {
     return Vector4(v.x * m[0] + v.y * m[4] + v.z * m[8],
                    v.x * m[1] + v.y * m[5] + v.z * m[9],
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "flutter/impeller/geometry/matrix.h"
@@ -24,5 +26,55 @@ TEST(MatrixTest, Multiply) {
                                         11.0, 21.0, 0.0, 1.0)));
 }
 
+TEST(MatrixTest, InvertRoundTrips) {
+  Matrix matrices[] = {
+      Matrix::MakeTranslation({10, 20, 30}) *
+          Matrix::MakeRotationZ(Radians{0.5}) *
+          Matrix::MakeScale({2.0, 3.0, 4.0}),
+      Matrix::MakePerspective(Radians{1.0}, 1.5, 0.1, 100.0) *
+          Matrix::MakeRotationY(Radians{0.3}),
+      Matrix(1.0, 2.0, 3.0, 4.0,  //
+             0.0, 1.0, 5.0, 6.0,  //
+             0.0, 0.0, 1.0, 7.0,  //
+             8.0, 0.0, 0.0, 1.0),
+  };
+  for (const Matrix& matrix : matrices) {
+    EXPECT_TRUE(MatrixNear(matrix * matrix.Invert(), Matrix()));
+    EXPECT_TRUE(MatrixNear(matrix.Invert() * matrix, Matrix()));
+  }
+}
+
+TEST(MatrixTest, InvertOfSingularMatrixIsIdentity) {
+  Matrix singular = Matrix::MakeScale({1.0, 0.0, 1.0});
+  EXPECT_EQ(singular.Invert(), Matrix());
+}
+
+TEST(MatrixTest, TransformPointsMatchesPointTransform) {
+  std::vector<Point> points;
+  for (int i = 0; i < 7; i++) {
+    points.emplace_back(i * 3.5f, i * -1.25f);
+  }
+  Matrix matrices[] = {
+      Matrix(),
+      Matrix::MakeTranslation({10, 20, 0}) *
+          Matrix::MakeRotationZ(Radians{0.5}) *
+          Matrix::MakeScale({2.0, 3.0, 1.0}),
+      Matrix::MakePerspective(Radians{1.0}, 1.5, 0.1, 100.0),
+  };
+  for (const Matrix& matrix : matrices) {
+    std::vector<Point> transformed(points.size());
+    matrix.TransformPoints(points.data(), transformed.data(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+      // Not exactly equal as the compiler may contract either into FMAs.
+      EXPECT_POINT_NEAR(transformed[i], matrix * points[i]);
+    }
+
+    // Transforming in place gives the same result.
+    std::vector<Point> in_place = points;
+    matrix.TransformPoints(in_place.data(), in_place.data(), in_place.size());
+    EXPECT_EQ(in_place, transformed);
+  }
+}
+
 }  // namespace testing
 }  // namespace impeller
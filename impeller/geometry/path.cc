@@ -60,6 +60,14 @@ bool Path::IsConvex() const {
   return convexity_ == Convexity::kConvex;
 }
 
+uint64_t Path::GetCacheKey() const {
+  return cache_key_;
+}
+
+void Path::SetCacheKey(uint64_t key) {
+  cache_key_ = key;
+}
+
 void Path::SetConvexity(Convexity value) {
   convexity_ = value;
 }
@@ -144,6 +144,14 @@ class Path {
 
   bool IsConvex() const;
 
+  /// An identifier for the geometry of this path that is stable across frames,
+  /// or 0 if the path has no such identity. Paths with the same non-zero cache
+  /// key have identical components, but may differ in fill type.
+  ///
+  /// This allows the flattened and tessellated forms of the path to be cached
+  /// between frames.
+  uint64_t GetCacheKey() const;
+
   template <class T>
   using Applier = std::function<void(size_t index, const T& component)>;
   void EnumerateComponents(
@@ -190,6 +198,8 @@ class Path {
 
   void SetFillType(FillType fill);
 
+  void SetCacheKey(uint64_t key);
+
   void SetBounds(Rect rect);
 
   Path& AddLinearComponent(const Point& p1, const Point& p2);
@@ -227,6 +237,7 @@ class Path {
 
   FillType fill_ = FillType::kNonZero;
   Convexity convexity_ = Convexity::kUnknown;
+  uint64_t cache_key_ = 0;
   std::vector<ComponentIndexPair> components_;
   std::vector<Point> points_;
   std::vector<ContourComponent> contours_;
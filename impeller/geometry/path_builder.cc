@@ -26,6 +26,8 @@ Path PathBuilder::TakePath(FillType fill) {
     path.ComputeBounds();
   }
   did_compute_bounds_ = false;
+  path.SetCacheKey(cache_key_);
+  cache_key_ = 0;
   return path;
 }
 
@@ -405,4 +407,9 @@ PathBuilder& PathBuilder::SetBounds(Rect bounds) {
   return *this;
 }
 
+PathBuilder& PathBuilder::SetCacheKey(uint64_t key) {
+  cache_key_ = key;
+  return *this;
+}
+
 }  // namespace impeller
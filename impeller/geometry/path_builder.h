@@ -104,6 +104,13 @@ class PathBuilder {
   ///        recomputing these bounds.
   PathBuilder& SetBounds(Rect bounds);
 
+  /// @brief Set the cache key of the path returned by the next call to
+  ///        `TakePath`.
+  ///
+  ///        The caller guarantees that every path built with the same key has
+  ///        identical components. See `Path::GetCacheKey`.
+  PathBuilder& SetCacheKey(uint64_t key);
+
   struct RoundingRadii {
     Point top_left;
     Point bottom_left;
@@ -161,6 +168,7 @@ class PathBuilder {
   Path prototype_;
   Convexity convexity_;
   bool did_compute_bounds_ = false;
+  uint64_t cache_key_ = 0;
 
   PathBuilder& AddRoundedRectTopLeft(Rect rect, RoundingRadii radii);
 
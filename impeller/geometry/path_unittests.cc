@@ -485,5 +485,20 @@ TEST(PathTest, CanBeCloned) {
   }
 }
 
+TEST(PathTest, CacheKeyAppliesToNextTakenPath) {
+  PathBuilder builder;
+  EXPECT_EQ(builder.TakePath().GetCacheKey(), 0u);
+
+  builder.SetCacheKey(42);
+  builder.MoveTo({10, 10});
+  builder.LineTo({20, 20});
+  auto path = builder.TakePath();
+  EXPECT_EQ(path.GetCacheKey(), 42u);
+  EXPECT_EQ(path.Clone().GetCacheKey(), 42u);
+
+  builder.MoveTo({10, 10});
+  EXPECT_EQ(builder.TakePath().GetCacheKey(), 0u);
+}
+
 }  // namespace testing
 }  // namespace impeller
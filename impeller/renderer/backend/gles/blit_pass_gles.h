@@ -58,7 +58,7 @@ class BlitPassGLES final : public BlitPass,
   // |BlitPass|
   bool OnCopyBufferToTextureCommand(BufferView source,
                                     std::shared_ptr<Texture> destination,
-                                    IPoint destination_origin,
+                                    IRect destination_region,
                                     std::string label) override {
     IMPELLER_UNIMPLEMENTED;
     return false;
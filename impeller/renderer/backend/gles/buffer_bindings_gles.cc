@@ -144,32 +144,17 @@ bool BufferBindingsGLES::BindVertexAttributes(const ProcTableGLES& gl,
 
 bool BufferBindingsGLES::BindUniformData(const ProcTableGLES& gl,
                                          Allocator& transients_allocator,
-                                         const Bindings& vertex_bindings,
-                                         const Bindings& fragment_bindings) {
-  for (const auto& buffer : vertex_bindings.buffers) {
+                                         const CommandStream& stream,
+                                         const EncodedCommand& command) {
+  const auto& buffers = stream.GetBuffers();
+  for (size_t i = 0; i < command.buffers.length; i++) {
+    const auto& buffer = buffers[command.buffers.offset + i].binding;
     if (!BindUniformBuffer(gl, transients_allocator, buffer.view)) {
       return false;
     }
   }
-  for (const auto& buffer : fragment_bindings.buffers) {
-    if (!BindUniformBuffer(gl, transients_allocator, buffer.view)) {
-      return false;
-    }
-  }
-
-  std::optional<size_t> next_unit_index =
-      BindTextures(gl, vertex_bindings, ShaderStage::kVertex);
-  if (!next_unit_index.has_value()) {
-    return false;
-  }
-
-  if (!BindTextures(gl, fragment_bindings, ShaderStage::kFragment,
-                    *next_unit_index)
-           .has_value()) {
-    return false;
-  }
 
-  return true;
+  return BindTextures(gl, stream, command);
 }
 
 bool BufferBindingsGLES::UnbindVertexAttributes(const ProcTableGLES& gl) const {
@@ -342,31 +327,33 @@ bool BufferBindingsGLES::BindUniformBuffer(const ProcTableGLES& gl,
   return true;
 }
 
-std::optional<size_t> BufferBindingsGLES::BindTextures(
-    const ProcTableGLES& gl,
-    const Bindings& bindings,
-    ShaderStage stage,
-    size_t unit_start_index) {
-  size_t active_index = unit_start_index;
-  for (const auto& data : bindings.sampled_images) {
+bool BufferBindingsGLES::BindTextures(const ProcTableGLES& gl,
+                                      const CommandStream& stream,
+                                      const EncodedCommand& command) {
+  const auto& textures = stream.GetTextures();
+  size_t active_index = 0;
+  for (size_t i = 0; i < command.textures.length; i++) {
+    const auto& stage_binding = textures[command.textures.offset + i];
+    const auto& data = stage_binding.binding;
     const auto& texture_gles = TextureGLES::Cast(*data.texture.resource);
     if (data.texture.GetMetadata() == nullptr) {
       VALIDATION_LOG << "No metadata found for texture binding.";
-      return std::nullopt;
+      return false;
     }
 
     auto location = ComputeTextureLocation(data.texture.GetMetadata());
     if (location == -1) {
-      return std::nullopt;
+      return false;
     }
 
     //--------------------------------------------------------------------------
     /// Set the active texture unit.
     ///
-    if (active_index >= gl.GetCapabilities()->GetMaxTextureUnits(stage)) {
+    if (active_index >=
+        gl.GetCapabilities()->GetMaxTextureUnits(stage_binding.stage)) {
       VALIDATION_LOG << "Texture units specified exceed the capabilities for "
                         "this shader stage.";
-      return std::nullopt;
+      return false;
     }
     gl.ActiveTexture(GL_TEXTURE0 + active_index);
 
@@ -374,7 +361,7 @@ std::optional<size_t> BufferBindingsGLES::BindTextures(
     /// Bind the texture.
     ///
     if (!texture_gles.Bind()) {
-      return std::nullopt;
+      return false;
     }
 
     //--------------------------------------------------------------------------
@@ -383,7 +370,7 @@ std::optional<size_t> BufferBindingsGLES::BindTextures(
     ///
     const auto& sampler_gles = SamplerGLES::Cast(*data.sampler);
     if (!sampler_gles.ConfigureBoundTexture(texture_gles, gl)) {
-      return std::nullopt;
+      return false;
     }
 
     //--------------------------------------------------------------------------
@@ -396,7 +383,7 @@ std::optional<size_t> BufferBindingsGLES::BindTextures(
     ///
     active_index++;
   }
-  return active_index;
+  return true;
 }
 
 }  // namespace impeller
@@ -12,6 +12,7 @@
 #include "impeller/renderer/backend/gles/gles.h"
 #include "impeller/renderer/backend/gles/proc_table_gles.h"
 #include "impeller/renderer/command.h"
+#include "impeller/renderer/command_stream.h"
 
 namespace impeller {
 
@@ -37,8 +38,8 @@ class BufferBindingsGLES {
 
   bool BindUniformData(const ProcTableGLES& gl,
                        Allocator& transients_allocator,
-                       const Bindings& vertex_bindings,
-                       const Bindings& fragment_bindings);
+                       const CommandStream& stream,
+                       const EncodedCommand& command);
 
   bool UnbindVertexAttributes(const ProcTableGLES& gl) const;
 
@@ -70,10 +71,9 @@ class BufferBindingsGLES {
                          Allocator& transients_allocator,
                          const BufferResource& buffer);
 
-  std::optional<size_t> BindTextures(const ProcTableGLES& gl,
-                                     const Bindings& bindings,
-                                     ShaderStage stage,
-                                     size_t unit_start_index = 0);
+  bool BindTextures(const ProcTableGLES& gl,
+                    const CommandStream& stream,
+                    const EncodedCommand& command);
 
   BufferBindingsGLES(const BufferBindingsGLES&) = delete;
 
@@ -147,11 +147,11 @@ struct RenderPassData {
     const RenderPassData& pass_data,
     const std::shared_ptr<Allocator>& transients_allocator,
     const ReactorGLES& reactor,
-    const std::vector<Command>& commands,
+    const CommandStream& stream,
     const std::shared_ptr<GPUTracerGLES>& tracer) {
   TRACE_EVENT0("impeller", "RenderPassGLES::EncodeCommandsInReactor");
 
-  if (commands.empty()) {
+  if (stream.IsEmpty()) {
     return true;
   }
 
@@ -249,7 +249,7 @@ struct RenderPassData {
 
   gl.Clear(clear_bits);
 
-  for (const auto& command : commands) {
+  for (const auto& command : stream.GetCommands()) {
     if (command.instance_count != 1u) {
       VALIDATION_LOG << "GLES backend does not support instanced rendering.";
       return false;
@@ -263,8 +263,8 @@ struct RenderPassData {
 #ifdef IMPELLER_DEBUG
     fml::ScopedCleanupClosure pop_cmd_debug_marker(
         [&gl]() { gl.PopDebugGroup(); });
-    if (!command.label.empty()) {
-      gl.PushDebugGroup(command.label);
+    if (auto label = stream.GetLabel(command); !label.empty()) {
+      gl.PushDebugGroup(std::string(label));
     } else {
       pop_cmd_debug_marker.Release();
     }
@@ -416,10 +416,10 @@ struct RenderPassData {
     //--------------------------------------------------------------------------
     /// Bind uniform data.
     ///
-    if (!vertex_desc_gles->BindUniformData(gl,                        //
-                                           *transients_allocator,     //
-                                           command.vertex_bindings,   //
-                                           command.fragment_bindings  //
+    if (!vertex_desc_gles->BindUniformData(gl,                     //
+                                           *transients_allocator,  //
+                                           stream,                 //
+                                           command                 //
                                            )) {
       return false;
     }
@@ -517,7 +517,7 @@ bool RenderPassGLES::OnEncodeCommands(const Context& context) const {
   if (!IsValid()) {
     return false;
   }
-  if (commands_.empty()) {
+  if (command_stream_.IsEmpty()) {
     return true;
   }
   const auto& render_target = GetRenderTarget();
@@ -579,7 +579,7 @@ bool RenderPassGLES::OnEncodeCommands(const Context& context) const {
                                  render_pass = std::move(shared_this),
                                  tracer](const auto& reactor) {
     auto result = EncodeCommandsInReactor(*pass_data, allocator, reactor,
-                                          render_pass->commands_, tracer);
+                                          render_pass->command_stream_, tracer);
     FML_CHECK(result) << "Must be able to encode GL commands without error.";
   });
 }
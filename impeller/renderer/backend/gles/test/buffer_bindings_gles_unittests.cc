@@ -0,0 +1,92 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/testing/testing.h"  // IWYU pragma: keep
+#include "gtest/gtest.h"
+#include "impeller/base/allocation.h"
+#include "impeller/core/allocator.h"
+#include "impeller/geometry/vector.h"
+#include "impeller/renderer/backend/gles/buffer_bindings_gles.h"
+#include "impeller/renderer/backend/gles/device_buffer_gles.h"
+#include "impeller/renderer/backend/gles/test/mock_gles.h"
+#include "impeller/renderer/command_stream.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+// Uniform data is read straight from the device buffers, so the transients
+// allocator is never used.
+class UnusedAllocator final : public Allocator {
+ public:
+  ISize GetMaxTextureSizeSupported() const override { return {}; }
+
+  std::shared_ptr<DeviceBuffer> OnCreateBuffer(
+      const DeviceBufferDescriptor& desc) override {
+    return nullptr;
+  }
+
+  std::shared_ptr<Texture> OnCreateTexture(
+      const TextureDescriptor& desc) override {
+    return nullptr;
+  }
+};
+
+}  // namespace
+
+TEST(BufferBindingsGLESTest, BindsUniformsOfEachRecordedCommand) {
+  auto mock_gles = MockGLES::Init();
+  auto& gl = mock_gles->GetProcTable();
+
+  BufferBindingsGLES bindings;
+  ASSERT_TRUE(bindings.ReadUniformsBindings(gl, 1u));
+
+  // Matches the single uniform of every mocked program.
+  ShaderMetadata metadata = {
+      .name = "FrameInfo",
+      .members = {ShaderStructMemberMetadata{
+          .type = ShaderType::kFloat,
+          .name = "color",
+          .offset = 0u,
+          .size = sizeof(Vector4),
+          .byte_length = sizeof(Vector4),
+      }},
+  };
+  ShaderUniformSlot slot = {.name = "FrameInfo", .ext_res_0 = 0u};
+
+  auto backing_store = std::make_shared<Allocation>();
+  ASSERT_TRUE(backing_store->Truncate(sizeof(Vector4)));
+  auto device_buffer = std::make_shared<DeviceBufferGLES>(
+      DeviceBufferDescriptor{.size = sizeof(Vector4)}, nullptr, backing_store);
+  BufferView view = {.buffer = device_buffer,
+                     .range = Range(0u, sizeof(Vector4))};
+
+  CommandStream stream;
+  ASSERT_TRUE(stream.BindBuffer(ShaderStage::kVertex, slot, &metadata, view));
+  stream.CommitPending();
+  ASSERT_TRUE(stream.BindBuffer(ShaderStage::kVertex, slot, &metadata, view));
+  stream.DiscardPending();
+  ASSERT_TRUE(stream.BindBuffer(ShaderStage::kVertex, slot, &metadata, view));
+  ASSERT_TRUE(
+      stream.BindBuffer(ShaderStage::kFragment, slot, &metadata, view));
+  stream.CommitPending();
+  ASSERT_EQ(stream.GetCommands().size(), 2u);
+
+  UnusedAllocator allocator;
+  mock_gles->GetCapturedCalls();
+
+  ASSERT_TRUE(bindings.BindUniformData(gl, allocator, stream,
+                                       stream.GetCommands()[0]));
+  EXPECT_EQ(mock_gles->GetCapturedCalls(),
+            std::vector<std::string>({"glUniform4fv"}));
+
+  ASSERT_TRUE(bindings.BindUniformData(gl, allocator, stream,
+                                       stream.GetCommands()[1]));
+  EXPECT_EQ(mock_gles->GetCapturedCalls(),
+            std::vector<std::string>({"glUniform4fv", "glUniform4fv"}));
+}
+
+}  // namespace testing
+}  // namespace impeller
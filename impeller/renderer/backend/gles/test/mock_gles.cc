@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <memory>
 
 #include "GLES3/gl3.h"
@@ -159,6 +162,63 @@ void mockDeleteQueriesEXT(GLsizei size, const GLuint* queries) {
 static_assert(CheckSameSignature<decltype(mockDeleteQueriesEXT),  //
                                  decltype(glDeleteQueriesEXT)>::value);
 
+// Every program has a single active uniform with this name.
+auto const kMockUniformName = "FrameInfo.color";
+
+GLboolean mockIsProgram(GLuint program) {
+  return GL_TRUE;
+}
+
+static_assert(CheckSameSignature<decltype(mockIsProgram),  //
+                                 decltype(glIsProgram)>::value);
+
+void mockGetProgramiv(GLuint program, GLenum name, GLint* value) {
+  switch (name) {
+    case GL_ACTIVE_UNIFORMS:
+      *value = 1;
+      break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+      *value = strlen(kMockUniformName) + 1;
+      break;
+    default:
+      *value = 0;
+      break;
+  }
+}
+
+static_assert(CheckSameSignature<decltype(mockGetProgramiv),  //
+                                 decltype(glGetProgramiv)>::value);
+
+void mockGetActiveUniform(GLuint program,
+                          GLuint index,
+                          GLsizei buffer_size,
+                          GLsizei* length,
+                          GLint* size,
+                          GLenum* type,
+                          GLchar* name) {
+  auto written = snprintf(name, buffer_size, "%s", kMockUniformName);
+  *length = std::min<GLsizei>(written, buffer_size - 1);
+  *size = 1;
+  *type = GL_FLOAT_VEC4;
+}
+
+static_assert(CheckSameSignature<decltype(mockGetActiveUniform),  //
+                                 decltype(glGetActiveUniform)>::value);
+
+GLint mockGetUniformLocation(GLuint program, const GLchar* name) {
+  return 0;
+}
+
+static_assert(CheckSameSignature<decltype(mockGetUniformLocation),  //
+                                 decltype(glGetUniformLocation)>::value);
+
+void mockUniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+  RecordGLCall("glUniform4fv");
+}
+
+static_assert(CheckSameSignature<decltype(mockUniform4fv),  //
+                                 decltype(glUniform4fv)>::value);
+
 std::shared_ptr<MockGLES> MockGLES::Init(
     const std::optional<std::vector<const unsigned char*>>& extensions) {
   // If we cannot obtain a lock, MockGLES is already being used elsewhere.
@@ -195,6 +255,16 @@ const ProcTableGLES::Resolver kMockResolver = [](const char* name) {
     return reinterpret_cast<void*>(mockGetQueryObjectui64vEXT);
   } else if (strcmp(name, "glGetQueryObjectuivEXT") == 0) {
     return reinterpret_cast<void*>(mockGetQueryObjectuivEXT);
+  } else if (strcmp(name, "glIsProgram") == 0) {
+    return reinterpret_cast<void*>(&mockIsProgram);
+  } else if (strcmp(name, "glGetProgramiv") == 0) {
+    return reinterpret_cast<void*>(&mockGetProgramiv);
+  } else if (strcmp(name, "glGetActiveUniform") == 0) {
+    return reinterpret_cast<void*>(&mockGetActiveUniform);
+  } else if (strcmp(name, "glGetUniformLocation") == 0) {
+    return reinterpret_cast<void*>(&mockGetUniformLocation);
+  } else if (strcmp(name, "glUniform4fv") == 0) {
+    return reinterpret_cast<void*>(&mockUniform4fv);
   } else {
     return reinterpret_cast<void*>(&doNothing);
   }
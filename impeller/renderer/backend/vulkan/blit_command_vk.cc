@@ -186,9 +186,9 @@ bool BlitCopyBufferToTextureCommandVK::Encode(CommandEncoderVK& encoder) const {
   image_copy.setImageSubresource(
       vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1));
   image_copy.setImageOffset(
-      vk::Offset3D(destination_origin.x, destination_origin.y, 0));
-  image_copy.setImageExtent(vk::Extent3D(destination->GetSize().width,
-                                         destination->GetSize().height, 1));
+      vk::Offset3D(destination_region.GetX(), destination_region.GetY(), 0));
+  image_copy.setImageExtent(vk::Extent3D(destination_region.GetWidth(),
+                                         destination_region.GetHeight(), 1));
 
   if (!dst.SetLayout(dst_barrier)) {
     VALIDATION_LOG << "Could not encode layout transition.";
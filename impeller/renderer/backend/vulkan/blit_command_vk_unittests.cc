@@ -54,6 +54,7 @@ TEST(BlitCommandVkTest, BlitCopyBufferToTextureCommandVK) {
       .format = PixelFormat::kR8G8B8A8UNormInt,
       .size = ISize(100, 100),
   });
+  cmd.destination_region = IRect::MakeXYWH(10, 20, 30, 40);
   cmd.source =
       DeviceBuffer::AsBufferView(context->GetResourceAllocator()->CreateBuffer({
           .size = 1,
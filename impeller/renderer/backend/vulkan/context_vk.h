@@ -132,8 +132,9 @@ class ContextVK final : public Context,
 
   const vk::Device& GetDevice() const;
 
+  // |Context|
   const std::shared_ptr<fml::ConcurrentTaskRunner>
-  GetConcurrentWorkerTaskRunner() const;
+  GetConcurrentWorkerTaskRunner() const override;
 
   /// @brief A single-threaded task runner that should only be used for
   ///        submitKHR.
@@ -87,10 +87,14 @@ class BlitPass {
   ///             No work is encoded into the command buffer at this time.
   ///
   /// @param[in]  source              The buffer view to read for copying.
+  ///                                 Its rows are tightly packed and it must
+  ///                                 hold exactly enough bytes to fill the
+  ///                                 destination region.
   /// @param[in]  destination         The texture to overwrite using the source
   ///                                 contents.
-  /// @param[in]  destination_offset  The offset to start writing to in the
-  ///                                 destination buffer.
+  /// @param[in]  destination_region  The region of the destination texture to
+  ///                                 overwrite. If not provided, the entire
+  ///                                 texture is overwritten.
   /// @param[in]  label               The optional debug label to give the
   ///                                 command.
   ///
@@ -98,7 +102,7 @@ class BlitPass {
   ///
   bool AddCopy(BufferView source,
                std::shared_ptr<Texture> destination,
-               IPoint destination_origin = {},
+               std::optional<IRect> destination_region = std::nullopt,
                std::string label = "");
 
   //----------------------------------------------------------------------------
@@ -145,7 +149,7 @@ class BlitPass {
   virtual bool OnCopyBufferToTextureCommand(
       BufferView source,
       std::shared_ptr<Texture> destination,
-      IPoint destination_origin,
+      IRect destination_region,
       std::string label) = 0;
 
   virtual bool OnGenerateMipmapCommand(std::shared_ptr<Texture> texture,
@@ -73,5 +73,33 @@ TEST_P(BlitPassTest, BlitPassesForMatchingFormats) {
   EXPECT_TRUE(blit_pass->AddCopy(src, dst));
 }
 
+TEST_P(BlitPassTest, BufferToTextureBlitsMustMatchDestinationRegion) {
+  ScopedValidationDisable scope;  // avoid noise in output.
+  auto context = GetContext();
+  if (!context->GetCapabilities()->SupportsBufferToTextureBlits()) {
+    GTEST_SKIP() << "Buffer to texture blits are not supported.";
+  }
+  auto cmd_buffer = context->CreateCommandBuffer();
+  auto blit_pass = cmd_buffer->CreateBlitPass();
+
+  TextureDescriptor dst_format;
+  dst_format.format = PixelFormat::kR8G8B8A8UNormInt;
+  dst_format.size = {100, 100};
+  auto dst = context->GetResourceAllocator()->CreateTexture(dst_format);
+
+  auto src = DeviceBuffer::AsBufferView(
+      context->GetResourceAllocator()->CreateBuffer({
+          .storage_mode = StorageMode::kHostVisible,
+          .size = 10 * 20 * 4,
+      }));
+
+  EXPECT_TRUE(blit_pass->AddCopy(src, dst, IRect::MakeXYWH(50, 50, 10, 20)));
+  // The region must be within the destination.
+  EXPECT_FALSE(blit_pass->AddCopy(src, dst, IRect::MakeXYWH(95, 50, 10, 20)));
+  // The source must hold exactly enough bytes for the region.
+  EXPECT_FALSE(blit_pass->AddCopy(src, dst, IRect::MakeXYWH(50, 50, 20, 20)));
+  EXPECT_FALSE(blit_pass->AddCopy(src, dst));
+}
+
 }  // namespace testing
 }  // namespace impeller
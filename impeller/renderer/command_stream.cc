@@ -0,0 +1,201 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/command_stream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "impeller/base/validation.h"
+#include "impeller/renderer/vertex_descriptor.h"
+
+namespace impeller {
+
+CommandStream::CommandStream() = default;
+
+CommandStream::~CommandStream() = default;
+
+void CommandStream::Reserve(size_t command_count) {
+  commands_.reserve(command_count);
+  // Most draws bind a uniform buffer to each stage and sample at most one
+  // texture.
+  buffers_.reserve(command_count * 2u);
+  textures_.reserve(command_count);
+}
+
+std::string_view CommandStream::GetLabel(const EncodedCommand& command) const {
+#ifdef IMPELLER_DEBUG
+  return std::string_view(labels_).substr(command.label.offset,
+                                          command.label.length);
+#else
+  return {};
+#endif  // IMPELLER_DEBUG
+}
+
+void CommandStream::SetPipeline(
+    const std::shared_ptr<Pipeline<PipelineDescriptor>>& pipeline) {
+  pending_.pipeline = pipeline.get();
+  if (!pipeline) {
+    return;
+  }
+  // A pass only uses a handful of distinct pipelines, so a linear search is
+  // cheaper than keeping a set.
+  auto found = std::find(pipelines_.rbegin(), pipelines_.rend(), pipeline);
+  if (found == pipelines_.rend()) {
+    pipelines_.push_back(pipeline);
+  }
+}
+
+void CommandStream::SetLabel(std::string_view label) {
+#ifdef IMPELLER_DEBUG
+  labels_.resize(pending_label_start_);
+  // Runs of commands are often labelled alike, in which case the label of the
+  // previous command is shared instead of copied.
+  if (!commands_.empty() && GetLabel(commands_.back()) == label) {
+    pending_.label = commands_.back().label;
+    return;
+  }
+  labels_.append(label);
+  pending_.label = Range(pending_label_start_, label.size());
+#endif  // IMPELLER_DEBUG
+}
+
+bool CommandStream::BindBuffer(ShaderStage stage,
+                               const ShaderUniformSlot& slot,
+                               const ShaderMetadata* metadata,
+                               BufferView view) {
+  return DoBindBuffer(stage, slot, metadata, std::move(view));
+}
+
+bool CommandStream::BindBuffer(ShaderStage stage,
+                               const ShaderUniformSlot& slot,
+                               std::shared_ptr<const ShaderMetadata> metadata,
+                               BufferView view) {
+  return DoBindBuffer(stage, slot, std::move(metadata), std::move(view));
+}
+
+template <class T>
+bool CommandStream::DoBindBuffer(ShaderStage stage,
+                                 const ShaderUniformSlot& slot,
+                                 T metadata,
+                                 BufferView view) {
+  FML_DCHECK(slot.ext_res_0 != VertexDescriptor::kReservedVertexBufferIndex);
+  if (!view) {
+    return false;
+  }
+
+  switch (stage) {
+    case ShaderStage::kVertex:
+    case ShaderStage::kFragment:
+      buffers_.emplace_back(StageBufferBinding{
+          .stage = stage,
+          .binding = {.slot = slot,
+                      .view = BufferResource(metadata, std::move(view))},
+      });
+      pending_.buffers.length++;
+      return true;
+    case ShaderStage::kCompute:
+      VALIDATION_LOG << "Use ComputeCommands for compute shader stages.";
+    case ShaderStage::kUnknown:
+      return false;
+  }
+
+  return false;
+}
+
+bool CommandStream::BindTexture(ShaderStage stage,
+                                const SampledImageSlot& slot,
+                                const ShaderMetadata* metadata,
+                                std::shared_ptr<const Texture> texture,
+                                std::shared_ptr<const Sampler> sampler) {
+  if (!sampler || !sampler->IsValid()) {
+    return false;
+  }
+  if (!texture || !texture->IsValid()) {
+    return false;
+  }
+
+  switch (stage) {
+    case ShaderStage::kVertex:
+    case ShaderStage::kFragment:
+      textures_.emplace_back(StageTextureBinding{
+          .stage = stage,
+          .binding =
+              {
+                  .slot = slot,
+                  .texture = {metadata, std::move(texture)},
+                  .sampler = std::move(sampler),
+              },
+      });
+      pending_.textures.length++;
+      return true;
+    case ShaderStage::kCompute:
+      VALIDATION_LOG << "Use ComputeCommands for compute shader stages.";
+    case ShaderStage::kUnknown:
+      return false;
+  }
+
+  return false;
+}
+
+void CommandStream::CommitPending() {
+  commands_.emplace_back(std::move(pending_));
+  ResetPending();
+}
+
+void CommandStream::DiscardPending() {
+  buffers_.erase(buffers_.begin() + pending_.buffers.offset, buffers_.end());
+  textures_.erase(textures_.begin() + pending_.textures.offset,
+                  textures_.end());
+#ifdef IMPELLER_DEBUG
+  labels_.resize(pending_label_start_);
+#endif  // IMPELLER_DEBUG
+  ResetPending();
+}
+
+void CommandStream::ResetPending() {
+  pending_ = EncodedCommand{};
+  pending_.buffers.offset = buffers_.size();
+  pending_.textures.offset = textures_.size();
+#ifdef IMPELLER_DEBUG
+  pending_label_start_ = labels_.size();
+  pending_.label.offset = pending_label_start_;
+#endif  // IMPELLER_DEBUG
+}
+
+Command CommandStream::ToCommand(const EncodedCommand& command) const {
+  Command result;
+  for (const auto& pipeline : pipelines_) {
+    if (pipeline.get() == command.pipeline) {
+      result.pipeline = pipeline;
+      break;
+    }
+  }
+  for (size_t i = 0; i < command.buffers.length; i++) {
+    const auto& buffer = buffers_[command.buffers.offset + i];
+    auto& bindings = buffer.stage == ShaderStage::kVertex
+                         ? result.vertex_bindings
+                         : result.fragment_bindings;
+    bindings.buffers.push_back(buffer.binding);
+  }
+  for (size_t i = 0; i < command.textures.length; i++) {
+    const auto& texture = textures_[command.textures.offset + i];
+    auto& bindings = texture.stage == ShaderStage::kVertex
+                         ? result.vertex_bindings
+                         : result.fragment_bindings;
+    bindings.sampled_images.push_back(texture.binding);
+  }
+#ifdef IMPELLER_DEBUG
+  result.label = std::string(GetLabel(command));
+#endif  // IMPELLER_DEBUG
+  result.stencil_reference = command.stencil_reference;
+  result.base_vertex = command.base_vertex;
+  result.viewport = command.viewport;
+  result.scissor = command.scissor;
+  result.instance_count = command.instance_count;
+  result.vertex_buffer = command.vertex_buffer;
+  return result;
+}
+
+}  // namespace impeller
@@ -0,0 +1,168 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_RENDERER_COMMAND_STREAM_H_
+#define FLUTTER_IMPELLER_RENDERER_COMMAND_STREAM_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "impeller/core/formats.h"
+#include "impeller/core/range.h"
+#include "impeller/core/shader_types.h"
+#include "impeller/core/vertex_buffer.h"
+#include "impeller/geometry/rect.h"
+#include "impeller/renderer/command.h"
+#include "impeller/renderer/pipeline.h"
+
+namespace impeller {
+
+/// @brief A uniform buffer bound to one stage of a recorded command.
+struct StageBufferBinding {
+  ShaderStage stage = ShaderStage::kUnknown;
+  BufferAndUniformSlot binding;
+};
+
+/// @brief A texture and sampler bound to one stage of a recorded command.
+struct StageTextureBinding {
+  ShaderStage stage = ShaderStage::kUnknown;
+  TextureAndSampler binding;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A draw recorded into a |CommandStream|.
+///
+///             Unlike a |Command|, an encoded command owns no heap
+///             allocations. Its bindings and label are ranges into arrays
+///             shared by every command of the stream, and its pipeline is
+///             kept alive by the stream.
+///
+struct EncodedCommand {
+  const Pipeline<PipelineDescriptor>* pipeline = nullptr;
+  /// The range of the stream's buffer bindings used by this command.
+  Range buffers;
+  /// The range of the stream's texture bindings used by this command.
+  Range textures;
+#ifdef IMPELLER_DEBUG
+  /// The range of the stream's label characters naming this command.
+  Range label;
+#endif  // IMPELLER_DEBUG
+  uint32_t stencil_reference = 0u;
+  uint64_t base_vertex = 0u;
+  std::optional<Viewport> viewport;
+  std::optional<IRect> scissor;
+  size_t instance_count = 1u;
+  VertexBuffer vertex_buffer;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A compact, append-only recording of the draws of a render pass.
+///
+///             Draws are built up in a pending command whose bindings are
+///             appended straight to the stream's binding arrays, then
+///             committed or discarded. Since those arrays only grow for the
+///             lifetime of a pass, recording a draw performs no heap
+///             allocation once they have reached their working size.
+///
+///             Backends that don't encode commands as they are recorded read
+///             the stream directly when the pass is encoded.
+///
+class CommandStream {
+ public:
+  CommandStream();
+
+  ~CommandStream();
+
+  /// @brief Reserves space for |command_count| commands and a typical number
+  ///        of bindings for each of them.
+  void Reserve(size_t command_count);
+
+  bool IsEmpty() const { return commands_.empty(); }
+
+  const std::vector<EncodedCommand>& GetCommands() const { return commands_; }
+
+  const std::vector<StageBufferBinding>& GetBuffers() const {
+    return buffers_;
+  }
+
+  const std::vector<StageTextureBinding>& GetTextures() const {
+    return textures_;
+  }
+
+  /// @brief Returns the debug label of |command|, which is always empty in
+  ///        builds without IMPELLER_DEBUG.
+  std::string_view GetLabel(const EncodedCommand& command) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The command that is being recorded. Its binding ranges are
+  ///             maintained by the stream and must not be modified.
+  ///
+  EncodedCommand& GetPendingCommand() { return pending_; }
+
+  void SetPipeline(
+      const std::shared_ptr<Pipeline<PipelineDescriptor>>& pipeline);
+
+  void SetLabel(std::string_view label);
+
+  bool BindBuffer(ShaderStage stage,
+                  const ShaderUniformSlot& slot,
+                  const ShaderMetadata* metadata,
+                  BufferView view);
+
+  bool BindBuffer(ShaderStage stage,
+                  const ShaderUniformSlot& slot,
+                  std::shared_ptr<const ShaderMetadata> metadata,
+                  BufferView view);
+
+  bool BindTexture(ShaderStage stage,
+                   const SampledImageSlot& slot,
+                   const ShaderMetadata* metadata,
+                   std::shared_ptr<const Texture> texture,
+                   std::shared_ptr<const Sampler> sampler);
+
+  /// @brief Appends the pending command to the stream and starts a new one.
+  void CommitPending();
+
+  /// @brief Drops the pending command along with its bindings.
+  void DiscardPending();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a standalone |Command| equivalent to |command|.
+  ///
+  /// @details    Visible for testing.
+  ///
+  Command ToCommand(const EncodedCommand& command) const;
+
+ private:
+  std::vector<EncodedCommand> commands_;
+  std::vector<StageBufferBinding> buffers_;
+  std::vector<StageTextureBinding> textures_;
+  // Each distinct pipeline is held once, however many commands use it.
+  std::vector<std::shared_ptr<Pipeline<PipelineDescriptor>>> pipelines_;
+#ifdef IMPELLER_DEBUG
+  std::string labels_;
+  size_t pending_label_start_ = 0u;
+#endif  // IMPELLER_DEBUG
+  EncodedCommand pending_;
+
+  template <class T>
+  bool DoBindBuffer(ShaderStage stage,
+                    const ShaderUniformSlot& slot,
+                    T metadata,
+                    BufferView view);
+
+  void ResetPending();
+
+  CommandStream(const CommandStream&) = delete;
+
+  CommandStream& operator=(const CommandStream&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_RENDERER_COMMAND_STREAM_H_
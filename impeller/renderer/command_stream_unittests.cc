@@ -0,0 +1,150 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "flutter/testing/testing.h"  // IWYU pragma: keep
+#include "gtest/gtest.h"
+#include "impeller/renderer/command_stream.h"
+#include "impeller/renderer/testing/mocks.h"
+
+namespace impeller {
+namespace testing {
+
+namespace {
+
+class FakePipeline : public Pipeline<PipelineDescriptor> {
+ public:
+  FakePipeline() : Pipeline({}, PipelineDescriptor{}) {}
+
+  bool IsValid() const override { return true; }
+};
+
+const ShaderMetadata kMetadata = {.name = "FrameInfo"};
+const ShaderUniformSlot kSlot = {.name = "FrameInfo", .ext_res_0 = 0u};
+
+BufferView MakeBufferView(size_t offset) {
+  auto buffer = std::make_shared<MockDeviceBuffer>(DeviceBufferDescriptor{});
+  return BufferView{.buffer = buffer, .range = Range(offset, 16u)};
+}
+
+VertexBuffer MakeVertexBuffer(size_t vertex_count) {
+  return VertexBuffer{
+      .vertex_buffer = MakeBufferView(0u),
+      .vertex_count = vertex_count,
+      .index_type = IndexType::kNone,
+  };
+}
+
+}  // namespace
+
+TEST(CommandStreamTest, DrawsAreRecordedIntoSharedBindingArrays) {
+  MockRenderPass pass(nullptr, RenderTarget{});
+  auto pipeline = std::make_shared<FakePipeline>();
+
+  for (size_t i = 0; i < 3; i++) {
+    pass.SetPipeline(pipeline);
+    pass.SetStencilReference(i);
+    ASSERT_TRUE(pass.SetVertexBuffer(MakeVertexBuffer(3u)));
+    ASSERT_TRUE(pass.BindResource(ShaderStage::kVertex,
+                                  DescriptorType::kUniformBuffer, kSlot,
+                                  kMetadata, MakeBufferView(i)));
+    ASSERT_TRUE(pass.BindResource(ShaderStage::kFragment,
+                                  DescriptorType::kUniformBuffer, kSlot,
+                                  kMetadata, MakeBufferView(i + 100u)));
+    ASSERT_TRUE(pass.Draw().ok());
+  }
+
+  const auto& commands = pass.GetCommands();
+  ASSERT_EQ(commands.size(), 3u);
+  for (size_t i = 0; i < commands.size(); i++) {
+    EXPECT_EQ(commands[i].pipeline, pipeline);
+    EXPECT_EQ(commands[i].stencil_reference, i);
+    ASSERT_EQ(commands[i].vertex_bindings.buffers.size(), 1u);
+    EXPECT_EQ(commands[i].vertex_bindings.buffers[0].view.resource.range.offset,
+              i);
+    ASSERT_EQ(commands[i].fragment_bindings.buffers.size(), 1u);
+    EXPECT_EQ(
+        commands[i].fragment_bindings.buffers[0].view.resource.range.offset,
+        i + 100u);
+  }
+}
+
+TEST(CommandStreamTest, RejectedDrawsDoNotLeaveBindingsBehind) {
+  CommandStream stream;
+  auto pipeline = std::make_shared<FakePipeline>();
+
+  stream.SetPipeline(pipeline);
+  ASSERT_TRUE(stream.BindBuffer(ShaderStage::kVertex, kSlot, &kMetadata,
+                                MakeBufferView(0u)));
+  stream.CommitPending();
+
+  ASSERT_TRUE(stream.BindBuffer(ShaderStage::kVertex, kSlot, &kMetadata,
+                                MakeBufferView(1u)));
+  ASSERT_TRUE(stream.BindBuffer(ShaderStage::kFragment, kSlot, &kMetadata,
+                                MakeBufferView(2u)));
+  stream.DiscardPending();
+  EXPECT_EQ(stream.GetBuffers().size(), 1u);
+
+  stream.SetPipeline(pipeline);
+  ASSERT_TRUE(stream.BindBuffer(ShaderStage::kFragment, kSlot, &kMetadata,
+                                MakeBufferView(3u)));
+  stream.CommitPending();
+
+  const auto& commands = stream.GetCommands();
+  ASSERT_EQ(commands.size(), 2u);
+  EXPECT_EQ(commands[1].buffers, Range(1u, 1u));
+  EXPECT_EQ(stream.GetBuffers()[1].stage, ShaderStage::kFragment);
+  EXPECT_EQ(stream.GetBuffers()[1].binding.view.resource.range.offset, 3u);
+}
+
+TEST(CommandStreamTest, EmptyDrawsAreNotRecorded) {
+  MockRenderPass pass(nullptr, RenderTarget{});
+  auto pipeline = std::make_shared<FakePipeline>();
+
+  pass.SetPipeline(pipeline);
+  ASSERT_TRUE(pass.SetVertexBuffer(MakeVertexBuffer(0u)));
+  ASSERT_TRUE(pass.BindResource(ShaderStage::kVertex,
+                                DescriptorType::kUniformBuffer, kSlot,
+                                kMetadata, MakeBufferView(0u)));
+  EXPECT_TRUE(pass.Draw().ok());
+
+  // Invalid without a pipeline.
+  ASSERT_TRUE(pass.SetVertexBuffer(MakeVertexBuffer(3u)));
+  EXPECT_FALSE(pass.Draw().ok());
+
+  EXPECT_TRUE(pass.GetCommands().empty());
+}
+
+TEST(CommandStreamTest, PipelinesAreHeldOnce) {
+  CommandStream stream;
+  auto pipeline = std::make_shared<FakePipeline>();
+  for (size_t i = 0; i < 10; i++) {
+    stream.SetPipeline(pipeline);
+    stream.CommitPending();
+  }
+  // The test and the stream.
+  EXPECT_EQ(pipeline.use_count(), 2);
+}
+
+#ifdef IMPELLER_DEBUG
+TEST(CommandStreamTest, RepeatedLabelsShareStorage) {
+  CommandStream stream;
+  stream.SetLabel("Solid Fill");
+  stream.CommitPending();
+  stream.SetLabel("Solid Fill");
+  stream.CommitPending();
+  stream.SetLabel("Text Frame");
+  stream.CommitPending();
+
+  const auto& commands = stream.GetCommands();
+  ASSERT_EQ(commands.size(), 3u);
+  EXPECT_EQ(commands[0].label, commands[1].label);
+  EXPECT_EQ(stream.GetLabel(commands[1]), "Solid Fill");
+  EXPECT_EQ(stream.GetLabel(commands[2]), "Text Frame");
+}
+#endif  // IMPELLER_DEBUG
+
+}  // namespace testing
+}  // namespace impeller
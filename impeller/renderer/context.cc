@@ -16,4 +16,9 @@ bool Context::UpdateOffscreenLayerPixelFormat(PixelFormat format) {
   return false;
 }
 
+const std::shared_ptr<fml::ConcurrentTaskRunner>
+Context::GetConcurrentWorkerTaskRunner() const {
+  return nullptr;
+}
+
 }  // namespace impeller
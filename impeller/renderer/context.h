@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "impeller/core/allocator.h"
 #include "impeller/core/capture.h"
 #include "impeller/core/formats.h"
@@ -163,6 +164,19 @@ class Context {
   ///
   virtual std::shared_ptr<CommandBuffer> CreateCommandBuffer() const = 0;
 
+  //----------------------------------------------------------------------------
+  /// @brief      A task runner for the worker threads owned by this context, if
+  ///             the backend has any.
+  ///
+  ///             Renderers may use these workers to move CPU side work, such
+  ///             as tessellation, off of the raster thread.
+  ///
+  /// @return     The worker task runner, or nullptr if this context has no
+  ///             worker threads.
+  ///
+  virtual const std::shared_ptr<fml::ConcurrentTaskRunner>
+  GetConcurrentWorkerTaskRunner() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Force all pending asynchronous work to finish. This is
   ///             achieved by deleting all owned concurrent message loops.
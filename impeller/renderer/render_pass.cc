@@ -50,8 +50,9 @@ void RenderPass::SetLabel(std::string label) {
   OnSetLabel(std::move(label));
 }
 
-bool RenderPass::AddCommand(Command&& command) {
-  if (!command.IsValid()) {
+bool RenderPass::AddPendingCommand() {
+  const auto& command = command_stream_.GetPendingCommand();
+  if (!command.pipeline || !command.pipeline->IsValid()) {
     VALIDATION_LOG << "Attempted to add an invalid command to the render pass.";
     return false;
   }
@@ -69,10 +70,11 @@ bool RenderPass::AddCommand(Command&& command) {
       command.instance_count == 0u) {
     // Essentially a no-op. Don't record the command but this is not necessary
     // an error either.
+    command_stream_.DiscardPending();
     return true;
   }
 
-  commands_.emplace_back(std::move(command));
+  command_stream_.CommitPending();
   return true;
 }
 
@@ -84,47 +86,59 @@ const std::shared_ptr<const Context>& RenderPass::GetContext() const {
   return context_;
 }
 
+const std::vector<Command>& RenderPass::GetCommands() const {
+  const auto& encoded = command_stream_.GetCommands();
+  // Commands are only ever appended to the stream, so only the ones recorded
+  // since the last call need to be created.
+  for (size_t i = commands_.size(); i < encoded.size(); i++) {
+    commands_.push_back(command_stream_.ToCommand(encoded[i]));
+  }
+  return commands_;
+}
+
 void RenderPass::SetPipeline(
     const std::shared_ptr<Pipeline<PipelineDescriptor>>& pipeline) {
-  pending_.pipeline = pipeline;
+  command_stream_.SetPipeline(pipeline);
 }
 
 void RenderPass::SetCommandLabel(std::string_view label) {
-#ifdef IMPELLER_DEBUG
-  pending_.label = std::string(label);
-#endif  // IMPELLER_DEBUG
+  command_stream_.SetLabel(label);
 }
 
 void RenderPass::SetStencilReference(uint32_t value) {
-  pending_.stencil_reference = value;
+  command_stream_.GetPendingCommand().stencil_reference = value;
 }
 
 void RenderPass::SetBaseVertex(uint64_t value) {
-  pending_.base_vertex = value;
+  command_stream_.GetPendingCommand().base_vertex = value;
 }
 
 void RenderPass::SetViewport(Viewport viewport) {
-  pending_.viewport = viewport;
+  command_stream_.GetPendingCommand().viewport = viewport;
 }
 
 void RenderPass::SetScissor(IRect scissor) {
-  pending_.scissor = scissor;
+  command_stream_.GetPendingCommand().scissor = scissor;
 }
 
 void RenderPass::SetInstanceCount(size_t count) {
-  pending_.instance_count = count;
+  command_stream_.GetPendingCommand().instance_count = count;
 }
 
 bool RenderPass::SetVertexBuffer(VertexBuffer buffer) {
-  return pending_.BindVertices(std::move(buffer));
+  if (buffer.index_type == IndexType::kUnknown) {
+    VALIDATION_LOG << "Cannot bind vertex buffer with an unknown index type.";
+    return false;
+  }
+  command_stream_.GetPendingCommand().vertex_buffer = std::move(buffer);
+  return true;
 }
 
 fml::Status RenderPass::Draw() {
-  auto result = AddCommand(std::move(pending_));
-  pending_ = Command{};
-  if (result) {
+  if (AddPendingCommand()) {
     return fml::Status();
   }
+  command_stream_.DiscardPending();
   return fml::Status(fml::StatusCode::kInvalidArgument,
                      "Failed to encode command");
 }
@@ -135,7 +149,7 @@ bool RenderPass::BindResource(ShaderStage stage,
                               const ShaderUniformSlot& slot,
                               const ShaderMetadata& metadata,
                               BufferView view) {
-  return pending_.BindResource(stage, type, slot, metadata, view);
+  return command_stream_.BindBuffer(stage, slot, &metadata, std::move(view));
 }
 
 bool RenderPass::BindResource(
@@ -144,7 +158,7 @@ bool RenderPass::BindResource(
     const ShaderUniformSlot& slot,
     const std::shared_ptr<const ShaderMetadata>& metadata,
     BufferView view) {
-  return pending_.BindResource(stage, type, slot, metadata, std::move(view));
+  return command_stream_.BindBuffer(stage, slot, metadata, std::move(view));
 }
 
 // |ResourceBinder|
@@ -154,8 +168,8 @@ bool RenderPass::BindResource(ShaderStage stage,
                               const ShaderMetadata& metadata,
                               std::shared_ptr<const Texture> texture,
                               std::shared_ptr<const Sampler> sampler) {
-  return pending_.BindResource(stage, type, slot, metadata, std::move(texture),
-                               std::move(sampler));
+  return command_stream_.BindTexture(stage, slot, &metadata, std::move(texture),
+                                     std::move(sampler));
 }
 
 }  // namespace impeller
@@ -14,6 +14,7 @@
 #include "impeller/core/vertex_buffer.h"
 #include "impeller/renderer/command.h"
 #include "impeller/renderer/command_buffer.h"
+#include "impeller/renderer/command_stream.h"
 #include "impeller/renderer/render_target.h"
 
 namespace impeller {
@@ -50,7 +51,7 @@ class RenderPass : public ResourceBinder {
   ///
   /// Note: this is not the native command buffer.
   virtual void ReserveCommands(size_t command_count) {
-    commands_.reserve(command_count);
+    command_stream_.Reserve(command_count);
   }
 
   //----------------------------------------------------------------------------
@@ -141,11 +142,12 @@ class RenderPass : public ResourceBinder {
   bool EncodeCommands() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Accessor for the current Commands.
+  /// @brief      Accessor for the current Commands, which are created from the
+  ///             recorded command stream on demand.
   ///
   /// @details    Visible for testing.
   ///
-  virtual const std::vector<Command>& GetCommands() const { return commands_; }
+  virtual const std::vector<Command>& GetCommands() const;
 
   //----------------------------------------------------------------------------
   /// @brief      The sample count of the attached render target.
@@ -171,19 +173,17 @@ class RenderPass : public ResourceBinder {
   const bool has_stencil_attachment_;
   const ISize render_target_size_;
   const RenderTarget render_target_;
-  std::vector<Command> commands_;
+  CommandStream command_stream_;
   const Matrix orthographic_;
 
   //----------------------------------------------------------------------------
-  /// @brief      Record a command for subsequent encoding to the underlying
-  ///             command buffer. No work is encoded into the command buffer at
-  ///             this time.
-  ///
-  /// @param[in]  command  The command
+  /// @brief      Record the pending command of the command stream for
+  ///             subsequent encoding to the underlying command buffer. No work
+  ///             is encoded into the command buffer at this time.
   ///
   /// @return     If the command was valid for subsequent commitment.
   ///
-  bool AddCommand(Command&& command);
+  bool AddPendingCommand();
 
   RenderPass(std::shared_ptr<const Context> context,
              const RenderTarget& target);
@@ -197,7 +197,8 @@ class RenderPass : public ResourceBinder {
 
   RenderPass& operator=(const RenderPass&) = delete;
 
-  Command pending_;
+  // The commands of |command_stream_| as returned by |GetCommands|.
+  mutable std::vector<Command> commands_;
 };
 
 }  // namespace impeller
@@ -0,0 +1,218 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/tessellator/path_cache.h"
+
+#include <cmath>
+#include <limits>
+
+namespace impeller {
+
+// Scales are bucketed in quarter octaves, so a cached polyline has at most
+// ~19% more points than one flattened at the exact requested scale.
+static constexpr Scalar kScaleBucketsPerOctave = 4.0f;
+
+// Used for a scale of zero, at which curves are flattened to straight lines.
+static constexpr int32_t kZeroScaleBucket =
+    std::numeric_limits<int32_t>::min();
+
+static int32_t GetScaleBucket(Scalar scale) {
+  if (scale <= 0) {
+    return kZeroScaleBucket;
+  }
+  return static_cast<int32_t>(
+      std::ceil(std::log2(scale) * kScaleBucketsPerOctave));
+}
+
+static Scalar GetScaleForBucket(int32_t bucket) {
+  if (bucket == kZeroScaleBucket) {
+    return 0;
+  }
+  return std::exp2(bucket / kScaleBucketsPerOctave);
+}
+
+static size_t EstimateBytes(const Path::Polyline& polyline) {
+  size_t bytes = sizeof(Path::Polyline) + sizeof(std::vector<Point>) +
+                 polyline.points->size() * sizeof(Point);
+  for (const auto& contour : polyline.contours) {
+    bytes += sizeof(Path::PolylineContour) +
+             contour.components.size() *
+                 sizeof(Path::PolylineContour::Component);
+  }
+  return bytes;
+}
+
+static size_t EstimateBytes(const PathCache::FillVertices& fill) {
+  return sizeof(PathCache::FillVertices) +
+         fill.vertices.size() * sizeof(float) +
+         fill.indices.size() * sizeof(uint16_t);
+}
+
+static size_t EstimateBytes(const std::vector<Point>& fill) {
+  return sizeof(std::vector<Point>) + fill.size() * sizeof(Point);
+}
+
+PathCache::PathCache(size_t byte_budget) : byte_budget_(byte_budget) {}
+
+PathCache::~PathCache() = default;
+
+bool PathCache::CanCache(const Path& path, Scalar scale) {
+  // Scales that are too large to bucket are not worth caching as the paths
+  // are unlikely to be drawn at the same scale again.
+  return path.GetCacheKey() != 0 && std::isfinite(scale) && scale >= 0 &&
+         scale < (1 << 20);
+}
+
+Scalar PathCache::GetBucketScale(Scalar scale) {
+  return GetScaleForBucket(GetScaleBucket(scale));
+}
+
+PathCache::Key PathCache::MakeKey(const Path& path,
+                                  Scalar scale,
+                                  EntryType type) {
+  FML_DCHECK(CanCache(path, scale));
+  return Key{
+      .path_key = path.GetCacheKey(),
+      .scale_bucket = GetScaleBucket(scale),
+      .type = type,
+      .fill_type = type == EntryType::kFill ? path.GetFillType()
+                                            : FillType::kNonZero,
+  };
+}
+
+std::shared_ptr<const Path::Polyline> PathCache::GetPolyline(const Path& path,
+                                                             Scalar scale) {
+  auto key = MakeKey(path, scale, EntryType::kPolyline);
+  if (auto entry = Find(key)) {
+    stats_.polyline_hits++;
+    return entry->polyline;
+  }
+  stats_.polyline_misses++;
+
+  auto polyline = std::make_shared<Path::Polyline>(
+      path.CreatePolyline(GetScaleForBucket(key.scale_bucket)));
+  Store(Entry{
+      .key = key,
+      .bytes = EstimateBytes(*polyline),
+      .polyline = polyline,
+  });
+  return polyline;
+}
+
+std::shared_ptr<const PathCache::FillVertices> PathCache::FindFill(
+    const Path& path,
+    Scalar scale) {
+  if (auto entry = Find(MakeKey(path, scale, EntryType::kFill))) {
+    stats_.fill_hits++;
+    return entry->fill;
+  }
+  stats_.fill_misses++;
+  return nullptr;
+}
+
+void PathCache::StoreFill(const Path& path,
+                          Scalar scale,
+                          std::shared_ptr<const FillVertices> fill) {
+  FML_DCHECK(fill);
+  auto bytes = EstimateBytes(*fill);
+  Store(Entry{
+      .key = MakeKey(path, scale, EntryType::kFill),
+      .bytes = bytes,
+      .fill = std::move(fill),
+  });
+}
+
+std::shared_ptr<const std::vector<Point>> PathCache::FindConvexFill(
+    const Path& path,
+    Scalar scale) {
+  if (auto entry = Find(MakeKey(path, scale, EntryType::kConvexFill))) {
+    stats_.fill_hits++;
+    return entry->convex_fill;
+  }
+  stats_.fill_misses++;
+  return nullptr;
+}
+
+void PathCache::StoreConvexFill(
+    const Path& path,
+    Scalar scale,
+    std::shared_ptr<const std::vector<Point>> fill) {
+  FML_DCHECK(fill);
+  auto bytes = EstimateBytes(*fill);
+  Store(Entry{
+      .key = MakeKey(path, scale, EntryType::kConvexFill),
+      .bytes = bytes,
+      .convex_fill = std::move(fill),
+  });
+}
+
+const PathCache::Entry* PathCache::Find(const Key& key) {
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    return nullptr;
+  }
+  // Move the entry to the front of the list, which does not invalidate any of
+  // the iterators in the index.
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return &entries_.front();
+}
+
+void PathCache::Store(Entry entry) {
+  if (entry.bytes > byte_budget_) {
+    return;
+  }
+  auto found = index_.find(entry.key);
+  if (found != index_.end()) {
+    bytes_ -= found->second->bytes;
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+  bytes_ += entry.bytes;
+  entries_.push_front(std::move(entry));
+  index_[entries_.front().key] = entries_.begin();
+  EvictToBudget();
+}
+
+void PathCache::EvictToBudget() {
+  while (bytes_ > byte_budget_ && !entries_.empty()) {
+    const auto& entry = entries_.back();
+    bytes_ -= entry.bytes;
+    index_.erase(entry.key);
+    entries_.pop_back();
+    stats_.evictions++;
+  }
+}
+
+void PathCache::SetByteBudget(size_t byte_budget) {
+  byte_budget_ = byte_budget;
+  EvictToBudget();
+}
+
+size_t PathCache::GetByteBudget() const {
+  return byte_budget_;
+}
+
+size_t PathCache::GetByteSize() const {
+  return bytes_;
+}
+
+size_t PathCache::GetEntryCount() const {
+  return entries_.size();
+}
+
+const PathCache::Stats& PathCache::GetStats() const {
+  return stats_;
+}
+
+void PathCache::ResetStats() {
+  stats_ = {};
+}
+
+void PathCache::Clear() {
+  entries_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
+
+}  // namespace impeller
@@ -0,0 +1,166 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_TESSELLATOR_PATH_CACHE_H_
+#define FLUTTER_IMPELLER_TESSELLATOR_PATH_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/path.h"
+#include "impeller/geometry/point.h"
+#include "impeller/geometry/scalar.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A least recently used cache of the flattened and tessellated
+///             forms of paths that have a cache key.
+///
+///             Entries are keyed on the path's cache key and a bucket of the
+///             scale the path is rendered at. Paths are flattened at the
+///             largest scale of their bucket, so that a cached polyline is
+///             never coarser than one created for the requested scale.
+///
+///             This object is not thread safe.
+///
+/// @see        |Path::GetCacheKey|
+///
+class PathCache {
+ public:
+  /// The vertices of a filled path in the form delivered to a
+  /// |Tessellator::BuilderCallback|.
+  struct FillVertices {
+    std::vector<float> vertices;
+    size_t vertex_count = 0;
+    std::vector<uint16_t> indices;
+  };
+
+  struct Stats {
+    size_t polyline_hits = 0;
+    size_t polyline_misses = 0;
+    size_t fill_hits = 0;
+    size_t fill_misses = 0;
+    size_t evictions = 0;
+  };
+
+  static constexpr size_t kDefaultByteBudget = 4 * 1024 * 1024;
+
+  explicit PathCache(size_t byte_budget = kDefaultByteBudget);
+
+  ~PathCache();
+
+  /// Whether results for this path at this scale can be cached.
+  static bool CanCache(const Path& path, Scalar scale);
+
+  /// The scale that paths requested at the given scale are flattened at.
+  static Scalar GetBucketScale(Scalar scale);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the polyline of the path at the bucket of the given
+  ///             scale, creating and caching it if necessary.
+  ///
+  ///             The path must be cacheable, see |CanCache|.
+  ///
+  std::shared_ptr<const Path::Polyline> GetPolyline(const Path& path,
+                                                    Scalar scale);
+
+  std::shared_ptr<const FillVertices> FindFill(const Path& path, Scalar scale);
+
+  void StoreFill(const Path& path,
+                 Scalar scale,
+                 std::shared_ptr<const FillVertices> fill);
+
+  std::shared_ptr<const std::vector<Point>> FindConvexFill(const Path& path,
+                                                           Scalar scale);
+
+  void StoreConvexFill(const Path& path,
+                       Scalar scale,
+                       std::shared_ptr<const std::vector<Point>> fill);
+
+  void SetByteBudget(size_t byte_budget);
+
+  size_t GetByteBudget() const;
+
+  /// The estimated number of bytes retained by all cached entries.
+  size_t GetByteSize() const;
+
+  size_t GetEntryCount() const;
+
+  const Stats& GetStats() const;
+
+  void ResetStats();
+
+  void Clear();
+
+ private:
+  enum class EntryType : uint8_t {
+    kPolyline,
+    kFill,
+    kConvexFill,
+  };
+
+  struct Key {
+    uint64_t path_key;
+    int32_t scale_bucket;
+    EntryType type;
+    // Paths with the same cache key may differ in fill type, which only
+    // changes their fill tessellation.
+    FillType fill_type;
+
+    struct Hash {
+      std::size_t operator()(const Key& key) const {
+        return fml::HashCombine(key.path_key, key.scale_bucket,
+                                static_cast<uint8_t>(key.type),
+                                static_cast<int>(key.fill_type));
+      }
+    };
+
+    struct Equal {
+      bool operator()(const Key& lhs, const Key& rhs) const {
+        return lhs.path_key == rhs.path_key &&
+               lhs.scale_bucket == rhs.scale_bucket && lhs.type == rhs.type &&
+               lhs.fill_type == rhs.fill_type;
+      }
+    };
+  };
+
+  struct Entry {
+    Key key;
+    size_t bytes = 0;
+    std::shared_ptr<const Path::Polyline> polyline;
+    std::shared_ptr<const FillVertices> fill;
+    std::shared_ptr<const std::vector<Point>> convex_fill;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  size_t byte_budget_;
+  size_t bytes_ = 0;
+  Stats stats_;
+  // Most recently used entries are at the front.
+  EntryList entries_;
+  std::unordered_map<Key, EntryList::iterator, Key::Hash, Key::Equal> index_;
+
+  static Key MakeKey(const Path& path, Scalar scale, EntryType type);
+
+  const Entry* Find(const Key& key);
+
+  void Store(Entry entry);
+
+  void EvictToBudget();
+
+  PathCache(const PathCache&) = delete;
+
+  PathCache& operator=(const PathCache&) = delete;
+};
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_TESSELLATOR_PATH_CACHE_H_
@@ -0,0 +1,162 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/testing/testing.h"
+#include "gtest/gtest.h"
+
+#include "impeller/geometry/path.h"
+#include "impeller/geometry/path_builder.h"
+#include "impeller/tessellator/path_cache.h"
+#include "impeller/tessellator/tessellator.h"
+
+namespace impeller {
+namespace testing {
+
+static Path MakeCurvedPath(uint64_t cache_key) {
+  return PathBuilder{}
+      .SetCacheKey(cache_key)
+      .MoveTo({0, 0})
+      .CubicCurveTo({100, 0}, {100, 100}, {0, 100})
+      .QuadraticCurveTo({50, 50}, {0, 0})
+      .Close()
+      .TakePath();
+}
+
+TEST(PathCacheTest, OnlyPathsWithCacheKeysAreCacheable) {
+  EXPECT_FALSE(PathCache::CanCache(MakeCurvedPath(0), 1.0f));
+  EXPECT_TRUE(PathCache::CanCache(MakeCurvedPath(1), 1.0f));
+  EXPECT_TRUE(PathCache::CanCache(MakeCurvedPath(1), 0.0f));
+  EXPECT_FALSE(PathCache::CanCache(MakeCurvedPath(1), -1.0f));
+  EXPECT_FALSE(PathCache::CanCache(MakeCurvedPath(1), NAN));
+  EXPECT_FALSE(PathCache::CanCache(MakeCurvedPath(1), INFINITY));
+}
+
+TEST(PathCacheTest, BucketScaleIsNotSmallerThanScale) {
+  for (Scalar scale : {0.1f, 0.5f, 1.0f, 1.1f, 2.0f, 3.7f, 100.0f}) {
+    auto bucket_scale = PathCache::GetBucketScale(scale);
+    EXPECT_GE(bucket_scale, scale);
+    EXPECT_LT(bucket_scale, scale * 1.2f);
+  }
+  EXPECT_EQ(PathCache::GetBucketScale(0.0f), 0.0f);
+}
+
+TEST(PathCacheTest, PolylinesAreCachedPerScaleBucket) {
+  PathCache cache;
+  auto path = MakeCurvedPath(1);
+
+  auto polyline = cache.GetPolyline(path, 1.0f);
+  EXPECT_EQ(cache.GetStats().polyline_misses, 1u);
+  EXPECT_EQ(cache.GetStats().polyline_hits, 0u);
+
+  // Scales in the same bucket reuse the polyline.
+  EXPECT_EQ(cache.GetPolyline(path, 1.0f), polyline);
+  EXPECT_EQ(cache.GetPolyline(path, 0.95f), polyline);
+  EXPECT_EQ(cache.GetStats().polyline_hits, 2u);
+
+  // A larger scale needs a finer polyline.
+  auto large_polyline = cache.GetPolyline(path, 4.0f);
+  EXPECT_NE(large_polyline, polyline);
+  EXPECT_GT(large_polyline->points->size(), polyline->points->size());
+  EXPECT_EQ(cache.GetStats().polyline_misses, 2u);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+
+  // The cached polyline matches one created at the bucket scale.
+  auto expected = path.CreatePolyline(PathCache::GetBucketScale(1.0f));
+  ASSERT_EQ(expected.points->size(), polyline->points->size());
+  for (size_t i = 0; i < expected.points->size(); i++) {
+    EXPECT_EQ(expected.GetPoint(i), polyline->GetPoint(i));
+  }
+  EXPECT_EQ(expected.contours.size(), polyline->contours.size());
+}
+
+TEST(PathCacheTest, LeastRecentlyUsedEntriesAreEvicted) {
+  PathCache cache;
+  auto path_1 = MakeCurvedPath(1);
+  auto path_2 = MakeCurvedPath(2);
+  auto path_3 = MakeCurvedPath(3);
+
+  cache.GetPolyline(path_1, 1.0f);
+  auto entry_size = cache.GetByteSize();
+  ASSERT_GT(entry_size, 0u);
+  cache.SetByteBudget(entry_size * 2);
+
+  cache.GetPolyline(path_2, 1.0f);
+  // Use the first path so that the second path is the least recently used.
+  cache.GetPolyline(path_1, 1.0f);
+  cache.GetPolyline(path_3, 1.0f);
+  EXPECT_EQ(cache.GetEntryCount(), 2u);
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+  EXPECT_LE(cache.GetByteSize(), cache.GetByteBudget());
+
+  cache.ResetStats();
+  cache.GetPolyline(path_1, 1.0f);
+  cache.GetPolyline(path_3, 1.0f);
+  EXPECT_EQ(cache.GetStats().polyline_hits, 2u);
+  cache.GetPolyline(path_2, 1.0f);
+  EXPECT_EQ(cache.GetStats().polyline_misses, 1u);
+}
+
+TEST(PathCacheTest, EntriesLargerThanBudgetAreNotCached) {
+  PathCache cache(16);
+  auto polyline = cache.GetPolyline(MakeCurvedPath(1), 1.0f);
+  ASSERT_TRUE(polyline);
+  EXPECT_FALSE(polyline->points->empty());
+  EXPECT_EQ(cache.GetEntryCount(), 0u);
+  EXPECT_EQ(cache.GetByteSize(), 0u);
+}
+
+TEST(PathCacheTest, TessellatorCachesFills) {
+  Tessellator tessellator;
+  auto path = MakeCurvedPath(1);
+
+  std::vector<float> first_vertices;
+  std::vector<uint16_t> first_indices;
+  auto result = tessellator.Tessellate(
+      path, 1.0f,
+      [&](const float* vertices, size_t vertices_count, const uint16_t* indices,
+          size_t indices_count) {
+        first_vertices.assign(vertices, vertices + vertices_count * 2);
+        first_indices.assign(indices, indices + indices_count);
+        return true;
+      });
+  ASSERT_EQ(result, Tessellator::Result::kSuccess);
+  EXPECT_EQ(tessellator.GetPathCache().GetStats().fill_misses, 1u);
+
+  result = tessellator.Tessellate(
+      path, 1.0f,
+      [&](const float* vertices, size_t vertices_count, const uint16_t* indices,
+          size_t indices_count) {
+        EXPECT_EQ(std::vector<float>(vertices, vertices + vertices_count * 2),
+                  first_vertices);
+        EXPECT_EQ(std::vector<uint16_t>(indices, indices + indices_count),
+                  first_indices);
+        return true;
+      });
+  ASSERT_EQ(result, Tessellator::Result::kSuccess);
+  EXPECT_EQ(tessellator.GetPathCache().GetStats().fill_hits, 1u);
+
+  auto convex = tessellator.TessellateConvex(path, 1.0f);
+  EXPECT_EQ(tessellator.TessellateConvex(path, 1.0f), convex);
+  EXPECT_EQ(tessellator.GetPathCache().GetStats().fill_hits, 2u);
+  // Both fills share a single polyline.
+  EXPECT_EQ(tessellator.GetPathCache().GetStats().polyline_misses, 1u);
+}
+
+TEST(PathCacheTest, TessellatorDoesNotCachePathsWithoutKey) {
+  Tessellator tessellator;
+  auto path = MakeCurvedPath(0);
+
+  for (int i = 0; i < 2; i++) {
+    auto result = tessellator.Tessellate(
+        path, 1.0f,
+        [](const float* vertices, size_t vertices_count,
+           const uint16_t* indices, size_t indices_count) { return true; });
+    ASSERT_EQ(result, Tessellator::Result::kSuccess);
+  }
+  EXPECT_EQ(tessellator.GetPathCache().GetEntryCount(), 0u);
+  EXPECT_EQ(tessellator.GetPathCache().GetStats().fill_misses, 0u);
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -68,15 +68,45 @@ Tessellator::Result Tessellator::Tessellate(const Path& path,
     return Result::kInputError;
   }
 
-  point_buffer_->clear();
-  auto polyline =
-      path.CreatePolyline(tolerance, std::move(point_buffer_),
-                          [this](Path::Polyline::PointBufferPtr point_buffer) {
-                            point_buffer_ = std::move(point_buffer);
-                          });
+  if (!PathCache::CanCache(path, tolerance)) {
+    point_buffer_->clear();
+    auto polyline = path.CreatePolyline(
+        tolerance, std::move(point_buffer_),
+        [this](Path::Polyline::PointBufferPtr point_buffer) {
+          point_buffer_ = std::move(point_buffer);
+        });
+    return TessellatePolyline(polyline, path.GetFillType(), callback);
+  }
+
+  if (auto fill = path_cache_.FindFill(path, tolerance)) {
+    if (!callback(fill->vertices.data(), fill->vertex_count,
+                  fill->indices.empty() ? nullptr : fill->indices.data(),
+                  fill->indices.size())) {
+      return Result::kInputError;
+    }
+    return Result::kSuccess;
+  }
 
-  auto fill_type = path.GetFillType();
+  auto polyline = path_cache_.GetPolyline(path, tolerance);
+  return TessellatePolyline(
+      *polyline, path.GetFillType(),
+      [&](const float* vertices, size_t vertices_count, const uint16_t* indices,
+          size_t indices_count) {
+        auto fill = std::make_shared<PathCache::FillVertices>();
+        fill->vertices.assign(vertices, vertices + vertices_count * 2);
+        fill->vertex_count = vertices_count;
+        if (indices != nullptr) {
+          fill->indices.assign(indices, indices + indices_count);
+        }
+        path_cache_.StoreFill(path, tolerance, fill);
+        return callback(vertices, vertices_count, indices, indices_count);
+      });
+}
 
+Tessellator::Result Tessellator::TessellatePolyline(
+    const Path::Polyline& polyline,
+    FillType fill_type,
+    const BuilderCallback& callback) {
   if (polyline.points->empty()) {
     return Result::kInputError;
   }
@@ -172,15 +202,29 @@ Tessellator::Result Tessellator::Tessellate(const Path& path,
 
 std::vector<Point> Tessellator::TessellateConvex(const Path& path,
                                                  Scalar tolerance) {
-  std::vector<Point> output;
+  if (!PathCache::CanCache(path, tolerance)) {
+    point_buffer_->clear();
+    auto polyline = path.CreatePolyline(
+        tolerance, std::move(point_buffer_),
+        [this](Path::Polyline::PointBufferPtr point_buffer) {
+          point_buffer_ = std::move(point_buffer);
+        });
+    return TessellateConvexPolyline(polyline);
+  }
 
-  point_buffer_->clear();
-  auto polyline =
-      path.CreatePolyline(tolerance, std::move(point_buffer_),
-                          [this](Path::Polyline::PointBufferPtr point_buffer) {
-                            point_buffer_ = std::move(point_buffer);
-                          });
+  if (auto fill = path_cache_.FindConvexFill(path, tolerance)) {
+    return *fill;
+  }
+  auto polyline = path_cache_.GetPolyline(path, tolerance);
+  auto fill = std::make_shared<std::vector<Point>>(
+      TessellateConvexPolyline(*polyline));
+  path_cache_.StoreConvexFill(path, tolerance, fill);
+  return *fill;
+}
 
+std::vector<Point> Tessellator::TessellateConvexPolyline(
+    const Path::Polyline& polyline) {
+  std::vector<Point> output;
   output.reserve(polyline.points->size() +
                  (4 * (polyline.contours.size() - 1)));
   for (auto j = 0u; j < polyline.contours.size(); j++) {
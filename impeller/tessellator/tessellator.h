@@ -14,6 +14,7 @@
 #include "impeller/geometry/path.h"
 #include "impeller/geometry/point.h"
 #include "impeller/geometry/trig.h"
+#include "impeller/tessellator/path_cache.h"
 
 struct TESStesselator;
 
@@ -218,6 +219,13 @@ class Tessellator {
   ///
   std::vector<Point> TessellateConvex(const Path& path, Scalar tolerance);
 
+  //----------------------------------------------------------------------------
+  /// @brief      The cache of polylines and fills of paths that have a cache
+  ///             key, which is used by |Tessellate| and |TessellateConvex| to
+  ///             avoid flattening and tessellating static paths every frame.
+  ///
+  PathCache& GetPathCache() { return path_cache_; }
+
   /// @brief   The pixel tolerance used by the algorighm to determine how
   ///          many divisions to create for a circle.
   ///
@@ -298,6 +306,7 @@ class Tessellator {
   /// Used for polyline generation.
   std::unique_ptr<std::vector<Point>> point_buffer_;
   CTessellator c_tessellator_;
+  PathCache path_cache_;
 
   // Data for variouos Circle/EllipseGenerator classes, cached per
   // Tessellator instance which is usually the foreground life of an app
@@ -307,6 +316,13 @@ class Tessellator {
 
   Trigs GetTrigsForDivisions(size_t divisions);
 
+  Result TessellatePolyline(const Path::Polyline& polyline,
+                            FillType fill_type,
+                            const BuilderCallback& callback);
+
+  static std::vector<Point> TessellateConvexPolyline(
+      const Path::Polyline& polyline);
+
   static void GenerateFilledCircle(const Trigs& trigs,
                                    const EllipticalVertexGenerator::Data& data,
                                    const TessellatedVertexProc& proc);
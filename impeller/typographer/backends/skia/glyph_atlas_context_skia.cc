@@ -13,11 +13,25 @@ GlyphAtlasContextSkia::GlyphAtlasContextSkia() = default;
 GlyphAtlasContextSkia::~GlyphAtlasContextSkia() = default;
 
 std::shared_ptr<SkBitmap> GlyphAtlasContextSkia::GetBitmap() const {
-  return bitmap_;
+  return GetPageBitmap(0);
 }
 
 void GlyphAtlasContextSkia::UpdateBitmap(std::shared_ptr<SkBitmap> bitmap) {
-  bitmap_ = std::move(bitmap);
+  bitmaps_.clear();
+  bitmaps_.push_back(std::move(bitmap));
+}
+
+std::shared_ptr<SkBitmap> GlyphAtlasContextSkia::GetPageBitmap(
+    size_t page) const {
+  return page < bitmaps_.size() ? bitmaps_[page] : nullptr;
+}
+
+void GlyphAtlasContextSkia::UpdatePageBitmap(size_t page,
+                                             std::shared_ptr<SkBitmap> bitmap) {
+  if (page >= bitmaps_.size()) {
+    bitmaps_.resize(page + 1);
+  }
+  bitmaps_[page] = std::move(bitmap);
 }
 
 }  // namespace impeller
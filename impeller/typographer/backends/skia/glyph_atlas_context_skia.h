@@ -5,6 +5,8 @@
 #ifndef FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_GLYPH_ATLAS_CONTEXT_SKIA_H_
 #define FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_GLYPH_ATLAS_CONTEXT_SKIA_H_
 
+#include <vector>
+
 #include "impeller/base/backend_cast.h"
 #include "impeller/typographer/glyph_atlas.h"
 
@@ -24,13 +26,23 @@ class GlyphAtlasContextSkia
   ~GlyphAtlasContextSkia() override;
 
   //----------------------------------------------------------------------------
-  /// @brief      Retrieve the previous (if any) SkBitmap instance.
+  /// @brief      Retrieve the previous (if any) SkBitmap instance of the first
+  ///             page.
   std::shared_ptr<SkBitmap> GetBitmap() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the bitmaps of all pages with the bitmap of a single
+  ///             page.
   void UpdateBitmap(std::shared_ptr<SkBitmap> bitmap);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the previous (if any) SkBitmap instance of a page.
+  std::shared_ptr<SkBitmap> GetPageBitmap(size_t page) const;
+
+  void UpdatePageBitmap(size_t page, std::shared_ptr<SkBitmap> bitmap);
+
  private:
-  std::shared_ptr<SkBitmap> bitmap_;
+  std::vector<std::shared_ptr<SkBitmap>> bitmaps_;
 
   GlyphAtlasContextSkia(const GlyphAtlasContextSkia&) = delete;
 
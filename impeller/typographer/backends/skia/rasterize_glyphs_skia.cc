@@ -0,0 +1,169 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/typographer/backends/skia/rasterize_glyphs_skia.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "impeller/typographer/backends/skia/typeface_skia.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace impeller {
+
+namespace {
+
+// Glyphs are claimed by threads in batches, which keeps contention on the
+// shared index low without leaving one thread with most of the work.
+constexpr size_t kGlyphsPerClaim = 8u;
+
+// Worker tasks are only posted when each thread drawing glyphs, including the
+// calling thread, has at least this many glyphs to draw. Below this, the cost
+// of posting tasks and of each thread warming up its own glyph cache exceeds
+// the savings.
+constexpr size_t kMinGlyphsPerThread = 64u;
+
+constexpr size_t kMaxThreads = 4u;
+
+/// The state shared between the calling thread and the worker tasks. Worker
+/// tasks keep it alive, as they may start after the caller has returned.
+struct RasterizationState {
+  RasterizationState(std::shared_ptr<SkBitmap> p_bitmap,
+                     std::vector<GlyphToRasterize> p_glyphs,
+                     bool p_has_color,
+                     Scalar p_padding)
+      : bitmap(std::move(p_bitmap)),
+        glyphs(std::move(p_glyphs)),
+        has_color(p_has_color),
+        padding(p_padding),
+        remaining(glyphs.size()) {}
+
+  const std::shared_ptr<SkBitmap> bitmap;
+  const std::vector<GlyphToRasterize> glyphs;
+  const bool has_color;
+  const Scalar padding;
+  std::atomic<size_t> next_index = 0;
+  std::atomic<size_t> remaining;
+  std::atomic<bool> failed = false;
+  std::mutex mutex;
+  std::condition_variable done;
+};
+
+void DrawGlyph(SkCanvas* canvas,
+               const GlyphToRasterize& to_rasterize,
+               bool has_color,
+               Scalar padding) {
+  const ScaledFont& scaled_font = *to_rasterize.scaled_font;
+  const Glyph& glyph = *to_rasterize.glyph;
+  const Rect& location = to_rasterize.location;
+
+  const auto& metrics = scaled_font.font.GetMetrics();
+  const auto position = SkPoint::Make(location.GetX() / scaled_font.scale,
+                                      location.GetY() / scaled_font.scale);
+  SkGlyphID glyph_id = glyph.index;
+
+  SkFont sk_font(
+      TypefaceSkia::Cast(*scaled_font.font.GetTypeface()).GetSkiaTypeface(),
+      metrics.point_size, metrics.scaleX, metrics.skewX);
+  sk_font.setEdging(SkFont::Edging::kAntiAlias);
+  sk_font.setHinting(SkFontHinting::kSlight);
+  sk_font.setEmbolden(metrics.embolden);
+
+  auto glyph_color = has_color ? SK_ColorWHITE : SK_ColorBLACK;
+
+  SkPaint glyph_paint;
+  glyph_paint.setColor(glyph_color);
+  canvas->save();
+  canvas->resetMatrix();
+  canvas->clipRect(SkRect::MakeXYWH(location.GetX(), location.GetY(),
+                                    location.GetWidth() + padding,
+                                    location.GetHeight() + padding));
+  canvas->scale(scaled_font.scale, scaled_font.scale);
+  canvas->drawGlyphs(1u,         // count
+                     &glyph_id,  // glyphs
+                     &position,  // positions
+                     SkPoint::Make(-glyph.bounds.GetLeft(),
+                                   -glyph.bounds.GetTop()),  // origin
+                     sk_font,                                // font
+                     glyph_paint                             // paint
+  );
+  canvas->restore();
+}
+
+/// Draws batches of glyphs until there are none left to claim.
+void RasterizeClaimedGlyphs(RasterizationState& state) {
+  SkCanvas* canvas = nullptr;
+  sk_sp<SkSurface> surface;
+  while (true) {
+    size_t begin = state.next_index.fetch_add(kGlyphsPerClaim);
+    if (begin >= state.glyphs.size()) {
+      return;
+    }
+    size_t end = std::min(begin + kGlyphsPerClaim, state.glyphs.size());
+
+    // Each thread draws through its own surface wrapping the shared pixels.
+    if (!canvas && !state.failed) {
+      surface = SkSurfaces::WrapPixels(state.bitmap->pixmap());
+      canvas = surface ? surface->getCanvas() : nullptr;
+      if (!canvas) {
+        state.failed = true;
+      }
+    }
+    if (canvas) {
+      for (size_t i = begin; i < end; i++) {
+        DrawGlyph(canvas, state.glyphs[i], state.has_color, state.padding);
+      }
+    }
+
+    if (state.remaining.fetch_sub(end - begin) == end - begin) {
+      std::scoped_lock lock(state.mutex);
+      state.done.notify_all();
+    }
+  }
+}
+
+}  // namespace
+
+bool RasterizeGlyphsConcurrently(
+    const std::shared_ptr<SkBitmap>& bitmap,
+    std::vector<GlyphToRasterize> glyphs,
+    bool has_color,
+    Scalar padding,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  TRACE_EVENT1("impeller", "RasterizeGlyphsConcurrently", "count",
+               std::to_string(glyphs.size()).c_str());
+  FML_DCHECK(bitmap != nullptr);
+  if (glyphs.empty()) {
+    return true;
+  }
+
+  auto state = std::make_shared<RasterizationState>(bitmap, std::move(glyphs),
+                                                    has_color, padding);
+  if (worker_task_runner) {
+    // The calling thread takes on one share of the work itself.
+    size_t thread_count =
+        std::min(kMaxThreads, state->glyphs.size() / kMinGlyphsPerThread);
+    for (size_t i = 1; i < thread_count; i++) {
+      worker_task_runner->PostTask(
+          [state]() { RasterizeClaimedGlyphs(*state); });
+    }
+  }
+
+  RasterizeClaimedGlyphs(*state);
+
+  // Wait for the glyphs that workers are still drawing.
+  std::unique_lock lock(state->mutex);
+  state->done.wait(lock, [&state]() { return state->remaining == 0; });
+  return !state->failed;
+}
+
+}  // namespace impeller
@@ -0,0 +1,61 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_RASTERIZE_GLYPHS_SKIA_H_
+#define FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_RASTERIZE_GLYPHS_SKIA_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "impeller/geometry/rect.h"
+#include "impeller/typographer/font_glyph_pair.h"
+
+class SkBitmap;
+
+namespace impeller {
+
+/// A glyph and the location it is drawn at in a glyph atlas bitmap.
+struct GlyphToRasterize {
+  const ScaledFont* scaled_font = nullptr;
+  const Glyph* glyph = nullptr;
+  Rect location;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Draws each of the glyphs into the bitmap at its location,
+///             sharing the work between the calling thread and the worker
+///             task runner when there are enough glyphs to make it worthwhile.
+///
+///             Each glyph is clipped to its location extended by the padding
+///             to its right and bottom, which is the region the rectangle
+///             packer reserved for it. As these regions are disjoint, glyphs
+///             drawn on different threads never write to the same pixels, and
+///             the contents of the bitmap do not depend on how many threads
+///             drew it.
+///
+///             Returns once every glyph is drawn.
+///
+/// @param[in]  bitmap              The bitmap of the glyph atlas.
+/// @param[in]  glyphs              The glyphs to draw. The fonts and glyphs
+///                                 they point to must outlive the call.
+/// @param[in]  has_color           Whether the bitmap is a color bitmap.
+/// @param[in]  padding             The padding to the right and bottom of each
+///                                 glyph location that is reserved for it.
+/// @param[in]  worker_task_runner  The task runner for the worker threads.
+///                                 May be nullptr, in which case all glyphs
+///                                 are drawn on the calling thread.
+///
+/// @return     Whether the bitmap could be drawn into.
+///
+bool RasterizeGlyphsConcurrently(
+    const std::shared_ptr<SkBitmap>& bitmap,
+    std::vector<GlyphToRasterize> glyphs,
+    bool has_color,
+    Scalar padding,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner);
+
+}  // namespace impeller
+
+#endif  // FLUTTER_IMPELLER_TYPOGRAPHER_BACKENDS_SKIA_RASTERIZE_GLYPHS_SKIA_H_
@@ -4,21 +4,25 @@
 
 #include "impeller/typographer/backends/skia/typographer_context_skia.h"
 
+#include <algorithm>
+#include <cstring>
 #include <numeric>
+#include <optional>
 #include <utility>
 
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/allocation.h"
 #include "impeller/core/allocator.h"
+#include "impeller/renderer/blit_pass.h"
+#include "impeller/renderer/command_buffer.h"
+#include "impeller/renderer/context.h"
 #include "impeller/typographer/backends/skia/glyph_atlas_context_skia.h"
-#include "impeller/typographer/backends/skia/typeface_skia.h"
+#include "impeller/typographer/backends/skia/rasterize_glyphs_skia.h"
 #include "impeller/typographer/rectangle_packer.h"
 #include "impeller/typographer/typographer_context.h"
 #include "third_party/skia/include/core/SkBitmap.h"
-#include "third_party/skia/include/core/SkCanvas.h"
-#include "third_party/skia/include/core/SkFont.h"
-#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkColor.h"
 
 namespace impeller {
 
@@ -75,67 +79,80 @@ static size_t PairsFitInAtlasOfSize(
   return 0;
 }
 
-static bool CanAppendToExistingAtlas(
-    const std::shared_ptr<GlyphAtlas>& atlas,
-    const std::vector<FontGlyphPair>& extra_pairs,
-    std::vector<Rect>& glyph_positions,
-    ISize atlas_size,
-    const std::shared_ptr<RectanglePacker>& rect_packer) {
+/// Packs as many of the new font-glyph pairs as fit into the free space of the
+/// existing pages of the atlas, recording their positions and the region of
+/// each page that must be redrawn and uploaded.
+///
+/// @return     The font-glyph pairs that did not fit on any existing page.
+static std::vector<FontGlyphPair> AppendToExistingPages(
+    GlyphAtlas& atlas,
+    GlyphAtlasContext& atlas_context,
+    const std::vector<FontGlyphPair>& new_pairs,
+    std::vector<std::vector<FontGlyphPair>>& page_pairs,
+    std::vector<std::optional<IRect>>& dirty_regions) {
   TRACE_EVENT0("impeller", __FUNCTION__);
-  if (!rect_packer || atlas_size.IsEmpty()) {
-    return false;
-  }
-
-  // We assume that all existing glyphs will fit. After all, they fit before.
-  // The glyph_positions only contains the values for the additional glyphs
-  // from extra_pairs.
-  FML_DCHECK(glyph_positions.size() == 0);
-  glyph_positions.reserve(extra_pairs.size());
-  for (size_t i = 0; i < extra_pairs.size(); i++) {
-    const FontGlyphPair& pair = extra_pairs[i];
+  const size_t page_count = atlas_context.GetPageCount();
+  page_pairs.resize(page_count);
+  dirty_regions.resize(page_count);
 
+  std::vector<FontGlyphPair> remaining_pairs;
+  for (const FontGlyphPair& pair : new_pairs) {
     const auto glyph_size =
         ISize::Ceil(pair.glyph.bounds.GetSize() * pair.scaled_font.scale);
-    IPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width + kPadding,   //
-                              glyph_size.height + kPadding,  //
-                              &location_in_atlas             //
-                              )) {
-      return false;
+    bool added = false;
+    for (size_t page = 0; page < page_count && !added; page++) {
+      const auto& rect_packer = atlas_context.GetPageRectPacker(page);
+      IPoint16 location_in_atlas;
+      if (!rect_packer ||
+          !rect_packer->addRect(glyph_size.width + kPadding,   //
+                                glyph_size.height + kPadding,  //
+                                &location_in_atlas             //
+                                )) {
+        continue;
+      }
+      auto glyph_rect = Rect::MakeXYWH(location_in_atlas.x(),  //
+                                       location_in_atlas.y(),  //
+                                       glyph_size.width,       //
+                                       glyph_size.height       //
+      );
+      atlas.AddTypefaceGlyphPosition(pair, glyph_rect, page);
+      atlas_context.MarkPageUsed(page);
+      page_pairs[page].push_back(pair);
+
+      // Glyphs may be drawn slightly outside of their bounds, into the
+      // padding that separates them from their neighbors.
+      auto dirty_rect =
+          IRect::RoundOut(glyph_rect)
+              .Expand(kPadding)
+              .Intersection(IRect::MakeSize(atlas_context.GetPageSize(page)));
+      dirty_regions[page] = IRect::Union(dirty_regions[page], dirty_rect);
+      added = true;
+    }
+    if (!added) {
+      remaining_pairs.push_back(pair);
     }
-    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
-                                                location_in_atlas.y(),  //
-                                                glyph_size.width,       //
-                                                glyph_size.height       //
-                                                ));
   }
-
-  return true;
+  return remaining_pairs;
 }
 
 static ISize OptimumAtlasSizeForFontGlyphPairs(
     const std::vector<FontGlyphPair>& pairs,
     std::vector<Rect>& glyph_positions,
-    const std::shared_ptr<GlyphAtlasContext>& atlas_context,
-    GlyphAtlas::Type type,
+    std::shared_ptr<RectanglePacker>& rect_packer,
+    const ISize& min_size,
     const ISize& max_texture_size) {
-  static constexpr auto kMinAtlasSize = 8u;
-  static constexpr auto kMinAlphaBitmapSize = 1024u;
-
   TRACE_EVENT0("impeller", __FUNCTION__);
 
-  ISize current_size = type == GlyphAtlas::Type::kAlphaBitmap
-                           ? ISize(kMinAlphaBitmapSize, kMinAlphaBitmapSize)
-                           : ISize(kMinAtlasSize, kMinAtlasSize);
+  ISize current_size = min_size;
   size_t total_pairs = pairs.size() + 1;
   do {
-    auto rect_packer = std::shared_ptr<RectanglePacker>(
+    auto packer = std::shared_ptr<RectanglePacker>(
         RectanglePacker::Factory(current_size.width, current_size.height));
 
-    auto remaining_pairs = PairsFitInAtlasOfSize(pairs, current_size,
-                                                 glyph_positions, rect_packer);
+    auto remaining_pairs =
+        PairsFitInAtlasOfSize(pairs, current_size, glyph_positions, packer);
     if (remaining_pairs == 0) {
-      atlas_context->UpdateRectPacker(rect_packer);
+      rect_packer = std::move(packer);
       return current_size;
     } else if (remaining_pairs < std::ceil(total_pairs / 2)) {
       current_size = ISize::MakeWH(
@@ -152,73 +169,58 @@ static ISize OptimumAtlasSizeForFontGlyphPairs(
   return ISize{0, 0};
 }
 
-static void DrawGlyph(SkCanvas* canvas,
-                      const ScaledFont& scaled_font,
-                      const Glyph& glyph,
-                      const Rect& location,
-                      bool has_color) {
-  const auto& metrics = scaled_font.font.GetMetrics();
-  const auto position = SkPoint::Make(location.GetX() / scaled_font.scale,
-                                      location.GetY() / scaled_font.scale);
-  SkGlyphID glyph_id = glyph.index;
-
-  SkFont sk_font(
-      TypefaceSkia::Cast(*scaled_font.font.GetTypeface()).GetSkiaTypeface(),
-      metrics.point_size, metrics.scaleX, metrics.skewX);
-  sk_font.setEdging(SkFont::Edging::kAntiAlias);
-  sk_font.setHinting(SkFontHinting::kSlight);
-  sk_font.setEmbolden(metrics.embolden);
-
-  auto glyph_color = has_color ? SK_ColorWHITE : SK_ColorBLACK;
-
-  SkPaint glyph_paint;
-  glyph_paint.setColor(glyph_color);
-  canvas->resetMatrix();
-  canvas->scale(scaled_font.scale, scaled_font.scale);
-  canvas->drawGlyphs(1u,         // count
-                     &glyph_id,  // glyphs
-                     &position,  // positions
-                     SkPoint::Make(-glyph.bounds.GetLeft(),
-                                   -glyph.bounds.GetTop()),  // origin
-                     sk_font,                                // font
-                     glyph_paint                             // paint
-  );
-}
+static ISize MinimumAtlasSize(GlyphAtlas::Type type) {
+  static constexpr auto kMinAtlasSize = 8u;
+  static constexpr auto kMinAlphaBitmapSize = 1024u;
 
-static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
-                              const std::shared_ptr<SkBitmap>& bitmap,
-                              const std::vector<FontGlyphPair>& new_pairs) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
-  FML_DCHECK(bitmap != nullptr);
+  return type == GlyphAtlas::Type::kAlphaBitmap
+             ? ISize(kMinAlphaBitmapSize, kMinAlphaBitmapSize)
+             : ISize(kMinAtlasSize, kMinAtlasSize);
+}
 
-  auto surface = SkSurfaces::WrapPixels(bitmap->pixmap());
-  if (!surface) {
-    return false;
-  }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
-    return false;
+static PixelFormat AtlasPixelFormat(GlyphAtlas::Type type) {
+  switch (type) {
+    case GlyphAtlas::Type::kAlphaBitmap:
+      return PixelFormat::kA8UNormInt;
+    case GlyphAtlas::Type::kColorBitmap:
+      return PixelFormat::kR8G8B8A8UNormInt;
   }
+  FML_UNREACHABLE();
+}
 
-  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
+static bool UpdateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    const std::shared_ptr<SkBitmap>& bitmap,
+    const std::vector<FontGlyphPair>& new_pairs,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  FML_DCHECK(bitmap != nullptr);
 
+  std::vector<GlyphToRasterize> glyphs;
+  glyphs.reserve(new_pairs.size());
   for (const FontGlyphPair& pair : new_pairs) {
     auto pos = atlas.FindFontGlyphBounds(pair);
     if (!pos.has_value()) {
       continue;
     }
-    DrawGlyph(canvas, pair.scaled_font, pair.glyph, pos.value(), has_color);
+    glyphs.push_back({
+        .scaled_font = &pair.scaled_font,
+        .glyph = &pair.glyph,
+        .location = pos.value(),
+    });
   }
-  return true;
+
+  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
+  return RasterizeGlyphsConcurrently(bitmap, std::move(glyphs), has_color,
+                                     kPadding, worker_task_runner);
 }
 
-static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
-                                                   const ISize& atlas_size) {
-  TRACE_EVENT0("impeller", __FUNCTION__);
+static std::shared_ptr<SkBitmap> AllocateAtlasBitmap(GlyphAtlas::Type type,
+                                                     const ISize& atlas_size) {
   auto bitmap = std::make_shared<SkBitmap>();
   SkImageInfo image_info;
 
-  switch (atlas.GetType()) {
+  switch (type) {
     case GlyphAtlas::Type::kAlphaBitmap:
       image_info = SkImageInfo::MakeA8(atlas_size.width, atlas_size.height);
       break;
@@ -231,25 +233,38 @@ static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
   if (!bitmap->tryAllocPixels(image_info)) {
     return nullptr;
   }
+  bitmap->eraseColor(SK_ColorTRANSPARENT);
+  return bitmap;
+}
 
-  auto surface = SkSurfaces::WrapPixels(bitmap->pixmap());
-  if (!surface) {
-    return nullptr;
-  }
-  auto canvas = surface->getCanvas();
-  if (!canvas) {
+static std::shared_ptr<SkBitmap> CreateAtlasBitmap(
+    const GlyphAtlas& atlas,
+    const ISize& atlas_size,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& worker_task_runner) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  auto bitmap = AllocateAtlasBitmap(atlas.GetType(), atlas_size);
+  if (!bitmap) {
     return nullptr;
   }
 
-  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
-
-  atlas.IterateGlyphs([canvas, has_color](const ScaledFont& scaled_font,
-                                          const Glyph& glyph,
-                                          const Rect& location) -> bool {
-    DrawGlyph(canvas, scaled_font, glyph, location, has_color);
+  std::vector<GlyphToRasterize> glyphs;
+  glyphs.reserve(atlas.GetGlyphCount());
+  atlas.IterateGlyphs([&glyphs](const ScaledFont& scaled_font,
+                                const Glyph& glyph,
+                                const Rect& location) -> bool {
+    glyphs.push_back({
+        .scaled_font = &scaled_font,
+        .glyph = &glyph,
+        .location = location,
+    });
     return true;
   });
 
+  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
+  if (!RasterizeGlyphsConcurrently(bitmap, std::move(glyphs), has_color,
+                                   kPadding, worker_task_runner)) {
+    return nullptr;
+  }
   return bitmap;
 }
 
@@ -269,6 +284,59 @@ static bool UpdateGlyphTextureAtlas(std::shared_ptr<SkBitmap> bitmap,
   return texture->SetContents(mapping);
 }
 
+/// Uploads only the given region of the bitmap to the texture. Backends that
+/// cannot blit from buffers to textures upload the entire bitmap instead.
+static bool UpdateGlyphTextureAtlasRegion(
+    Context& context,
+    const std::shared_ptr<SkBitmap>& bitmap,
+    const std::shared_ptr<Texture>& texture,
+    const IRect& region) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  FML_DCHECK(bitmap != nullptr);
+
+  if (!context.GetCapabilities()->SupportsBufferToTextureBlits()) {
+    return UpdateGlyphTextureAtlas(bitmap, texture);
+  }
+
+  const auto& pixmap = bitmap->pixmap();
+  const size_t region_row_bytes =
+      region.GetWidth() * pixmap.info().bytesPerPixel();
+  auto buffer = context.GetResourceAllocator()->CreateBuffer({
+      .storage_mode = StorageMode::kHostVisible,
+      .size = region_row_bytes * region.GetHeight(),
+  });
+  if (!buffer) {
+    return false;
+  }
+  uint8_t* contents = buffer->OnGetContents();
+  for (int64_t row = 0; row < region.GetHeight(); row++) {
+    std::memcpy(contents + row * region_row_bytes,
+                pixmap.addr(static_cast<int>(region.GetX()),
+                            static_cast<int>(region.GetY() + row)),
+                region_row_bytes);
+  }
+  buffer->Flush();
+
+  auto command_buffer = context.CreateCommandBuffer();
+  if (!command_buffer) {
+    return false;
+  }
+  command_buffer->SetLabel("GlyphAtlas Command Buffer");
+  auto blit_pass = command_buffer->CreateBlitPass();
+  if (!blit_pass) {
+    return false;
+  }
+  blit_pass->SetLabel("GlyphAtlas Blit Pass");
+  if (!blit_pass->AddCopy(DeviceBuffer::AsBufferView(buffer), texture,
+                          region)) {
+    return false;
+  }
+  if (!blit_pass->EncodeCommands(context.GetResourceAllocator())) {
+    return false;
+  }
+  return command_buffer->SubmitCommands();
+}
+
 static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
     const std::shared_ptr<Allocator>& allocator,
     std::shared_ptr<SkBitmap> bitmap,
@@ -310,6 +378,95 @@ static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
   return texture;
 }
 
+/// Places font-glyph pairs that do not fit on any existing page on a page of
+/// their own. The least recently used page is evicted and reused once the
+/// atlas has its maximum number of pages. Pages used by the current frame are
+/// never evicted, so a frame with more glyphs than fit in the maximum number
+/// of pages adds pages beyond the maximum.
+static bool AddPageForFontGlyphPairs(
+    Context& context,
+    GlyphAtlas& atlas,
+    GlyphAtlasContextSkia& atlas_context,
+    const std::vector<FontGlyphPair>& pairs) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  std::optional<size_t> evicted_page;
+  if (atlas_context.GetPageCount() >= atlas_context.GetMaxPageCount()) {
+    evicted_page = atlas_context.GetLeastRecentlyUsedPage();
+  }
+
+  // Pages are never smaller than the first page, so that they have room for
+  // the glyphs of later frames.
+  ISize min_size = MinimumAtlasSize(atlas.GetType());
+  min_size = ISize(std::max(min_size.width, atlas_context.GetAtlasSize().width),
+                   std::max(min_size.height,
+                            atlas_context.GetAtlasSize().height));
+  if (evicted_page.has_value()) {
+    const ISize& evicted_size =
+        atlas_context.GetPageSize(evicted_page.value());
+    min_size = ISize(std::max(min_size.width, evicted_size.width),
+                     std::max(min_size.height, evicted_size.height));
+  }
+
+  std::vector<Rect> glyph_positions;
+  std::shared_ptr<RectanglePacker> rect_packer;
+  auto page_size = OptimumAtlasSizeForFontGlyphPairs(
+      pairs,                                                        //
+      glyph_positions,                                              //
+      rect_packer,                                                  //
+      min_size,                                                     //
+      context.GetResourceAllocator()->GetMaxTextureSizeSupported()  //
+  );
+  if (page_size.IsEmpty() || glyph_positions.size() != pairs.size()) {
+    return false;
+  }
+
+  size_t page;
+  std::shared_ptr<SkBitmap> bitmap;
+  if (evicted_page.has_value()) {
+    page = evicted_page.value();
+    atlas.RemoveGlyphsOnPage(page);
+    if (page_size == atlas_context.GetPageSize(page)) {
+      bitmap = atlas_context.GetPageBitmap(page);
+    }
+    atlas_context.UpdatePage(page, page_size, rect_packer);
+  } else {
+    page = atlas_context.AddPage(page_size, rect_packer);
+  }
+
+  for (size_t i = 0; i < pairs.size(); i++) {
+    atlas.AddTypefaceGlyphPosition(pairs[i], glyph_positions[i], page);
+  }
+
+  if (bitmap) {
+    // Reuse the bitmap and texture of the evicted page.
+    bitmap->eraseColor(SK_ColorTRANSPARENT);
+    if (!UpdateAtlasBitmap(atlas, bitmap, pairs,
+                           context.GetConcurrentWorkerTaskRunner())) {
+      return false;
+    }
+    return UpdateGlyphTextureAtlas(bitmap, atlas.GetPageTexture(page));
+  }
+
+  bitmap = AllocateAtlasBitmap(atlas.GetType(), page_size);
+  if (!bitmap || !UpdateAtlasBitmap(atlas, bitmap, pairs,
+                                    context.GetConcurrentWorkerTaskRunner())) {
+    return false;
+  }
+  atlas_context.UpdatePageBitmap(page, bitmap);
+  auto texture =
+      UploadGlyphTextureAtlas(context.GetResourceAllocator(), bitmap,
+                              page_size, AtlasPixelFormat(atlas.GetType()));
+  if (!texture) {
+    return false;
+  }
+  if (page < atlas.GetPageCount()) {
+    atlas.SetPageTexture(page, std::move(texture));
+  } else {
+    atlas.AddPage(std::move(texture));
+  }
+  return true;
+}
+
 std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
     Context& context,
     GlyphAtlas::Type type,
@@ -325,10 +482,13 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   if (font_glyph_map.empty()) {
     return last_atlas;
   }
+  atlas_context->BeginFrame();
 
   // ---------------------------------------------------------------------------
   // Step 1: Determine if the atlas type and font glyph pairs are compatible
-  //         with the current atlas and reuse if possible.
+  //         with the current atlas and reuse if possible. Pages that have
+  //         glyphs of this frame are marked as used so that they are not
+  //         evicted.
   // ---------------------------------------------------------------------------
   std::vector<FontGlyphPair> new_glyphs;
   for (const auto& font_value : font_glyph_map) {
@@ -337,7 +497,10 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
         last_atlas->GetFontGlyphAtlas(scaled_font.font, scaled_font.scale);
     if (font_glyph_atlas) {
       for (const Glyph& glyph : font_value.second) {
-        if (!font_glyph_atlas->FindGlyphBounds(glyph)) {
+        auto position = font_glyph_atlas->FindGlyphPosition(glyph);
+        if (position.has_value()) {
+          atlas_context->MarkPageUsed(position->page);
+        } else {
           new_glyphs.emplace_back(scaled_font, glyph);
         }
       }
@@ -352,38 +515,49 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 2: Determine if the additional missing glyphs can be appended to the
-  //         existing bitmap without recreating the atlas. This requires that
-  //         the type is identical.
+  // Step 2: Determine if the additional missing glyphs can be added to the
+  //         pages of the existing atlas without recreating the atlas. This
+  //         requires that the type is identical.
   // ---------------------------------------------------------------------------
-  std::vector<Rect> glyph_positions;
-  if (last_atlas->GetType() == type &&
-      CanAppendToExistingAtlas(last_atlas, new_glyphs, glyph_positions,
-                               atlas_context->GetAtlasSize(),
-                               atlas_context->GetRectPacker())) {
-    // The old bitmap will be reused and only the additional glyphs will be
-    // added.
-
+  if (last_atlas->GetType() == type && last_atlas->IsValid() &&
+      last_atlas->GetPageCount() == atlas_context->GetPageCount()) {
     // ---------------------------------------------------------------------------
-    // Step 3a: Record the positions in the glyph atlas of the newly added
-    //          glyphs.
+    // Step 3a: Record the positions of the newly added glyphs that fit in the
+    //          free space of existing pages.
     // ---------------------------------------------------------------------------
-    for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
-      last_atlas->AddTypefaceGlyphPosition(new_glyphs[i], glyph_positions[i]);
-    }
+    std::vector<std::vector<FontGlyphPair>> page_glyphs;
+    std::vector<std::optional<IRect>> dirty_regions;
+    auto remaining_glyphs = AppendToExistingPages(
+        *last_atlas, *atlas_context, new_glyphs, page_glyphs, dirty_regions);
 
     // ---------------------------------------------------------------------------
-    // Step 4a: Draw new font-glyph pairs into the existing bitmap.
+    // Step 4a: Draw those glyphs into the existing bitmaps and upload only the
+    //          regions of the textures that changed.
     // ---------------------------------------------------------------------------
-    auto bitmap = atlas_context_skia.GetBitmap();
-    if (!UpdateAtlasBitmap(*last_atlas, bitmap, new_glyphs)) {
-      return nullptr;
+    for (size_t page = 0; page < page_glyphs.size(); page++) {
+      if (page_glyphs[page].empty() || !dirty_regions[page].has_value()) {
+        continue;
+      }
+      auto bitmap = atlas_context_skia.GetPageBitmap(page);
+      if (!bitmap ||
+          !UpdateAtlasBitmap(*last_atlas, bitmap, page_glyphs[page],
+                             context.GetConcurrentWorkerTaskRunner())) {
+        return nullptr;
+      }
+      if (!UpdateGlyphTextureAtlasRegion(context, bitmap,
+                                         last_atlas->GetPageTexture(page),
+                                         dirty_regions[page].value())) {
+        return nullptr;
+      }
     }
 
     // ---------------------------------------------------------------------------
-    // Step 5a: Update the existing texture with the updated bitmap.
+    // Step 5a: Place the glyphs that did not fit on a new page, or on the page
+    //          that has gone unused the longest.
     // ---------------------------------------------------------------------------
-    if (!UpdateGlyphTextureAtlas(bitmap, last_atlas->GetTexture())) {
+    if (!remaining_glyphs.empty() &&
+        !AddPageForFontGlyphPairs(context, *last_atlas, atlas_context_skia,
+                                  remaining_glyphs)) {
       return nullptr;
     }
     return last_atlas;
@@ -404,13 +578,18 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
     }
   }
   auto glyph_atlas = std::make_shared<GlyphAtlas>(type);
+  std::vector<Rect> glyph_positions;
+  std::shared_ptr<RectanglePacker> rect_packer;
   auto atlas_size = OptimumAtlasSizeForFontGlyphPairs(
       font_glyph_pairs,                                             //
       glyph_positions,                                              //
-      atlas_context,                                                //
-      type,                                                         //
+      rect_packer,                                                  //
+      MinimumAtlasSize(type),                                       //
       context.GetResourceAllocator()->GetMaxTextureSizeSupported()  //
   );
+  if (rect_packer) {
+    atlas_context->UpdateRectPacker(rect_packer);
+  }
 
   atlas_context->UpdateGlyphAtlas(glyph_atlas, atlas_size);
   if (atlas_size.IsEmpty()) {
@@ -440,7 +619,8 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   // ---------------------------------------------------------------------------
   // Step 6b: Draw font-glyph pairs in the correct spot in the atlas.
   // ---------------------------------------------------------------------------
-  auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size);
+  auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size,
+                                  context.GetConcurrentWorkerTaskRunner());
   if (!bitmap) {
     return nullptr;
   }
@@ -463,17 +643,8 @@ std::shared_ptr<GlyphAtlas> TypographerContextSkia::CreateGlyphAtlas(
   // ---------------------------------------------------------------------------
   // Step 7b: Upload the atlas as a texture.
   // ---------------------------------------------------------------------------
-  PixelFormat format;
-  switch (type) {
-    case GlyphAtlas::Type::kAlphaBitmap:
-      format = PixelFormat::kA8UNormInt;
-      break;
-    case GlyphAtlas::Type::kColorBitmap:
-      format = PixelFormat::kR8G8B8A8UNormInt;
-      break;
-  }
   auto texture = UploadGlyphTextureAtlas(context.GetResourceAllocator(), bitmap,
-                                         atlas_size, format);
+                                         atlas_size, AtlasPixelFormat(type));
   if (!texture) {
     return nullptr;
   }
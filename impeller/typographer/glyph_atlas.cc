@@ -4,14 +4,19 @@
 
 #include "impeller/typographer/glyph_atlas.h"
 
+#include <algorithm>
 #include <numeric>
 #include <utility>
 
+#include "flutter/fml/logging.h"
+
 namespace impeller {
 
+static const std::shared_ptr<Texture> kNullTexture = nullptr;
+
 GlyphAtlasContext::GlyphAtlasContext()
     : atlas_(std::make_shared<GlyphAtlas>(GlyphAtlas::Type::kAlphaBitmap)),
-      atlas_size_(ISize(0, 0)) {}
+      pages_(1, Page{.size = ISize(0, 0)}) {}
 
 GlyphAtlasContext::~GlyphAtlasContext() {}
 
@@ -20,22 +25,93 @@ std::shared_ptr<GlyphAtlas> GlyphAtlasContext::GetGlyphAtlas() const {
 }
 
 const ISize& GlyphAtlasContext::GetAtlasSize() const {
-  return atlas_size_;
+  return pages_[0].size;
 }
 
 std::shared_ptr<RectanglePacker> GlyphAtlasContext::GetRectPacker() const {
-  return rect_packer_;
+  return pages_[0].rect_packer;
 }
 
 void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas,
                                          ISize size) {
   atlas_ = std::move(atlas);
-  atlas_size_ = size;
+  pages_.resize(1);
+  pages_[0].size = size;
+  pages_[0].last_used_frame = current_frame_;
 }
 
 void GlyphAtlasContext::UpdateRectPacker(
     std::shared_ptr<RectanglePacker> rect_packer) {
-  rect_packer_ = std::move(rect_packer);
+  pages_[0].rect_packer = std::move(rect_packer);
+}
+
+size_t GlyphAtlasContext::GetPageCount() const {
+  return pages_.size();
+}
+
+const ISize& GlyphAtlasContext::GetPageSize(size_t page) const {
+  FML_DCHECK(page < pages_.size());
+  return pages_[page].size;
+}
+
+std::shared_ptr<RectanglePacker> GlyphAtlasContext::GetPageRectPacker(
+    size_t page) const {
+  FML_DCHECK(page < pages_.size());
+  return pages_[page].rect_packer;
+}
+
+size_t GlyphAtlasContext::AddPage(
+    ISize size,
+    std::shared_ptr<RectanglePacker> rect_packer) {
+  pages_.push_back(Page{
+      .size = size,
+      .rect_packer = std::move(rect_packer),
+      .last_used_frame = current_frame_,
+  });
+  return pages_.size() - 1;
+}
+
+void GlyphAtlasContext::UpdatePage(
+    size_t page,
+    ISize size,
+    std::shared_ptr<RectanglePacker> rect_packer) {
+  FML_DCHECK(page < pages_.size());
+  pages_[page] = Page{
+      .size = size,
+      .rect_packer = std::move(rect_packer),
+      .last_used_frame = current_frame_,
+  };
+}
+
+void GlyphAtlasContext::BeginFrame() {
+  current_frame_++;
+}
+
+void GlyphAtlasContext::MarkPageUsed(size_t page) {
+  FML_DCHECK(page < pages_.size());
+  pages_[page].last_used_frame = current_frame_;
+}
+
+std::optional<size_t> GlyphAtlasContext::GetLeastRecentlyUsedPage() const {
+  std::optional<size_t> result;
+  for (size_t i = 0; i < pages_.size(); i++) {
+    if (pages_[i].last_used_frame == current_frame_) {
+      continue;
+    }
+    if (!result.has_value() ||
+        pages_[i].last_used_frame < pages_[result.value()].last_used_frame) {
+      result = i;
+    }
+  }
+  return result;
+}
+
+void GlyphAtlasContext::SetMaxPageCount(size_t max_page_count) {
+  max_page_count_ = std::max(max_page_count, static_cast<size_t>(1u));
+}
+
+size_t GlyphAtlasContext::GetMaxPageCount() const {
+  return max_page_count_;
 }
 
 GlyphAtlas::GlyphAtlas(Type type) : type_(type) {}
@@ -43,7 +119,7 @@ GlyphAtlas::GlyphAtlas(Type type) : type_(type) {}
 GlyphAtlas::~GlyphAtlas() = default;
 
 bool GlyphAtlas::IsValid() const {
-  return !!texture_;
+  return !pages_.empty() && !!pages_[0];
 }
 
 GlyphAtlas::Type GlyphAtlas::GetType() const {
@@ -51,16 +127,62 @@ GlyphAtlas::Type GlyphAtlas::GetType() const {
 }
 
 const std::shared_ptr<Texture>& GlyphAtlas::GetTexture() const {
-  return texture_;
+  return pages_.empty() ? kNullTexture : pages_[0];
 }
 
 void GlyphAtlas::SetTexture(std::shared_ptr<Texture> texture) {
-  texture_ = std::move(texture);
+  if (pages_.empty()) {
+    pages_.push_back(std::move(texture));
+  } else {
+    pages_[0] = std::move(texture);
+  }
+}
+
+size_t GlyphAtlas::AddPage(std::shared_ptr<Texture> texture) {
+  pages_.push_back(std::move(texture));
+  return pages_.size() - 1;
+}
+
+void GlyphAtlas::SetPageTexture(size_t page, std::shared_ptr<Texture> texture) {
+  FML_DCHECK(page < pages_.size());
+  pages_[page] = std::move(texture);
+}
+
+const std::shared_ptr<Texture>& GlyphAtlas::GetPageTexture(size_t page) const {
+  return page < pages_.size() ? pages_[page] : kNullTexture;
+}
+
+size_t GlyphAtlas::GetPageCount() const {
+  return pages_.size();
 }
 
 void GlyphAtlas::AddTypefaceGlyphPosition(const FontGlyphPair& pair,
-                                          Rect rect) {
-  font_atlas_map_[pair.scaled_font].positions_[pair.glyph] = rect;
+                                          Rect rect,
+                                          size_t page) {
+  font_atlas_map_[pair.scaled_font].positions_[pair.glyph] =
+      GlyphAtlasPosition{.bounds = rect, .page = page};
+}
+
+size_t GlyphAtlas::RemoveGlyphsOnPage(size_t page) {
+  size_t count = 0u;
+  for (auto font_it = font_atlas_map_.begin();
+       font_it != font_atlas_map_.end();) {
+    auto& positions = font_it->second.positions_;
+    for (auto it = positions.begin(); it != positions.end();) {
+      if (it->second.page == page) {
+        it = positions.erase(it);
+        count++;
+      } else {
+        ++it;
+      }
+    }
+    if (positions.empty()) {
+      font_it = font_atlas_map_.erase(font_it);
+    } else {
+      ++font_it;
+    }
+  }
+  return count;
 }
 
 std::optional<Rect> GlyphAtlas::FindFontGlyphBounds(
@@ -100,7 +222,8 @@ size_t GlyphAtlas::IterateGlyphs(
   for (const auto& font_value : font_atlas_map_) {
     for (const auto& glyph_value : font_value.second.positions_) {
       count++;
-      if (!iterator(font_value.first, glyph_value.first, glyph_value.second)) {
+      if (!iterator(font_value.first, glyph_value.first,
+                    glyph_value.second.bounds)) {
         return count;
       }
     }
@@ -113,6 +236,15 @@ std::optional<Rect> FontGlyphAtlas::FindGlyphBounds(const Glyph& glyph) const {
   if (found == positions_.end()) {
     return std::nullopt;
   }
+  return found->second.bounds;
+}
+
+std::optional<GlyphAtlasPosition> FontGlyphAtlas::FindGlyphPosition(
+    const Glyph& glyph) const {
+  const auto& found = positions_.find(glyph);
+  if (found == positions_.end()) {
+    return std::nullopt;
+  }
   return found->second;
 }
 
@@ -9,6 +9,7 @@
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "impeller/core/texture.h"
@@ -22,9 +23,23 @@ namespace impeller {
 class FontGlyphAtlas;
 
 //------------------------------------------------------------------------------
-/// @brief      A texture containing the bitmap representation of glyphs in
-///             different fonts along with the ability to query the location of
-///             specific font glyphs within the texture.
+/// @brief      The location of a glyph within the pages of a glyph atlas.
+///
+struct GlyphAtlasPosition {
+  /// The bounds of the glyph within the texture of its page.
+  Rect bounds;
+  /// The index of the page containing the glyph.
+  size_t page = 0;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      One or more textures, called pages, containing the bitmap
+///             representation of glyphs in different fonts along with the
+///             ability to query the location of specific font glyphs within
+///             the textures.
+///
+///             Each glyph is stored on exactly one page. All pages share the
+///             type of the atlas.
 ///
 class GlyphAtlas {
  public:
@@ -61,27 +76,71 @@ class GlyphAtlas {
   Type GetType() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Set the texture for the glyph atlas.
+  /// @brief      Set the texture for the first page of the glyph atlas.
   ///
   /// @param[in]  texture  The texture
   ///
   void SetTexture(std::shared_ptr<Texture> texture);
 
   //----------------------------------------------------------------------------
-  /// @brief      Get the texture for the glyph atlas.
+  /// @brief      Get the texture for the first page of the glyph atlas.
   ///
   /// @return     The texture.
   ///
   const std::shared_ptr<Texture>& GetTexture() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Add a page to the glyph atlas.
+  ///
+  /// @param[in]  texture  The texture of the new page
+  ///
+  /// @return     The index of the new page.
+  ///
+  size_t AddPage(std::shared_ptr<Texture> texture);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the texture of an existing page.
+  ///
+  /// @param[in]  page     The index of the page
+  /// @param[in]  texture  The texture
+  ///
+  void SetPageTexture(size_t page, std::shared_ptr<Texture> texture);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the texture of a page of the glyph atlas.
+  ///
+  /// @param[in]  page  The index of the page
+  ///
+  /// @return     The texture.
+  ///
+  const std::shared_ptr<Texture>& GetPageTexture(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get the number of pages in this atlas.
+  ///
+  size_t GetPageCount() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Record the location of a specific font-glyph pair within the
   ///             atlas.
   ///
   /// @param[in]  pair  The font-glyph pair
   /// @param[in]  rect  The rectangle
+  /// @param[in]  page  The index of the page the rectangle is in
   ///
-  void AddTypefaceGlyphPosition(const FontGlyphPair& pair, Rect rect);
+  void AddTypefaceGlyphPosition(const FontGlyphPair& pair,
+                                Rect rect,
+                                size_t page = 0);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget the locations of all the glyphs on a page so that the
+  ///             page can be reused for other glyphs.
+  ///
+  /// @param[in]  page  The index of the page
+  ///
+  /// @return     The number of glyphs removed.
+  ///
+  size_t RemoveGlyphsOnPage(size_t page);
 
   //----------------------------------------------------------------------------
   /// @brief      Get the number of unique font-glyph pairs in this atlas.
@@ -130,7 +189,7 @@ class GlyphAtlas {
 
  private:
   const Type type_;
-  std::shared_ptr<Texture> texture_;
+  std::vector<std::shared_ptr<Texture>> pages_;
 
   std::unordered_map<ScaledFont, FontGlyphAtlas> font_atlas_map_;
 
@@ -151,26 +210,87 @@ class GlyphAtlasContext {
   std::shared_ptr<GlyphAtlas> GetGlyphAtlas() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Retrieve the size of the current glyph atlas.
+  /// @brief      Retrieve the size of the first page of the current glyph
+  ///             atlas.
   const ISize& GetAtlasSize() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Retrieve the previous (if any) rect packer.
+  /// @brief      Retrieve the previous (if any) rect packer of the first page.
   std::shared_ptr<RectanglePacker> GetRectPacker() const;
 
   //----------------------------------------------------------------------------
-  /// @brief      Update the context with a newly constructed glyph atlas.
+  /// @brief      Update the context with a newly constructed glyph atlas that
+  ///             has a single page of the given size.
   void UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas, ISize size);
 
   void UpdateRectPacker(std::shared_ptr<RectanglePacker> rect_packer);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the number of pages of the current glyph atlas.
+  size_t GetPageCount() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the size of a page of the current glyph atlas.
+  const ISize& GetPageSize(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the rect packer of a page of the current glyph atlas.
+  std::shared_ptr<RectanglePacker> GetPageRectPacker(size_t page) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Add a page to the current glyph atlas. The page is marked as
+  ///             used by the current frame.
+  ///
+  /// @return     The index of the new page.
+  ///
+  size_t AddPage(ISize size, std::shared_ptr<RectanglePacker> rect_packer);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Replace a page of the current glyph atlas, such as when all
+  ///             of its glyphs are evicted. The page is marked as used by the
+  ///             current frame.
+  void UpdatePage(size_t page,
+                  ISize size,
+                  std::shared_ptr<RectanglePacker> rect_packer);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Begin collecting the glyphs of a new frame. Pages that are
+  ///             not marked as used after this call may be evicted.
+  void BeginFrame();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record that the current frame has glyphs on the page.
+  void MarkPageUsed(size_t page);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the page that has gone unused for the most frames,
+  ///             or `std::nullopt` if every page is used by the current frame.
+  std::optional<size_t> GetLeastRecentlyUsedPage() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Set the number of pages beyond which pages that are not used
+  ///             by the current frame are evicted rather than new pages being
+  ///             added.
+  void SetMaxPageCount(size_t max_page_count);
+
+  size_t GetMaxPageCount() const;
+
  protected:
   GlyphAtlasContext();
 
  private:
+  static constexpr size_t kDefaultMaxPageCount = 4u;
+
+  struct Page {
+    ISize size;
+    std::shared_ptr<RectanglePacker> rect_packer;
+    uint64_t last_used_frame = 0;
+  };
+
   std::shared_ptr<GlyphAtlas> atlas_;
-  ISize atlas_size_;
-  std::shared_ptr<RectanglePacker> rect_packer_;
+  std::vector<Page> pages_;
+  uint64_t current_frame_ = 0;
+  size_t max_page_count_ = kDefaultMaxPageCount;
 
   GlyphAtlasContext(const GlyphAtlasContext&) = delete;
 
@@ -195,9 +315,20 @@ class FontGlyphAtlas {
   ///
   std::optional<Rect> FindGlyphBounds(const Glyph& glyph) const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find the location of a glyph in the atlas, including the page
+  ///             that contains it.
+  ///
+  /// @param[in]  glyph The glyph
+  ///
+  /// @return     The location of the glyph in the atlas.
+  ///             `std::nullopt` if the glyph is not in the atlas.
+  ///
+  std::optional<GlyphAtlasPosition> FindGlyphPosition(const Glyph& glyph) const;
+
  private:
   friend class GlyphAtlas;
-  std::unordered_map<Glyph, Rect> positions_;
+  std::unordered_map<Glyph, GlyphAtlasPosition> positions_;
 
   FontGlyphAtlas(const FontGlyphAtlas&) = delete;
 
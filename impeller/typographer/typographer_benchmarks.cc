@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <string>
+
+#include "flutter/display_list/testing/dl_test_snippets.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "impeller/typographer/backends/skia/rasterize_glyphs_skia.h"
+#include "impeller/typographer/backends/skia/text_frame_skia.h"
+#include "impeller/typographer/rectangle_packer.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkGraphics.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+
+namespace impeller {
+
+namespace {
+
+// The padding the Skia typographer context reserves around each glyph.
+constexpr auto kPadding = 2;
+
+constexpr auto kAtlasSize = 4096;
+
+/// Collects |glyph_count| unique glyphs of the test font, using as many scales
+/// of the font as needed.
+FontGlyphMap CollectUniqueGlyphs(size_t glyph_count) {
+  std::string text;
+  for (char c = '!'; c <= '~'; c++) {
+    text.push_back(c);
+  }
+  auto frame = MakeTextFrameFromTextBlobSkia(SkTextBlob::MakeFromString(
+      text.c_str(), flutter::testing::CreateTestFontOfSize(12)));
+
+  FontGlyphMap font_glyph_map;
+  size_t collected = 0u;
+  for (size_t i = 0; collected < glyph_count; i++) {
+    FontGlyphMap scale_glyph_map;
+    frame->CollectUniqueFontGlyphPairs(scale_glyph_map, 1.0f + i * 0.25f);
+    for (auto& [scaled_font, glyphs] : scale_glyph_map) {
+      auto& set = font_glyph_map[scaled_font];
+      for (const Glyph& glyph : glyphs) {
+        if (collected == glyph_count) {
+          break;
+        }
+        set.insert(glyph);
+        collected++;
+      }
+    }
+  }
+  return font_glyph_map;
+}
+
+}  // namespace
+
+/// Packs and rasterizes |state.range(0)| glyphs that are new to the glyph
+/// atlas, as the first frame of a screen of text does, on the calling thread
+/// and |state.range(1)| worker threads. The glyph cache of Skia is purged
+/// before each iteration, so glyph outlines are rasterized from scratch.
+static void BM_RasterizeNewGlyphs(benchmark::State& state) {
+  size_t glyph_count = state.range(0);
+  size_t worker_count = state.range(1);
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner;
+  if (worker_count > 0) {
+    loop = fml::ConcurrentMessageLoop::Create(worker_count);
+    worker_task_runner = loop->GetTaskRunner();
+  }
+
+  auto font_glyph_map = CollectUniqueGlyphs(glyph_count);
+  auto bitmap = std::make_shared<SkBitmap>();
+  if (!bitmap->tryAllocPixels(SkImageInfo::MakeA8(kAtlasSize, kAtlasSize))) {
+    state.SkipWithError("Could not allocate the atlas bitmap.");
+    return;
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    SkGraphics::PurgeFontCache();
+    bitmap->eraseColor(SK_ColorTRANSPARENT);
+    state.ResumeTiming();
+
+    auto rect_packer = RectanglePacker::Factory(kAtlasSize, kAtlasSize);
+    std::vector<GlyphToRasterize> glyphs;
+    glyphs.reserve(glyph_count);
+    for (const auto& [scaled_font, font_glyphs] : font_glyph_map) {
+      for (const Glyph& glyph : font_glyphs) {
+        auto glyph_size =
+            ISize::Ceil(glyph.bounds.GetSize() * scaled_font.scale);
+        IPoint16 location;
+        if (!rect_packer->addRect(glyph_size.width + kPadding,
+                                  glyph_size.height + kPadding, &location)) {
+          state.SkipWithError("The glyphs do not fit in the atlas.");
+          return;
+        }
+        glyphs.push_back({
+            .scaled_font = &scaled_font,
+            .glyph = &glyph,
+            .location = Rect::MakeXYWH(location.x(), location.y(),
+                                       glyph_size.width, glyph_size.height),
+        });
+      }
+    }
+    RasterizeGlyphsConcurrently(bitmap, std::move(glyphs), false, kPadding,
+                                worker_task_runner);
+  }
+  state.SetItemsProcessed(state.iterations() * glyph_count);
+}
+
+// Glyph counts of 64, 256, and 1024 with 0, 1, and 3 workers.
+BENCHMARK(BM_RasterizeNewGlyphs)
+    ->RangeMultiplier(4)
+    ->Ranges({{64, 1024}, {0, 3}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+}  // namespace impeller
@@ -338,7 +338,7 @@ TEST_P(TypographerTest, RectanglePackerAddsNonoverlapingRectangles) {
   ASSERT_EQ(packer->percentFull(), 0);
 }
 
-TEST_P(TypographerTest, GlyphAtlasTextureIsRecycledWhenContentsAreRecreated) {
+TEST_P(TypographerTest, GlyphAtlasAddsPageInsteadOfRecreatingContents) {
   auto context = TypographerContextSkia::Make();
   auto atlas_context = context->CreateGlyphAtlasContext();
   ASSERT_TRUE(context && context->IsValid());
@@ -354,24 +354,111 @@ TEST_P(TypographerTest, GlyphAtlasTextureIsRecycledWhenContentsAreRecreated) {
   ASSERT_NE(atlas, nullptr);
   ASSERT_NE(atlas->GetTexture(), nullptr);
   ASSERT_EQ(atlas, atlas_context->GetGlyphAtlas());
+  ASSERT_EQ(atlas->GetPageCount(), 1u);
+  auto first_glyph_count = atlas->GetGlyphCount();
 
   auto* first_texture = atlas->GetTexture().get();
 
-  // Now create a new glyph atlas with a completely different textblob.
-  // everything should be different except for the underlying atlas texture.
-
+  // Now add a completely different textblob that does not fit in the free
+  // space of the atlas. The glyphs that do not fit are added to a new page
+  // instead of recreating the atlas.
   auto blob2 = SkTextBlob::MakeFromString("abcdefghijklmnopqrstuvwxyz123456789",
                                           sk_font);
   auto next_atlas = CreateGlyphAtlas(
       *GetContext(), context.get(), GlyphAtlas::Type::kColorBitmap, 32.0f,
       atlas_context, *MakeTextFrameFromTextBlobSkia(blob2));
-  ASSERT_NE(atlas, next_atlas);
-  auto* second_texture = next_atlas->GetTexture().get();
+  ASSERT_EQ(atlas, next_atlas);
+  ASSERT_EQ(next_atlas->GetTexture().get(), first_texture);
+  ASSERT_EQ(atlas_context->GetRectPacker(), old_packer);
+  ASSERT_EQ(next_atlas->GetPageCount(), 2u);
+  ASSERT_EQ(atlas_context->GetPageCount(), 2u);
+  ASSERT_NE(next_atlas->GetPageTexture(1), nullptr);
+  // "123456789" was already in the atlas.
+  EXPECT_EQ(next_atlas->GetGlyphCount(), first_glyph_count + 26u);
+
+  // Every glyph is on a page that exists.
+  next_atlas->IterateGlyphs([&](const ScaledFont& scaled_font,
+                                const Glyph& glyph, const Rect& rect) {
+    auto position = next_atlas->GetFontGlyphAtlas(scaled_font.font,
+                                                  scaled_font.scale)
+                        ->FindGlyphPosition(glyph);
+    EXPECT_TRUE(position.has_value());
+    EXPECT_LT(position->page, next_atlas->GetPageCount());
+    EXPECT_EQ(position->bounds, rect);
+    return true;
+  });
+}
 
-  auto new_packer = atlas_context->GetRectPacker();
+TEST_P(TypographerTest, GlyphAtlasContextEvictsLeastRecentlyUsedPage) {
+  auto context = TypographerContextSkia::Make();
+  auto atlas_context = context->CreateGlyphAtlasContext();
+  ASSERT_EQ(atlas_context->GetPageCount(), 1u);
+  atlas_context->SetMaxPageCount(3u);
+  EXPECT_EQ(atlas_context->GetMaxPageCount(), 3u);
+
+  atlas_context->BeginFrame();
+  atlas_context->UpdateGlyphAtlas(
+      std::make_shared<GlyphAtlas>(GlyphAtlas::Type::kAlphaBitmap),
+      ISize(64, 64));
+  EXPECT_EQ(atlas_context->AddPage(ISize(128, 64), nullptr), 1u);
+  EXPECT_EQ(atlas_context->GetPageSize(1), ISize(128, 64));
+
+  // Every page is used by the current frame.
+  EXPECT_FALSE(atlas_context->GetLeastRecentlyUsedPage().has_value());
+
+  atlas_context->BeginFrame();
+  EXPECT_EQ(atlas_context->AddPage(ISize(64, 64), nullptr), 2u);
+  atlas_context->BeginFrame();
+  atlas_context->MarkPageUsed(0);
+  // Page 1 was last used two frames ago and page 2 one frame ago.
+  EXPECT_EQ(atlas_context->GetLeastRecentlyUsedPage(), 1u);
+
+  atlas_context->UpdatePage(1, ISize(256, 256), nullptr);
+  EXPECT_EQ(atlas_context->GetPageSize(1), ISize(256, 256));
+  EXPECT_EQ(atlas_context->GetLeastRecentlyUsedPage(), 2u);
+
+  // A new atlas has a single page.
+  atlas_context->UpdateGlyphAtlas(
+      std::make_shared<GlyphAtlas>(GlyphAtlas::Type::kAlphaBitmap),
+      ISize(64, 64));
+  EXPECT_EQ(atlas_context->GetPageCount(), 1u);
+}
 
-  ASSERT_EQ(second_texture, first_texture);
-  ASSERT_NE(old_packer, new_packer);
+TEST_P(TypographerTest, GlyphAtlasCanRemoveGlyphsOnPage) {
+  SkFont sk_font = flutter::testing::CreateTestFontOfSize(12);
+  auto blob = SkTextBlob::MakeFromString("abc", sk_font);
+  ASSERT_TRUE(blob);
+  FontGlyphMap font_glyph_map;
+  MakeTextFrameFromTextBlobSkia(blob)->CollectUniqueFontGlyphPairs(
+      font_glyph_map, 1.0f);
+  ASSERT_EQ(font_glyph_map.size(), 1u);
+  const auto& [scaled_font, glyphs] = *font_glyph_map.begin();
+  ASSERT_EQ(glyphs.size(), 3u);
+
+  GlyphAtlas atlas(GlyphAtlas::Type::kAlphaBitmap);
+  size_t page = 0;
+  for (const Glyph& glyph : glyphs) {
+    atlas.AddTypefaceGlyphPosition({scaled_font, glyph},
+                                   Rect::MakeXYWH(0, 0, 10, 10), page);
+    page = 1 - page;
+  }
+  EXPECT_EQ(atlas.GetGlyphCount(), 3u);
+
+  EXPECT_EQ(atlas.RemoveGlyphsOnPage(0), 2u);
+  EXPECT_EQ(atlas.GetGlyphCount(), 1u);
+  atlas.IterateGlyphs([&](const ScaledFont& font, const Glyph& glyph,
+                          const Rect& rect) {
+    EXPECT_EQ(atlas.GetFontGlyphAtlas(font.font, font.scale)
+                  ->FindGlyphPosition(glyph)
+                  ->page,
+              1u);
+    return true;
+  });
+
+  EXPECT_EQ(atlas.RemoveGlyphsOnPage(1), 1u);
+  EXPECT_EQ(atlas.GetGlyphCount(), 0u);
+  EXPECT_EQ(atlas.GetFontGlyphAtlas(scaled_font.font, scaled_font.scale),
+            nullptr);
 }
 
 }  // namespace testing
@@ -26,8 +26,10 @@ PictureRecorder::PictureRecorder() {}
 PictureRecorder::~PictureRecorder() {}
 
 sk_sp<DisplayListBuilder> PictureRecorder::BeginRecording(SkRect bounds) {
-  display_list_builder_ =
-      sk_make_sp<DisplayListBuilder>(bounds, /*prepare_rtree=*/true);
+  // Apps can record hundreds of pictures per frame, so recycle their storage
+  // rather than going back to the system allocator for each one.
+  display_list_builder_ = sk_make_sp<DisplayListBuilder>(
+      bounds, /*prepare_rtree=*/true, /*pool_storage=*/true);
   return display_list_builder_;
 }
 
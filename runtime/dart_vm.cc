@@ -17,6 +17,7 @@
 #include "flutter/fml/size.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/lib/ui/dart_ui.h"
 #include "flutter/runtime/dart_isolate.h"
 #include "flutter/runtime/dart_vm_initializer.h"
@@ -471,6 +472,10 @@ DartVM::DartVM(const std::shared_ptr<const DartVMData>& vm_data,
     DartVMInitializer::Initialize(&params,
                                   settings_.enable_timeline_event_handler,
                                   settings_.trace_systrace);
+    if (!settings_.trace_to_recorder.empty()) {
+      // Replaces the Dart timeline event handler installed above.
+      fml::tracing::TraceRecorderEnable();
+    }
     // Send the earliest available timestamp in the application lifecycle to
     // timeline. The difference between this timestamp and the time we render
     // the very first frame gives us a good idea about Flutter's startup time.
@@ -523,6 +528,11 @@ DartVM::~DartVM() {
 
   DartVMInitializer::Cleanup();
 
+  if (!settings_.trace_to_recorder.empty()) {
+    fml::tracing::TraceRecorderDisable();
+    fml::tracing::TraceRecorderWriteToFile(settings_.trace_to_recorder);
+  }
+
   dart::bin::CleanupDartIo();
 }
 
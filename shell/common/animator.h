@@ -47,7 +47,9 @@ class Animator final {
 
   Animator(Delegate& delegate,
            const TaskRunners& task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           PipelineFullPolicy pipeline_full_policy =
+               PipelineFullPolicy::kDropNewest);
 
   ~Animator();
 
@@ -5,8 +5,10 @@
 #include "flutter/common/graphics/persistent_cache.h"
 
 #include <memory>
+#include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/graphics/shader_cache_archive.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/fml/command_line.h"
@@ -199,5 +201,184 @@ TEST_F(PersistentCacheTest, PurgeAllowsFutureSkSLCache) {
   DestroyShell(std::move(shell));
 }
 
+static sk_sp<SkData> MakeTextSkData(const std::string& text) {
+  return SkData::MakeWithCopy(text.data(), text.size());
+}
+
+TEST(ShaderCacheArchiveTest, LoadsEntriesStoredByPreviousArchive) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  {
+    ShaderCacheArchive archive(temp_dir.fd(), false);
+    ASSERT_TRUE(archive.IsValid());
+    EXPECT_EQ(archive.GetEntryCount(), 0u);
+    EXPECT_TRUE(archive.Store(*MakeTextSkData("A"), *MakeTextSkData("x")));
+    EXPECT_TRUE(archive.Store({
+        {MakeTextSkData("B"), MakeTextSkData("y")},
+        {MakeTextSkData("C"), MakeTextSkData("z")},
+    }));
+    CheckTextSkData(archive.Load(*MakeTextSkData("B")), "y");
+  }
+
+  ShaderCacheArchive archive(temp_dir.fd(), true);
+  ASSERT_TRUE(archive.IsValid());
+  EXPECT_EQ(archive.GetEntryCount(), 3u);
+  CheckTextSkData(archive.Load(*MakeTextSkData("A")), "x");
+  CheckTextSkData(archive.Load(*MakeTextSkData("C")), "z");
+  EXPECT_EQ(archive.Load(*MakeTextSkData("D")), nullptr);
+  EXPECT_FALSE(archive.Store(*MakeTextSkData("D"), *MakeTextSkData("w")));
+
+  auto entries = archive.LoadAll();
+  ASSERT_EQ(entries.size(), 3u);
+  CheckTextSkData(entries[0].key, "B");
+  CheckTextSkData(entries[1].key, "A");
+  CheckTextSkData(entries[2].key, "C");
+}
+
+TEST(ShaderCacheArchiveTest, IsInvalidIfReadOnlyAndMissing) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  ShaderCacheArchive archive(temp_dir.fd(), true);
+  EXPECT_FALSE(archive.IsValid());
+  EXPECT_EQ(archive.Load(*MakeTextSkData("A")), nullptr);
+}
+
+TEST(ShaderCacheArchiveTest, CompactsSupersededEntries) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  ShaderCacheArchive archive(temp_dir.fd(), false);
+  ASSERT_TRUE(archive.IsValid());
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("A"), *MakeTextSkData("x")));
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("A"), *MakeTextSkData("xx")));
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("B"), *MakeTextSkData("y")));
+  EXPECT_EQ(archive.GetEntryCount(), 2u);
+  CheckTextSkData(archive.Load(*MakeTextSkData("A")), "xx");
+
+  size_t file_size = archive.GetFileSize();
+  ASSERT_TRUE(archive.Compact());
+  EXPECT_LT(archive.GetFileSize(), file_size);
+  EXPECT_EQ(archive.GetEntryCount(), 2u);
+  CheckTextSkData(archive.Load(*MakeTextSkData("A")), "xx");
+  CheckTextSkData(archive.Load(*MakeTextSkData("B")), "y");
+}
+
+TEST(ShaderCacheArchiveTest, TrimsLeastRecentlyUsedEntries) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  const std::string value(1000, 'v');
+  ShaderCacheArchive archive(temp_dir.fd(), false, 4000);
+  ASSERT_TRUE(archive.IsValid());
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("A"), *MakeTextSkData(value)));
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("B"), *MakeTextSkData(value)));
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("C"), *MakeTextSkData(value)));
+  ASSERT_NE(archive.Load(*MakeTextSkData("A")), nullptr);
+
+  // Growing past the maximum size drops B, which was used least recently.
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("D"), *MakeTextSkData(value)));
+  EXPECT_LE(archive.GetFileSize(), archive.GetMaxSize());
+  EXPECT_EQ(archive.Load(*MakeTextSkData("B")), nullptr);
+  EXPECT_NE(archive.Load(*MakeTextSkData("D")), nullptr);
+  EXPECT_NE(archive.Load(*MakeTextSkData("A")), nullptr);
+}
+
+TEST(ShaderCacheArchiveTest, DropsTornAndCorruptRecords) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  size_t intact_size = 0u;
+  {
+    ShaderCacheArchive archive(temp_dir.fd(), false);
+    ASSERT_TRUE(archive.Store(*MakeTextSkData("A"), *MakeTextSkData("x")));
+    ASSERT_TRUE(archive.Store(*MakeTextSkData("B"), *MakeTextSkData("y")));
+    intact_size = archive.GetFileSize();
+    ASSERT_TRUE(archive.Store(*MakeTextSkData("C"), *MakeTextSkData("z")));
+  }
+
+  // Tear the last record and flip the value of the second one.
+  {
+    auto file = fml::OpenFile(temp_dir.fd(), ShaderCacheArchive::kFileName,
+                              false, fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fml::TruncateFile(file, intact_size + 4u));
+    fml::FileMapping mapping(file, {fml::FileMapping::Protection::kRead,
+                                    fml::FileMapping::Protection::kWrite});
+    ASSERT_NE(mapping.GetMutableMapping(), nullptr);
+    mapping.GetMutableMapping()[intact_size - 1] = 'q';
+  }
+
+  ShaderCacheArchive archive(temp_dir.fd(), false);
+  ASSERT_TRUE(archive.IsValid());
+  EXPECT_EQ(archive.GetFileSize(), intact_size);
+  CheckTextSkData(archive.Load(*MakeTextSkData("A")), "x");
+  EXPECT_EQ(archive.Load(*MakeTextSkData("B")), nullptr);
+  EXPECT_EQ(archive.Load(*MakeTextSkData("C")), nullptr);
+
+  // New records are appended after the last intact record.
+  ASSERT_TRUE(archive.Store(*MakeTextSkData("C"), *MakeTextSkData("w")));
+  CheckTextSkData(archive.Load(*MakeTextSkData("C")), "w");
+}
+
+TEST(ShaderCacheArchiveTest, SharesDirectoryWithOtherArchives) {
+  fml::ScopedTemporaryDirectory temp_dir;
+  const std::string value(1000, 'v');
+  ShaderCacheArchive first(temp_dir.fd(), false, 4000);
+  ShaderCacheArchive second(temp_dir.fd(), false, 4000);
+  ASSERT_TRUE(first.IsValid());
+  ASSERT_TRUE(second.IsValid());
+  ASSERT_TRUE(first.Store(*MakeTextSkData("A"), *MakeTextSkData("x")));
+  ASSERT_TRUE(second.Store(*MakeTextSkData("B"), *MakeTextSkData("y")));
+
+  // Each archive appends after the records of the other one.
+  EXPECT_EQ(second.GetEntryCount(), 2u);
+  CheckTextSkData(second.Load(*MakeTextSkData("A")), "x");
+  ASSERT_TRUE(first.Store(*MakeTextSkData("C"), *MakeTextSkData(value)));
+  CheckTextSkData(first.Load(*MakeTextSkData("B")), "y");
+
+  // Compacting replaces the file, so the other archive can keep reading the
+  // file it has mapped until it stores again.
+  ASSERT_TRUE(second.Store({
+      {MakeTextSkData("D"), MakeTextSkData(value)},
+      {MakeTextSkData("E"), MakeTextSkData(value)},
+      {MakeTextSkData("F"), MakeTextSkData(value)},
+  }));
+  EXPECT_LE(second.GetFileSize(), second.GetMaxSize());
+  CheckTextSkData(first.Load(*MakeTextSkData("A")), "x");
+  ASSERT_TRUE(first.Store(*MakeTextSkData("G"), *MakeTextSkData("z")));
+  EXPECT_LE(first.GetFileSize(), first.GetMaxSize());
+  CheckTextSkData(first.Load(*MakeTextSkData("G")), "z");
+  CheckTextSkData(second.Load(*MakeTextSkData("F")), value);
+}
+
+TEST_F(PersistentCacheTest, MovesCacheFilesIntoArchive) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+  auto sksl_dir = fml::CreateDirectory(cache_dir, {"sksl"},
+                                       fml::FilePermission::kReadWrite);
+
+  auto key = MakeTextSkData("A");
+  auto program = PersistentCache::BuildCacheObject(*key, *MakeTextSkData("x"));
+  auto sksl = PersistentCache::BuildCacheObject(*MakeTextSkData("B"),
+                                                *MakeTextSkData("y"));
+  auto file_name = PersistentCache::SkKeyToFilePath(*key);
+  ASSERT_TRUE(fml::WriteAtomically(cache_dir, file_name.c_str(), *program));
+  ASSERT_TRUE(fml::WriteAtomically(sksl_dir, "sksl_file", *sksl));
+  fml::DataMapping skp(std::string("skp"));
+  ASSERT_TRUE(fml::WriteAtomically(cache_dir, "shader_dump_1.skp", skp));
+
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+
+  EXPECT_FALSE(fml::OpenFileReadOnly(cache_dir, file_name.c_str()).is_valid());
+  EXPECT_FALSE(fml::OpenFileReadOnly(sksl_dir, "sksl_file").is_valid());
+  EXPECT_TRUE(fml::OpenFileReadOnly(cache_dir, "shader_dump_1.skp").is_valid());
+
+  CheckTextSkData(persistent_cache->load(*key), "x");
+  auto sksls = persistent_cache->LoadSkSLs();
+  ASSERT_EQ(sksls.size(), 1u);
+  CheckTextSkData(sksls[0].key, "B");
+  CheckTextSkData(sksls[0].value, "y");
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
 }  // namespace testing
 }  // namespace flutter
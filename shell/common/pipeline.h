@@ -5,15 +5,15 @@
 #ifndef FLUTTER_SHELL_COMMON_PIPELINE_H_
 #define FLUTTER_SHELL_COMMON_PIPELINE_H_
 
-#include <deque>
+#include <atomic>
+#include <limits>
 #include <memory>
-#include <mutex>
+#include <thread>
 
 #include "flutter/flow/frame_timings.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
-#include "flutter/fml/synchronization/semaphore.h"
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -24,6 +24,9 @@ struct PipelineProduceResult {
   // Whether it is the first item of the pipeline. Only valid when 'success' is
   // 'true'.
   bool is_first_item = false;
+  // Whether the item took the place of an older item that had not been
+  // consumed yet, which was dropped. Only valid when 'success' is 'true'.
+  bool replaced_item = false;
 };
 
 enum class PipelineConsumeResult {
@@ -34,10 +37,23 @@ enum class PipelineConsumeResult {
   // NOLINTEND(readability-identifier-naming)
 };
 
+/// What |Pipeline::Produce| does once the pipeline is at its maximum depth.
+enum class PipelineFullPolicy {
+  /// No continuation is handed out, so the new resource is never produced.
+  /// The producer has to try again later, and its next resource is queued
+  /// behind the ones that are already waiting.
+  kDropNewest,
+  /// While a resource is waiting to be consumed, a continuation is still
+  /// handed out, and completing it replaces the most recently queued resource
+  /// that hasn't been consumed yet. This keeps the consumer working on the
+  /// freshest resource instead of a backlog of stale ones.
+  kLatestWins,
+};
+
 size_t GetNextPipelineTraceID();
 
-/// A thread-safe queue of resources for a single consumer and a single
-/// producer, with a maximum queue depth.
+/// A thread-safe queue of resources for a single consumer and any number of
+/// producers, with a maximum queue depth.
 ///
 /// Pipelines support two key operations: produce and consume.
 ///
@@ -48,7 +64,14 @@ size_t GetNextPipelineTraceID();
 /// provides a means to enqueue a resource in the pipeline, if the pipeline is
 /// below its maximum depth. When the resource has been prepared, the producer
 /// calls `Complete` on the continuation, which enqueues the resource and
-/// signals the waiting consumer.
+/// signals the waiting consumer. What happens when the pipeline is full is
+/// determined by its |PipelineFullPolicy|.
+///
+/// Resources are queued in a fixed-size ring of slots, each with a sequence
+/// number that hands it between producers and the consumer, so producing,
+/// completing and consuming never take a lock. The only waiting is for a slot
+/// that another thread is in the middle of publishing, replacing or
+/// consuming, which takes a few instructions.
 ///
 /// Pipelines generate the following tracing information:
 /// * PipelineItem: async flow tracking time taken from the time a producer
@@ -128,32 +151,45 @@ class Pipeline {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(
+      uint32_t depth,
+      PipelineFullPolicy full_policy = PipelineFullPolicy::kDropNewest)
+      : depth_(depth),
+        full_policy_(full_policy),
+        slots_(std::make_unique<Slot[]>(depth)) {
+    for (uint32_t i = 0; i < depth_; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
 
   ~Pipeline() = default;
 
-  bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
+  bool IsValid() const { return slots_ != nullptr; }
+
+  PipelineFullPolicy full_policy() const { return full_policy_; }
 
   /// Creates a `ProducerContinuation` that a producer can use to add a
   /// resource to the queue.
   ///
   /// If the queue is already at its maximum depth, the `ProducerContinuation`
-  /// is returned with success = false.
+  /// is returned with success = false, unless the pipeline uses
+  /// |PipelineFullPolicy::kLatestWins| and a resource is waiting to be
+  /// consumed, in which case completing the continuation replaces it.
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
-      return {};
+    if (TryReserveSlot()) {
+      return ProducerContinuation{
+          std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
+                    std::placeholders::_2),  // continuation
+          GetNextPipelineTraceID()};         // trace id
     }
-    ++inflight_;
-    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
-                      reinterpret_cast<int64_t>(this),      //
-                      "frames in flight", inflight_.load()  //
-    );
-
-    return ProducerContinuation{
-        std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
-        GetNextPipelineTraceID()};         // trace id
+    if (full_policy_ == PipelineFullPolicy::kLatestWins && HasQueuedItem()) {
+      return ProducerContinuation{
+          std::bind(&Pipeline::ProducerCommitOrReplace, this,
+                    std::placeholders::_1,
+                    std::placeholders::_2),  // continuation
+          GetNextPipelineTraceID()};         // trace id
+    }
+    return {};
   }
 
   /// Creates a `ProducerContinuation` that will only push the task if the
@@ -162,15 +198,9 @@ class Pipeline {
   /// Prefer using |Produce|. ProducerContinuation returned by this method
   /// doesn't guarantee that the frame will be rendered.
   ProducerContinuation ProduceIfEmpty() {
-    if (!empty_.TryWait()) {
+    if (!TryReserveSlot()) {
       return {};
     }
-    ++inflight_;
-    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
-                      reinterpret_cast<int64_t>(this),      //
-                      "frames in flight", inflight_.load()  //
-    );
-
     return ProducerContinuation{
         std::bind(&Pipeline::ProducerCommitIfEmpty, this, std::placeholders::_1,
                   std::placeholders::_2),  // continuation
@@ -185,71 +215,188 @@ class Pipeline {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    if (!available_.TryWait()) {
+    // Only the consumer advances the dequeue position.
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    if (position == enqueue_position_.load()) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
-    size_t items_count = 0;
-
-    {
-      std::scoped_lock lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
-      queue_.pop_front();
-      items_count = queue_.size();
+    // The slot has been claimed by a producer, but it may not have stored its
+    // resource yet, or a producer may be replacing it.
+    Slot& slot = slots_[position % depth_];
+    size_t expected = position + 1;
+    while (!slot.sequence.compare_exchange_weak(expected, kSlotLocked,
+                                                std::memory_order_acquire)) {
+      expected = position + 1;
+      std::this_thread::yield();
     }
+    ResourcePtr resource = std::move(slot.resource);
+    size_t trace_id = slot.trace_id;
+    dequeue_position_.store(position + 1);
+    slot.sequence.store(position + depth_, std::memory_order_release);
+    // Pairs with the check in |Enqueue|, so that a producer that completes
+    // concurrently with this either sees an empty queue and reports the first
+    // item, or is seen here.
+    bool more_available = enqueue_position_.load() > position + 1;
 
     consumer(std::move(resource));
 
-    empty_.Signal();
-    --inflight_;
+    ReleaseSlot();
 
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
     TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
 
-    return items_count > 0 ? PipelineConsumeResult::MoreAvailable
-                           : PipelineConsumeResult::Done;
+    return more_available ? PipelineConsumeResult::MoreAvailable
+                          : PipelineConsumeResult::Done;
   }
 
  private:
-  fml::Semaphore empty_;
-  fml::Semaphore available_;
-  std::atomic<int> inflight_;
-  std::mutex queue_mutex_;
-  std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  struct Slot {
+    // The position in the queue this slot can next be used for. A slot is
+    // free for the resource at |position| when this is |position|, and holds
+    // that resource once this is |position + 1|. While the consumer or a
+    // replacing producer is accessing the resource, this is |kSlotLocked|.
+    std::atomic<size_t> sequence;
+    ResourcePtr resource;
+    size_t trace_id = 0;
+  };
 
-  /// Commits a produced resource to the queue and signals the consumer that a
-  /// resource is available.
-  PipelineProduceResult ProducerCommit(ResourcePtr resource, size_t trace_id) {
-    bool is_first_item = false;
-    {
-      std::scoped_lock lock(queue_mutex_);
-      is_first_item = queue_.empty();
-      queue_.emplace_back(std::move(resource), trace_id);
+  static constexpr size_t kSlotLocked = std::numeric_limits<size_t>::max();
+
+  const uint32_t depth_;
+  const PipelineFullPolicy full_policy_;
+  std::unique_ptr<Slot[]> slots_;
+  // The number of reserved slots: resources that are being produced, queued
+  // or consumed.
+  std::atomic<uint32_t> inflight_ = 0;
+  // The position the next completed resource is queued at.
+  std::atomic<size_t> enqueue_position_ = 0;
+  // The position of the next resource to consume.
+  std::atomic<size_t> dequeue_position_ = 0;
+
+  bool TryReserveSlot() {
+    uint32_t inflight = inflight_.load(std::memory_order_relaxed);
+    do {
+      if (inflight >= depth_) {
+        return false;
+      }
+    } while (!inflight_.compare_exchange_weak(inflight, inflight + 1,
+                                              std::memory_order_acq_rel));
+    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
+                      reinterpret_cast<int64_t>(this),   //
+                      "frames in flight", inflight + 1  //
+    );
+    return true;
+  }
+
+  void ReleaseSlot() { inflight_.fetch_sub(1, std::memory_order_acq_rel); }
+
+  bool HasQueuedItem() const {
+    return enqueue_position_.load() != dequeue_position_.load();
+  }
+
+  /// Queues |resource| in a reserved slot. If |only_if_empty| is true, the
+  /// resource is only queued if no other resources are waiting.
+  PipelineProduceResult Enqueue(ResourcePtr resource,
+                                size_t trace_id,
+                                bool only_if_empty) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      if (only_if_empty && position != dequeue_position_.load()) {
+        return {.success = false, .is_first_item = false};
+      }
+      // The slot is guaranteed to be free since the producer reserved it, so
+      // this only fails if another producer claimed |position| first.
+      if (enqueue_position_.compare_exchange_weak(position, position + 1)) {
+        break;
+      }
     }
+    bool is_first_item = position == dequeue_position_.load();
 
-    // Ensure the queue mutex is not held as that would be a pessimization.
-    available_.Signal();
+    Slot& slot = slots_[position % depth_];
+    FML_DCHECK(slot.sequence.load(std::memory_order_acquire) == position);
+    slot.resource = std::move(resource);
+    slot.trace_id = trace_id;
+    slot.sequence.store(position + 1, std::memory_order_release);
     return {.success = true, .is_first_item = is_first_item};
   }
 
+  /// Swaps |resource| and |trace_id| with those of the most recently queued
+  /// resource, if it hasn't been consumed yet.
+  bool TryReplaceNewestItem(ResourcePtr& resource, size_t& trace_id) {
+    while (true) {
+      size_t position = enqueue_position_.load();
+      if (position == dequeue_position_.load()) {
+        return false;
+      }
+      Slot& slot = slots_[(position - 1) % depth_];
+      size_t expected = position;
+      if (slot.sequence.compare_exchange_strong(expected, kSlotLocked,
+                                                std::memory_order_acquire)) {
+        if (enqueue_position_.load() != position) {
+          // Another producer queued a resource after |position| was read, so
+          // this one isn't the newest anymore.
+          slot.sequence.store(position, std::memory_order_release);
+          continue;
+        }
+        std::swap(slot.resource, resource);
+        std::swap(slot.trace_id, trace_id);
+        slot.sequence.store(position, std::memory_order_release);
+        return true;
+      }
+      if (expected != kSlotLocked) {
+        // Still being published, or already consumed.
+        return false;
+      }
+      // Being consumed or replaced right now; look again.
+      std::this_thread::yield();
+    }
+  }
+
+  /// Commits a produced resource to the queue and signals the consumer that a
+  /// resource is available.
+  PipelineProduceResult ProducerCommit(ResourcePtr resource, size_t trace_id) {
+    return Enqueue(std::move(resource), trace_id, /*only_if_empty=*/false);
+  }
+
   PipelineProduceResult ProducerCommitIfEmpty(ResourcePtr resource,
                                               size_t trace_id) {
-    {
-      std::scoped_lock lock(queue_mutex_);
-      if (!queue_.empty()) {
-        // Bail if the queue is not empty, opens up spaces to produce other
-        // frames.
-        empty_.Signal();
-        return {.success = false, .is_first_item = false};
-      }
-      queue_.emplace_back(std::move(resource), trace_id);
+    PipelineProduceResult result =
+        Enqueue(std::move(resource), trace_id, /*only_if_empty=*/true);
+    if (!result.success) {
+      // Bail if the queue is not empty, opens up spaces to produce other
+      // frames.
+      ReleaseSlot();
     }
+    return result;
+  }
 
-    // Ensure the queue mutex is not held as that would be a pessimization.
-    available_.Signal();
-    return {.success = true, .is_first_item = true};
+  /// Commits a resource produced without a reserved slot. If a slot has been
+  /// freed up in the meantime it is queued normally, otherwise it replaces the
+  /// newest resource that hasn't been consumed.
+  PipelineProduceResult ProducerCommitOrReplace(ResourcePtr resource,
+                                                size_t trace_id) {
+    if (!resource) {
+      // Dropped continuations must not replace a real resource.
+      return {};
+    }
+    if (TryReserveSlot()) {
+      return Enqueue(std::move(resource), trace_id, /*only_if_empty=*/false);
+    }
+    if (!TryReplaceNewestItem(resource, trace_id)) {
+      // The consumer took the newest resource, which frees up a slot once it
+      // is done.
+      if (TryReserveSlot()) {
+        return Enqueue(std::move(resource), trace_id, /*only_if_empty=*/false);
+      }
+      return {};
+    }
+    // |resource| and |trace_id| now refer to the replaced resource, which is
+    // dropped.
+    TRACE_EVENT_INSTANT0("flutter", "PipelineItemReplaced");
+    TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
+    return {.success = true, .is_first_item = false, .replaced_item = true};
   }
 
   FML_DISALLOW_COPY_AND_ASSIGN(Pipeline);
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr std::chrono::microseconds kVsyncInterval(1000);
+constexpr fml::TimeDelta kBuildTime = fml::TimeDelta::FromMicroseconds(200);
+
+// A frame that remembers when the input it reflects was sampled.
+struct TimedFrame {
+  fml::TimePoint input_time;
+};
+
+using TimedFramePipeline = Pipeline<TimedFrame>;
+
+void BusyWait(fml::TimeDelta duration) {
+  fml::TimePoint end = fml::TimePoint::Now() + duration;
+  while (fml::TimePoint::Now() < end) {
+  }
+}
+
+}  // namespace
+
+// Measures the time from sampling the input of a frame to finishing its
+// rasterization, when the consumer takes |state.range(0)| microseconds per
+// frame and so can't keep up with a producer that builds a frame every vsync.
+static void PipelineInputToPresentLatency(benchmark::State& state,
+                                          PipelineFullPolicy policy) {
+  const fml::TimeDelta raster_time =
+      fml::TimeDelta::FromMicroseconds(state.range(0));
+  auto pipeline = std::make_shared<TimedFramePipeline>(/*depth=*/2, policy);
+
+  std::atomic<bool> running = true;
+  std::thread producer([pipeline, &running]() {
+    auto next_vsync = std::chrono::steady_clock::now();
+    while (running.load()) {
+      next_vsync += kVsyncInterval;
+      std::this_thread::sleep_until(next_vsync);
+      auto continuation = pipeline->Produce();
+      if (!continuation) {
+        // The pipeline is full; skip this vsync like the animator does.
+        continue;
+      }
+      TimedFrame frame = {.input_time = fml::TimePoint::Now()};
+      BusyWait(kBuildTime);
+      PipelineProduceResult result =
+          continuation.Complete(std::make_unique<TimedFrame>(frame));
+      benchmark::DoNotOptimize(result);
+    }
+  });
+
+  double total_latency_us = 0;
+  for (auto _ : state) {
+    PipelineConsumeResult result = PipelineConsumeResult::NoneAvailable;
+    while (result == PipelineConsumeResult::NoneAvailable) {
+      result = pipeline->Consume([&](std::unique_ptr<TimedFrame> frame) {
+        BusyWait(raster_time);
+        total_latency_us +=
+            (fml::TimePoint::Now() - frame->input_time).ToMicrosecondsF();
+      });
+      if (result == PipelineConsumeResult::NoneAvailable) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  running = false;
+  producer.join();
+
+  state.counters["latency_us"] =
+      benchmark::Counter(total_latency_us, benchmark::Counter::kAvgIterations);
+}
+
+static void BM_PipelineLatencyDropNewest(benchmark::State& state) {
+  PipelineInputToPresentLatency(state, PipelineFullPolicy::kDropNewest);
+}
+
+static void BM_PipelineLatencyLatestWins(benchmark::State& state) {
+  PipelineInputToPresentLatency(state, PipelineFullPolicy::kLatestWins);
+}
+
+// Measures the overhead of passing a resource through the pipeline.
+static void BM_PipelineProduceConsume(benchmark::State& state) {
+  auto pipeline = std::make_shared<TimedFramePipeline>(/*depth=*/2);
+  for (auto _ : state) {
+    PipelineProduceResult produce_result = pipeline->Produce().Complete(
+        std::make_unique<TimedFrame>(TimedFrame{}));
+    PipelineConsumeResult consume_result =
+        pipeline->Consume([](std::unique_ptr<TimedFrame> frame) {
+          benchmark::DoNotOptimize(frame);
+        });
+    benchmark::DoNotOptimize(produce_result);
+    benchmark::DoNotOptimize(consume_result);
+  }
+}
+
+BENCHMARK(BM_PipelineLatencyDropNewest)
+    ->RangeMultiplier(2)
+    ->Range(1500, 6000)
+    ->Iterations(100)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PipelineLatencyLatestWins)
+    ->RangeMultiplier(2)
+    ->Range(1500, 6000)
+    ->Iterations(100)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PipelineProduceConsume);
+
+}  // namespace flutter
@@ -6,9 +6,13 @@
 
 #include "flutter/shell/common/pipeline.h"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <future>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -144,5 +148,217 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, LatestWinsReplacesQueuedItemWhenFull) {
+  const int depth = 1;
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(depth, PipelineFullPolicy::kLatestWins);
+
+  Continuation continuation_1 = pipeline->Produce();
+  const int test_val_1 = 1, test_val_2 = 2;
+  PipelineProduceResult result =
+      continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, true);
+  ASSERT_EQ(result.replaced_item, false);
+
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_TRUE(continuation_2);
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, false);
+  ASSERT_EQ(result.replaced_item, true);
+
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      [&test_val_2](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_2); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  consume_result = pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::NoneAvailable);
+}
+
+TEST(PipelineTest, LatestWinsQueuesItemsWhileBelowDepth) {
+  const int depth = 2;
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(depth, PipelineFullPolicy::kLatestWins);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  PipelineProduceResult result =
+      continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.replaced_item, false);
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.replaced_item, false);
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::MoreAvailable);
+  PipelineConsumeResult consume_result_2 = pipeline->Consume(
+      [&test_val_2](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_2); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, LatestWinsCannotProduceWithoutQueuedItem) {
+  const int depth = 1;
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(depth, PipelineFullPolicy::kLatestWins);
+
+  // The only slot is reserved, but nothing is queued yet that could be
+  // replaced.
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1);
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_FALSE(continuation_2);
+}
+
+TEST(PipelineTest, LatestWinsQueuesItemWhenSlotIsFreedBeforeCompletion) {
+  const int depth = 1;
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(depth, PipelineFullPolicy::kLatestWins);
+
+  Continuation continuation_1 = pipeline->Produce();
+  const int test_val_1 = 1, test_val_2 = 2;
+  PipelineProduceResult result =
+      continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result.success, true);
+
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_TRUE(continuation_2);
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result.success, true);
+  ASSERT_EQ(result.is_first_item, true);
+  ASSERT_EQ(result.replaced_item, false);
+
+  PipelineConsumeResult consume_result_2 = pipeline->Consume(
+      [&test_val_2](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_2); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, DropNewestDoesNotReplaceQueuedItem) {
+  const int depth = 1;
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(depth, PipelineFullPolicy::kDropNewest);
+
+  Continuation continuation_1 = pipeline->Produce();
+  PipelineProduceResult result =
+      continuation_1.Complete(std::make_unique<int>(1));
+  ASSERT_EQ(result.success, true);
+
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_FALSE(continuation_2);
+}
+
+TEST(PipelineTest, ConcurrentProducersDeliverEveryItemInOrder) {
+  const int depth = 4;
+  const int producer_count = 4;
+  const int items_per_producer = 1000;
+  std::shared_ptr<IntPipeline> pipeline = std::make_shared<IntPipeline>(depth);
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < producer_count; producer++) {
+    producers.emplace_back([pipeline, producer]() {
+      for (int i = 0; i < items_per_producer;) {
+        Continuation continuation = pipeline->Produce();
+        if (!continuation) {
+          std::this_thread::yield();
+          continue;
+        }
+        PipelineProduceResult result = continuation.Complete(
+            std::make_unique<int>(producer * items_per_producer + i));
+        ASSERT_TRUE(result.success);
+        i++;
+      }
+    });
+  }
+
+  std::vector<int> last_values(producer_count, -1);
+  int consumed = 0;
+  while (consumed < producer_count * items_per_producer) {
+    PipelineConsumeResult result =
+        pipeline->Consume([&](std::unique_ptr<int> v) {
+          int producer = *v / items_per_producer;
+          int value = *v % items_per_producer;
+          EXPECT_EQ(value, last_values[producer] + 1);
+          last_values[producer] = value;
+        });
+    if (result == PipelineConsumeResult::NoneAvailable) {
+      std::this_thread::yield();
+    } else {
+      consumed++;
+    }
+  }
+
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  for (int last_value : last_values) {
+    EXPECT_EQ(last_value, items_per_producer - 1);
+  }
+}
+
+TEST(PipelineTest, LatestWinsConcurrentProducersDeliverNewerItemsInOrder) {
+  const int depth = 2;
+  const int producer_count = 4;
+  const int items_per_producer = 1000;
+  std::shared_ptr<IntPipeline> pipeline =
+      std::make_shared<IntPipeline>(depth, PipelineFullPolicy::kLatestWins);
+
+  std::atomic<int> finished_producers = 0;
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < producer_count; producer++) {
+    producers.emplace_back([pipeline, producer, &finished_producers]() {
+      for (int i = 0; i < items_per_producer;) {
+        Continuation continuation = pipeline->Produce();
+        if (!continuation) {
+          std::this_thread::yield();
+          continue;
+        }
+        // Items can be dropped in favor of newer ones, but an item can only
+        // fail to be queued if there was nothing left to replace.
+        PipelineProduceResult result = continuation.Complete(
+            std::make_unique<int>(producer * items_per_producer + i));
+        if (result.success) {
+          i++;
+        }
+      }
+      finished_producers++;
+    });
+  }
+
+  std::vector<int> last_values(producer_count, -1);
+  while (true) {
+    bool producers_done = finished_producers.load() == producer_count;
+    PipelineConsumeResult result =
+        pipeline->Consume([&](std::unique_ptr<int> v) {
+          int producer = *v / items_per_producer;
+          int value = *v % items_per_producer;
+          EXPECT_GT(value, last_values[producer]);
+          last_values[producer] = value;
+        });
+    if (result == PipelineConsumeResult::NoneAvailable) {
+      if (producers_done) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  // The last item of every producer is never replaced by one of its own.
+  // Items from other producers may still replace it, so only check that the
+  // most recently queued item made it through.
+  EXPECT_TRUE(std::find(last_values.begin(), last_values.end(),
+                        items_per_producer - 1) != last_values.end());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -5,7 +5,10 @@
 #include "flutter/shell/common/rasterizer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 #include "flow/frame_timings.h"
@@ -603,6 +606,15 @@ std::unique_ptr<FrameItem> Rasterizer::DrawToSurfacesUnsafe(
 
   frame_timings_recorder.RecordRasterStart(fml::TimePoint::Now());
 
+  // Layer trees that are drawn without the raster cache can be prerolled and
+  // painted off the raster thread. The frames are still acquired and
+  // submitted below, on the raster thread and in order.
+  if (tasks.size() > 1 &&
+      delegate_.GetSettings().enable_concurrent_view_rasterization &&
+      !surface_->EnableRasterCache()) {
+    RecordLayerTreesConcurrently(tasks);
+  }
+
   // Second traverse: draw all layer trees.
   std::vector<std::unique_ptr<LayerTreeTask>> resubmitted_tasks;
   for (std::unique_ptr<LayerTreeTask>& task : tasks) {
@@ -711,6 +723,9 @@ DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
         damage->SetClipAlignment(
             frame->framebuffer_info().horizontal_clip_alignment,
             frame->framebuffer_info().vertical_clip_alignment);
+        DamageMergePolicy merge_policy;
+        merge_policy.max_rects = frame->framebuffer_info().max_damage_rects;
+        damage->SetDamageMergePolicy(merge_policy);
       }
     }
 
@@ -734,6 +749,8 @@ DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
     if (damage) {
       submit_info.frame_damage = damage->GetFrameDamage();
       submit_info.buffer_damage = damage->GetBufferDamage();
+      submit_info.frame_damage_rects = damage->GetFrameDamageRects();
+      submit_info.buffer_damage_rects = damage->GetBufferDamageRects();
     }
 
     frame->set_submit_info(submit_info);
@@ -764,6 +781,77 @@ DrawSurfaceStatus Rasterizer::DrawToSurfaceUnsafe(
   return DrawSurfaceStatus::kFailed;
 }
 
+namespace {
+
+// The layer trees of a frame that are being recorded, shared between the
+// raster thread and the worker tasks.
+struct LayerTreeRecordingState {
+  explicit LayerTreeRecordingState(std::vector<LayerTree*> trees)
+      : layer_trees(std::move(trees)), remaining(layer_trees.size()) {}
+
+  const std::vector<LayerTree*> layer_trees;
+  std::atomic_size_t next_index = 0u;
+  std::atomic_size_t remaining;
+  std::mutex mutex;
+  std::condition_variable done;
+};
+
+// Records layer trees until there are none left to claim.
+void RecordClaimedLayerTrees(LayerTreeRecordingState& state) {
+  while (true) {
+    size_t index = state.next_index.fetch_add(1u);
+    if (index >= state.layer_trees.size()) {
+      return;
+    }
+    state.layer_trees[index]->Record();
+    if (state.remaining.fetch_sub(1u) == 1u) {
+      std::scoped_lock lock(state.mutex);
+      state.done.notify_all();
+    }
+  }
+}
+
+}  // namespace
+
+void Rasterizer::RecordLayerTreesConcurrently(
+    const std::vector<std::unique_ptr<LayerTreeTask>>& tasks) {
+  TRACE_EVENT0("flutter", "Rasterizer::RecordLayerTreesConcurrently");
+  auto worker_task_runner = delegate_.GetConcurrentWorkerTaskRunner();
+  if (!worker_task_runner) {
+    return;
+  }
+
+  std::vector<LayerTree*> layer_trees;
+  layer_trees.reserve(tasks.size());
+  for (const std::unique_ptr<LayerTreeTask>& task : tasks) {
+    layer_trees.push_back(task->layer_tree.get());
+  }
+
+  // Layers that are part of several layer trees would be prerolled on more
+  // than one thread at once, so those layer trees are recorded in turn.
+  if (LayerTree::ShareLayers(layer_trees)) {
+    for (LayerTree* layer_tree : layer_trees) {
+      layer_tree->Record();
+    }
+    return;
+  }
+
+  auto state =
+      std::make_shared<LayerTreeRecordingState>(std::move(layer_trees));
+
+  // The raster thread records a share of the layer trees itself. The worker
+  // tasks hold on to the state, as they may only start after all layer trees
+  // have been claimed.
+  for (size_t i = 1; i < tasks.size(); i++) {
+    worker_task_runner->PostTask(
+        [state]() { RecordClaimedLayerTrees(*state); });
+  }
+  RecordClaimedLayerTrees(*state);
+
+  std::unique_lock lock(state->mutex);
+  state->done.wait(lock, [&state]() { return state->remaining == 0u; });
+}
+
 Rasterizer::ViewRecord& Rasterizer::EnsureViewRecord(int64_t view_id) {
   return view_records_[view_id];
 }
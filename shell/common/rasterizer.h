@@ -18,6 +18,7 @@
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "flutter/fml/synchronization/sync_switch.h"
@@ -171,6 +172,12 @@ class Rasterizer final : public SnapshotDelegate,
 
     virtual bool ShouldDiscardLayerTree(int64_t view_id,
                                         const flutter::LayerTree& tree) = 0;
+
+    /// The task runner for the concurrent worker threads, if any.
+    ///
+    /// See: `Settings::enable_concurrent_view_rasterization`.
+    virtual const std::shared_ptr<fml::ConcurrentTaskRunner>
+    GetConcurrentWorkerTaskRunner() const = 0;
   };
 
   //----------------------------------------------------------------------------
@@ -706,6 +713,14 @@ class Rasterizer final : public SnapshotDelegate,
       float device_pixel_ratio,
       std::optional<fml::TimePoint> presentation_time);
 
+  // Records the layer trees of the tasks on the concurrent worker threads
+  // together with the raster thread, so that drawing them doesn't need to
+  // preroll and paint the layers.
+  //
+  // See `Settings::enable_concurrent_view_rasterization`.
+  void RecordLayerTreesConcurrently(
+      const std::vector<std::unique_ptr<LayerTreeTask>>& tasks);
+
   ViewRecord& EnsureViewRecord(int64_t view_id);
 
   void FireNextFrameCallbackIfPresent();
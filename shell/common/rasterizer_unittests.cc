@@ -10,6 +10,8 @@
 #include <optional>
 
 #include "flutter/flow/frame_timings.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/thread_host.h"
@@ -66,6 +68,10 @@ class MockDelegate : public Rasterizer::Delegate {
               ShouldDiscardLayerTree,
               (int64_t, const flutter::LayerTree&),
               (override));
+  MOCK_METHOD(const std::shared_ptr<fml::ConcurrentTaskRunner>,
+              GetConcurrentWorkerTaskRunner,
+              (),
+              (const, override));
 };
 
 class MockSurface : public Surface {
@@ -85,6 +91,11 @@ class MockSurface : public Surface {
   MOCK_METHOD(bool, AllowsDrawingWhenGpuDisabled, (), (const, override));
 };
 
+class MockSurfaceWithoutRasterCache : public MockSurface {
+ public:
+  bool EnableRasterCache() const override { return false; }
+};
+
 class MockExternalViewEmbedder : public ExternalViewEmbedder {
  public:
   MOCK_METHOD(DlCanvas*, GetRootCanvas, (), (override));
@@ -732,6 +743,147 @@ TEST(RasterizerTest, drawMultipleViewsWithExternalViewEmbedder) {
   latch.Wait();
 }
 
+TEST(RasterizerTest, drawMultipleViewsRecordsLayerTreesConcurrently) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::kPlatform |
+                             ThreadHost::Type::kRaster | ThreadHost::Type::kIo |
+                             ThreadHost::Type::kUi);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto worker_loop = fml::ConcurrentMessageLoop::Create(2);
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner =
+      worker_loop->GetTaskRunner();
+  NiceMock<MockDelegate> delegate;
+  Settings settings;
+  settings.enable_concurrent_view_rasterization = true;
+  ON_CALL(delegate, GetSettings()).WillByDefault(ReturnRef(settings));
+  ON_CALL(delegate, GetConcurrentWorkerTaskRunner())
+      .WillByDefault(Return(worker_task_runner));
+  EXPECT_CALL(delegate, GetTaskRunners())
+      .WillRepeatedly(ReturnRef(task_runners));
+  EXPECT_CALL(delegate, OnFrameRasterized(_));
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+  auto surface = std::make_unique<NiceMock<MockSurfaceWithoutRasterCache>>();
+  EXPECT_CALL(*surface, AllowsDrawingWhenGpuDisabled()).WillOnce(Return(true));
+  EXPECT_CALL(*surface, AcquireFrame(SkISize())).Times(3);
+  ON_CALL(*surface, AcquireFrame).WillByDefault([](const SkISize& size) {
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.supports_readback = true;
+    return std::make_unique<SurfaceFrame>(
+        /*surface=*/
+        nullptr, framebuffer_info,
+        /*submit_callback=*/[](const SurfaceFrame&, DlCanvas*) { return true; },
+        /*frame_size=*/SkISize::Make(800, 600));
+  });
+  EXPECT_CALL(*surface, MakeRenderContextCurrent())
+      .WillOnce(Return(ByMove(std::make_unique<GLContextDefaultResult>(true))));
+
+  rasterizer->Setup(std::move(surface));
+  fml::AutoResetWaitableEvent latch;
+  thread_host.raster_thread->GetTaskRunner()->PostTask([&] {
+    auto pipeline = std::make_shared<FramePipeline>(/*depth=*/10);
+    std::vector<std::unique_ptr<LayerTreeTask>> tasks;
+    for (int64_t view_id = 0; view_id < 3; view_id++) {
+      auto layer_tree = std::make_unique<LayerTree>(
+          LayerTree::Config{.root_layer = std::make_shared<ContainerLayer>()},
+          SkISize());
+      tasks.push_back(std::make_unique<LayerTreeTask>(
+          view_id, std::move(layer_tree), kDevicePixelRatio));
+    }
+    auto layer_tree_item = std::make_unique<FrameItem>(
+        std::move(tasks), CreateFinishedBuildRecorder());
+    PipelineProduceResult result =
+        pipeline->Produce().Complete(std::move(layer_tree_item));
+    EXPECT_TRUE(result.success);
+    ON_CALL(delegate, ShouldDiscardLayerTree).WillByDefault(Return(false));
+    rasterizer->Draw(pipeline);
+    for (int64_t view_id = 0; view_id < 3; view_id++) {
+      EXPECT_EQ(rasterizer->GetLastDrawStatus(view_id),
+                DrawSurfaceStatus::kSuccess);
+      ASSERT_NE(rasterizer->GetLastLayerTree(view_id), nullptr);
+      EXPECT_TRUE(rasterizer->GetLastLayerTree(view_id)->is_recorded());
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+TEST(RasterizerTest, drawMultipleViewsRecordsLayerTreesSharingLayers) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::kPlatform |
+                             ThreadHost::Type::kRaster | ThreadHost::Type::kIo |
+                             ThreadHost::Type::kUi);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto worker_loop = fml::ConcurrentMessageLoop::Create(2);
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner =
+      worker_loop->GetTaskRunner();
+  NiceMock<MockDelegate> delegate;
+  Settings settings;
+  settings.enable_concurrent_view_rasterization = true;
+  ON_CALL(delegate, GetSettings()).WillByDefault(ReturnRef(settings));
+  ON_CALL(delegate, GetConcurrentWorkerTaskRunner())
+      .WillByDefault(Return(worker_task_runner));
+  EXPECT_CALL(delegate, GetTaskRunners())
+      .WillRepeatedly(ReturnRef(task_runners));
+  EXPECT_CALL(delegate, OnFrameRasterized(_));
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+  auto surface = std::make_unique<NiceMock<MockSurfaceWithoutRasterCache>>();
+  EXPECT_CALL(*surface, AllowsDrawingWhenGpuDisabled()).WillOnce(Return(true));
+  EXPECT_CALL(*surface, AcquireFrame(SkISize())).Times(3);
+  ON_CALL(*surface, AcquireFrame).WillByDefault([](const SkISize& size) {
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.supports_readback = true;
+    return std::make_unique<SurfaceFrame>(
+        /*surface=*/
+        nullptr, framebuffer_info,
+        /*submit_callback=*/[](const SurfaceFrame&, DlCanvas*) { return true; },
+        /*frame_size=*/SkISize::Make(800, 600));
+  });
+  EXPECT_CALL(*surface, MakeRenderContextCurrent())
+      .WillOnce(Return(ByMove(std::make_unique<GLContextDefaultResult>(true))));
+
+  rasterizer->Setup(std::move(surface));
+  fml::AutoResetWaitableEvent latch;
+  thread_host.raster_thread->GetTaskRunner()->PostTask([&] {
+    auto pipeline = std::make_shared<FramePipeline>(/*depth=*/10);
+    std::vector<std::unique_ptr<LayerTreeTask>> tasks;
+    // The layer is retained in the scenes of all views.
+    auto retained_layer = std::make_shared<ContainerLayer>();
+    for (int64_t view_id = 0; view_id < 3; view_id++) {
+      auto root_layer = std::make_shared<ContainerLayer>();
+      root_layer->Add(retained_layer);
+      auto layer_tree = std::make_unique<LayerTree>(
+          LayerTree::Config{.root_layer = root_layer}, SkISize());
+      tasks.push_back(std::make_unique<LayerTreeTask>(
+          view_id, std::move(layer_tree), kDevicePixelRatio));
+    }
+    auto layer_tree_item = std::make_unique<FrameItem>(
+        std::move(tasks), CreateFinishedBuildRecorder());
+    PipelineProduceResult result =
+        pipeline->Produce().Complete(std::move(layer_tree_item));
+    EXPECT_TRUE(result.success);
+    ON_CALL(delegate, ShouldDiscardLayerTree).WillByDefault(Return(false));
+    rasterizer->Draw(pipeline);
+    for (int64_t view_id = 0; view_id < 3; view_id++) {
+      EXPECT_EQ(rasterizer->GetLastDrawStatus(view_id),
+                DrawSurfaceStatus::kSuccess);
+      ASSERT_NE(rasterizer->GetLastLayerTree(view_id), nullptr);
+      EXPECT_TRUE(rasterizer->GetLastLayerTree(view_id)->is_recorded());
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 TEST(RasterizerTest,
      drawWithGpuEnabledAndSurfaceAllowsDrawingWhenGpuDisabledDoesAcquireFrame) {
   std::string test_name =
@@ -8,6 +8,7 @@
 #include <utility>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
@@ -16,6 +17,21 @@
 
 namespace flutter {
 
+// Adds the assets in the directory, resolving those packed into a bundle file
+// in the directory, if there is one, from the bundle.
+static void PushBackAssetDirectory(AssetManager& asset_manager,
+                                   fml::UniqueFD directory) {
+  // The bundle is built from the directory, so once the asset manager
+  // changes, the loose files there may be newer than the bundle.
+  if (auto bundle = fml::FileMapping::CreateReadOnly(
+          directory, PackedAssetBundle::kFileName)) {
+    asset_manager.PushBack(std::make_unique<PackedAssetBundle>(
+        std::move(bundle), false, fml::Duplicate(directory.get())));
+  }
+  asset_manager.PushBack(
+      std::make_unique<DirectoryAssetBundle>(std::move(directory), true));
+}
+
 RunConfiguration RunConfiguration::InferFromSettings(
     const Settings& settings,
     const fml::RefPtr<fml::TaskRunner>& io_worker,
@@ -23,14 +39,13 @@ RunConfiguration RunConfiguration::InferFromSettings(
   auto asset_manager = std::make_shared<AssetManager>();
 
   if (fml::UniqueFD::traits_type::IsValid(settings.assets_dir)) {
-    asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-        fml::Duplicate(settings.assets_dir), true));
+    PushBackAssetDirectory(*asset_manager,
+                           fml::Duplicate(settings.assets_dir));
   }
 
-  asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-      fml::OpenDirectory(settings.assets_path.c_str(), false,
-                         fml::FilePermission::kRead),
-      true));
+  PushBackAssetDirectory(*asset_manager,
+                         fml::OpenDirectory(settings.assets_path.c_str(),
+                                            false, fml::FilePermission::kRead));
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker, launch_type),
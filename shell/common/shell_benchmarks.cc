@@ -5,8 +5,16 @@
 #include "flutter/shell/common/shell.h"
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/display_list/dl_builder.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/display_list_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
@@ -120,4 +128,217 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+namespace {
+
+class BenchmarkRasterizerDelegate : public Rasterizer::Delegate {
+ public:
+  BenchmarkRasterizerDelegate(
+      const TaskRunners& task_runners,
+      const Settings& settings,
+      std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
+      : task_runners_(task_runners),
+        settings_(settings),
+        worker_task_runner_(std::move(worker_task_runner)),
+        is_gpu_disabled_sync_switch_(std::make_shared<fml::SyncSwitch>()) {}
+
+  // |Rasterizer::Delegate|
+  void OnFrameRasterized(const FrameTiming& frame_timing) override {}
+
+  // |Rasterizer::Delegate|
+  fml::Milliseconds GetFrameBudget() override {
+    return fml::Milliseconds(1000.0 / 60.0);
+  }
+
+  // |Rasterizer::Delegate|
+  fml::TimePoint GetLatestFrameTargetTime() const override {
+    return fml::TimePoint::Now();
+  }
+
+  // |Rasterizer::Delegate|
+  const TaskRunners& GetTaskRunners() const override { return task_runners_; }
+
+  // |Rasterizer::Delegate|
+  const fml::RefPtr<fml::RasterThreadMerger> GetParentRasterThreadMerger()
+      const override {
+    return nullptr;
+  }
+
+  // |Rasterizer::Delegate|
+  std::shared_ptr<const fml::SyncSwitch> GetIsGpuDisabledSyncSwitch()
+      const override {
+    return is_gpu_disabled_sync_switch_;
+  }
+
+  // |Rasterizer::Delegate|
+  const Settings& GetSettings() const override { return settings_; }
+
+  // |Rasterizer::Delegate|
+  bool ShouldDiscardLayerTree(int64_t view_id,
+                              const flutter::LayerTree& tree) override {
+    return false;
+  }
+
+  // |Rasterizer::Delegate|
+  const std::shared_ptr<fml::ConcurrentTaskRunner>
+  GetConcurrentWorkerTaskRunner() const override {
+    return worker_task_runner_;
+  }
+
+ private:
+  const TaskRunners& task_runners_;
+  const Settings& settings_;
+  const std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
+  const std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch_;
+};
+
+/// A surface whose frames record into display lists, so that drawing layer
+/// trees measures the work of the rasterizer rather than of a GPU.
+class BenchmarkSurface : public Surface {
+ public:
+  // |Surface|
+  bool IsValid() override { return true; }
+
+  // |Surface|
+  std::unique_ptr<SurfaceFrame> AcquireFrame(const SkISize& size) override {
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.supports_readback = true;
+    return std::make_unique<SurfaceFrame>(
+        /*surface=*/nullptr, framebuffer_info,
+        /*submit_callback=*/[](const SurfaceFrame&, DlCanvas*) { return true; },
+        /*frame_size=*/size, /*context_result=*/nullptr,
+        /*display_list_fallback=*/true);
+  }
+
+  // |Surface|
+  SkMatrix GetRootTransformation() const override { return SkMatrix::I(); }
+
+  // |Surface|
+  GrDirectContext* GetContext() override { return nullptr; }
+
+  // |Surface|
+  bool EnableRasterCache() const override { return false; }
+};
+
+constexpr int kTileRows = 16;
+constexpr int kTileColumns = 16;
+constexpr SkScalar kTileSize = 64;
+
+/// Builds the layer tree of a view, a grid of transformed, translucent and
+/// clipped tiles.
+std::unique_ptr<LayerTree> MakeViewLayerTree(
+    const sk_sp<DisplayList>& tile_display_list) {
+  auto root = std::make_shared<ContainerLayer>();
+  for (int row = 0; row < kTileRows; row++) {
+    for (int column = 0; column < kTileColumns; column++) {
+      auto transform = std::make_shared<TransformLayer>(
+          SkMatrix::Translate(column * kTileSize, row * kTileSize));
+      auto opacity = std::make_shared<OpacityLayer>(128, SkPoint::Make(0, 0));
+      auto clip = std::make_shared<ClipRectLayer>(
+          SkRect::MakeWH(kTileSize, kTileSize), Clip::kHardEdge);
+      clip->Add(std::make_shared<DisplayListLayer>(
+          SkPoint::Make(0, 0), tile_display_list, /*is_complex=*/false,
+          /*will_change=*/false));
+      opacity->Add(clip);
+      transform->Add(opacity);
+      root->Add(transform);
+    }
+  }
+  return std::make_unique<LayerTree>(
+      LayerTree::Config{.root_layer = root},
+      SkISize::Make(kTileColumns * kTileSize, kTileRows * kTileSize));
+}
+
+void RunOnTaskRunner(const fml::RefPtr<fml::TaskRunner>& task_runner,
+                     const fml::closure& task) {
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(task_runner, [&task, &latch]() {
+    task();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+}  // namespace
+
+/// Draws frames of |state.range(0)| views, each with its own layer tree, with
+/// the layer trees recorded concurrently or not.
+static void DrawMultipleViews(benchmark::State& state, bool concurrent) {
+  const int64_t view_count = state.range(0);
+  ThreadHost thread_host(ThreadHost::ThreadHostConfig(
+      "io.flutter.bench.",
+      ThreadHost::Type::kPlatform | ThreadHost::Type::kRaster |
+          ThreadHost::Type::kIo | ThreadHost::Type::kUi));
+  TaskRunners task_runners("test",
+                           thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto worker_loop = fml::ConcurrentMessageLoop::Create();
+  Settings settings;
+  settings.enable_concurrent_view_rasterization = concurrent;
+  BenchmarkRasterizerDelegate delegate(task_runners, settings,
+                                       worker_loop->GetTaskRunner());
+  const auto& raster_task_runner = task_runners.GetRasterTaskRunner();
+
+  std::unique_ptr<Rasterizer> rasterizer;
+  RunOnTaskRunner(raster_task_runner, [&]() {
+    rasterizer = std::make_unique<Rasterizer>(delegate);
+    rasterizer->Setup(std::make_unique<BenchmarkSurface>());
+  });
+
+  DisplayListBuilder tile_builder;
+  for (int i = 0; i < 4; i++) {
+    tile_builder.DrawRect(SkRect::MakeXYWH(i * 8, i * 8, 32, 32),
+                          DlPaint(DlColor::kBlue()));
+  }
+  sk_sp<DisplayList> tile_display_list = tile_builder.Build();
+
+  auto pipeline = std::make_shared<FramePipeline>(/*depth=*/2);
+  while (state.KeepRunning()) {
+    {
+      benchmarking::ScopedPauseTiming pause(state);
+      std::vector<std::unique_ptr<LayerTreeTask>> tasks;
+      for (int64_t view_id = 0; view_id < view_count; view_id++) {
+        tasks.push_back(std::make_unique<LayerTreeTask>(
+            view_id, MakeViewLayerTree(tile_display_list),
+            /*device_pixel_ratio=*/1.0f));
+      }
+      auto recorder = std::make_unique<FrameTimingsRecorder>();
+      const auto now = fml::TimePoint::Now();
+      recorder->RecordVsync(now, now);
+      recorder->RecordBuildStart(now);
+      recorder->RecordBuildEnd(now);
+      PipelineProduceResult result = pipeline->Produce().Complete(
+          std::make_unique<FrameItem>(std::move(tasks), std::move(recorder)));
+      FML_CHECK(result.success);
+    }
+    RunOnTaskRunner(raster_task_runner,
+                    [&]() { rasterizer->Draw(pipeline); });
+  }
+
+  RunOnTaskRunner(raster_task_runner, [&]() {
+    rasterizer->Teardown();
+    rasterizer.reset();
+  });
+  state.SetItemsProcessed(state.iterations() * view_count);
+}
+
+static void BM_RasterizerDrawMultipleViews(benchmark::State& state) {
+  DrawMultipleViews(state, /*concurrent=*/false);
+}
+
+static void BM_RasterizerDrawMultipleViewsConcurrently(
+    benchmark::State& state) {
+  DrawMultipleViews(state, /*concurrent=*/true);
+}
+
+BENCHMARK(BM_RasterizerDrawMultipleViews)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RasterizerDrawMultipleViewsConcurrently)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
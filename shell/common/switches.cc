@@ -356,6 +356,9 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   command_line.GetOptionValue(FlagForSwitch(Switch::TraceToFile),
                               &settings.trace_to_file);
 
+  command_line.GetOptionValue(FlagForSwitch(Switch::TraceToRecorder),
+                              &settings.trace_to_recorder);
+
   settings.skia_deterministic_rendering_on_cpu =
       command_line.HasOption(FlagForSwitch(Switch::SkiaDeterministicRendering));
 
@@ -468,6 +471,14 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
       command_line.HasOption(FlagForSwitch(Switch::EnableVulkanValidation));
   settings.enable_opengl_gpu_tracing =
       command_line.HasOption(FlagForSwitch(Switch::EnableOpenGLGPUTracing));
+  settings.enable_concurrent_view_rasterization = command_line.HasOption(
+      FlagForSwitch(Switch::EnableConcurrentViewRasterization));
+
+  settings.enable_frame_pipeline_latest_wins = command_line.HasOption(
+      FlagForSwitch(Switch::EnableFramePipelineLatestWins));
+
+  settings.enable_tiled_software_rasterization = command_line.HasOption(
+      FlagForSwitch(Switch::EnableTiledSoftwareRasterization));
 
   settings.enable_embedder_api =
       command_line.HasOption(FlagForSwitch(Switch::EnableEmbedderAPI));
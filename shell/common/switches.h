@@ -202,6 +202,14 @@ DEF_SWITCH(TraceToFile,
            "Write the timeline trace to a file at the specified path. The file "
            "will be in Perfetto's proto format; it will be possible to load "
            "the file into Perfetto's trace viewer.")
+DEF_SWITCH(TraceToRecorder,
+           "trace-to-recorder",
+           "Record trace events into in-process per-thread ring buffers "
+           "instead of the Dart timeline, and write them to the file at the "
+           "specified path when the Dart VM shuts down. Paths ending in .json "
+           "are written in the Chrome trace event format, all others in "
+           "Perfetto's proto format. This works without the VM service, for "
+           "instance in headless embedder runs.")
 DEF_SWITCH(UseTestFonts,
            "use-test-fonts",
            "Running tests that layout and measure text will not yield "
@@ -275,6 +283,20 @@ DEF_SWITCH(EnableVulkanValidation,
            "Enable loading Vulkan validation layers. The layers must be "
            "available to the application and loadable. On non-Vulkan backends, "
            "this flag does nothing.")
+DEF_SWITCH(EnableConcurrentViewRasterization,
+           "enable-concurrent-view-rasterization",
+           "Record the layer trees of multiple views concurrently on the "
+           "worker threads. Only applies to views drawn without the raster "
+           "cache, such as with Impeller.")
+DEF_SWITCH(EnableFramePipelineLatestWins,
+           "enable-frame-pipeline-latest-wins",
+           "When the raster thread falls behind, replace the newest frame "
+           "that is waiting to be rasterized with the next one instead of "
+           "skipping the next one.")
+DEF_SWITCH(EnableTiledSoftwareRasterization,
+           "enable-tiled-software-rasterization",
+           "Split frames of the software renderer into bands that are "
+           "rasterized in parallel on the worker threads.")
 DEF_SWITCH(EnableOpenGLGPUTracing,
            "enable-opengl-gpu-tracing",
            "Enable tracing of GPU execution time when using the Impeller "
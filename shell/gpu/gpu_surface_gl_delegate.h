@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 
 #include <optional>
+#include <vector>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/embedded_views.h"
@@ -46,6 +47,14 @@ struct GLPresentInfo {
   // The buffer damage refers to the region that needs to be set as damaged
   // within the frame buffer.
   const std::optional<SkIRect>& buffer_damage;
+
+  // Disjoint rectangles covering frame_damage. If empty, frame_damage should
+  // be used as a single damage rectangle.
+  std::vector<SkIRect> frame_damage_rects = {};
+
+  // Disjoint rectangles covering buffer_damage. If empty, buffer_damage
+  // should be used as a single damage rectangle.
+  std::vector<SkIRect> buffer_damage_rects = {};
 };
 
 class GPUSurfaceGLDelegate {
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/gpu/gpu_surface_gl_impeller.h"
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/make_copyable.h"
 #include "impeller/display_list/dl_dispatcher.h"
 #include "impeller/renderer/backend/gles/surface_gles.h"
@@ -35,6 +36,9 @@ GPUSurfaceGLImpeller::GPUSurfaceGLImpeller(
   if (!aiks_context->IsValid()) {
     return;
   }
+  aiks_context->GetContentContext().SetPipelineVariantManifest(
+      std::make_shared<impeller::PipelineVariantManifest>(
+          PersistentCache::GetCacheForProcess()->OpenImpellerCacheDirectory()));
 
   delegate_ = delegate;
   impeller_context_ = std::move(context);
@@ -281,6 +281,8 @@ bool GPUSurfaceGLSkia::PresentSurface(const SurfaceFrame& frame,
       .frame_damage = frame.submit_info().frame_damage,
       .presentation_time = frame.submit_info().presentation_time,
       .buffer_damage = frame.submit_info().buffer_damage,
+      .frame_damage_rects = frame.submit_info().frame_damage_rects,
+      .buffer_damage_rects = frame.submit_info().buffer_damage_rects,
   };
   if (!delegate_->GLContextPresent(present_info)) {
     return false;
@@ -7,6 +7,7 @@
 #import <Metal/Metal.h>
 #import <QuartzCore/QuartzCore.h>
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/common/settings.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/mapping.h"
@@ -45,6 +46,11 @@ GPUSurfaceMetalImpeller::GPUSurfaceMetalImpeller(GPUSurfaceMetalDelegate* delega
   if (disablePartialRepaint != nil) {
     disable_partial_repaint_ = disablePartialRepaint.boolValue;
   }
+  if (IsValid()) {
+    aiks_context_->GetContentContext().SetPipelineVariantManifest(
+        std::make_shared<impeller::PipelineVariantManifest>(
+            PersistentCache::GetCacheForProcess()->OpenImpellerCacheDirectory()));
+  }
 }
 
 GPUSurfaceMetalImpeller::~GPUSurfaceMetalImpeller() = default;
@@ -12,10 +12,25 @@
 
 namespace flutter {
 
-GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                                       bool render_to_surface)
+namespace {
+
+SoftwarePresentInfo GetPresentInfo(const SurfaceFrame& surface_frame) {
+  const SurfaceFrame::SubmitInfo& submit_info = surface_frame.submit_info();
+  return {
+      .frame_damage = submit_info.frame_damage,
+      .frame_damage_rects = submit_info.frame_damage_rects,
+  };
+}
+
+}  // namespace
+
+GPUSurfaceSoftware::GPUSurfaceSoftware(
+    GPUSurfaceSoftwareDelegate* delegate,
+    bool render_to_surface,
+    std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer)
     : delegate_(delegate),
       render_to_surface_(render_to_surface),
+      tiled_rasterizer_(std::move(tiled_rasterizer)),
       weak_factory_(this) {}
 
 GPUSurfaceSoftware::~GPUSurfaceSoftware() = default;
@@ -58,6 +73,13 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     return nullptr;
   }
 
+  framebuffer_info = delegate_->GetBackingStoreInfo();
+
+  if (tiled_rasterizer_) {
+    return AcquireTiledFrame(std::move(backing_store), framebuffer_info,
+                             logical_size);
+  }
+
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
@@ -74,13 +96,45 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->Flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    return self->delegate_->PresentBackingStoreWithInfo(
+        surface_frame.SkiaSurface(), GetPresentInfo(surface_frame));
   };
 
   return std::make_unique<SurfaceFrame>(backing_store, framebuffer_info,
                                         on_submit, logical_size);
 }
 
+std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireTiledFrame(
+    sk_sp<SkSurface> backing_store,
+    const SurfaceFrame::FramebufferInfo& framebuffer_info,
+    const SkISize& logical_size) {
+  SurfaceFrame::SubmitCallback on_submit =
+      [self = weak_factory_.GetWeakPtr(), backing_store](
+          SurfaceFrame& surface_frame, DlCanvas* canvas) -> bool {
+    // If the surface itself went away, there is nothing more to do.
+    if (!self || !self->IsValid() || canvas == nullptr) {
+      return false;
+    }
+
+    sk_sp<DisplayList> display_list = surface_frame.BuildDisplayList();
+    if (!display_list ||
+        self->tiled_rasterizer_->Rasterize(display_list,
+                                           backing_store.get()) == 0) {
+      return false;
+    }
+
+    return self->delegate_->PresentBackingStoreWithInfo(
+        backing_store, GetPresentInfo(surface_frame));
+  };
+
+  // The frame is recorded with an RTree so that each band only replays the
+  // ops that touch it.
+  return std::make_unique<SurfaceFrame>(
+      nullptr, framebuffer_info, on_submit, logical_size,
+      /*context_result=*/nullptr, /*display_list_fallback=*/true,
+      /*prepare_rtree=*/true);
+}
+
 // |Surface|
 SkMatrix GPUSurfaceSoftware::GetRootTransformation() const {
   // This backend does not currently support root surface transformations. Just
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_H_
 
+#include "flutter/display_list/skia/dl_sk_tiled_rasterizer.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
@@ -14,8 +15,23 @@ namespace flutter {
 
 class GPUSurfaceSoftware : public Surface {
  public:
-  GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate,
-                     bool render_to_surface);
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a surface that renders into the raster backing stores
+  ///             of |delegate|.
+  ///
+  /// @param[in]  delegate           The platform surface.
+  /// @param[in]  render_to_surface  Whether frames are rendered into the
+  ///                                backing store at all, see below.
+  /// @param[in]  tiled_rasterizer   If not null, frames are recorded into a
+  ///                                DisplayList and rasterized into the
+  ///                                backing store in bands on the worker
+  ///                                threads of the rasterizer, instead of
+  ///                                directly on the raster thread.
+  ///
+  GPUSurfaceSoftware(
+      GPUSurfaceSoftwareDelegate* delegate,
+      bool render_to_surface,
+      std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer = nullptr);
 
   ~GPUSurfaceSoftware() override;
 
@@ -32,13 +48,22 @@ class GPUSurfaceSoftware : public Surface {
   GrDirectContext* GetContext() override;
 
  private:
+  // Returns a frame that records a DisplayList, which is rasterized into
+  // |backing_store| by |tiled_rasterizer_| when the frame is submitted.
+  std::unique_ptr<SurfaceFrame> AcquireTiledFrame(
+      sk_sp<SkSurface> backing_store,
+      const SurfaceFrame::FramebufferInfo& framebuffer_info,
+      const SkISize& logical_size);
+
   GPUSurfaceSoftwareDelegate* delegate_;
   // TODO(38466): Refactor GPU surface APIs take into account the fact that an
   // external view embedder may want to render to the root surface. This is a
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  const std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer_;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
+
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
 
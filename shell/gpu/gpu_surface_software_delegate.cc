@@ -8,4 +8,17 @@ namespace flutter {
 
 GPUSurfaceSoftwareDelegate::~GPUSurfaceSoftwareDelegate() = default;
 
+SurfaceFrame::FramebufferInfo GPUSurfaceSoftwareDelegate::GetBackingStoreInfo()
+    const {
+  SurfaceFrame::FramebufferInfo info;
+  info.supports_readback = true;
+  return info;
+}
+
+bool GPUSurfaceSoftwareDelegate::PresentBackingStoreWithInfo(
+    sk_sp<SkSurface> backing_store,
+    const SoftwarePresentInfo& present_info) {
+  return PresentBackingStore(std::move(backing_store));
+}
+
 }  // namespace flutter
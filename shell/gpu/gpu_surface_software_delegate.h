@@ -5,12 +5,27 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_SOFTWARE_DELEGATE_H_
 
+#include <optional>
+#include <vector>
+
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/surface_frame.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 
+// Information passed during presentation of a software backing store.
+struct SoftwarePresentInfo {
+  // The area of the backing store that changed since the last frame was
+  // presented. If unspecified, the whole backing store must be presented.
+  std::optional<SkIRect> frame_damage;
+
+  // Disjoint rectangles covering frame_damage. If empty, frame_damage should
+  // be used as a single damage rectangle.
+  std::vector<SkIRect> frame_damage_rects;
+};
+
 //------------------------------------------------------------------------------
 /// @brief      Interface implemented by all platform surfaces that can present
 ///             a software backing store to the "screen". The GPU surface
@@ -48,6 +63,39 @@ class GPUSurfaceSoftwareDelegate {
   ///             the screen.
   ///
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Describes the backing store most recently returned by
+  ///             |AcquireBackingStore|. Platforms that keep the contents of
+  ///             their backing stores between frames may report support for
+  ///             partial repaint along with the existing damage of the
+  ///             backing store, so that only the damaged areas of a frame are
+  ///             rendered.
+  ///
+  ///             The default implementation reports that the backing store
+  ///             supports readback but not partial repaint.
+  ///
+  /// @return     The framebuffer info of the backing store.
+  ///
+  virtual SurfaceFrame::FramebufferInfo GetBackingStoreInfo() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Like |PresentBackingStore|, but also passes the area that
+  ///             changed since the last frame was presented, so that the
+  ///             platform only needs to copy those pixels to the screen.
+  ///
+  ///             The default implementation ignores the damage and calls
+  ///             |PresentBackingStore|.
+  ///
+  /// @param[in]  backing_store  The software backing store to present.
+  /// @param[in]  present_info   The damage of the frame.
+  ///
+  /// @return     Returns if the platform could present the backing store onto
+  ///             the screen.
+  ///
+  virtual bool PresentBackingStoreWithInfo(
+      sk_sp<SkSurface> backing_store,
+      const SoftwarePresentInfo& present_info);
 };
 
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/gpu/gpu_surface_vulkan_impeller.h"
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/make_copyable.h"
 #include "impeller/display_list/dl_dispatcher.h"
 #include "impeller/renderer/backend/vulkan/surface_context_vk.h"
@@ -29,6 +30,9 @@ GPUSurfaceVulkanImpeller::GPUSurfaceVulkanImpeller(
   if (!aiks_context->IsValid()) {
     return;
   }
+  aiks_context->GetContentContext().SetPipelineVariantManifest(
+      std::make_shared<impeller::PipelineVariantManifest>(
+          PersistentCache::GetCacheForProcess()->OpenImpellerCacheDirectory()));
 
   impeller_context_ = std::move(context);
   impeller_renderer_ = std::move(renderer);
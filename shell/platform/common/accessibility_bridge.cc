@@ -19,6 +19,25 @@ constexpr int kHasScrollingAction =
     FlutterSemanticsAction::kFlutterSemanticsActionScrollUp |
     FlutterSemanticsAction::kFlutterSemanticsActionScrollDown;
 
+// The groups of semantics node fields that can change between updates. See
+// AccessibilityBridge::GetChangedSemanticsNodeFields.
+constexpr int kBoundsChanged = 1 << 0;
+constexpr int kTextChanged = 1 << 1;
+// Any other field, which may affect every attribute of the node.
+constexpr int kOtherFieldsChanged = 1 << 2;
+
+static bool operator==(const FlutterRect& a, const FlutterRect& b) {
+  return a.left == b.left && a.top == b.top && a.right == b.right &&
+         a.bottom == b.bottom;
+}
+
+static bool operator==(const FlutterTransformation& a,
+                       const FlutterTransformation& b) {
+  return a.scaleX == b.scaleX && a.skewX == b.skewX && a.transX == b.transX &&
+         a.skewY == b.skewY && a.scaleY == b.scaleY && a.transY == b.transY &&
+         a.pers0 == b.pers0 && a.pers1 == b.pers1 && a.pers2 == b.pers2;
+}
+
 // AccessibilityBridge
 AccessibilityBridge::AccessibilityBridge()
     : tree_(std::make_unique<ui::AXTree>()) {
@@ -83,16 +102,22 @@ void AccessibilityBridge::CommitUpdates() {
   std::vector<std::vector<SemanticsNode>> results;
   while (!pending_semantics_node_updates_.empty()) {
     auto begin = pending_semantics_node_updates_.begin();
-    SemanticsNode target = begin->second;
-    std::vector<SemanticsNode> sub_tree_list;
-    GetSubTreeList(target, sub_tree_list);
-    results.push_back(sub_tree_list);
+    SemanticsNode target = std::move(begin->second);
     pending_semantics_node_updates_.erase(begin);
+    std::vector<SemanticsNode> sub_tree_list;
+    GetSubTreeList(std::move(target), sub_tree_list);
+    results.push_back(std::move(sub_tree_list));
   }
 
+  // Most updates only change a few fields of a few nodes, such as the bounds
+  // of the nodes in a scrolling list or the label of a clock. Nodes that
+  // didn't change are left out of the tree update, and nodes whose bounds or
+  // text changed reuse their current node data.
   for (size_t i = results.size(); i > 0; i--) {
     for (const SemanticsNode& node : results[i - 1]) {
-      ConvertFlutterUpdate(node, update);
+      if (!ConvertChangedFlutterUpdate(node, update)) {
+        ConvertFlutterUpdate(node, update);
+      }
     }
   }
 
@@ -112,8 +137,20 @@ void AccessibilityBridge::CommitUpdates() {
   std::string error = tree_->error();
   if (!error.empty()) {
     FML_LOG(ERROR) << "Failed to update ui::AXTree, error: " << error;
+    // Convert every node in full from now on.
+    committed_semantics_nodes_.clear();
     return;
   }
+
+  for (auto& sub_tree_list : results) {
+    for (SemanticsNode& node : sub_tree_list) {
+      if (tree_->GetFromId(node.id)) {
+        int32_t id = node.id;
+        committed_semantics_nodes_[id] = std::move(node);
+      }
+    }
+  }
+
   // Handles accessibility events as the result of the semantics update.
   for (const auto& targeted_event : event_generator_) {
     auto event_target =
@@ -178,6 +215,7 @@ void AccessibilityBridge::OnNodeDeleted(ui::AXTree* tree,
   if (id_wrapper_map_.find(node_id) != id_wrapper_map_.end()) {
     id_wrapper_map_.erase(node_id);
   }
+  committed_semantics_nodes_.erase(node_id);
 }
 
 void AccessibilityBridge::OnAtomicUpdateFinished(
@@ -256,19 +294,112 @@ AccessibilityBridge::CreateRemoveReparentedNodesUpdate() {
 }
 
 // Private method.
-void AccessibilityBridge::GetSubTreeList(const SemanticsNode& target,
+void AccessibilityBridge::GetSubTreeList(SemanticsNode target,
                                          std::vector<SemanticsNode>& result) {
-  result.push_back(target);
-  for (int32_t child : target.children_in_traversal_order) {
+  result.push_back(std::move(target));
+  // The children are read from the list as the node may move when the list
+  // grows.
+  size_t index = result.size() - 1;
+  for (size_t i = 0; i < result[index].children_in_traversal_order.size();
+       i++) {
+    int32_t child = result[index].children_in_traversal_order[i];
     auto iter = pending_semantics_node_updates_.find(child);
     if (iter != pending_semantics_node_updates_.end()) {
-      SemanticsNode node = iter->second;
-      GetSubTreeList(node, result);
+      SemanticsNode node = std::move(iter->second);
       pending_semantics_node_updates_.erase(iter);
+      GetSubTreeList(std::move(node), result);
     }
   }
 }
 
+int AccessibilityBridge::GetChangedSemanticsNodeFields(
+    const SemanticsNode& previous,
+    const SemanticsNode& node) const {
+  int changes = 0;
+  if (!(previous.rect == node.rect) ||
+      !(previous.transform == node.transform)) {
+    changes |= kBoundsChanged;
+  }
+  if (previous.label != node.label || previous.hint != node.hint ||
+      previous.value != node.value ||
+      previous.increased_value != node.increased_value ||
+      previous.decreased_value != node.decreased_value ||
+      previous.tooltip != node.tooltip) {
+    changes |= kTextChanged;
+  }
+  if (previous.flags != node.flags || previous.actions != node.actions ||
+      previous.text_selection_base != node.text_selection_base ||
+      previous.text_selection_extent != node.text_selection_extent ||
+      previous.scroll_child_count != node.scroll_child_count ||
+      previous.scroll_index != node.scroll_index ||
+      previous.scroll_position != node.scroll_position ||
+      previous.scroll_extent_max != node.scroll_extent_max ||
+      previous.scroll_extent_min != node.scroll_extent_min ||
+      previous.elevation != node.elevation ||
+      previous.thickness != node.thickness ||
+      previous.text_direction != node.text_direction ||
+      previous.children_in_traversal_order !=
+          node.children_in_traversal_order ||
+      previous.custom_accessibility_actions !=
+          node.custom_accessibility_actions) {
+    changes |= kOtherFieldsChanged;
+  }
+  // The descriptions of the custom actions come from the custom action
+  // updates.
+  for (int32_t action_id : node.custom_accessibility_actions) {
+    if (pending_semantics_custom_action_updates_.find(action_id) !=
+        pending_semantics_custom_action_updates_.end()) {
+      changes |= kOtherFieldsChanged;
+      break;
+    }
+  }
+  return changes;
+}
+
+bool AccessibilityBridge::ConvertChangedFlutterUpdate(
+    const SemanticsNode& node,
+    ui::AXTreeUpdate& tree_update) {
+  // Nodes that aren't in the tree, such as new nodes and reparented nodes,
+  // are converted in full.
+  ui::AXNode* ax_node = tree_->GetFromId(node.id);
+  auto previous = committed_semantics_nodes_.find(node.id);
+  if (!ax_node || previous == committed_semantics_nodes_.end()) {
+    return false;
+  }
+
+  int changes = GetChangedSemanticsNodeFields(previous->second, node);
+  if (changes & kOtherFieldsChanged) {
+    return false;
+  }
+  if (changes & kTextChanged) {
+    // Whether the node is ignored depends on whether it has any text, and the
+    // selection of text fields on the length of their value.
+    const SemanticsNode& old = previous->second;
+    FlutterSemanticsFlag flags = node.flags;
+    if (old.label.empty() != node.label.empty() ||
+        old.value.empty() != node.value.empty() ||
+        old.hint.empty() != node.hint.empty() ||
+        flags & FlutterSemanticsFlag::kFlutterSemanticsFlagIsTextField) {
+      return false;
+    }
+  }
+  if (changes == 0) {
+    return true;
+  }
+
+  ui::AXNodeData node_data = ax_node->data();
+  if (changes & kBoundsChanged) {
+    SetBoundsFromFlutterUpdate(node_data, node);
+  }
+  if (changes & kTextChanged) {
+    SetNameFromFlutterUpdate(node_data, node);
+    SetValueFromFlutterUpdate(node_data, node);
+    SetTooltipFromFlutterUpdate(node_data, node);
+  }
+  tree_update.nodes.push_back(std::move(node_data));
+  return true;
+}
+
 void AccessibilityBridge::ConvertFlutterUpdate(const SemanticsNode& node,
                                                ui::AXTreeUpdate& tree_update) {
   ui::AXNodeData node_data;
@@ -283,19 +414,12 @@ void AccessibilityBridge::ConvertFlutterUpdate(const SemanticsNode& node,
   SetNameFromFlutterUpdate(node_data, node);
   SetValueFromFlutterUpdate(node_data, node);
   SetTooltipFromFlutterUpdate(node_data, node);
-  node_data.relative_bounds.bounds.SetRect(node.rect.left, node.rect.top,
-                                           node.rect.right - node.rect.left,
-                                           node.rect.bottom - node.rect.top);
-  node_data.relative_bounds.transform = std::make_unique<gfx::Transform>(
-      node.transform.scaleX, node.transform.skewX, node.transform.transX, 0,
-      node.transform.skewY, node.transform.scaleY, node.transform.transY, 0,
-      node.transform.pers0, node.transform.pers1, node.transform.pers2, 0, 0, 0,
-      0, 0);
+  SetBoundsFromFlutterUpdate(node_data, node);
   for (auto child : node.children_in_traversal_order) {
     node_data.child_ids.push_back(child);
   }
   SetTreeData(node, tree_update);
-  tree_update.nodes.push_back(node_data);
+  tree_update.nodes.push_back(std::move(node_data));
 }
 
 void AccessibilityBridge::SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
@@ -535,6 +659,19 @@ void AccessibilityBridge::SetTooltipFromFlutterUpdate(
   node_data.SetTooltip(node.tooltip);
 }
 
+void AccessibilityBridge::SetBoundsFromFlutterUpdate(
+    ui::AXNodeData& node_data,
+    const SemanticsNode& node) {
+  node_data.relative_bounds.bounds.SetRect(node.rect.left, node.rect.top,
+                                           node.rect.right - node.rect.left,
+                                           node.rect.bottom - node.rect.top);
+  node_data.relative_bounds.transform = std::make_unique<gfx::Transform>(
+      node.transform.scaleX, node.transform.skewX, node.transform.transX, 0,
+      node.transform.skewY, node.transform.scaleY, node.transform.transY, 0,
+      node.transform.pers0, node.transform.pers1, node.transform.pers2, 0, 0, 0,
+      0, 0);
+}
+
 void AccessibilityBridge::SetTreeData(const SemanticsNode& node,
                                       ui::AXTreeUpdate& tree_update) {
   FlutterSemanticsFlag flags = node.flags;
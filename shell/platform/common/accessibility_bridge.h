@@ -199,6 +199,10 @@ class AccessibilityBridge
   std::unique_ptr<ui::AXTree> tree_;
   ui::AXEventGenerator event_generator_;
   std::unordered_map<int32_t, SemanticsNode> pending_semantics_node_updates_;
+  // The semantics nodes as of the last commit, for the nodes in the tree.
+  // Updates are compared against these so that only the attributes that
+  // changed are converted.
+  std::unordered_map<int32_t, SemanticsNode> committed_semantics_nodes_;
   std::unordered_map<int32_t, SemanticsCustomAction>
       pending_semantics_custom_action_updates_;
   AccessibilityNodeId last_focused_id_ = ui::AXNode::kInvalidAXID;
@@ -209,10 +213,16 @@ class AccessibilityBridge
   // pending_semantics_updates_. Returns std::nullopt if none are reparented.
   std::optional<ui::AXTreeUpdate> CreateRemoveReparentedNodesUpdate();
 
-  void GetSubTreeList(const SemanticsNode& target,
-                      std::vector<SemanticsNode>& result);
+  void GetSubTreeList(SemanticsNode target, std::vector<SemanticsNode>& result);
   void ConvertFlutterUpdate(const SemanticsNode& node,
                             ui::AXTreeUpdate& tree_update);
+  // Adds the node to the update if it changed since the last commit, reusing
+  // its current node data if only its geometry or text changed. Returns false
+  // if the node must be converted in full.
+  bool ConvertChangedFlutterUpdate(const SemanticsNode& node,
+                                   ui::AXTreeUpdate& tree_update);
+  int GetChangedSemanticsNodeFields(const SemanticsNode& previous,
+                                    const SemanticsNode& node) const;
   void SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
                                 const SemanticsNode& node);
   void SetStateFromFlutterUpdate(ui::AXNodeData& node_data,
@@ -233,6 +243,8 @@ class AccessibilityBridge
                                  const SemanticsNode& node);
   void SetTooltipFromFlutterUpdate(ui::AXNodeData& node_data,
                                    const SemanticsNode& node);
+  void SetBoundsFromFlutterUpdate(ui::AXNodeData& node_data,
+                                  const SemanticsNode& node);
   void SetTreeData(const SemanticsNode& node, ui::AXTreeUpdate& tree_update);
   SemanticsNode FromFlutterSemanticsNode(
       const FlutterSemanticsNode2& flutter_node);
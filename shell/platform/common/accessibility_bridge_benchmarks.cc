@@ -0,0 +1,145 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/test_accessibility_bridge.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr double kRowHeight = 48.0;
+
+/// The semantics of a scrolling list, as the framework sends it: a root node
+/// with one node per row.
+class SemanticsList {
+ public:
+  explicit SemanticsList(int32_t row_count) {
+    for (int32_t i = 1; i <= row_count; i++) {
+      children_.push_back(i);
+      labels_.push_back("Row " + std::to_string(i));
+    }
+    nodes_.push_back(CreateNode(0, "List"));
+    nodes_.back().child_count = children_.size();
+    nodes_.back().children_in_traversal_order = children_.data();
+    for (int32_t i = 1; i <= row_count; i++) {
+      nodes_.push_back(CreateNode(i, labels_[i - 1].c_str()));
+    }
+    Scroll(0.0);
+  }
+
+  /// Moves every row by the scroll offset.
+  void Scroll(double offset) {
+    for (size_t i = 1; i < nodes_.size(); i++) {
+      double top = (i - 1) * kRowHeight - offset;
+      nodes_[i].rect = {0.0, top, 400.0, top + kRowHeight};
+    }
+  }
+
+  /// Changes the labels of every |stride|th row.
+  void Relabel(size_t stride, int frame) {
+    for (size_t i = 1; i < nodes_.size(); i += stride) {
+      labels_[i - 1] =
+          "Row " + std::to_string(i) + " frame " + std::to_string(frame);
+      nodes_[i].label = labels_[i - 1].c_str();
+    }
+  }
+
+  void Send(AccessibilityBridge& bridge) const {
+    for (const FlutterSemanticsNode2& node : nodes_) {
+      bridge.AddFlutterSemanticsNodeUpdate(node);
+    }
+    bridge.CommitUpdates();
+  }
+
+ private:
+  std::vector<int32_t> children_;
+  std::vector<std::string> labels_;
+  std::vector<FlutterSemanticsNode2> nodes_;
+
+  static FlutterSemanticsNode2 CreateNode(int32_t id, const char* label) {
+    return {
+        .id = id,
+        .flags = static_cast<FlutterSemanticsFlag>(0),
+        .actions = static_cast<FlutterSemanticsAction>(0),
+        .text_selection_base = -1,
+        .text_selection_extent = -1,
+        .label = label,
+        .hint = "",
+        .value = "",
+        .increased_value = "",
+        .decreased_value = "",
+        .transform = {.scaleX = 1.0, .scaleY = 1.0, .pers2 = 1.0},
+        .child_count = 0,
+        .children_in_traversal_order = nullptr,
+        .custom_accessibility_actions_count = 0,
+        .tooltip = "",
+    };
+  }
+};
+
+}  // namespace
+
+// Resends every node each frame without changing any of them.
+static void BM_AccessibilityBridgeCommitUnchanged(benchmark::State& state) {
+  auto bridge = std::make_shared<TestAccessibilityBridge>();
+  SemanticsList list(state.range(0));
+  list.Send(*bridge);
+
+  while (state.KeepRunning()) {
+    list.Send(*bridge);
+    bridge->accessibility_events.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Moves every row each frame, as scrolling does.
+static void BM_AccessibilityBridgeCommitScroll(benchmark::State& state) {
+  auto bridge = std::make_shared<TestAccessibilityBridge>();
+  SemanticsList list(state.range(0));
+  list.Send(*bridge);
+
+  double offset = 0.0;
+  while (state.KeepRunning()) {
+    offset += 1.0;
+    list.Scroll(offset);
+    list.Send(*bridge);
+    bridge->accessibility_events.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Changes the labels of a few rows each frame.
+static void BM_AccessibilityBridgeCommitRelabel(benchmark::State& state) {
+  auto bridge = std::make_shared<TestAccessibilityBridge>();
+  SemanticsList list(state.range(0));
+  list.Send(*bridge);
+
+  int frame = 0;
+  while (state.KeepRunning()) {
+    list.Relabel(/*stride=*/100, ++frame);
+    list.Send(*bridge);
+    bridge->accessibility_events.clear();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AccessibilityBridgeCommitUnchanged)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AccessibilityBridgeCommitScroll)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AccessibilityBridgeCommitRelabel)
+    ->RangeMultiplier(4)
+    ->Range(64, 4096)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -572,5 +572,100 @@ TEST(AccessibilityBridgeTest, LineBreakingObjectTest) {
       ax::mojom::BoolAttribute::kIsLineBreakingObject));
 }
 
+TEST(AccessibilityBridgeTest, DoesNotUpdateUnchangedNodes) {
+  std::shared_ptr<TestAccessibilityBridge> bridge =
+      std::make_shared<TestAccessibilityBridge>();
+
+  std::vector<int32_t> children{1, 2};
+  FlutterSemanticsNode2 root = CreateSemanticsNode(0, "root", &children);
+  FlutterSemanticsNode2 child1 = CreateSemanticsNode(1, "child 1");
+  FlutterSemanticsNode2 child2 = CreateSemanticsNode(2, "child 2");
+
+  bridge->AddFlutterSemanticsNodeUpdate(root);
+  bridge->AddFlutterSemanticsNodeUpdate(child1);
+  bridge->AddFlutterSemanticsNodeUpdate(child2);
+  bridge->CommitUpdates();
+  bridge->accessibility_events.clear();
+
+  // The framework resends nodes that didn't change.
+  bridge->AddFlutterSemanticsNodeUpdate(root);
+  bridge->AddFlutterSemanticsNodeUpdate(child2);
+  bridge->CommitUpdates();
+
+  EXPECT_TRUE(bridge->accessibility_events.empty());
+  auto root_node = bridge->GetFlutterPlatformNodeDelegateFromID(0).lock();
+  auto child2_node = bridge->GetFlutterPlatformNodeDelegateFromID(2).lock();
+  EXPECT_EQ(root_node->GetChildCount(), 2);
+  EXPECT_EQ(root_node->GetName(), "root");
+  EXPECT_EQ(child2_node->GetName(), "child 2");
+}
+
+TEST(AccessibilityBridgeTest, UpdatesBoundsAndTextOfChangedNodes) {
+  std::shared_ptr<TestAccessibilityBridge> bridge =
+      std::make_shared<TestAccessibilityBridge>();
+
+  std::vector<int32_t> children{1};
+  FlutterSemanticsNode2 root = CreateSemanticsNode(0, "root", &children);
+  FlutterSemanticsNode2 child = CreateSemanticsNode(1, "child");
+  child.rect = {0, 0, 100, 50};
+
+  bridge->AddFlutterSemanticsNodeUpdate(root);
+  bridge->AddFlutterSemanticsNodeUpdate(child);
+  bridge->CommitUpdates();
+  bridge->accessibility_events.clear();
+
+  child.rect = {0, 50, 100, 100};
+  bridge->AddFlutterSemanticsNodeUpdate(child);
+  bridge->CommitUpdates();
+
+  auto child_node = bridge->GetFlutterPlatformNodeDelegateFromID(1).lock();
+  EXPECT_EQ(child_node->GetData().relative_bounds.bounds,
+            gfx::RectF(0, 50, 100, 50));
+  EXPECT_EQ(child_node->GetName(), "child");
+
+  child.label = "updated child";
+  bridge->AddFlutterSemanticsNodeUpdate(child);
+  bridge->CommitUpdates();
+
+  EXPECT_EQ(child_node->GetName(), "updated child");
+  EXPECT_EQ(child_node->GetData().role, ax::mojom::Role::kStaticText);
+  EXPECT_EQ(child_node->GetData().relative_bounds.bounds,
+            gfx::RectF(0, 50, 100, 50));
+  EXPECT_THAT(bridge->accessibility_events,
+              Contains(ui::AXEventGenerator::Event::NAME_CHANGED));
+}
+
+TEST(AccessibilityBridgeTest, UpdatesStateWhenTextBecomesEmpty) {
+  std::shared_ptr<TestAccessibilityBridge> bridge =
+      std::make_shared<TestAccessibilityBridge>();
+
+  std::vector<int32_t> children{1};
+  FlutterSemanticsNode2 root = CreateSemanticsNode(0, "root", &children);
+  FlutterSemanticsNode2 child = CreateSemanticsNode(1, "child");
+
+  bridge->AddFlutterSemanticsNodeUpdate(root);
+  bridge->AddFlutterSemanticsNodeUpdate(child);
+  bridge->CommitUpdates();
+
+  auto child_node = bridge->GetFlutterPlatformNodeDelegateFromID(1).lock();
+  EXPECT_FALSE(child_node->GetData().HasState(ax::mojom::State::kIgnored));
+
+  // Static text without any text is ignored.
+  child.label = "";
+  bridge->AddFlutterSemanticsNodeUpdate(child);
+  bridge->CommitUpdates();
+
+  EXPECT_TRUE(child_node->GetData().HasState(ax::mojom::State::kIgnored));
+
+  child.label = "child";
+  child.flags = FlutterSemanticsFlag::kFlutterSemanticsFlagIsButton;
+  bridge->AddFlutterSemanticsNodeUpdate(child);
+  bridge->CommitUpdates();
+
+  EXPECT_FALSE(child_node->GetData().HasState(ax::mojom::State::kIgnored));
+  EXPECT_EQ(child_node->GetData().role, ax::mojom::Role::kButton);
+  EXPECT_EQ(child_node->GetName(), "child");
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -196,7 +196,8 @@ class EncodableValue : public internal::EncodableValueVariant {
   // compile, go through a pointer->bool->EncodableValue(bool) chain and
   // silently call the function with a temp-constructed EncodableValue(true).
   template <class T>
-  constexpr explicit EncodableValue(T&& t) noexcept : super(t) {}
+  constexpr explicit EncodableValue(T&& t) noexcept
+      : super(std::forward<T>(t)) {}
 
   // Returns true if the value is null. Convenience wrapper since unlike the
   // other types, std::monostate uses aren't self-documenting.
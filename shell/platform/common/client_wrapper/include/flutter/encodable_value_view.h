@@ -0,0 +1,379 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "encodable_value.h"
+
+namespace flutter {
+
+class EncodableValueView;
+
+// A non-owning view of a fixed-type list of |T|s.
+//
+// Views returned by StandardMessageCodec::DecodeMessageView point directly
+// into the encoded message. The codec only guarantees the alignment of list
+// data relative to the start of the message, so elements are read with
+// memcpy rather than by dereferencing a |T*|; data() can be used to get a
+// typed pointer when the underlying buffer happens to be aligned.
+template <typename T>
+class TypedDataView {
+ public:
+  TypedDataView() = default;
+
+  // Creates a view of the |count| elements starting at |data|, which must
+  // remain valid for the lifetime of the view.
+  TypedDataView(const T* data, size_t count)
+      : bytes_(reinterpret_cast<const uint8_t*>(data)), size_(count) {}
+
+  // Creates a view of |count| elements stored in |bytes|, which need not be
+  // aligned for |T|.
+  static TypedDataView FromBytes(const uint8_t* bytes, size_t count) {
+    TypedDataView view;
+    view.bytes_ = bytes;
+    view.size_ = count;
+    return view;
+  }
+
+  // The number of elements in the view.
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  // The raw bytes backing the view.
+  const uint8_t* bytes() const { return bytes_; }
+
+  size_t size_in_bytes() const { return size_ * sizeof(T); }
+
+  // Returns the element at |index|, which must be less than size().
+  T operator[](size_t index) const {
+    T value;
+    std::memcpy(&value, bytes_ + index * sizeof(T), sizeof(T));
+    return value;
+  }
+
+  // Returns a typed pointer to the elements, or nullptr if the backing bytes
+  // aren't suitably aligned for |T|.
+  const T* data() const {
+    if (reinterpret_cast<uintptr_t>(bytes_) % alignof(T) != 0) {
+      return nullptr;
+    }
+    return reinterpret_cast<const T*>(bytes_);
+  }
+
+  // Returns an owning copy of the elements.
+  std::vector<T> ToVector() const {
+    std::vector<T> vector(size_);
+    if (size_ > 0) {
+      std::memcpy(vector.data(), bytes_, size_in_bytes());
+    }
+    return vector;
+  }
+
+  bool operator==(const TypedDataView& other) const {
+    return size_ == other.size_ &&
+           (size_ == 0 ||
+            std::memcmp(bytes_, other.bytes_, size_in_bytes()) == 0);
+  }
+  bool operator!=(const TypedDataView& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  const uint8_t* bytes_ = nullptr;
+  size_t size_ = 0;
+};
+
+// A non-owning view of a list in a message encoded with the standard codec.
+//
+// Elements are decoded lazily during iteration, so walking a list doesn't
+// allocate. Instances are obtained from an EncodableValueView.
+class EncodableListView {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = EncodableValueView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = EncodableValueView;
+
+    const_iterator() = default;
+
+    EncodableValueView operator*() const;
+    const_iterator& operator++();
+    const_iterator operator++(int) {
+      const_iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return remaining_ == other.remaining_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class EncodableListView;
+
+    const_iterator(const uint8_t* message,
+                   size_t message_size,
+                   size_t offset,
+                   size_t remaining)
+        : message_(message),
+          message_size_(message_size),
+          offset_(offset),
+          remaining_(remaining) {}
+
+    const uint8_t* message_ = nullptr;
+    size_t message_size_ = 0;
+    // The offset of the current element in |message_|.
+    size_t offset_ = 0;
+    // The number of elements left, including the current one.
+    size_t remaining_ = 0;
+  };
+
+  EncodableListView() = default;
+
+  // The number of elements in the list.
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const_iterator begin() const {
+    return const_iterator(message_, message_size_, offset_, size_);
+  }
+  const_iterator end() const {
+    return const_iterator(message_, message_size_, offset_, 0);
+  }
+
+  // Two list views are equal if they refer to the same encoded list.
+  bool operator==(const EncodableListView& other) const {
+    return message_ == other.message_ && offset_ == other.offset_ &&
+           size_ == other.size_;
+  }
+  bool operator!=(const EncodableListView& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  friend class StandardCodecSerializer;
+
+  EncodableListView(const uint8_t* message,
+                    size_t message_size,
+                    size_t offset,
+                    size_t size)
+      : message_(message),
+        message_size_(message_size),
+        offset_(offset),
+        size_(size) {}
+
+  // The start of the message containing the list. Alignment of the encoded
+  // data is relative to this.
+  const uint8_t* message_ = nullptr;
+  size_t message_size_ = 0;
+  // The offset of the first element in |message_|.
+  size_t offset_ = 0;
+  size_t size_ = 0;
+};
+
+// A non-owning view of a map in a message encoded with the standard codec.
+//
+// Entries are decoded lazily, in encoded order, during iteration. Instances
+// are obtained from an EncodableValueView.
+class EncodableMapView {
+ public:
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<EncodableValueView, EncodableValueView>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    const_iterator() = default;
+
+    value_type operator*() const;
+    const_iterator& operator++();
+    const_iterator operator++(int) {
+      const_iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return remaining_ == other.remaining_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class EncodableMapView;
+
+    const_iterator(const uint8_t* message,
+                   size_t message_size,
+                   size_t offset,
+                   size_t remaining)
+        : message_(message),
+          message_size_(message_size),
+          offset_(offset),
+          remaining_(remaining) {}
+
+    const uint8_t* message_ = nullptr;
+    size_t message_size_ = 0;
+    // The offset of the current entry's key in |message_|.
+    size_t offset_ = 0;
+    // The number of entries left, including the current one.
+    size_t remaining_ = 0;
+  };
+
+  EncodableMapView() = default;
+
+  // The number of entries in the map.
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const_iterator begin() const {
+    return const_iterator(message_, message_size_, offset_, size_);
+  }
+  const_iterator end() const {
+    return const_iterator(message_, message_size_, offset_, 0);
+  }
+
+  // Two map views are equal if they refer to the same encoded map.
+  bool operator==(const EncodableMapView& other) const {
+    return message_ == other.message_ && offset_ == other.offset_ &&
+           size_ == other.size_;
+  }
+  bool operator!=(const EncodableMapView& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  friend class StandardCodecSerializer;
+
+  EncodableMapView(const uint8_t* message,
+                   size_t message_size,
+                   size_t offset,
+                   size_t size)
+      : message_(message),
+        message_size_(message_size),
+        offset_(offset),
+        size_(size) {}
+
+  // The start of the message containing the map. Alignment of the encoded
+  // data is relative to this.
+  const uint8_t* message_ = nullptr;
+  size_t message_size_ = 0;
+  // The offset of the first key in |message_|.
+  size_t offset_ = 0;
+  size_t size_ = 0;
+};
+
+namespace internal {
+// The base class for EncodableValueView. Do not use this directly; it exists
+// only for EncodableValueView to inherit from.
+//
+// Do not change the order or indexes of the items here; see the comment on
+// EncodableValueView.
+using EncodableValueViewVariant = std::variant<std::monostate,
+                                               bool,
+                                               int32_t,
+                                               int64_t,
+                                               double,
+                                               std::string_view,
+                                               TypedDataView<uint8_t>,
+                                               TypedDataView<int32_t>,
+                                               TypedDataView<int64_t>,
+                                               TypedDataView<double>,
+                                               EncodableListView,
+                                               EncodableMapView,
+                                               TypedDataView<float>>;
+}  // namespace internal
+
+// A non-owning counterpart to EncodableValue.
+//
+// Values decoded with StandardMessageCodec::DecodeMessageView borrow strings,
+// typed lists, lists and maps from the encoded message rather than copying
+// them, so the message buffer must outlive the view and anything obtained
+// from it. This is intended for handlers that receive large payloads (e.g.,
+// image or sensor data) directly from a BinaryMessenger:
+//   messenger->SetMessageHandler(
+//       "channel", [](const uint8_t* message, size_t size,
+//                     BinaryReply reply) {
+//         const auto& codec = StandardMessageCodec::GetInstance();
+//         auto value = codec.DecodeMessageView(message, size);
+//         const auto* frame =
+//             value ? std::get_if<TypedDataView<uint8_t>>(&*value) : nullptr;
+//         if (frame) {
+//           ProcessFrame(frame->bytes(), frame->size());
+//         }
+//       });
+//
+// Views can also be encoded with StandardMessageCodec::EncodeMessageToBuffer,
+// which allows sending existing client data without first copying it into an
+// EncodableValue.
+//
+// The variant types are mapped with the EncodableValue types in the following
+// ways; the order/indexes match EncodableValue up to, but not including,
+// CustomEncodableValue, which has no view equivalent:
+// std::monostate          -> std::monostate
+// bool                    -> bool
+// int32_t                 -> int32_t
+// int64_t                 -> int64_t
+// double                  -> double
+// std::string_view        -> std::string
+// TypedDataView<uint8_t>  -> std::vector<uint8_t>
+// TypedDataView<int32_t>  -> std::vector<int32_t>
+// TypedDataView<int64_t>  -> std::vector<int64_t>
+// TypedDataView<double>   -> std::vector<double>
+// EncodableListView       -> EncodableList
+// EncodableMapView        -> EncodableMap
+// TypedDataView<float>    -> std::vector<float>
+class EncodableValueView : public internal::EncodableValueViewVariant {
+ public:
+  // Rely on std::variant for most of the constructors/operators.
+  using super = internal::EncodableValueViewVariant;
+  using super::super;
+  using super::operator=;
+
+  explicit EncodableValueView() = default;
+
+  // Avoid the C++17 pitfall of conversion from char* to bool.
+  explicit EncodableValueView(const char* string)
+      : super(std::string_view(string)) {}
+
+  // Returns true if the value is null.
+  bool IsNull() const { return std::holds_alternative<std::monostate>(*this); }
+
+  // See EncodableValue::LongValue.
+  int64_t LongValue() const {
+    if (std::holds_alternative<int32_t>(*this)) {
+      return std::get<int32_t>(*this);
+    }
+    return std::get<int64_t>(*this);
+  }
+
+  // Returns an owning copy of this value, recursively copying any borrowed
+  // data.
+  EncodableValue ToEncodableValue() const;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
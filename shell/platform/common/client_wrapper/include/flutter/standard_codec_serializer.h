@@ -5,8 +5,11 @@
 #ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_SERIALIZER_H_
 #define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_SERIALIZER_H_
 
+#include <optional>
+
 #include "byte_streams.h"
 #include "encodable_value.h"
+#include "encodable_value_view.h"
 
 namespace flutter {
 
@@ -36,6 +39,22 @@ class StandardCodecSerializer {
   virtual void WriteValue(const EncodableValue& value,
                           ByteStreamWriter* stream) const;
 
+  // Returns a view of the value encoded at the start of |message|, which
+  // borrows strings, typed lists and collections from |message| rather than
+  // copying them.
+  //
+  // The whole value is validated up front, so accessing the returned view
+  // never reads outside of |message|. Returns std::nullopt if the encoding is
+  // malformed or contains types other than the standard ones; custom types
+  // must be read with ReadValue.
+  std::optional<EncodableValueView> ReadValueView(const uint8_t* message,
+                                                  size_t message_size) const;
+
+  // Writes the encoding of |value| to |stream|, including the initial type
+  // discrimination byte.
+  void WriteValueView(const EncodableValueView& value,
+                      ByteStreamWriter* stream) const;
+
  protected:
   // Codecs require long-lived serializers, so clients should always use
   // GetInstance().
@@ -58,6 +77,25 @@ class StandardCodecSerializer {
   void WriteSize(size_t size, ByteStreamWriter* stream) const;
 
  private:
+  friend class EncodableListView::const_iterator;
+  friend class EncodableMapView::const_iterator;
+
+  // Reads the view of the value at |offset| in |message| into |value|. Lists
+  // and maps are returned without reading their contents.
+  //
+  // |message| must already have been validated with SkipValueView.
+  static void ReadValueViewAt(const uint8_t* message,
+                              size_t message_size,
+                              size_t offset,
+                              EncodableValueView* value);
+
+  // Validates the encoding of the value at |*offset| in |message|, including
+  // the contents of lists and maps, and advances |*offset| past it. Returns
+  // false if the encoding is malformed or isn't one of the standard types.
+  static bool SkipValueView(const uint8_t* message,
+                            size_t message_size,
+                            size_t* offset);
+
   // Reads a fixed-type list whose values are of type T from the current
   // position in |stream|, and returns it as the corresponding EncodableValue.
   // |T| must correspond to one of the supported list value types of
@@ -68,7 +106,14 @@ class StandardCodecSerializer {
   // Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
   // one of the supported list value types of EncodableValue.
   template <typename T>
-  void WriteVector(const std::vector<T> vector, ByteStreamWriter* stream) const;
+  void WriteVector(const std::vector<T>& vector,
+                   ByteStreamWriter* stream) const;
+
+  // Writes |data| to |stream| as a fixed-type list. |T| must correspond to
+  // one of the supported list value types of EncodableValue.
+  template <typename T>
+  void WriteTypedData(const TypedDataView<T>& data,
+                      ByteStreamWriter* stream) const;
 };
 
 }  // namespace flutter
@@ -6,8 +6,11 @@
 #define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_MESSAGE_CODEC_H_
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "encodable_value.h"
+#include "encodable_value_view.h"
 #include "message_codec.h"
 #include "standard_codec_serializer.h"
 
@@ -35,6 +38,32 @@ class StandardMessageCodec : public MessageCodec<EncodableValue> {
   StandardMessageCodec(StandardMessageCodec const&) = delete;
   StandardMessageCodec& operator=(StandardMessageCodec const&) = delete;
 
+  // Returns a view of the message encoded in |binary_message| that borrows
+  // from it rather than copying; see EncodableValueView. |binary_message|
+  // must outlive the returned view.
+  //
+  // Returns std::nullopt if the message can't be decoded as a view, which
+  // includes any message containing custom types.
+  std::optional<EncodableValueView> DecodeMessageView(
+      const uint8_t* binary_message,
+      const size_t message_size) const;
+
+  // Encodes |message| into |buffer|, replacing its contents.
+  //
+  // The capacity of |buffer| is retained, so clients that send messages
+  // frequently can reuse a single buffer rather than allocating a new one
+  // for each message as EncodeMessage does.
+  void EncodeMessageToBuffer(const EncodableValue& message,
+                             std::vector<uint8_t>* buffer) const;
+
+  // Encodes |message| into |buffer|, replacing its contents.
+  //
+  // This allows encoding client-owned data wrapped in views (e.g., a
+  // TypedDataView of an existing array) without copying it into an
+  // EncodableValue first.
+  void EncodeMessageToBuffer(const EncodableValueView& message,
+                             std::vector<uint8_t>* buffer) const;
+
  protected:
   // |flutter::MessageCodec|
   std::unique_ptr<EncodableValue> DecodeMessageInternal(
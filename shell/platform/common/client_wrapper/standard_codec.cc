@@ -7,14 +7,17 @@
 // together to simplify use of the client wrapper, since the common case is
 // that any client that needs one of these files needs all three.
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "byte_buffer_streams.h"
+#include "include/flutter/encodable_value_view.h"
 #include "include/flutter/standard_codec_serializer.h"
 #include "include/flutter/standard_message_codec.h"
 #include "include/flutter/standard_method_codec.h"
@@ -78,6 +81,135 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Returns the encoded type that should be written when serializing |value|.
+EncodedType EncodedTypeForValueView(const EncodableValueView& value) {
+  switch (value.index()) {
+    case 0:
+      return EncodedType::kNull;
+    case 1:
+      return std::get<bool>(value) ? EncodedType::kTrue : EncodedType::kFalse;
+    case 2:
+      return EncodedType::kInt32;
+    case 3:
+      return EncodedType::kInt64;
+    case 4:
+      return EncodedType::kFloat64;
+    case 5:
+      return EncodedType::kString;
+    case 6:
+      return EncodedType::kUInt8List;
+    case 7:
+      return EncodedType::kInt32List;
+    case 8:
+      return EncodedType::kInt64List;
+    case 9:
+      return EncodedType::kFloat64List;
+    case 10:
+      return EncodedType::kList;
+    case 11:
+      return EncodedType::kMap;
+    case 12:
+      return EncodedType::kFloat32List;
+  }
+  assert(false);
+  return EncodedType::kNull;
+}
+
+// Reads the variable-length size at |*offset| in |message| into |size|, and
+// advances |*offset| past it. Returns false if the size runs past the end of
+// the message.
+bool ReadSizeAt(const uint8_t* message,
+                size_t message_size,
+                size_t* offset,
+                size_t* size) {
+  if (*offset >= message_size) {
+    return false;
+  }
+  uint8_t byte = message[(*offset)++];
+  if (byte < 254) {
+    *size = byte;
+    return true;
+  }
+  size_t length = byte == 254 ? 2 : 4;
+  if (message_size - *offset < length) {
+    return false;
+  }
+  if (byte == 254) {
+    uint16_t value = 0;
+    std::memcpy(&value, message + *offset, 2);
+    *size = value;
+  } else {
+    uint32_t value = 0;
+    std::memcpy(&value, message + *offset, 4);
+    *size = value;
+  }
+  *offset += length;
+  return true;
+}
+
+// Aligns |*offset| to |alignment| and advances it past |length| bytes, storing
+// the aligned offset in |start|. Returns false if the bytes run past the end
+// of a message of |message_size| bytes.
+bool ReadBytesAt(size_t message_size,
+                 size_t alignment,
+                 size_t length,
+                 size_t* offset,
+                 size_t* start) {
+  size_t aligned = *offset;
+  size_t mod = aligned % alignment;
+  if (mod) {
+    aligned += alignment - mod;
+  }
+  if (length == 0) {
+    // Like ByteBufferStreamReader, tolerate missing padding before an empty
+    // list at the end of a message.
+    *start = *offset = std::min(aligned, message_size);
+    return true;
+  }
+  if (aligned > message_size || message_size - aligned < length) {
+    return false;
+  }
+  *start = aligned;
+  *offset = aligned + length;
+  return true;
+}
+
+// Reads the bounds of a fixed-type list whose values are of type T at
+// |*offset| in |message|, and advances |*offset| past it.
+template <typename T>
+bool ReadTypedDataAt(const uint8_t* message,
+                     size_t message_size,
+                     size_t* offset,
+                     size_t* start,
+                     size_t* count) {
+  if (!ReadSizeAt(message, message_size, offset, count) ||
+      *count > message_size / sizeof(T)) {
+    return false;
+  }
+  return ReadBytesAt(message_size, sizeof(T), *count * sizeof(T), offset,
+                     start);
+}
+
+// Reads the fixed-size value of type T starting at |offset| in |message|.
+template <typename T>
+T ReadScalarAt(const uint8_t* message, size_t offset) {
+  T value;
+  std::memcpy(&value, message + offset, sizeof(T));
+  return value;
+}
+
+// Returns a view of the fixed-type list whose values are of type T at
+// |offset| in a validated |message|.
+template <typename T>
+TypedDataView<T> ReadTypedDataViewAt(const uint8_t* message,
+                                     size_t message_size,
+                                     size_t offset) {
+  size_t start = 0;
+  size_t count = 0;
+  ReadTypedDataAt<T>(message, message_size, &offset, &start, &count);
+  return TypedDataView<T>::FromBytes(message + start, count);
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -188,7 +320,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -205,7 +337,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +347,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -268,13 +400,19 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
-  size_t count = vector.size();
+  WriteTypedData(TypedDataView<T>(vector.data(), vector.size()), stream);
+}
+
+template <typename T>
+void StandardCodecSerializer::WriteTypedData(const TypedDataView<T>& data,
+                                             ByteStreamWriter* stream) const {
+  size_t count = data.size();
   WriteSize(count, stream);
   if (count == 0) {
     return;
@@ -283,8 +421,291 @@ void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
   if (type_size > 1) {
     stream->WriteAlignment(type_size);
   }
-  stream->WriteBytes(reinterpret_cast<const uint8_t*>(vector.data()),
-                     count * type_size);
+  stream->WriteBytes(data.bytes(), data.size_in_bytes());
+}
+
+std::optional<EncodableValueView> StandardCodecSerializer::ReadValueView(
+    const uint8_t* message,
+    size_t message_size) const {
+  size_t end = 0;
+  if (!SkipValueView(message, message_size, &end)) {
+    return std::nullopt;
+  }
+  EncodableValueView value;
+  ReadValueViewAt(message, message_size, 0, &value);
+  return value;
+}
+
+void StandardCodecSerializer::WriteValueView(const EncodableValueView& value,
+                                             ByteStreamWriter* stream) const {
+  stream->WriteByte(static_cast<uint8_t>(EncodedTypeForValueView(value)));
+  switch (value.index()) {
+    case 0:
+    case 1:
+      // Null and bool are encoded directly in the type.
+      break;
+    case 2:
+      stream->WriteInt32(std::get<int32_t>(value));
+      break;
+    case 3:
+      stream->WriteInt64(std::get<int64_t>(value));
+      break;
+    case 4:
+      stream->WriteAlignment(8);
+      stream->WriteDouble(std::get<double>(value));
+      break;
+    case 5: {
+      std::string_view string_value = std::get<std::string_view>(value);
+      size_t size = string_value.size();
+      WriteSize(size, stream);
+      if (size > 0) {
+        stream->WriteBytes(
+            reinterpret_cast<const uint8_t*>(string_value.data()), size);
+      }
+      break;
+    }
+    case 6:
+      WriteTypedData(std::get<TypedDataView<uint8_t>>(value), stream);
+      break;
+    case 7:
+      WriteTypedData(std::get<TypedDataView<int32_t>>(value), stream);
+      break;
+    case 8:
+      WriteTypedData(std::get<TypedDataView<int64_t>>(value), stream);
+      break;
+    case 9:
+      WriteTypedData(std::get<TypedDataView<double>>(value), stream);
+      break;
+    case 10: {
+      const auto& list = std::get<EncodableListView>(value);
+      WriteSize(list.size(), stream);
+      for (const EncodableValueView& item : list) {
+        WriteValueView(item, stream);
+      }
+      break;
+    }
+    case 11: {
+      const auto& map = std::get<EncodableMapView>(value);
+      WriteSize(map.size(), stream);
+      for (const auto& pair : map) {
+        WriteValueView(pair.first, stream);
+        WriteValueView(pair.second, stream);
+      }
+      break;
+    }
+    case 12:
+      WriteTypedData(std::get<TypedDataView<float>>(value), stream);
+      break;
+  }
+}
+
+// static
+void StandardCodecSerializer::ReadValueViewAt(const uint8_t* message,
+                                              size_t message_size,
+                                              size_t offset,
+                                              EncodableValueView* value) {
+  uint8_t type = message[offset++];
+  switch (static_cast<EncodedType>(type)) {
+    case EncodedType::kNull:
+      *value = EncodableValueView();
+      return;
+    case EncodedType::kTrue:
+      *value = true;
+      return;
+    case EncodedType::kFalse:
+      *value = false;
+      return;
+    case EncodedType::kInt32:
+      *value = ReadScalarAt<int32_t>(message, offset);
+      return;
+    case EncodedType::kInt64:
+      *value = ReadScalarAt<int64_t>(message, offset);
+      return;
+    case EncodedType::kFloat64: {
+      size_t start = 0;
+      ReadBytesAt(message_size, 8, 8, &offset, &start);
+      *value = ReadScalarAt<double>(message, start);
+      return;
+    }
+    case EncodedType::kLargeInt:
+    case EncodedType::kString: {
+      size_t start = 0;
+      size_t size = 0;
+      ReadTypedDataAt<uint8_t>(message, message_size, &offset, &start, &size);
+      *value = std::string_view(reinterpret_cast<const char*>(message + start),
+                                size);
+      return;
+    }
+    case EncodedType::kUInt8List:
+      *value = ReadTypedDataViewAt<uint8_t>(message, message_size, offset);
+      return;
+    case EncodedType::kInt32List:
+      *value = ReadTypedDataViewAt<int32_t>(message, message_size, offset);
+      return;
+    case EncodedType::kInt64List:
+      *value = ReadTypedDataViewAt<int64_t>(message, message_size, offset);
+      return;
+    case EncodedType::kFloat64List:
+      *value = ReadTypedDataViewAt<double>(message, message_size, offset);
+      return;
+    case EncodedType::kList: {
+      size_t size = 0;
+      ReadSizeAt(message, message_size, &offset, &size);
+      *value = EncodableListView(message, message_size, offset, size);
+      return;
+    }
+    case EncodedType::kMap: {
+      size_t size = 0;
+      ReadSizeAt(message, message_size, &offset, &size);
+      *value = EncodableMapView(message, message_size, offset, size);
+      return;
+    }
+    case EncodedType::kFloat32List:
+      *value = ReadTypedDataViewAt<float>(message, message_size, offset);
+      return;
+  }
+  // Unreachable for validated messages.
+  assert(false);
+  *value = EncodableValueView();
+}
+
+// static
+bool StandardCodecSerializer::SkipValueView(const uint8_t* message,
+                                            size_t message_size,
+                                            size_t* offset) {
+  if (*offset >= message_size) {
+    return false;
+  }
+  uint8_t type = message[(*offset)++];
+  size_t start = 0;
+  size_t size = 0;
+  switch (static_cast<EncodedType>(type)) {
+    case EncodedType::kNull:
+    case EncodedType::kTrue:
+    case EncodedType::kFalse:
+      return true;
+    case EncodedType::kInt32:
+      return ReadBytesAt(message_size, 1, 4, offset, &start);
+    case EncodedType::kInt64:
+      return ReadBytesAt(message_size, 1, 8, offset, &start);
+    case EncodedType::kFloat64:
+      return ReadBytesAt(message_size, 8, 8, offset, &start);
+    case EncodedType::kLargeInt:
+    case EncodedType::kString:
+    case EncodedType::kUInt8List:
+      return ReadTypedDataAt<uint8_t>(message, message_size, offset, &start,
+                                      &size);
+    case EncodedType::kInt32List:
+      return ReadTypedDataAt<int32_t>(message, message_size, offset, &start,
+                                      &size);
+    case EncodedType::kInt64List:
+      return ReadTypedDataAt<int64_t>(message, message_size, offset, &start,
+                                      &size);
+    case EncodedType::kFloat64List:
+      return ReadTypedDataAt<double>(message, message_size, offset, &start,
+                                     &size);
+    case EncodedType::kFloat32List:
+      return ReadTypedDataAt<float>(message, message_size, offset, &start,
+                                    &size);
+    case EncodedType::kList:
+    case EncodedType::kMap: {
+      if (!ReadSizeAt(message, message_size, offset, &size)) {
+        return false;
+      }
+      size_t count =
+          static_cast<EncodedType>(type) == EncodedType::kMap ? size * 2 : size;
+      for (size_t i = 0; i < count; ++i) {
+        if (!SkipValueView(message, message_size, offset)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+// ===== encodable_value_view.h =====
+
+EncodableValueView EncodableListView::const_iterator::operator*() const {
+  EncodableValueView value;
+  StandardCodecSerializer::ReadValueViewAt(message_, message_size_, offset_,
+                                           &value);
+  return value;
+}
+
+EncodableListView::const_iterator&
+EncodableListView::const_iterator::operator++() {
+  StandardCodecSerializer::SkipValueView(message_, message_size_, &offset_);
+  --remaining_;
+  return *this;
+}
+
+EncodableMapView::const_iterator::value_type
+EncodableMapView::const_iterator::operator*() const {
+  value_type entry;
+  size_t value_offset = offset_;
+  StandardCodecSerializer::ReadValueViewAt(message_, message_size_, offset_,
+                                           &entry.first);
+  StandardCodecSerializer::SkipValueView(message_, message_size_,
+                                         &value_offset);
+  StandardCodecSerializer::ReadValueViewAt(message_, message_size_,
+                                           value_offset, &entry.second);
+  return entry;
+}
+
+EncodableMapView::const_iterator&
+EncodableMapView::const_iterator::operator++() {
+  StandardCodecSerializer::SkipValueView(message_, message_size_, &offset_);
+  StandardCodecSerializer::SkipValueView(message_, message_size_, &offset_);
+  --remaining_;
+  return *this;
+}
+
+EncodableValue EncodableValueView::ToEncodableValue() const {
+  switch (index()) {
+    case 0:
+      return EncodableValue();
+    case 1:
+      return EncodableValue(std::get<bool>(*this));
+    case 2:
+      return EncodableValue(std::get<int32_t>(*this));
+    case 3:
+      return EncodableValue(std::get<int64_t>(*this));
+    case 4:
+      return EncodableValue(std::get<double>(*this));
+    case 5:
+      return EncodableValue(std::string(std::get<std::string_view>(*this)));
+    case 6:
+      return EncodableValue(std::get<TypedDataView<uint8_t>>(*this).ToVector());
+    case 7:
+      return EncodableValue(std::get<TypedDataView<int32_t>>(*this).ToVector());
+    case 8:
+      return EncodableValue(std::get<TypedDataView<int64_t>>(*this).ToVector());
+    case 9:
+      return EncodableValue(std::get<TypedDataView<double>>(*this).ToVector());
+    case 10: {
+      const auto& list_view = std::get<EncodableListView>(*this);
+      EncodableList list;
+      list.reserve(list_view.size());
+      for (const EncodableValueView& item : list_view) {
+        list.push_back(item.ToEncodableValue());
+      }
+      return EncodableValue(std::move(list));
+    }
+    case 11: {
+      EncodableMap map;
+      for (const auto& pair : std::get<EncodableMapView>(*this)) {
+        map.emplace(pair.first.ToEncodableValue(),
+                    pair.second.ToEncodableValue());
+      }
+      return EncodableValue(std::move(map));
+    }
+    case 12:
+      return EncodableValue(std::get<TypedDataView<float>>(*this).ToVector());
+  }
+  assert(false);
+  return EncodableValue();
 }
 
 // ===== standard_message_codec.h =====
@@ -325,6 +746,31 @@ std::unique_ptr<EncodableValue> StandardMessageCodec::DecodeMessageInternal(
   return std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
 }
 
+std::optional<EncodableValueView> StandardMessageCodec::DecodeMessageView(
+    const uint8_t* binary_message,
+    size_t message_size) const {
+  if (!binary_message || message_size == 0) {
+    return EncodableValueView();
+  }
+  return serializer_->ReadValueView(binary_message, message_size);
+}
+
+void StandardMessageCodec::EncodeMessageToBuffer(
+    const EncodableValue& message,
+    std::vector<uint8_t>* buffer) const {
+  buffer->clear();
+  ByteBufferStreamWriter stream(buffer);
+  serializer_->WriteValue(message, &stream);
+}
+
+void StandardMessageCodec::EncodeMessageToBuffer(
+    const EncodableValueView& message,
+    std::vector<uint8_t>* buffer) const {
+  buffer->clear();
+  ByteBufferStreamWriter stream(buffer);
+  serializer_->WriteValueView(message, &stream);
+}
+
 std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
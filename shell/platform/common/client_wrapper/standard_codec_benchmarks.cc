@@ -0,0 +1,181 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/encodable_value_view.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// Returns the encoding of a byte array of |size| bytes, such as a camera
+// frame.
+std::unique_ptr<std::vector<uint8_t>> EncodeByteArray(size_t size) {
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; ++i) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  return StandardMessageCodec::GetInstance().EncodeMessage(
+      EncodableValue(std::move(bytes)));
+}
+
+// Returns a batch of |count| sensor readings, each a map with a timestamp and
+// a Float32List of samples.
+EncodableValue MakeSensorBatch(size_t count) {
+  EncodableList batch;
+  batch.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    batch.emplace_back(EncodableMap{
+        {EncodableValue("timestamp"),
+         EncodableValue(static_cast<int64_t>(i) * 1000)},
+        {EncodableValue("samples"),
+         EncodableValue(std::vector<float>{0.1f * i, 0.2f * i, 0.3f * i})},
+    });
+  }
+  return EncodableValue(std::move(batch));
+}
+
+}  // namespace
+
+static void BM_StandardCodecDecodeByteArray(benchmark::State& state) {
+  auto encoded = EncodeByteArray(state.range(0));
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  for (auto _ : state) {
+    auto value = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecDecodeByteArrayView(benchmark::State& state) {
+  auto encoded = EncodeByteArray(state.range(0));
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  for (auto _ : state) {
+    auto view = codec.DecodeMessageView(encoded->data(), encoded->size());
+    benchmark::DoNotOptimize(view);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecDecodeSensorBatch(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(MakeSensorBatch(state.range(0)));
+  for (auto _ : state) {
+    auto value = codec.DecodeMessage(*encoded);
+    double sum = 0;
+    for (const EncodableValue& reading : std::get<EncodableList>(*value)) {
+      const auto& map = std::get<EncodableMap>(reading);
+      const auto& samples =
+          std::get<std::vector<float>>(map.at(EncodableValue("samples")));
+      for (float sample : samples) {
+        sum += sample;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecDecodeSensorBatchView(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(MakeSensorBatch(state.range(0)));
+  for (auto _ : state) {
+    auto view = codec.DecodeMessageView(encoded->data(), encoded->size());
+    double sum = 0;
+    for (const EncodableValueView& reading :
+         std::get<EncodableListView>(*view)) {
+      for (const auto& entry : std::get<EncodableMapView>(reading)) {
+        if (std::get<std::string_view>(entry.first) != "samples") {
+          continue;
+        }
+        const auto& samples = std::get<TypedDataView<float>>(entry.second);
+        for (size_t i = 0; i < samples.size(); ++i) {
+          sum += samples[i];
+        }
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecEncodeFloatArray(benchmark::State& state) {
+  std::vector<float> samples(state.range(0), 0.5f);
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  for (auto _ : state) {
+    // Sending client-owned data previously required copying it into an
+    // EncodableValue.
+    auto encoded = codec.EncodeMessage(EncodableValue(samples));
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(state.iterations() * samples.size() * sizeof(float));
+}
+
+static void BM_StandardCodecEncodeFloatArrayViewToBuffer(
+    benchmark::State& state) {
+  std::vector<float> samples(state.range(0), 0.5f);
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<uint8_t> buffer;
+  for (auto _ : state) {
+    codec.EncodeMessageToBuffer(
+        EncodableValueView(
+            TypedDataView<float>(samples.data(), samples.size())),
+        &buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * samples.size() * sizeof(float));
+}
+
+static void BM_StandardCodecEncodeSensorBatch(benchmark::State& state) {
+  EncodableValue batch = MakeSensorBatch(state.range(0));
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  for (auto _ : state) {
+    auto encoded = codec.EncodeMessage(batch);
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+static void BM_StandardCodecEncodeSensorBatchToBuffer(
+    benchmark::State& state) {
+  EncodableValue batch = MakeSensorBatch(state.range(0));
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<uint8_t> buffer;
+  for (auto _ : state) {
+    codec.EncodeMessageToBuffer(batch, &buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+BENCHMARK(BM_StandardCodecDecodeByteArray)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_StandardCodecDecodeByteArrayView)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_StandardCodecDecodeSensorBatch)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK(BM_StandardCodecDecodeSensorBatchView)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK(BM_StandardCodecEncodeFloatArray)
+    ->RangeMultiplier(8)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_StandardCodecEncodeFloatArrayViewToBuffer)
+    ->RangeMultiplier(8)
+    ->Range(1 << 8, 1 << 20);
+BENCHMARK(BM_StandardCodecEncodeSensorBatch)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+BENCHMARK(BM_StandardCodecEncodeSensorBatchToBuffer)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096);
+
+}  // namespace flutter
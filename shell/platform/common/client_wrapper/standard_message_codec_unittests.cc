@@ -5,6 +5,8 @@
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
 
 #include <map>
+#include <optional>
+#include <string_view>
 #include <vector>
 
 #include "flutter/shell/platform/common/client_wrapper/testing/test_codec_extensions.h"
@@ -262,4 +264,170 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeVariableLengthCustomType) {
                     some_data_comparator);
 }
 
+TEST(StandardMessageCodec, CanDecodeViewsOfAllStandardTypes) {
+  EncodableValue value(EncodableList{
+      EncodableValue(),
+      EncodableValue(true),
+      EncodableValue(false),
+      EncodableValue(0x12345678),
+      EncodableValue(INT64_C(0x1234567890abcdef)),
+      EncodableValue(3.14),
+      EncodableValue("hello"),
+      EncodableValue(std::vector<uint8_t>{0xba, 0x5e, 0xba, 0x11}),
+      EncodableValue(std::vector<int32_t>{0x12345678, -1, 0}),
+      EncodableValue(std::vector<int64_t>{0x1234567890abcdef, -1}),
+      EncodableValue(std::vector<float>{3.14f, 1000.0f}),
+      EncodableValue(std::vector<double>{3.14, 1000.0}),
+      EncodableValue(EncodableList{EncodableValue("nested")}),
+      EncodableValue(EncodableMap{
+          {EncodableValue("a"), EncodableValue(3.14)},
+          {EncodableValue(47), EncodableValue(std::vector<uint8_t>{})},
+      }),
+  });
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  std::optional<EncodableValueView> view =
+      codec.DecodeMessageView(encoded->data(), encoded->size());
+  ASSERT_TRUE(view.has_value());
+  ASSERT_TRUE(std::holds_alternative<EncodableListView>(*view));
+  EXPECT_EQ(std::get<EncodableListView>(*view).size(), 14u);
+  EXPECT_EQ(view->ToEncodableValue(), value);
+}
+
+TEST(StandardMessageCodec, DecodedViewsBorrowFromTheMessage) {
+  EncodableValue value(EncodableList{
+      EncodableValue("hello"),
+      EncodableValue(std::vector<uint8_t>{0xba, 0x5e, 0xba, 0x11}),
+      EncodableValue(std::vector<float>{3.14f, 1000.0f}),
+  });
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+  const uint8_t* message_start = encoded->data();
+  const uint8_t* message_end = message_start + encoded->size();
+  auto is_in_message = [&](const void* pointer) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(pointer);
+    return bytes >= message_start && bytes < message_end;
+  };
+
+  std::optional<EncodableValueView> view =
+      codec.DecodeMessageView(encoded->data(), encoded->size());
+  ASSERT_TRUE(view.has_value());
+  auto it = std::get<EncodableListView>(*view).begin();
+
+  std::string_view string_value = std::get<std::string_view>(*it++);
+  EXPECT_EQ(string_value, "hello");
+  EXPECT_TRUE(is_in_message(string_value.data()));
+
+  TypedDataView<uint8_t> bytes = std::get<TypedDataView<uint8_t>>(*it++);
+  ASSERT_EQ(bytes.size(), 4u);
+  EXPECT_EQ(bytes[1], 0x5e);
+  EXPECT_TRUE(is_in_message(bytes.bytes()));
+
+  TypedDataView<float> floats = std::get<TypedDataView<float>>(*it++);
+  ASSERT_EQ(floats.size(), 2u);
+  EXPECT_EQ(floats[0], 3.14f);
+  EXPECT_EQ(floats[1], 1000.0f);
+  EXPECT_TRUE(is_in_message(floats.bytes()));
+  EXPECT_EQ(it, std::get<EncodableListView>(*view).end());
+}
+
+TEST(StandardMessageCodec, CanIterateMapViews) {
+  EncodableValue value(EncodableMap{
+      {EncodableValue("a"), EncodableValue(EncodableList{EncodableValue(1)})},
+      {EncodableValue("b"), EncodableValue(2)},
+  });
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  std::optional<EncodableValueView> view =
+      codec.DecodeMessageView(encoded->data(), encoded->size());
+  ASSERT_TRUE(view.has_value());
+  std::map<std::string_view, EncodableValue> entries;
+  for (const auto& entry : std::get<EncodableMapView>(*view)) {
+    entries.emplace(std::get<std::string_view>(entry.first),
+                    entry.second.ToEncodableValue());
+  }
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries["a"], EncodableValue(EncodableList{EncodableValue(1)}));
+  EXPECT_EQ(entries["b"], EncodableValue(2));
+}
+
+TEST(StandardMessageCodec, CanDecodeEmptyBytesAsNullView) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::optional<EncodableValueView> view = codec.DecodeMessageView(nullptr, 0);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_TRUE(view->IsNull());
+}
+
+TEST(StandardMessageCodec, DecodeMessageViewRejectsInvalidMessages) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  // A list claiming two elements, with only one present.
+  std::vector<uint8_t> truncated_list = {0x0c, 0x02, 0x03, 0x2a,
+                                         0x00, 0x00, 0x00};
+  EXPECT_FALSE(
+      codec.DecodeMessageView(truncated_list.data(), truncated_list.size()));
+  // A byte array claiming more bytes than are present.
+  std::vector<uint8_t> truncated_bytes = {0x08, 0x04, 0xba, 0x5e};
+  EXPECT_FALSE(
+      codec.DecodeMessageView(truncated_bytes.data(), truncated_bytes.size()));
+  // A custom type.
+  std::vector<uint8_t> custom = {0x80, 0x09, 0x00, 0x00, 0x00,
+                                 0x10, 0x00, 0x00, 0x00};
+  EXPECT_FALSE(codec.DecodeMessageView(custom.data(), custom.size()));
+}
+
+TEST(StandardMessageCodec, EncodeMessageToBufferReplacesContents) {
+  EncodableValue value(std::vector<double>{3.14, 1000.0});
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto expected = codec.EncodeMessage(value);
+  ASSERT_TRUE(expected);
+
+  std::vector<uint8_t> buffer = {0x01, 0x02, 0x03};
+  codec.EncodeMessageToBuffer(value, &buffer);
+  EXPECT_EQ(buffer, *expected);
+
+  // Reusing the buffer shouldn't reallocate it.
+  const uint8_t* data = buffer.data();
+  codec.EncodeMessageToBuffer(value, &buffer);
+  EXPECT_EQ(buffer, *expected);
+  EXPECT_EQ(buffer.data(), data);
+}
+
+TEST(StandardMessageCodec, CanEncodeViews) {
+  std::vector<float> floats = {3.14f, 1000.0f};
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto expected = codec.EncodeMessage(EncodableValue(floats));
+  ASSERT_TRUE(expected);
+
+  std::vector<uint8_t> buffer;
+  codec.EncodeMessageToBuffer(
+      EncodableValueView(TypedDataView<float>(floats.data(), floats.size())),
+      &buffer);
+  EXPECT_EQ(buffer, *expected);
+}
+
+TEST(StandardMessageCodec, ReencodingDecodedViewsIsLossless) {
+  EncodableValue value(EncodableList{
+      EncodableValue("hello"),
+      EncodableValue(std::vector<int64_t>{0x1234567890abcdef, -1}),
+      EncodableValue(EncodableMap{
+          {EncodableValue("a"), EncodableValue(3.14)},
+      }),
+  });
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  std::optional<EncodableValueView> view =
+      codec.DecodeMessageView(encoded->data(), encoded->size());
+  ASSERT_TRUE(view.has_value());
+  std::vector<uint8_t> reencoded;
+  codec.EncodeMessageToBuffer(*view, &reencoded);
+  EXPECT_EQ(reencoded, *encoded);
+}
+
 }  // namespace flutter
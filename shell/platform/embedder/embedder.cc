@@ -5,6 +5,7 @@
 #define FML_USED_ON_EMBEDDER
 #define RAPIDJSON_HAS_STDSTRING 1
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -175,8 +176,20 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
-  if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+  // The buffer callbacks must be specified together.
+  int buffer_callback_count =
+      SAFE_EXISTS(software_config, acquire_buffer_callback) +
+      SAFE_EXISTS(software_config, present_buffer_callback) +
+      SAFE_EXISTS(software_config, release_buffer_callback);
+  if (buffer_callback_count != 0 && buffer_callback_count != 3) {
+    return false;
+  }
+
+  int present_mode_count =
+      SAFE_EXISTS(software_config, surface_present_callback) +
+      SAFE_EXISTS(software_config, surface_present_with_info_callback) +
+      (buffer_callback_count == 3);
+  if (present_mode_count != 1) {
     return false;
   }
 
@@ -255,7 +268,6 @@ static void* DefaultGLProcResolver(const char* name) {
 }
 #endif  // FML_OS_LINUX || FML_OS_WIN
 
-#ifdef SHELL_ENABLE_GL
 // Auxiliary function used to translate rectangles of type SkIRect to
 // FlutterRect.
 static FlutterRect SkIRectToFlutterRect(const SkIRect sk_rect) {
@@ -266,6 +278,7 @@ static FlutterRect SkIRectToFlutterRect(const SkIRect sk_rect) {
   return flutter_rect;
 }
 
+#ifdef SHELL_ENABLE_GL
 // Auxiliary function used to translate rectangles of type FlutterRect to
 // SkIRect.
 static const SkIRect FlutterRectToSkIRect(FlutterRect flutter_rect) {
@@ -304,18 +317,26 @@ InferOpenGLPlatformViewCreationCallback(
     if (present) {
       return present(user_data);
     } else {
-      // Format the frame and buffer damages accordingly. Note that, since the
-      // current compute damage algorithm only returns one rectangle for damage
-      // we are assuming the number of rectangles provided in frame and buffer
-      // damage are always 1. Once the function that computes damage implements
-      // support for multiple damage rectangles, GLPresentInfo should also
-      // contain the number of damage rectangles.
-      const size_t num_rects = 1;
-
-      std::array<FlutterRect, num_rects> frame_damage_rect = {
-          SkIRectToFlutterRect(*(gl_present_info.frame_damage))};
-      std::array<FlutterRect, num_rects> buffer_damage_rect = {
-          SkIRectToFlutterRect(*(gl_present_info.buffer_damage))};
+      // Format the frame and buffer damages accordingly. If the damage was
+      // not split into multiple rectangles, the bounding damage rectangle is
+      // reported as the only rectangle.
+      auto to_flutter_rects = [](const std::optional<SkIRect>& damage,
+                                 const std::vector<SkIRect>& damage_rects) {
+        std::vector<FlutterRect> rects;
+        if (!damage_rects.empty()) {
+          rects.reserve(damage_rects.size());
+          for (const auto& rect : damage_rects) {
+            rects.push_back(SkIRectToFlutterRect(rect));
+          }
+        } else {
+          rects.push_back(SkIRectToFlutterRect(*damage));
+        }
+        return rects;
+      };
+      std::vector<FlutterRect> frame_damage_rect = to_flutter_rects(
+          gl_present_info.frame_damage, gl_present_info.frame_damage_rects);
+      std::vector<FlutterRect> buffer_damage_rect = to_flutter_rects(
+          gl_present_info.buffer_damage, gl_present_info.buffer_damage_rects);
 
       FlutterDamage frame_damage{
           .struct_size = sizeof(FlutterDamage),
@@ -440,6 +461,9 @@ InferOpenGLPlatformViewCreationCallback(
   bool fbo_reset_after_present =
       SAFE_ACCESS(open_gl_config, fbo_reset_after_present, false);
 
+  size_t max_damage_rects =
+      std::max<size_t>(SAFE_ACCESS(open_gl_config, max_damage_rects, 1), 1);
+
   flutter::EmbedderSurfaceGL::GLDispatchTable gl_dispatch_table = {
       gl_make_current,                     // gl_make_current_callback
       gl_clear_current,                    // gl_clear_current_callback
@@ -452,8 +476,8 @@ InferOpenGLPlatformViewCreationCallback(
   };
 
   return fml::MakeCopyable(
-      [gl_dispatch_table, fbo_reset_after_present, platform_dispatch_table,
-       enable_impeller,
+      [gl_dispatch_table, fbo_reset_after_present, max_damage_rects,
+       platform_dispatch_table, enable_impeller,
        external_view_embedder =
            std::move(external_view_embedder)](flutter::Shell& shell) mutable {
         std::shared_ptr<flutter::EmbedderExternalViewEmbedder> view_embedder =
@@ -473,7 +497,7 @@ InferOpenGLPlatformViewCreationCallback(
             shell,                   // delegate
             shell.GetTaskRunners(),  // task runners
             std::make_unique<flutter::EmbedderSurfaceGL>(
-                gl_dispatch_table, fbo_reset_after_present,
+                gl_dispatch_table, fbo_reset_after_present, max_damage_rects,
                 view_embedder),       // embedder_surface
             platform_dispatch_table,  // embedder platform dispatch table
             view_embedder             // external view embedder
@@ -659,6 +683,23 @@ InferVulkanPlatformViewCreationCallback(
 #endif
 }
 
+// Formats the frame damage of a software surface. The frame damage must be
+// specified. If it was not split into multiple rectangles, the bounding damage
+// rectangle is reported as the only rectangle.
+static std::vector<FlutterRect> FrameDamageToFlutterRects(
+    const flutter::SoftwarePresentInfo& info) {
+  std::vector<FlutterRect> rects;
+  if (!info.frame_damage_rects.empty()) {
+    rects.reserve(info.frame_damage_rects.size());
+    for (const auto& rect : info.frame_damage_rects) {
+      rects.push_back(SkIRectToFlutterRect(rect));
+    }
+  } else {
+    rects.push_back(SkIRectToFlutterRect(*info.frame_damage));
+  }
+  return rects;
+}
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferSoftwarePlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -671,27 +712,135 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
-  auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
-  };
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  std::function<bool(const void*, size_t, size_t)>
+      software_present_backing_store;
+  if (auto ptr = SAFE_ACCESS(software_config, surface_present_callback,
+                             nullptr)) {
+    software_present_backing_store = [ptr, user_data](const void* allocation,
+                                                      size_t row_bytes,
+                                                      size_t height) -> bool {
+      return ptr(user_data, allocation, row_bytes, height);
+    };
+  }
+
+  std::function<bool(const void*, size_t, size_t,
+                     const flutter::SoftwarePresentInfo&)>
+      software_present_backing_store_with_info;
+  if (auto ptr = SAFE_ACCESS(software_config,
+                             surface_present_with_info_callback, nullptr)) {
+    software_present_backing_store_with_info =
+        [ptr, user_data](const void* allocation, size_t row_bytes,
+                         size_t height,
+                         const flutter::SoftwarePresentInfo& info) -> bool {
+      std::vector<FlutterRect> rects = FrameDamageToFlutterRects(info);
+
+      FlutterSoftwarePresentInfo present_info = {
+          .struct_size = sizeof(FlutterSoftwarePresentInfo),
+          .allocation = allocation,
+          .row_bytes = row_bytes,
+          .height = height,
+          .frame_damage =
+              {
+                  .struct_size = sizeof(FlutterDamage),
+                  .num_rects = rects.size(),
+                  .damage = rects.data(),
+              },
+      };
+      return ptr(user_data, &present_info);
+    };
+  }
+
+  std::function<bool(const SkISize&,
+                     flutter::EmbedderSurfaceSoftware::SoftwareBuffer*)>
+      software_acquire_buffer;
+  std::function<bool(uint64_t, const flutter::SoftwarePresentInfo&)>
+      software_present_buffer;
+  std::function<void(uint64_t)> software_release_buffer;
+  if (SAFE_EXISTS(software_config, acquire_buffer_callback)) {
+    software_acquire_buffer =
+        [ptr = software_config->acquire_buffer_callback,
+         release = software_config->release_buffer_callback, user_data](
+            const SkISize& size,
+            flutter::EmbedderSurfaceSoftware::SoftwareBuffer* buffer) -> bool {
+      FlutterFrameInfo frame_info = {
+          .struct_size = sizeof(FlutterFrameInfo),
+          .size = {static_cast<uint32_t>(size.width()),
+                   static_cast<uint32_t>(size.height())},
+      };
+      FlutterSoftwareBuffer software_buffer = {};
+      software_buffer.struct_size = sizeof(FlutterSoftwareBuffer);
+      if (!ptr(user_data, &frame_info, &software_buffer)) {
+        return false;
+      }
+      if (software_buffer.allocation == nullptr ||
+          software_buffer.height != static_cast<size_t>(size.height())) {
+        FML_LOG(ERROR) << "The embedder returned a software buffer that "
+                          "doesn't fit the frame.";
+        // The engine owns the buffer from here on, so it has to be handed
+        // back even though it can't be used.
+        release(user_data, software_buffer.buffer_id);
+        return false;
+      }
+      buffer->id = software_buffer.buffer_id;
+      buffer->allocation = software_buffer.allocation;
+      buffer->row_bytes = software_buffer.row_bytes;
+      return true;
+    };
+    software_present_buffer =
+        [ptr = software_config->present_buffer_callback, user_data](
+            uint64_t buffer_id,
+            const flutter::SoftwarePresentInfo& info) -> bool {
+      std::vector<FlutterRect> rects = FrameDamageToFlutterRects(info);
+
+      FlutterSoftwareBufferPresentInfo present_info = {
+          .struct_size = sizeof(FlutterSoftwareBufferPresentInfo),
+          .buffer_id = buffer_id,
+          .frame_damage =
+              {
+                  .struct_size = sizeof(FlutterDamage),
+                  .num_rects = rects.size(),
+                  .damage = rects.data(),
+              },
+      };
+      return ptr(user_data, &present_info);
+    };
+    software_release_buffer =
+        [ptr = software_config->release_buffer_callback,
+         user_data](uint64_t buffer_id) { ptr(user_data, buffer_id); };
+  }
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          .software_present_backing_store = software_present_backing_store,
+          .software_present_backing_store_with_info =
+              software_present_backing_store_with_info,
+          .max_damage_rects = std::max<size_t>(
+              SAFE_ACCESS(software_config, max_damage_rects, 1), 1),
+          .software_acquire_buffer = software_acquire_buffer,
+          .software_present_buffer = software_present_buffer,
+          .software_release_buffer = software_release_buffer,
       };
 
   return fml::MakeCopyable(
       [software_dispatch_table, platform_dispatch_table,
        external_view_embedder =
            std::move(external_view_embedder)](flutter::Shell& shell) mutable {
+        std::shared_ptr<flutter::DlSkTiledRasterizer> tiled_rasterizer;
+        if (shell.GetSettings().enable_tiled_software_rasterization) {
+          // The raster thread renders a band of its own.
+          auto loop = shell.GetDartVM()->GetConcurrentMessageLoop();
+          tiled_rasterizer = std::make_shared<flutter::DlSkTiledRasterizer>(
+              loop->GetTaskRunner(), loop->GetWorkerCount() + 1);
+        }
         return std::make_unique<flutter::PlatformViewEmbedder>(
-            shell,                             // delegate
-            shell.GetTaskRunners(),            // task runners
-            software_dispatch_table,           // software dispatch table
-            platform_dispatch_table,           // platform dispatch table
-            std::move(external_view_embedder)  // external view embedder
+            shell,                              // delegate
+            shell.GetTaskRunners(),             // task runners
+            software_dispatch_table,            // software dispatch table
+            platform_dispatch_table,            // platform dispatch table
+            std::move(external_view_embedder),  // external view embedder
+            std::move(tiled_rasterizer)         // tiled rasterizer
         );
       });
 }
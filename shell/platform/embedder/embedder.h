@@ -588,6 +588,14 @@ typedef struct {
   /// ID. Not specifying populate_existing_damage will result in full
   /// repaint (i.e. rendering all the pixels on the screen at every frame).
   FlutterFrameBufferWithDamageCallback populate_existing_damage;
+  /// The maximum number of disjoint rectangles the engine may report in the
+  /// `frame_damage` and `buffer_damage` of `FlutterPresentInfo`. Distant
+  /// damaged areas (for example a blinking cursor and a progress indicator in
+  /// opposite corners) are then reported separately instead of as a single
+  /// bounding rectangle. A value of 0 or 1 reports at most one rectangle.
+  /// Only used when `present_with_info` and `populate_existing_damage` are
+  /// specified.
+  size_t max_damage_rects;
 } FlutterOpenGLRendererConfig;
 
 /// Alias for id<MTLDevice>.
@@ -811,14 +819,142 @@ typedef struct {
 
 } FlutterVulkanRendererConfig;
 
+/// This information is passed to the embedder when a software surface is
+/// presented.
+///
+/// See: \ref FlutterSoftwareRendererConfig.surface_present_with_info_callback.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwarePresentInfo).
+  size_t struct_size;
+  /// The fully populated buffer. The pixel format of the buffer is the native
+  /// 32-bit RGBA format. The buffer is owned by the Flutter engine.
+  const void* allocation;
+  /// The number of bytes in a row of the buffer.
+  size_t row_bytes;
+  /// The number of rows in the buffer.
+  size_t height;
+  /// The areas of the buffer that changed since the last present call. Only
+  /// these need to be copied to the user's framebuffer. The rectangles are
+  /// owned by the Flutter engine and only valid for the duration of the call.
+  FlutterDamage frame_damage;
+} FlutterSoftwarePresentInfo;
+
+/// Callback for when a software surface is presented.
+typedef bool (*SoftwareSurfacePresentWithInfoCallback)(
+    void* /* user data */,
+    const FlutterSoftwarePresentInfo* /* present info */);
+
+/// A pixel buffer owned by the embedder that the engine renders a frame into.
+///
+/// See: \ref FlutterSoftwareRendererConfig.acquire_buffer_callback.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwareBuffer).
+  size_t struct_size;
+  /// Identifies the buffer in the other buffer callbacks. Each buffer of the
+  /// embedder's pool must have its own identifier, and the identifier must
+  /// not be reused for a different allocation while the engine is running.
+  uint64_t buffer_id;
+  /// The pixels of the buffer, in the native 32-bit RGBA format. The
+  /// allocation must stay valid until the buffer is handed back to the
+  /// embedder.
+  void* allocation;
+  /// The number of bytes in a row of the buffer. Must be at least 4 times the
+  /// width of the frame.
+  size_t row_bytes;
+  /// The number of rows in the buffer. Must be the height of the frame.
+  size_t height;
+} FlutterSoftwareBuffer;
+
+/// Callback for when the engine needs a buffer to render a frame into.
+typedef bool (*SoftwareBufferAcquireCallback)(
+    void* /* user data */,
+    const FlutterFrameInfo* /* frame info */,
+    FlutterSoftwareBuffer* /* buffer out */);
+
+/// This information is passed to the embedder when a frame rendered into one
+/// of its buffers is presented.
+///
+/// See: \ref FlutterSoftwareRendererConfig.present_buffer_callback.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterSoftwareBufferPresentInfo).
+  size_t struct_size;
+  /// The identifier of the buffer that holds the frame.
+  uint64_t buffer_id;
+  /// The areas of the frame that changed since the previously presented
+  /// frame, which may have been rendered into a different buffer. The
+  /// rectangles are owned by the Flutter engine and only valid for the
+  /// duration of the call.
+  FlutterDamage frame_damage;
+} FlutterSoftwareBufferPresentInfo;
+
+/// Callback for when a frame rendered into a buffer of the embedder is
+/// presented.
+typedef bool (*SoftwareBufferPresentCallback)(
+    void* /* user data */,
+    const FlutterSoftwareBufferPresentInfo* /* present info */);
+
+/// Callback for when the engine hands back a buffer without presenting it.
+typedef void (*SoftwareBufferReleaseCallback)(void* /* user data */,
+                                              uint64_t /* buffer id */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
   size_t struct_size;
+  /// Specifying one (and only one) of `surface_present_callback`,
+  /// `surface_present_with_info_callback` or the buffer callbacks
+  /// (`acquire_buffer_callback`, `present_buffer_callback` and
+  /// `release_buffer_callback`) is required. Specifying more than one is an
+  /// error and engine initialization will be terminated.
+  ///
   /// The callback presented to the embedder to present a fully populated buffer
   /// to the user. The pixel format of the buffer is the native 32-bit RGBA
   /// format. The buffer is owned by the Flutter engine and must be copied in
   /// this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  /// See `surface_present_callback` for the present callbacks that may be
+  /// specified.
+  ///
+  /// When using this variant, the engine keeps the contents of the buffer
+  /// between frames and only renders the areas of the screen that changed.
+  /// Those areas are passed to the embedder in the `frame_damage` of
+  /// `FlutterSoftwarePresentInfo`, so that the embedder only needs to copy
+  /// the changed rows to its framebuffer. The rest of the buffer still holds
+  /// the previously presented frame.
+  SoftwareSurfacePresentWithInfoCallback surface_present_with_info_callback;
+  /// The maximum number of disjoint rectangles the engine may report in the
+  /// `frame_damage` of `FlutterSoftwarePresentInfo` or
+  /// `FlutterSoftwareBufferPresentInfo`. A value of 0 or 1 reports at most one
+  /// rectangle. Only used when `surface_present_with_info_callback` or the
+  /// buffer callbacks are specified.
+  size_t max_damage_rects;
+  /// The buffer callbacks let the engine render directly into a pool of
+  /// pixel buffers owned by the embedder, such as shared memory that can be
+  /// scanned out, instead of into a buffer of its own that the embedder has to
+  /// copy. Either all or none of them must be specified. A pool of 2 or 3
+  /// buffers is recommended, so that the engine can render the next frame
+  /// while the embedder scans out the previous one.
+  ///
+  /// The engine calls `acquire_buffer_callback` on the raster thread before
+  /// it renders a frame, and owns the returned buffer until it passes it to
+  /// `present_buffer_callback` or `release_buffer_callback`. The embedder
+  /// must not hand out a buffer that it is still reading from. The callback
+  /// may block until that is the case, which acts as the fence between the
+  /// embedder's scanout and the engine's rendering. Returning false skips the
+  /// frame.
+  ///
+  /// The engine keeps track of the frames each buffer missed, and only
+  /// repaints the areas of a buffer that differ from the frame being
+  /// rendered.
+  SoftwareBufferAcquireCallback acquire_buffer_callback;
+  /// Called on the raster thread once a frame has been completely rendered
+  /// into a buffer. All of the engine's writes to the buffer have finished
+  /// by then, so the embedder may scan it out right away. Ownership of the
+  /// buffer returns to the embedder, regardless of the return value.
+  SoftwareBufferPresentCallback present_buffer_callback;
+  /// Called when the engine hands a buffer back without presenting it, for
+  /// example when the surface is resized or destroyed. The contents of the
+  /// buffer are undefined.
+  SoftwareBufferReleaseCallback release_buffer_callback;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -13,9 +13,11 @@ namespace flutter {
 EmbedderSurfaceGL::EmbedderSurfaceGL(
     GLDispatchTable gl_dispatch_table,
     bool fbo_reset_after_present,
+    size_t max_damage_rects,
     std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
     : gl_dispatch_table_(std::move(gl_dispatch_table)),
       fbo_reset_after_present_(fbo_reset_after_present),
+      max_damage_rects_(max_damage_rects),
       external_view_embedder_(std::move(external_view_embedder)) {
   // Make sure all required members of the dispatch table are checked.
   if (!gl_dispatch_table_.gl_make_current_callback ||
@@ -90,6 +92,7 @@ SurfaceFrame::FramebufferInfo EmbedderSurfaceGL::GLContextFramebufferInfo()
   info.supports_readback = true;
   info.supports_partial_repaint =
       gl_dispatch_table_.gl_populate_existing_damage != nullptr;
+  info.max_damage_rects = max_damage_rects_;
   return info;
 }
 
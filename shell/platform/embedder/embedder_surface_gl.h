@@ -30,6 +30,7 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   EmbedderSurfaceGL(
       GLDispatchTable gl_dispatch_table,
       bool fbo_reset_after_present,
+      size_t max_damage_rects,
       std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
 
   ~EmbedderSurfaceGL() override;
@@ -38,6 +39,7 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   bool valid_ = false;
   GLDispatchTable gl_dispatch_table_;
   bool fbo_reset_after_present_;
+  size_t max_damage_rects_;
 
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
 
@@ -15,18 +15,30 @@
 
 namespace flutter {
 
+// The number of frames whose damage is remembered. Buffers that missed more
+// frames than this are repainted in full.
+static constexpr size_t kMaxFrameDamageHistory = 4;
+
 EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     SoftwareDispatchTable software_dispatch_table,
-    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
+    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer)
     : software_dispatch_table_(std::move(software_dispatch_table)),
-      external_view_embedder_(std::move(external_view_embedder)) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+      external_view_embedder_(std::move(external_view_embedder)),
+      tiled_rasterizer_(std::move(tiled_rasterizer)) {
+  if (!software_dispatch_table_.software_present_backing_store &&
+      !software_dispatch_table_.software_present_backing_store_with_info &&
+      !UsesEmbedderBuffers()) {
     return;
   }
   valid_ = true;
 }
 
-EmbedderSurfaceSoftware::~EmbedderSurfaceSoftware() = default;
+EmbedderSurfaceSoftware::~EmbedderSurfaceSoftware() {
+  if (buffer_id_.has_value()) {
+    ReleaseEmbedderBuffer();
+  }
+}
 
 // |EmbedderSurface|
 bool EmbedderSurfaceSoftware::IsValid() const {
@@ -39,7 +51,8 @@ std::unique_ptr<Surface> EmbedderSurfaceSoftware::CreateGPUSurface() {
     return nullptr;
   }
   const bool render_to_surface = !external_view_embedder_;
-  auto surface = std::make_unique<GPUSurfaceSoftware>(this, render_to_surface);
+  auto surface = std::make_unique<GPUSurfaceSoftware>(this, render_to_surface,
+                                                      tiled_rasterizer_);
 
   if (!surface->IsValid()) {
     return nullptr;
@@ -63,12 +76,21 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
     return nullptr;
   }
 
+  if (UsesEmbedderBuffers()) {
+    return AcquireEmbedderBuffer(size);
+  }
+
   if (sk_surface_ != nullptr &&
       SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
-    // The old and new surface sizes are the same. Nothing to do here.
+    // The old and new surface sizes are the same. The surface still holds
+    // the last presented frame, so only the damaged area of the next frame
+    // needs to be rendered.
+    existing_damage_ = SkIRect::MakeEmpty();
     return sk_surface_;
   }
 
+  existing_damage_ = std::nullopt;
+
   SkImageInfo info = SkImageInfo::MakeN32(
       size.fWidth, size.fHeight, kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
   sk_surface_ = SkSurfaces::Raster(info, nullptr);
@@ -84,11 +106,39 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
 // |GPUSurfaceSoftwareDelegate|
 bool EmbedderSurfaceSoftware::PresentBackingStore(
     sk_sp<SkSurface> backing_store) {
+  return PresentBackingStoreWithInfo(std::move(backing_store), {});
+}
+
+// |GPUSurfaceSoftwareDelegate|
+SurfaceFrame::FramebufferInfo EmbedderSurfaceSoftware::GetBackingStoreInfo()
+    const {
+  SurfaceFrame::FramebufferInfo info;
+  info.supports_readback = true;
+  // Without the damage, the embedder would have to copy the whole backing
+  // store anyway.
+  if (software_dispatch_table_.software_present_backing_store_with_info ||
+      UsesEmbedderBuffers()) {
+    info.supports_partial_repaint = true;
+    info.existing_damage = existing_damage_;
+    info.max_damage_rects = software_dispatch_table_.max_damage_rects;
+  }
+  return info;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreWithInfo(
+    sk_sp<SkSurface> backing_store,
+    const SoftwarePresentInfo& present_info) {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
   }
 
+  if (UsesEmbedderBuffers()) {
+    FML_DCHECK(backing_store == sk_surface_);
+    return PresentEmbedderBuffer(present_info);
+  }
+
   SkPixmap pixmap;
   if (!backing_store->peekPixels(&pixmap)) {
     FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
@@ -105,6 +155,21 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
     return false;
   }
 
+  if (software_dispatch_table_.software_present_backing_store_with_info) {
+    // Without a frame damage, the whole backing store has changed.
+    SoftwarePresentInfo info = present_info;
+    if (!info.frame_damage.has_value()) {
+      info.frame_damage = pixmap.bounds();
+      info.frame_damage_rects.clear();
+    }
+    return software_dispatch_table_.software_present_backing_store_with_info(
+        pixmap.addr(),      //
+        pixmap.rowBytes(),  //
+        pixmap.height(),    //
+        info                //
+    );
+  }
+
   return software_dispatch_table_.software_present_backing_store(
       pixmap.addr(),      //
       pixmap.rowBytes(),  //
@@ -112,4 +177,109 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+bool EmbedderSurfaceSoftware::UsesEmbedderBuffers() const {
+  return software_dispatch_table_.software_acquire_buffer &&
+         software_dispatch_table_.software_present_buffer &&
+         software_dispatch_table_.software_release_buffer;
+}
+
+sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireEmbedderBuffer(
+    const SkISize& size) {
+  if (buffer_id_.has_value()) {
+    // The last frame was dropped before it was presented. Its buffer is still
+    // ours, so render the next frame into it if it fits. The dropped frame
+    // may have drawn into it, so it must be repainted in full.
+    if (SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
+      existing_damage_ = std::nullopt;
+      return sk_surface_;
+    }
+    ReleaseEmbedderBuffer();
+  }
+
+  SoftwareBuffer buffer;
+  if (!software_dispatch_table_.software_acquire_buffer(size, &buffer)) {
+    FML_LOG(ERROR) << "Could not acquire a buffer from the embedder.";
+    return nullptr;
+  }
+
+  SkImageInfo info = SkImageInfo::MakeN32(
+      size.fWidth, size.fHeight, kPremul_SkAlphaType, SkColorSpace::MakeSRGB());
+  sk_surface_ =
+      SkSurfaces::WrapPixels(info, buffer.allocation, buffer.row_bytes);
+  if (sk_surface_ == nullptr) {
+    FML_LOG(ERROR) << "Could not wrap the embedder buffer for software "
+                      "rendering.";
+    software_dispatch_table_.software_release_buffer(buffer.id);
+    return nullptr;
+  }
+  buffer_id_ = buffer.id;
+
+  // Buffers of another size can't hold any of the previous frames.
+  if (size != buffer_size_) {
+    buffer_size_ = size;
+    presented_frame_count_ = 0;
+    buffer_presented_frames_.clear();
+    frame_damage_history_.clear();
+  }
+  existing_damage_ = GetEmbedderBufferExistingDamage(buffer.id);
+
+  return sk_surface_;
+}
+
+bool EmbedderSurfaceSoftware::PresentEmbedderBuffer(
+    const SoftwarePresentInfo& present_info) {
+  if (!buffer_id_.has_value()) {
+    FML_LOG(ERROR) << "Tried to present without an embedder buffer.";
+    return false;
+  }
+  uint64_t buffer_id = buffer_id_.value();
+  buffer_id_ = std::nullopt;
+  sk_surface_ = nullptr;
+
+  // Without a frame damage, the whole frame has changed.
+  SoftwarePresentInfo info = present_info;
+  if (!info.frame_damage.has_value()) {
+    info.frame_damage = SkIRect::MakeSize(buffer_size_);
+    info.frame_damage_rects.clear();
+  }
+
+  presented_frame_count_++;
+  buffer_presented_frames_[buffer_id] = presented_frame_count_;
+  frame_damage_history_.push_back(info.frame_damage.value());
+  if (frame_damage_history_.size() > kMaxFrameDamageHistory) {
+    frame_damage_history_.pop_front();
+  }
+
+  return software_dispatch_table_.software_present_buffer(buffer_id, info);
+}
+
+void EmbedderSurfaceSoftware::ReleaseEmbedderBuffer() {
+  FML_DCHECK(buffer_id_.has_value());
+  uint64_t buffer_id = buffer_id_.value();
+  buffer_id_ = std::nullopt;
+  sk_surface_ = nullptr;
+  // The contents of the buffer are no longer known.
+  buffer_presented_frames_.erase(buffer_id);
+  software_dispatch_table_.software_release_buffer(buffer_id);
+}
+
+std::optional<SkIRect>
+EmbedderSurfaceSoftware::GetEmbedderBufferExistingDamage(
+    uint64_t buffer_id) const {
+  auto found = buffer_presented_frames_.find(buffer_id);
+  if (found == buffer_presented_frames_.end()) {
+    return std::nullopt;
+  }
+  uint64_t missed_frames = presented_frame_count_ - found->second;
+  if (missed_frames > frame_damage_history_.size()) {
+    return std::nullopt;
+  }
+  SkIRect damage = SkIRect::MakeEmpty();
+  auto frame_damage = frame_damage_history_.rbegin();
+  for (uint64_t i = 0; i < missed_frames; i++, frame_damage++) {
+    damage.join(*frame_damage);
+  }
+  return damage;
+}
+
 }  // namespace flutter
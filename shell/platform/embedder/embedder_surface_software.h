@@ -5,6 +5,10 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include <deque>
+#include <optional>
+#include <unordered_map>
+
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -17,14 +21,43 @@ namespace flutter {
 class EmbedderSurfaceSoftware final : public EmbedderSurface,
                                       public GPUSurfaceSoftwareDelegate {
  public:
+  // A pixel buffer of the embedder's pool.
+  struct SoftwareBuffer {
+    uint64_t id = 0;
+    void* allocation = nullptr;
+    size_t row_bytes = 0;
+  };
+
   struct SoftwareDispatchTable {
+    // One (and only one) of the present callbacks, or all of the buffer
+    // callbacks, are required. Partial repaint is not supported with
+    // |software_present_backing_store|.
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const SoftwarePresentInfo& present_info)>
+        software_present_backing_store_with_info;
+    // The maximum number of damage rectangles passed to the present
+    // callbacks.
+    size_t max_damage_rects = 1;
+    // Frames are rendered into the buffers returned by
+    // |software_acquire_buffer| instead of into a backing store owned by the
+    // engine. Each buffer is handed back by passing it to either
+    // |software_present_buffer| or |software_release_buffer|.
+    std::function<bool(const SkISize& size, SoftwareBuffer* buffer)>
+        software_acquire_buffer;
+    std::function<bool(uint64_t buffer_id,
+                       const SoftwarePresentInfo& present_info)>
+        software_present_buffer;
+    std::function<void(uint64_t buffer_id)> software_release_buffer;
   };
 
   EmbedderSurfaceSoftware(
       SoftwareDispatchTable software_dispatch_table,
-      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
+      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer = nullptr);
 
   ~EmbedderSurfaceSoftware() override;
 
@@ -32,7 +65,22 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
+  // The area of |sk_surface_| that doesn't hold the last presented frame.
+  std::optional<SkIRect> existing_damage_;
   std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder_;
+  std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer_;
+
+  // The embedder buffer wrapped by |sk_surface_|, if any.
+  std::optional<uint64_t> buffer_id_;
+  // The size of the embedder buffers that frames were presented into.
+  SkISize buffer_size_ = SkISize::MakeEmpty();
+  // The number of frames presented into embedder buffers of |buffer_size_|.
+  uint64_t presented_frame_count_ = 0;
+  // The value of |presented_frame_count_| after each embedder buffer was last
+  // presented.
+  std::unordered_map<uint64_t, uint64_t> buffer_presented_frames_;
+  // The damage of the most recently presented frames, newest last.
+  std::deque<SkIRect> frame_damage_history_;
 
   // |EmbedderSurface|
   bool IsValid() const override;
@@ -49,6 +97,27 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  SurfaceFrame::FramebufferInfo GetBackingStoreInfo() const override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreWithInfo(
+      sk_sp<SkSurface> backing_store,
+      const SoftwarePresentInfo& present_info) override;
+
+  bool UsesEmbedderBuffers() const;
+
+  sk_sp<SkSurface> AcquireEmbedderBuffer(const SkISize& size);
+
+  bool PresentEmbedderBuffer(const SoftwarePresentInfo& present_info);
+
+  void ReleaseEmbedderBuffer();
+
+  // Returns the union of the damage of the frames presented since the buffer
+  // was last presented, or nullopt if that isn't known.
+  std::optional<SkIRect> GetEmbedderBufferExistingDamage(
+      uint64_t buffer_id) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
@@ -51,12 +51,14 @@ PlatformViewEmbedder::PlatformViewEmbedder(
     const EmbedderSurfaceSoftware::SoftwareDispatchTable&
         software_dispatch_table,
     PlatformDispatchTable platform_dispatch_table,
-    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder)
+    std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+    std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer)
     : PlatformView(delegate, task_runners),
       external_view_embedder_(std::move(external_view_embedder)),
-      embedder_surface_(
-          std::make_unique<EmbedderSurfaceSoftware>(software_dispatch_table,
-                                                    external_view_embedder_)),
+      embedder_surface_(std::make_unique<EmbedderSurfaceSoftware>(
+          software_dispatch_table,
+          external_view_embedder_,
+          std::move(tiled_rasterizer))),
       platform_message_handler_(new EmbedderPlatformMessageHandler(
           GetWeakPtr(),
           task_runners.GetPlatformTaskRunner())),
@@ -54,14 +54,16 @@ class PlatformViewEmbedder final : public PlatformView {
     ChanneUpdateCallback on_channel_update;                     // optional
   };
 
-  // Create a platform view that sets up a software rasterizer.
+  // Create a platform view that sets up a software rasterizer. If
+  // |tiled_rasterizer| is not null, frames are rasterized in parallel bands.
   PlatformViewEmbedder(
       PlatformView::Delegate& delegate,
       const flutter::TaskRunners& task_runners,
       const EmbedderSurfaceSoftware::SoftwareDispatchTable&
           software_dispatch_table,
       PlatformDispatchTable platform_dispatch_table,
-      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder);
+      std::shared_ptr<EmbedderExternalViewEmbedder> external_view_embedder,
+      std::shared_ptr<DlSkTiledRasterizer> tiled_rasterizer = nullptr);
 
 #ifdef SHELL_ENABLE_GL
   // Creates a platform view that sets up an OpenGL rasterizer.
@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -152,6 +153,233 @@ TEST_F(EmbedderTest, CanTerminateCleanly) {
   ASSERT_TRUE(engine.is_valid());
 }
 
+TEST_F(EmbedderTest, MustNotRunWithBothSoftwarePresentCallbacks) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.GetRendererConfig().software.surface_present_with_info_callback =
+      [](void* context, const FlutterSoftwarePresentInfo* present_info) {
+        return true;
+      };
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
+TEST_F(EmbedderTest, SoftwarePresentInfoContainsFrameDamage) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("render_gradient_retained");
+
+  static std::function<void(const FlutterSoftwarePresentInfo&)>
+      present_callback;
+  builder.GetRendererConfig().software.surface_present_callback = nullptr;
+  builder.GetRendererConfig().software.surface_present_with_info_callback =
+      [](void* context, const FlutterSoftwarePresentInfo* present_info) {
+        present_callback(*present_info);
+        return true;
+      };
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  fml::AutoResetWaitableEvent latch;
+
+  // The first frame is rendered into a new buffer, so all of it is damaged.
+  present_callback = [&](const FlutterSoftwarePresentInfo& present_info) {
+    ASSERT_EQ(present_info.row_bytes, 800u * 4);
+    ASSERT_EQ(present_info.height, 600u);
+    ASSERT_EQ(present_info.frame_damage.num_rects, 1u);
+    ASSERT_EQ(present_info.frame_damage.damage->left, 0);
+    ASSERT_EQ(present_info.frame_damage.damage->top, 0);
+    ASSERT_EQ(present_info.frame_damage.damage->right, 800);
+    ASSERT_EQ(present_info.frame_damage.damage->bottom, 600);
+
+    latch.Signal();
+  };
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  latch.Wait();
+
+  // The second frame is the same as the first and the buffer still holds the
+  // first frame, so nothing needs to be copied.
+  present_callback = [&](const FlutterSoftwarePresentInfo& present_info) {
+    ASSERT_EQ(present_info.frame_damage.num_rects, 1u);
+    ASSERT_EQ(present_info.frame_damage.damage->left, 0);
+    ASSERT_EQ(present_info.frame_damage.damage->top, 0);
+    ASSERT_EQ(present_info.frame_damage.damage->right, 0);
+    ASSERT_EQ(present_info.frame_damage.damage->bottom, 0);
+
+    latch.Signal();
+  };
+
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  latch.Wait();
+
+  engine.reset();
+  present_callback = nullptr;
+}
+
+TEST_F(EmbedderTest, MustNotRunWithIncompleteSoftwareBufferCallbacks) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.GetRendererConfig().software.surface_present_callback = nullptr;
+  builder.GetRendererConfig().software.acquire_buffer_callback =
+      [](void* context, const FlutterFrameInfo* frame_info,
+         FlutterSoftwareBuffer* buffer) { return false; };
+  builder.GetRendererConfig().software.present_buffer_callback =
+      [](void* context, const FlutterSoftwareBufferPresentInfo* present_info) {
+        return true;
+      };
+  auto engine = builder.LaunchEngine();
+  ASSERT_FALSE(engine.is_valid());
+}
+
+TEST_F(EmbedderTest, CanRenderIntoEmbedderSoftwareBuffers) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("render_gradient_retained");
+
+  // The buffers are handed out in turn.
+  static std::vector<std::vector<uint32_t>> buffers(
+      3, std::vector<uint32_t>(800 * 600));
+  static size_t next_buffer = 0;
+  static std::function<void(const FlutterSoftwareBufferPresentInfo&)>
+      present_callback;
+  builder.GetRendererConfig().software.surface_present_callback = nullptr;
+  builder.GetRendererConfig().software.acquire_buffer_callback =
+      [](void* context, const FlutterFrameInfo* frame_info,
+         FlutterSoftwareBuffer* buffer) {
+        EXPECT_EQ(frame_info->size.width, 800u);
+        EXPECT_EQ(frame_info->size.height, 600u);
+        size_t index = next_buffer++ % buffers.size();
+        buffer->buffer_id = index;
+        buffer->allocation = buffers[index].data();
+        buffer->row_bytes = 800 * 4;
+        buffer->height = 600;
+        return true;
+      };
+  builder.GetRendererConfig().software.present_buffer_callback =
+      [](void* context, const FlutterSoftwareBufferPresentInfo* present_info) {
+        present_callback(*present_info);
+        return true;
+      };
+  builder.GetRendererConfig().software.release_buffer_callback =
+      [](void* context, uint64_t buffer_id) {};
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  fml::AutoResetWaitableEvent latch;
+
+  // The first frame is rendered in full into the first buffer.
+  present_callback = [&](const FlutterSoftwareBufferPresentInfo& present_info) {
+    ASSERT_EQ(present_info.buffer_id, 0u);
+    ASSERT_EQ(present_info.frame_damage.num_rects, 1u);
+    ASSERT_EQ(present_info.frame_damage.damage->right, 800);
+    ASSERT_EQ(present_info.frame_damage.damage->bottom, 600);
+
+    latch.Signal();
+  };
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  latch.Wait();
+  ASSERT_NE(buffers[0][800 * 300 + 400], 0u);
+
+  // The second frame doesn't change anything, but the second buffer has
+  // never held a frame, so it is still rendered in full.
+  present_callback = [&](const FlutterSoftwareBufferPresentInfo& present_info) {
+    ASSERT_EQ(present_info.buffer_id, 1u);
+    ASSERT_EQ(present_info.frame_damage.num_rects, 1u);
+    ASSERT_EQ(present_info.frame_damage.damage->right, 0);
+    ASSERT_EQ(present_info.frame_damage.damage->bottom, 0);
+
+    latch.Signal();
+  };
+
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  latch.Wait();
+  ASSERT_EQ(buffers[0], buffers[1]);
+
+  engine.reset();
+  present_callback = nullptr;
+}
+
+TEST_F(EmbedderTest, ReleasesSoftwareBuffersThatDontFitTheFrame) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("render_gradient_retained");
+
+  // The buffer is too short for the frame.
+  static std::vector<uint32_t> buffer(800 * 300);
+  static std::function<void(uint64_t)> release_callback;
+  builder.GetRendererConfig().software.surface_present_callback = nullptr;
+  builder.GetRendererConfig().software.acquire_buffer_callback =
+      [](void* context, const FlutterFrameInfo* frame_info,
+         FlutterSoftwareBuffer* software_buffer) {
+        software_buffer->buffer_id = 7;
+        software_buffer->allocation = buffer.data();
+        software_buffer->row_bytes = 800 * 4;
+        software_buffer->height = 300;
+        return true;
+      };
+  builder.GetRendererConfig().software.present_buffer_callback =
+      [](void* context, const FlutterSoftwareBufferPresentInfo* present_info) {
+        ADD_FAILURE() << "A buffer that doesn't fit the frame was presented.";
+        return true;
+      };
+  builder.GetRendererConfig().software.release_buffer_callback =
+      [](void* context, uint64_t buffer_id) {
+        if (release_callback) {
+          release_callback(buffer_id);
+        }
+      };
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  fml::AutoResetWaitableEvent latch;
+  release_callback = [&](uint64_t buffer_id) {
+    ASSERT_EQ(buffer_id, 7u);
+    latch.Signal();
+  };
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  latch.Wait();
+
+  engine.reset();
+  release_callback = nullptr;
+}
+
 TEST_F(EmbedderTest, ExecutableNameNotNull) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
 
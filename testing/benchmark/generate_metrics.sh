@@ -16,3 +16,6 @@ $ENGINE_PATH/src/out/host_release/ui_benchmarks --benchmark_format=json > $ENGIN
 $ENGINE_PATH/src/out/host_release/display_list_builder_benchmarks --benchmark_format=json > $ENGINE_PATH/src/out/host_release/display_list_builder_benchmarks.json
 $ENGINE_PATH/src/out/host_release/geometry_benchmarks --benchmark_format=json > $ENGINE_PATH/src/out/host_release/geometry_benchmarks.json
 $ENGINE_PATH/src/out/host_release/canvas_benchmarks --benchmark_format=json > $ENGINE_PATH/src/out/host_release/canvas_benchmarks.json
+$ENGINE_PATH/src/out/host_release/entity_benchmarks --benchmark_format=json > $ENGINE_PATH/src/out/host_release/entity_benchmarks.json
+$ENGINE_PATH/src/out/host_release/typographer_benchmarks --benchmark_format=json > $ENGINE_PATH/src/out/host_release/typographer_benchmarks.json
+$ENGINE_PATH/src/out/host_release/client_wrapper_benchmarks --benchmark_format=json > $ENGINE_PATH/src/out/host_release/client_wrapper_benchmarks.json
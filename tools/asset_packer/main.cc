@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+
+using flutter::PackedAssetBundle;
+
+void Usage() {
+  std::cout << "Usage:" << std::endl;
+  std::cout << "asset-packer <output.pak> <assets_directory>" << std::endl;
+  std::cout << std::endl;
+  std::cout << "Packs every file in the assets directory and its "
+               "subdirectories into a single bundle. The assets are named by "
+               "their paths relative to the assets directory."
+            << std::endl;
+  std::cout << "Place the bundle in the assets directory as "
+            << PackedAssetBundle::kFileName
+            << " for the engine to resolve assets from it." << std::endl;
+}
+
+bool CollectAssets(const fml::UniqueFD& directory,
+                   const std::string& prefix,
+                   std::vector<PackedAssetBundle::Asset>& assets) {
+  bool success = true;
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& dir,
+                                 const std::string& filename) {
+    std::string name = prefix + filename;
+    if (name == PackedAssetBundle::kFileName) {
+      // A bundle left by a previous run.
+      return true;
+    }
+    if (fml::IsDirectory(dir, filename.c_str())) {
+      auto subdirectory = fml::OpenDirectoryReadOnly(dir, filename.c_str());
+      success = success && CollectAssets(subdirectory, name + "/", assets);
+      return success;
+    }
+    std::shared_ptr<fml::Mapping> data =
+        fml::FileMapping::CreateReadOnly(dir, filename);
+    if (!data) {
+      std::cerr << "Failed to read " << name << "; aborting." << std::endl;
+      success = false;
+      return false;
+    }
+    assets.push_back({.name = std::move(name), .data = std::move(data)});
+    return true;
+  });
+  return success;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    Usage();
+    return -1;
+  }
+  std::string output_file_path(argv[1]);
+  std::string assets_directory_path(argv[2]);
+
+  auto assets_directory = fml::OpenDirectory(
+      assets_directory_path.c_str(), false, fml::FilePermission::kRead);
+  if (!assets_directory.is_valid()) {
+    std::cerr << "Failed to open the assets directory "
+              << assets_directory_path << "; aborting." << std::endl;
+    return -1;
+  }
+
+  std::vector<PackedAssetBundle::Asset> assets;
+  if (!CollectAssets(assets_directory, "", assets)) {
+    return -1;
+  }
+
+  auto bundle = PackedAssetBundle::Pack(assets);
+  if (!bundle) {
+    std::cerr << "Failed to pack the assets; aborting." << std::endl;
+    return -1;
+  }
+
+  std::ofstream output_file(output_file_path,
+                                 std::ios::out | std::ios::binary);
+  output_file.write(reinterpret_cast<const char*>(bundle->GetMapping()),
+                         bundle->GetSize());
+  if (!output_file.good()) {
+    std::cerr << "Failed to write " << output_file_path << "; aborting."
+              << std::endl;
+    return -1;
+  }
+  std::cout << "Packed " << assets.size() << " assets ("
+            << bundle->GetSize() << " bytes) into " << output_file_path
+            << std::endl;
+  return 0;
+}